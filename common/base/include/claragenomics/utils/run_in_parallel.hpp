@@ -0,0 +1,74 @@
+/*
+* Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <future>
+#include <thread>
+#include <vector>
+
+namespace claraparabricks
+{
+
+namespace genomeworks
+{
+
+/// \brief returns number_of_threads if it is positive, the number of hardware threads otherwise
+/// \param number_of_threads requested number of threads, 0 for one thread per hardware thread
+/// \return number of threads to use
+inline std::int32_t get_number_of_host_threads(const std::int32_t number_of_threads)
+{
+    if (number_of_threads > 0)
+    {
+        return number_of_threads;
+    }
+    return std::max(1, static_cast<std::int32_t>(std::thread::hardware_concurrency()));
+}
+
+/// \brief calls task(i) for every i in [0, number_of_tasks) using up to number_of_threads threads
+/// Threads pick up the next task as soon as they finish the previous one.
+/// Exceptions thrown by tasks are rethrown after all threads have finished.
+/// \param number_of_threads
+/// \param number_of_tasks
+/// \param task callable taking task id
+template <typename Task>
+void run_in_parallel(const std::int32_t number_of_threads,
+                     const std::size_t number_of_tasks,
+                     const Task& task)
+{
+    std::atomic<std::size_t> next_task(0);
+    std::vector<std::future<void>> workers;
+    const std::size_t number_of_workers = std::min(static_cast<std::size_t>(std::max(number_of_threads, 1)), number_of_tasks);
+    for (std::size_t i = 0; i < number_of_workers; ++i)
+    {
+        workers.push_back(std::async(std::launch::async,
+                                     [&next_task, number_of_tasks, &task]() {
+                                         for (std::size_t task_id = next_task++; task_id < number_of_tasks; task_id = next_task++)
+                                         {
+                                             task(task_id);
+                                         }
+                                     }));
+    }
+    for (std::future<void>& worker : workers)
+    {
+        worker.wait();
+    }
+    for (std::future<void>& worker : workers)
+    {
+        worker.get();
+    }
+}
+
+} // namespace genomeworks
+
+} // namespace claraparabricks
@@ -10,8 +10,11 @@
 
 #pragma once
 
+#include <algorithm>
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <cstdint>
 #include <deque>
 #include <exception>
 #include <mutex>
@@ -86,23 +89,45 @@ private:
     std::atomic<std::size_t> counter_;
 };
 
+/// ProducerConsumerStatistics - statistics of a ThreadsafeProducerConsumer
+struct ProducerConsumerStatistics
+{
+    /// largest number of elements that were in the queue at the same time
+    std::int64_t high_water_mark = 0;
+    /// number of elements added so far
+    std::int64_t number_of_added_elements = 0;
+    /// number of add calls which had to wait for a free slot because the queue was full
+    std::int64_t number_of_blocked_adds = 0;
+    /// number of timed add calls which gave up because the queue stayed full
+    std::int64_t number_of_timed_out_adds = 0;
+    /// total time add calls spent waiting for a free slot
+    double blocked_seconds = 0.0;
+};
+
 /// ThreadsafeProducerConsumer - a threadsafe implementation of producer-consumer pattern with an option to signal that there will be no new elements
 ///
 /// Producers add elements using add_new_element(), consumers consume elements in the order the were added using get_next_element().
 /// If there is no available element get_next_element() blocks and waits for one.
 ///
+/// Optionally the number of elements in the queue can be limited. If the queue is full add_new_element() blocks until a consumer takes
+/// an element and try_add_new_element_for() gives up after a timeout, so producers which are faster than consumers get throttled instead
+/// of filling the memory.
+///
 /// One producer can signal that there are not going to be any new elements using signal_pushed_last_element(). After this is done and all elements
 /// have been consumed get_next_element() returns empty optionals indicating that there is not going to be any new data and consumers can carry on
 template <typename T>
 class ThreadsafeProducerConsumer
 {
 public:
-    /// \brief default constructor
-    ThreadsafeProducerConsumer()
+    /// \brief Constructor
+    /// \param capacity maximal number of elements in the queue, 0 means no limit
+    explicit ThreadsafeProducerConsumer(const std::size_t capacity = 0)
         : data_()
+        , capacity_(capacity)
         , pushed_last_element_(false)
         , mutex_()
         , condition_variable_()
+        , space_available_condition_variable_()
     {
     }
 
@@ -125,40 +150,36 @@ public:
     /// \brief destructor
     ~ThreadsafeProducerConsumer() = default;
 
-    /// \brief adds an element to the queue
+    /// \brief adds an element to the queue, if the queue is full waits for a consumer to take an element first
     ///
     /// \param element element to add
     /// \throw std::logic_error if called after signal_pushed_last_element() has been called by any producer
     void add_new_element(const T& element) // not using reference in order to support both rvalue and lvalue
     {
-        // consider adding max number of elements and waiting for consumer to process an element before adding a new one
-        {
-            std::lock_guard<std::mutex> lg(mutex_);
-            if (pushed_last_element_)
-            {
-                throw std::logic_error("ThreadsafeProducerConsumer: pushed an element after signal_pushed_last_element() has been called");
-            }
-            data_.push_front(element);
-        }
-        condition_variable_.notify_one();
+        add_element(element, nullptr);
     }
 
-    /// \brief adds an element to the queue
+    /// \brief adds an element to the queue, if the queue is full waits for a consumer to take an element first
     ///
     /// \param element element to add
     /// \throw std::logic_error if called after signal_pushed_last_element() has been called by any producer
     void add_new_element(T&& element) // not using reference in order to support both rvalue and lvalue
     {
-        // consider adding max number of elements and waiting for consumer to process an element before adding a new one
-        {
-            std::lock_guard<std::mutex> lg(mutex_);
-            if (pushed_last_element_)
-            {
-                throw std::logic_error("ThreadsafeProducerConsumer: pushed an element after signal_pushed_last_element() has been called");
-            }
-            data_.push_front(std::move(element));
-        }
-        condition_variable_.notify_one();
+        add_element(std::move(element), nullptr);
+    }
+
+    /// \brief adds an element to the queue, if the queue is full waits at most timeout for a consumer to take an element
+    ///
+    /// \param element element to add, only moved from if it has been added
+    /// \param timeout
+    /// \return true if the element has been added, false if the queue was still full after timeout
+    /// \throw std::logic_error if called after signal_pushed_last_element() has been called by any producer
+    template <typename Rep, typename Period>
+    bool try_add_new_element_for(T&& element,
+                                 const std::chrono::duration<Rep, Period>& timeout)
+    {
+        const std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + timeout;
+        return add_element(std::move(element), &deadline);
     }
 
     /// \brief tells container that no new elements are going to be added
@@ -178,6 +199,8 @@ public:
             pushed_last_element_ = true;
         }
         condition_variable_.notify_all();
+        // producers waiting for a free slot throw
+        space_available_condition_variable_.notify_all();
     }
 
     /// \brief gets the next element
@@ -204,19 +227,94 @@ public:
         {
             cga_optional_t<T> res = std::move(data_.back());
             data_.pop_back();
+            ul.unlock();
+            space_available_condition_variable_.notify_one();
             return res;
         }
     }
 
+    /// \brief returns maximal number of elements in the queue, 0 means no limit
+    std::size_t capacity() const
+    {
+        return capacity_;
+    }
+
+    /// \brief returns statistics of all calls so far
+    ProducerConsumerStatistics statistics() const
+    {
+        std::lock_guard<std::mutex> lg(mutex_);
+        return statistics_;
+    }
+
 private:
+    /// \brief adds an element to the queue, waits until deadline for a free slot if the queue is full
+    /// \param element
+    /// \param deadline nullptr to wait without a time limit
+    /// \return true if the element has been added, false if the queue was still full at the deadline
+    template <typename U>
+    bool add_element(U&& element,
+                     const std::chrono::steady_clock::time_point* const deadline)
+    {
+        {
+            std::unique_lock<std::mutex> ul(mutex_);
+
+            if (is_full() && !pushed_last_element_)
+            {
+                ++statistics_.number_of_blocked_adds;
+                const auto wait_start = std::chrono::steady_clock::now();
+                while (is_full() && !pushed_last_element_)
+                {
+                    if (nullptr == deadline)
+                    {
+                        space_available_condition_variable_.wait(ul);
+                    }
+                    else if (std::cv_status::timeout == space_available_condition_variable_.wait_until(ul, *deadline) && is_full())
+                    {
+                        break;
+                    }
+                }
+                statistics_.blocked_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - wait_start).count();
+            }
+
+            if (pushed_last_element_)
+            {
+                throw std::logic_error("ThreadsafeProducerConsumer: pushed an element after signal_pushed_last_element() has been called");
+            }
+
+            if (is_full())
+            {
+                ++statistics_.number_of_timed_out_adds;
+                return false;
+            }
+
+            data_.push_front(std::forward<U>(element));
+            ++statistics_.number_of_added_elements;
+            statistics_.high_water_mark = std::max(statistics_.high_water_mark, static_cast<std::int64_t>(data_.size()));
+        }
+        condition_variable_.notify_one();
+        return true;
+    }
+
+    /// \brief returns true if the queue has a capacity and is full, mutex_ has to be locked
+    bool is_full() const
+    {
+        return capacity_ > 0 && data_.size() >= capacity_;
+    }
+
     /// data
     std::deque<T> data_;
+    /// maximal number of elements in data_, 0 means no limit
+    const std::size_t capacity_;
     /// if true no new calls to signal_pushed_last_element() is called
     bool pushed_last_element_;
-    /// mutex for condition_variable_
-    std::mutex mutex_;
+    /// statistics of all calls so far
+    ProducerConsumerStatistics statistics_;
+    /// mutex for condition_variable_ and space_available_condition_variable_
+    mutable std::mutex mutex_;
     /// condition_variable to wait on if there are no available elements
     std::condition_variable condition_variable_;
+    /// condition_variable to wait on if the queue is full
+    std::condition_variable space_available_condition_variable_;
 };
 
 } // namespace genomeworks
@@ -0,0 +1,76 @@
+/*
+* Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#include "gtest/gtest.h"
+
+#include <claragenomics/utils/run_in_parallel.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+namespace claraparabricks
+{
+
+namespace genomeworks
+{
+
+TEST(TestUtilsRunInParallel, every_task_once)
+{
+    for (const std::int32_t number_of_threads : {0, 1, 3, 16})
+    {
+        for (const std::size_t number_of_tasks : {0, 1, 5, 1000})
+        {
+            std::vector<std::atomic<std::int32_t>> calls_per_task(number_of_tasks);
+            for (std::atomic<std::int32_t>& calls : calls_per_task)
+            {
+                calls = 0;
+            }
+            run_in_parallel(number_of_threads,
+                            number_of_tasks,
+                            [&calls_per_task](const std::size_t task_id) {
+                                ++calls_per_task[task_id];
+                            });
+            for (std::size_t task_id = 0; task_id < number_of_tasks; ++task_id)
+            {
+                ASSERT_EQ(calls_per_task[task_id], 1) << "number_of_threads: " << number_of_threads << ", number_of_tasks: " << number_of_tasks << ", task_id: " << task_id;
+            }
+        }
+    }
+}
+
+TEST(TestUtilsRunInParallel, exceptions_are_rethrown)
+{
+    std::atomic<std::int32_t> finished_tasks(0);
+    EXPECT_THROW(run_in_parallel(4,
+                                 100,
+                                 [&finished_tasks](const std::size_t task_id) {
+                                     if (42 == task_id)
+                                     {
+                                         throw std::runtime_error("task failed");
+                                     }
+                                     ++finished_tasks;
+                                 }),
+                 std::runtime_error);
+    // the worker which threw stops, the other workers finish the remaining tasks
+    EXPECT_EQ(finished_tasks, 99);
+}
+
+TEST(TestUtilsRunInParallel, get_number_of_host_threads)
+{
+    EXPECT_EQ(get_number_of_host_threads(5), 5);
+    EXPECT_GE(get_number_of_host_threads(0), 1);
+    EXPECT_GE(get_number_of_host_threads(-1), 1);
+}
+
+} // namespace genomeworks
+
+} // namespace claraparabricks
@@ -13,6 +13,8 @@
 #include <claragenomics/utils/threadsafe_containers.hpp>
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <mutex>
 #include <cstdint>
 #include <numeric>
@@ -88,7 +90,8 @@ TEST(TestUtilsThreadsafeContainers, test_threadsafe_data_provider_no_data)
 void test_test_threadsafe_producer_consumer(const std::int32_t number_of_elements,
                                             const std::int32_t number_of_producers,
                                             const std::int32_t number_of_consumers,
-                                            const std::int32_t producers_sleep_for_ms) // give consumers some time to empty the queue)
+                                            const std::int32_t producers_sleep_for_ms, // give consumers some time to empty the queue)
+                                            const std::size_t capacity = 0)
 {
     ASSERT_GT(number_of_elements, 0);
     ASSERT_GT(number_of_producers, 0);
@@ -98,7 +101,7 @@ void test_test_threadsafe_producer_consumer(const std::int32_t number_of_element
     const std::int32_t producers_sleep_after           = number_of_elements_per_producer / 10 * 3;
     ASSERT_GT(number_of_elements_per_producer, producers_sleep_after);
 
-    ThreadsafeProducerConsumer<std::int32_t> producer_consumer;
+    ThreadsafeProducerConsumer<std::int32_t> producer_consumer(capacity);
 
     std::mutex occurrences_per_element_mutex; // using mutex instead of atomic as the test was failining when using more than 1'000'000 atomics
     std::vector<std::int32_t> occurrences_per_element(number_of_elements, 0);
@@ -164,6 +167,11 @@ void test_test_threadsafe_producer_consumer(const std::int32_t number_of_element
                             [](const std::int32_t val) {
                                 return val == 1;
                             }));
+
+    if (capacity > 0)
+    {
+        ASSERT_LE(producer_consumer.statistics().high_water_mark, static_cast<std::int64_t>(capacity));
+    }
 }
 
 TEST(TestUtilsThreadsafeContainers, test_threadsafe_producer_consumer_single_producer_single_consumer)
@@ -196,6 +204,91 @@ TEST(TestUtilsThreadsafeContainers, test_threadsafe_producer_consumer_multiple_p
                                            producers_sleep_for_ms);
 }
 
+TEST(TestUtilsThreadsafeContainers, test_threadsafe_producer_consumer_bounded_multiple_producers_multiple_consumers)
+{
+    const std::int32_t number_of_elements     = 1'000'000;
+    const std::int32_t number_of_producers    = 10;
+    const std::int32_t number_of_consumers    = 20;
+    const std::int32_t producers_sleep_for_ms = 100;
+    const std::size_t capacity                = 10;
+
+    test_test_threadsafe_producer_consumer(number_of_elements,
+                                           number_of_producers,
+                                           number_of_consumers,
+                                           producers_sleep_for_ms,
+                                           capacity);
+}
+
+TEST(TestUtilsThreadsafeContainers, test_threadsafe_producer_consumer_bounded_timed_add)
+{
+    ThreadsafeProducerConsumer<std::vector<std::int32_t>> producer_consumer(1);
+    ASSERT_EQ(producer_consumer.capacity(), 1u);
+
+    producer_consumer.add_new_element({0});
+    std::vector<std::int32_t> element({1, 2});
+    // queue is full, element is not moved from
+    ASSERT_FALSE(producer_consumer.try_add_new_element_for(std::move(element), std::chrono::milliseconds(10)));
+    ASSERT_EQ(element, std::vector<std::int32_t>({1, 2}));
+
+    ASSERT_EQ(producer_consumer.get_next_element().value(), std::vector<std::int32_t>({0}));
+    ASSERT_TRUE(producer_consumer.try_add_new_element_for(std::move(element), std::chrono::milliseconds(10)));
+    ASSERT_EQ(producer_consumer.get_next_element().value(), std::vector<std::int32_t>({1, 2}));
+
+    const ProducerConsumerStatistics statistics = producer_consumer.statistics();
+    ASSERT_EQ(statistics.high_water_mark, 1);
+    ASSERT_EQ(statistics.number_of_added_elements, 2);
+    ASSERT_EQ(statistics.number_of_blocked_adds, 1);
+    ASSERT_EQ(statistics.number_of_timed_out_adds, 1);
+    ASSERT_GT(statistics.blocked_seconds, 0.0);
+}
+
+TEST(TestUtilsThreadsafeContainers, test_threadsafe_producer_consumer_bounded_blocking_add)
+{
+    ThreadsafeProducerConsumer<std::int32_t> producer_consumer(2);
+
+    std::atomic<bool> added_all_elements(false);
+    std::atomic<bool> add_after_last_threw(false);
+    std::thread producer_thread([&producer_consumer, &added_all_elements, &add_after_last_threw]() {
+        for (std::int32_t i = 0; i < 3; ++i)
+        {
+            producer_consumer.add_new_element(i);
+        }
+        added_all_elements = true;
+        // waiting producers throw once the last element has been signaled
+        try
+        {
+            producer_consumer.add_new_element(3);
+        }
+        catch (const std::logic_error&)
+        {
+            add_after_last_threw = true;
+        }
+    });
+
+    // third element is only added once a consumer takes the first one
+    while (producer_consumer.statistics().number_of_blocked_adds < 1)
+    {
+        std::this_thread::yield();
+    }
+    ASSERT_FALSE(added_all_elements);
+    ASSERT_EQ(producer_consumer.get_next_element().value(), 0);
+
+    // fourth element waits until the last element is signaled
+    while (producer_consumer.statistics().number_of_blocked_adds < 2)
+    {
+        std::this_thread::yield();
+    }
+    ASSERT_TRUE(added_all_elements);
+    producer_consumer.signal_pushed_last_element();
+    producer_thread.join();
+    ASSERT_TRUE(add_after_last_threw);
+
+    ASSERT_EQ(producer_consumer.get_next_element().value(), 1);
+    ASSERT_EQ(producer_consumer.get_next_element().value(), 2);
+    ASSERT_FALSE(producer_consumer.get_next_element());
+    ASSERT_EQ(producer_consumer.statistics().high_water_mark, 2);
+}
+
 TEST(TestUtilsThreadsafeContainers, test_threadsafe_producer_consumer_add_after_last)
 {
     ThreadsafeProducerConsumer<std::int32_t> producer_consumer;
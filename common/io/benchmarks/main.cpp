@@ -0,0 +1,179 @@
+/*
+* Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#include <claragenomics/io/fasta_parser.hpp>
+#include <claragenomics/utils/genomeutils.hpp>
+
+#include "../src/bgzf.hpp"
+
+#include <benchmark/benchmark.h>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace claraparabricks
+{
+
+namespace genomeworks
+{
+
+namespace io
+{
+
+/// ReadsFile - FASTA file with random reads, deleted when the benchmark finishes
+class ReadsFile
+{
+public:
+    ReadsFile(const std::int32_t number_of_reads,
+              const std::int32_t read_length,
+              const bool bgzf)
+        : file_path_(bgzf ? "benchmark_cgaio_reads.fasta.gz" : "benchmark_cgaio_reads.fasta")
+    {
+        std::string content;
+        std::minstd_rand rng(1);
+        for (std::int32_t i = 0; i < number_of_reads; ++i)
+        {
+            content += ">read_" + std::to_string(i) + "\n" + genomeutils::generate_random_genome(read_length, rng) + "\n";
+        }
+        // bytes processed are always counted in uncompressed bytes
+        file_size_ = content.size();
+
+        std::ofstream file(file_path_, std::ios::binary);
+        if (bgzf)
+        {
+            const std::vector<char> compressed = deflate_bgzf(content.data(), content.size());
+            file.write(compressed.data(), compressed.size());
+        }
+        else
+        {
+            file << content;
+        }
+    }
+
+    ~ReadsFile()
+    {
+        std::remove(file_path_.c_str());
+    }
+
+    const std::string& path() const
+    {
+        return file_path_;
+    }
+
+    std::int64_t size() const
+    {
+        return file_size_;
+    }
+
+private:
+    std::string file_path_;
+    std::int64_t file_size_;
+};
+
+/// 20'000 reads of 10'000 basepairs, about 200 MB
+const ReadsFile& get_reads_file()
+{
+    static const ReadsFile reads_file(20000, 10000, false);
+    return reads_file;
+}
+
+/// same reads as get_reads_file(), compressed with BGZF
+const ReadsFile& get_bgzf_reads_file()
+{
+    static const ReadsFile reads_file(20000, 10000, true);
+    return reads_file;
+}
+
+static void BM_KseqParser(benchmark::State& state)
+{
+    const ReadsFile& reads_file = get_reads_file();
+
+    for (auto _ : state)
+    {
+        std::unique_ptr<FastaParser> parser = create_kseq_fasta_parser(reads_file.path(), 0, true);
+        benchmark::DoNotOptimize(parser->get_num_seqences());
+    }
+
+    state.SetBytesProcessed(state.iterations() * reads_file.size());
+}
+
+static void BM_ParallelParser(benchmark::State& state)
+{
+    const ReadsFile& reads_file          = get_reads_file();
+    const std::int32_t number_of_threads = state.range(0);
+
+    for (auto _ : state)
+    {
+        std::unique_ptr<FastaParser> parser = create_parallel_fasta_parser(reads_file.path(), 0, true, number_of_threads);
+        benchmark::DoNotOptimize(parser->get_num_seqences());
+    }
+
+    state.SetBytesProcessed(state.iterations() * reads_file.size());
+}
+
+static void BM_KseqParserBgzf(benchmark::State& state)
+{
+    const ReadsFile& reads_file = get_bgzf_reads_file();
+
+    for (auto _ : state)
+    {
+        std::unique_ptr<FastaParser> parser = create_kseq_fasta_parser(reads_file.path(), 0, true);
+        benchmark::DoNotOptimize(parser->get_num_seqences());
+    }
+
+    state.SetBytesProcessed(state.iterations() * reads_file.size());
+}
+
+static void BM_ParallelParserBgzf(benchmark::State& state)
+{
+    const ReadsFile& reads_file          = get_bgzf_reads_file();
+    const std::int32_t number_of_threads = state.range(0);
+
+    for (auto _ : state)
+    {
+        std::unique_ptr<FastaParser> parser = create_parallel_fasta_parser(reads_file.path(), 0, true, number_of_threads);
+        benchmark::DoNotOptimize(parser->get_num_seqences());
+    }
+
+    state.SetBytesProcessed(state.iterations() * reads_file.size());
+}
+
+// Register the functions as a benchmark
+BENCHMARK(BM_KseqParser)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+BENCHMARK(BM_ParallelParser)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime()
+    ->RangeMultiplier(2)
+    ->Range(1, std::max(1, static_cast<int>(std::thread::hardware_concurrency())));
+
+BENCHMARK(BM_KseqParserBgzf)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+BENCHMARK(BM_ParallelParserBgzf)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime()
+    ->RangeMultiplier(2)
+    ->Range(1, std::max(1, static_cast<int>(std::thread::hardware_concurrency())));
+
+} // namespace io
+
+} // namespace genomeworks
+
+} // namespace claraparabricks
+
+BENCHMARK_MAIN();
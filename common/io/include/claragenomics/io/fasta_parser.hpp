@@ -9,8 +9,10 @@
 */
 #pragma once
 
+#include <functional>
 #include <string>
 #include <memory>
+#include <mutex>
 #include <vector>
 
 #include <claragenomics/types.hpp>
@@ -24,6 +26,9 @@ namespace genomeworks
 namespace io
 {
 
+class PackedSequenceStore;
+class ReadNameIndex;
+
 /// A structure to hold details of a single FASTA entry.
 typedef struct
 {
@@ -38,8 +43,11 @@ typedef struct
 class FastaParser
 {
 public:
+    /// \brief Constructor, defined out of line as the name index is only declared here.
+    FastaParser();
+
     /// \brief FastaParser implementations can have custom destructors, so delcare the abstract dtor as default.
-    virtual ~FastaParser() = default;
+    virtual ~FastaParser();
 
     /// \brief Return number of sequences in FASTA file
     /// \return Sequence count in file
@@ -49,8 +57,110 @@ public:
     /// \param sequence_id Position of sequence in file. If sequence_id is invalid an error is thrown.
     /// \return A reference to FastaSequence describing the entry.
     virtual const FastaSequence& get_sequence_by_id(read_id_t sequence_id) const = 0;
+
+    /// \brief Return the number of basepairs of an entry.
+    /// Implementations which do not store reads as FastaSequence should override this to avoid materializing the entry.
+    /// \param sequence_id Position of sequence in file.
+    /// \return Number of basepairs in the entry.
+    virtual number_of_basepairs_t get_sequence_length_by_id(read_id_t sequence_id) const;
+
+    /// \brief Fetch the name of an entry without copying it.
+    /// \param sequence_id Position of sequence in file.
+    /// \return A view of the name, valid for the lifetime of the parser.
+    virtual cga_string_view_t get_name_view_by_id(read_id_t sequence_id) const;
+
+    /// \brief Fetch the basepairs of an entry without copying them.
+    /// \param sequence_id Position of sequence in file.
+    /// \return A view of the basepairs, valid for the lifetime of the parser.
+    virtual cga_string_view_t get_sequence_view_by_id(read_id_t sequence_id) const;
+
+    /// \brief Copy a section of the basepairs of an entry into a buffer owned by the caller.
+    /// Implementations which do not store reads as plain text decode the basepairs directly into the buffer.
+    /// \param sequence_id Position of sequence in file.
+    /// \param first_basepair First basepair to copy.
+    /// \param number_of_basepairs Number of basepairs to copy, section must not go past the end of the entry.
+    /// \param destination Buffer with space for at least number_of_basepairs characters. No null-terminator is written.
+    virtual void copy_sequence_by_id(read_id_t sequence_id,
+                                     position_in_read_t first_basepair,
+                                     number_of_basepairs_t number_of_basepairs,
+                                     char* destination) const;
+
+    /// \brief Return packed basepairs of all entries, if the parser stores them.
+    /// Ids of sequences in the store are the same as ids of entries in the parser.
+    /// \return A pointer to the store valid for the lifetime of the parser, nullptr if basepairs are not stored packed.
+    virtual const PackedSequenceStore* get_packed_sequences() const;
+
+    /// \brief Hint that a range of entries is going to be accessed soon.
+    /// Parsers which do not keep all entries in host memory start loading the range in the background, others ignore the hint.
+    /// \param first_sequence_id First entry in the range.
+    /// \param number_of_sequences Number of entries in the range.
+    virtual void prefetch_sequences(read_id_t first_sequence_id,
+                                    number_of_reads_t number_of_sequences) const;
+
+    /// \brief Hint that a set of entries, not necessarily with consecutive ids, is going to be accessed soon.
+    /// Parsers which load entries in the background load the whole set at once.
+    /// The default implementation calls prefetch_sequences() for every run of consecutive ids.
+    /// \param sequence_ids Entries in the set, in any order.
+    virtual void prefetch_sequences_by_ids(const std::vector<read_id_t>& sequence_ids) const;
+
+    /// \brief Return the id of the entry with the given name.
+    /// On first call an index of all names is built, which takes time linear in the number of entries.
+    /// The index is a hash table of 8-byte slots whose size is the smallest power of two that is at least twice
+    /// the number of entries, i.e. it takes 16 to 32 bytes per entry of host memory.
+    /// Names are not copied, so the index is only built if this function is used.
+    /// The function can be called from multiple threads concurrently.
+    /// \param name Name of the entry, i.e. the header up to the first whitespace.
+    /// \return Id of the entry. If several entries have the same name the lowest id is returned.
+    ///         If no entry has the given name an error is thrown.
+    virtual read_id_t get_sequence_id_by_name(cga_string_view_t name) const;
+
+private:
+    /// built on first call to get_sequence_id_by_name()
+    mutable std::unique_ptr<ReadNameIndex> read_name_index_;
+    mutable std::once_flag read_name_index_flag_;
+};
+
+/// ReadOrdering - strategies for assigning read_ids to reads
+///
+/// cudamapper groups reads with consecutive read_ids into indices with similar numbers of basepairs. Orderings which
+/// spread reads of different lengths over the whole range of read_ids make the workload of those indices more even.
+/// All orderings are deterministic.
+enum class ReadOrdering
+{
+    /// read_ids in file order
+    file_order,
+    /// fixed pseudo-random shuffle, the same as the one done by parsers created with shuffle enabled
+    random,
+    /// reads sorted by length and interleaved from both ends: longest, shortest, second longest, second shortest, ...
+    length_striped,
+    /// reads grouped into buckets of lengths within a factor of two of each other, reads are then taken from all buckets in turn,
+    /// in proportion to bucket sizes, so that every range of read_ids has about the same mix of lengths
+    length_bucketed
 };
 
+/// InputFileFormat - formats of input files, see detect_input_file_format()
+enum class InputFileFormat
+{
+    /// uncompressed file, e.g. FASTA or FASTQ
+    uncompressed,
+    /// file compressed with bgzip
+    bgzip,
+    /// file compressed with gzip, but not with bgzip
+    gzip,
+    /// read store written by write_read_store(), see create_read_store_parser()
+    read_store
+};
+
+/// \brief Detects the format of a file from its first bytes.
+///
+/// Only the magic bytes are checked, the content of the file is not validated.
+///
+/// \param file Path to the file.
+///
+/// \return Format of the file.
+/// \throw std::invalid_argument if the file cannot be opened
+InputFileFormat detect_input_file_format(const std::string& file);
+
 /// \brief A builder function that returns a FASTA parser object which uses KSEQPP.
 ///
 /// \param fasta_file Path to FASTA(.gz) file. If .gz, it must be zipped with bgzip.
@@ -62,6 +172,137 @@ std::unique_ptr<FastaParser> create_kseq_fasta_parser(const std::string& fasta_f
                                                       number_of_basepairs_t min_sequence_length = 0,
                                                       bool shuffle                              = true);
 
+/// \brief A builder function that returns a FASTA parser object which memory-maps the file.
+///
+/// Sequences are located through a samtools-style index (<fasta_file>.fai). If the index does not exist or is older
+/// than the FASTA file it is built and saved next to the FASTA file if possible, otherwise an existing index is reused
+/// and construction time depends only on the number of sequences.
+/// Sequences which are written on a single line are served directly from the mapping, sequences spanning multiple lines
+/// have their line breaks removed on first access.
+/// Shuffling produces the same order of reads as create_kseq_fasta_parser().
+///
+/// \param fasta_file Path to uncompressed FASTA file.
+/// \param min_sequence_length Minimum length a sequence needs to be to be parsed. Shorter sequences are ignored.
+/// \param shuffle Enables shuffling reads
+///
+/// \return A unique pointer to a constructed parser object.
+std::unique_ptr<FastaParser> create_mmap_fasta_parser(const std::string& fasta_file,
+                                                      number_of_basepairs_t min_sequence_length = 0,
+                                                      bool shuffle                              = true);
+
+/// \brief A builder function that returns a FASTA parser object which keeps basepairs packed to 2 bits per basepair.
+///
+/// Reads are parsed with KSEQPP and stored in a PackedSequenceStore, using about a quarter of the host memory
+/// create_kseq_fasta_parser() uses. Basepairs are decoded on access, prefer copy_sequence_by_id() as
+/// get_sequence_by_id() and get_sequence_view_by_id() keep decoded copies of the requested reads for the lifetime of the parser.
+/// Shuffling produces the same order of reads as create_kseq_fasta_parser().
+///
+/// \param fasta_file Path to FASTA(.gz) file. If .gz, it must be zipped with bgzip.
+/// \param min_sequence_length Minimum length a sequence needs to be to be parsed. Shorter sequences are ignored.
+/// \param shuffle Enables shuffling reads
+///
+/// \return A unique pointer to a constructed parser object.
+std::unique_ptr<FastaParser> create_packed_fasta_parser(const std::string& fasta_file,
+                                                        number_of_basepairs_t min_sequence_length = 0,
+                                                        bool shuffle                              = true);
+
+/// \brief A builder function that returns a FASTA/FASTQ parser object which parses the file on multiple threads.
+///
+/// The file is memory-mapped and split into byte ranges, which are moved to record boundaries and parsed concurrently.
+/// Reads are stored in one contiguous table and get the same read_ids as with create_kseq_fasta_parser(),
+/// independently of the number of threads.
+/// Files compressed with bgzip are first inflated on the same threads, which needs host memory for the whole
+/// uncompressed file while parsing. Other gzip files are rejected, use create_kseq_fasta_parser() for them.
+///
+/// \param fasta_file Path to FASTA or FASTQ file, uncompressed or compressed with bgzip.
+/// \param min_sequence_length Minimum length a sequence needs to be to be parsed. Shorter sequences are ignored.
+/// \param shuffle Enables shuffling reads
+/// \param number_of_threads Number of threads to parse with, 0 to use one thread per hardware thread
+///
+/// \return A unique pointer to a constructed parser object.
+std::unique_ptr<FastaParser> create_parallel_fasta_parser(const std::string& fasta_file,
+                                                          number_of_basepairs_t min_sequence_length = 0,
+                                                          bool shuffle                              = true,
+                                                          std::int32_t number_of_threads            = 0);
+
+/// \brief A builder function that returns a FASTA parser object which keeps at most a given number of basepairs in host memory.
+///
+/// Like create_mmap_fasta_parser() sequences are located through a samtools-style index (<fasta_file>.fai), which is
+/// built if needed. Only the index and the names are kept in host memory, basepairs are loaded in ranges of consecutive
+/// read_ids. prefetch_sequences() starts loading a range in the background, reads which are not resident are copied
+/// directly from the file. Once resident ranges hold more than max_resident_basepairs the least recently used ones are
+/// evicted, which allows processing files larger than host memory.
+/// Prefer copy_sequence_by_id(), get_sequence_by_id() and get_sequence_view_by_id() keep copies of the requested reads
+/// for the lifetime of the parser, outside of max_resident_basepairs.
+/// Shuffling produces the same order of reads as create_kseq_fasta_parser().
+///
+/// \param fasta_file Path to uncompressed FASTA file.
+/// \param min_sequence_length Minimum length a sequence needs to be to be parsed. Shorter sequences are ignored.
+/// \param shuffle Enables shuffling reads
+/// \param max_resident_basepairs Number of basepairs above which least recently used ranges are evicted
+///
+/// \return A unique pointer to a constructed parser object.
+std::unique_ptr<FastaParser> create_windowed_fasta_parser(const std::string& fasta_file,
+                                                          number_of_basepairs_t min_sequence_length = 0,
+                                                          bool shuffle                              = true,
+                                                          std::size_t max_resident_basepairs        = 1'000'000'000);
+
+/// \brief A builder function that returns a parser object which reads a read store file.
+///
+/// Read stores are written by write_read_store() (see claragenomics/io/read_store.hpp) or the create_read_store tool.
+/// The file is memory-mapped and not parsed, so construction time depends only on the number of reads and
+/// processes reading the same read store share its pages.
+/// Shuffling produces the same order of reads as create_kseq_fasta_parser() on the file the read store was created from.
+///
+/// \param read_store_file Path to read store file.
+/// \param min_sequence_length Minimum length a sequence needs to be to be parsed. Shorter sequences are ignored.
+/// \param shuffle Enables shuffling reads
+///
+/// \return A unique pointer to a constructed parser object.
+std::unique_ptr<FastaParser> create_read_store_parser(const std::string& read_store_file,
+                                                      number_of_basepairs_t min_sequence_length = 0,
+                                                      bool shuffle                              = true);
+
+/// \brief A builder function that returns a parser object which assigns new read_ids to the reads of another parser.
+///
+/// Read_ids are assigned to the order of reads in the given parser, which should therefore be created with shuffling
+/// disabled for the result to be independent of the type of parser.
+/// get_packed_sequences() of the returned parser returns nullptr, as ids in the packed store would not match the new ids.
+///
+/// \param parser Parser whose reads get reordered, the returned parser takes ownership of it.
+/// \param ordering Strategy for assigning new read_ids.
+///
+/// \return A unique pointer to a constructed parser object.
+std::unique_ptr<FastaParser> create_ordered_fasta_parser(std::unique_ptr<FastaParser> parser,
+                                                         ReadOrdering ordering);
+
+/// \brief A builder function that returns a parser object which presents the reads of several files as one file.
+///
+/// Files are parsed concurrently, each by a parser created by create_file_parser. Reads of the first file get the
+/// lowest read_ids, followed by the reads of the second file and so on, so the result is as if the files were
+/// concatenated. File parsers should therefore be created with shuffling disabled, use create_ordered_fasta_parser()
+/// with ReadOrdering::random on the returned parser to get the same read_ids as for the concatenated file.
+///
+/// \param fasta_files Paths to the files, see also read_file_of_filenames().
+/// \param create_file_parser Function which creates the parser for one file, called concurrently for different files,
+///                           e.g. a lambda calling create_kseq_fasta_parser().
+/// \param number_of_threads Number of files to parse concurrently, 0 to use one thread per hardware thread
+///
+/// \return A unique pointer to a constructed parser object.
+std::unique_ptr<FastaParser> create_multi_file_fasta_parser(const std::vector<std::string>& fasta_files,
+                                                            const std::function<std::unique_ptr<FastaParser>(const std::string&)>& create_file_parser,
+                                                            std::int32_t number_of_threads = 0);
+
+/// \brief Reads a file-of-filenames (FOFN).
+///
+/// A FOFN lists one path per line. Empty lines and lines starting with '#' are skipped, relative paths are relative
+/// to the directory of the FOFN.
+///
+/// \param file_of_filenames Path to the FOFN.
+///
+/// \return Paths in the order they are listed.
+std::vector<std::string> read_file_of_filenames(const std::string& file_of_filenames);
+
 } // namespace io
 
 } // namespace genomeworks
@@ -0,0 +1,72 @@
+/*
+* Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace claraparabricks
+{
+
+namespace genomeworks
+{
+
+namespace io
+{
+
+/// MemoryMappedFile - read-only mapping of a whole file into the address space of the process
+///
+/// Pages are loaded by the OS on first access and are shared with every other process mapping the same file,
+/// so opening a file is O(1) regardless of its size.
+class MemoryMappedFile
+{
+public:
+    /// \brief Constructor, maps the whole file
+    /// \param file_path path to the file
+    /// \throw std::invalid_argument if the file cannot be opened
+    /// \throw std::runtime_error if the file cannot be mapped
+    explicit MemoryMappedFile(const std::string& file_path);
+
+    /// \brief Unmaps the file
+    ~MemoryMappedFile();
+
+    MemoryMappedFile(const MemoryMappedFile&) = delete;
+    MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+
+    /// \brief move constructor
+    MemoryMappedFile(MemoryMappedFile&& rhs) noexcept;
+
+    /// \brief move assignment operator
+    MemoryMappedFile& operator=(MemoryMappedFile&& rhs) noexcept;
+
+    /// \brief returns pointer to the first byte of the file, nullptr if the file is empty
+    const char* data() const;
+
+    /// \brief returns size of the file in bytes
+    std::size_t size() const;
+
+    /// \brief returns path of the mapped file
+    const std::string& path() const;
+
+private:
+    /// \brief unmaps the file if it is mapped
+    void unmap();
+
+    std::string file_path_;
+    const char* data_;
+    std::size_t size_;
+};
+
+} // namespace io
+
+} // namespace genomeworks
+
+} // namespace claraparabricks
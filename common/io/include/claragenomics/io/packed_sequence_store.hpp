@@ -0,0 +1,133 @@
+/*
+* Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <claragenomics/types.hpp>
+
+namespace claraparabricks
+{
+
+namespace genomeworks
+{
+
+namespace io
+{
+
+/// PackedSequenceStore - stores basepairs of many sequences using 2 bits per basepair
+///
+/// A, C, G and T are encoded as 0, 1, 2 and 3, which is the same encoding cudamapper's minimizers use for basepair hashes.
+/// Every sequence starts at the beginning of a new word and basepair i of a sequence is stored in
+/// bits [2*(i%32), 2*(i%32)+1] of its word i/32.
+/// Case is stored separately from the basepairs, lowercase characters are packed like their uppercase versions and
+/// every stretch of lowercase characters is stored as one interval, so soft-masked sequences stay at about 2 bits per basepair.
+/// All other characters (N, IUPAC codes) are stored as runs in a sparse exception list and have code 0 in the packed words,
+/// so decoding always returns the original sequence.
+class PackedSequenceStore
+{
+public:
+    /// type of one packed word
+    using word_t = std::uint64_t;
+
+    /// number of basepairs stored in one word
+    static constexpr std::uint32_t basepairs_per_word = 32;
+
+    /// \brief adds a sequence to the end of the store
+    /// \param sequence basepairs, does not have to be null-terminated
+    /// \param number_of_basepairs
+    /// \return id of the added sequence, ids are assigned consecutively starting from 0
+    read_id_t add_sequence(const char* sequence,
+                           number_of_basepairs_t number_of_basepairs);
+
+    /// \brief returns a store with the same sequences in a different order
+    /// \param new_to_old_id new_to_old_id[i] is the id in this store of the sequence which gets id i in the new store
+    /// \return reordered store
+    PackedSequenceStore reordered(const std::vector<read_id_t>& new_to_old_id) const;
+
+    /// \brief returns number of sequences in the store
+    number_of_reads_t number_of_sequences() const;
+
+    /// \brief returns number of basepairs in a sequence
+    /// \param sequence_id
+    number_of_basepairs_t sequence_length(read_id_t sequence_id) const;
+
+    /// \brief decodes a section of a sequence into a buffer owned by the caller
+    /// \param sequence_id
+    /// \param first_basepair first basepair to decode
+    /// \param number_of_basepairs number of basepairs to decode, first_basepair + number_of_basepairs must not be larger than sequence length
+    /// \param destination buffer with space for at least number_of_basepairs characters, no null-terminator is written
+    void decode(read_id_t sequence_id,
+                position_in_read_t first_basepair,
+                number_of_basepairs_t number_of_basepairs,
+                char* destination) const;
+
+    /// \brief returns packed words of a sequence
+    /// Lowercase basepairs have the code of their uppercase version. Positions of characters other than A, C, G and T in either case
+    /// have code 0, check has_exceptions() before using words directly
+    /// \param sequence_id
+    /// \return pointer to number_of_packed_words(sequence_id) words
+    const word_t* packed_words(read_id_t sequence_id) const;
+
+    /// \brief returns number of words used by a sequence
+    /// \param sequence_id
+    std::size_t number_of_packed_words(read_id_t sequence_id) const;
+
+    /// \brief returns whether a sequence contains characters other than A, C, G and T in either case
+    /// \param sequence_id
+    bool has_exceptions(read_id_t sequence_id) const;
+
+    /// \brief returns approximate number of bytes of host memory used by the store
+    std::size_t memory_usage_bytes() const;
+
+    /// \brief releases unused capacity of internal arrays
+    void shrink_to_fit();
+
+private:
+    /// sequence of equal non-ACGT characters
+    struct ExceptionRun
+    {
+        position_in_read_t first_basepair;
+        number_of_basepairs_t number_of_basepairs;
+        char basepair;
+    };
+
+    /// sequence of lowercase characters
+    struct LowercaseInterval
+    {
+        position_in_read_t first_basepair;
+        number_of_basepairs_t number_of_basepairs;
+    };
+
+    /// location of one sequence in words_, exception_runs_ and lowercase_intervals_
+    struct SequenceEntry
+    {
+        std::size_t first_word;
+        std::size_t first_exception_run;
+        std::size_t first_lowercase_interval;
+        number_of_basepairs_t number_of_basepairs;
+        std::uint32_t number_of_exception_runs;
+        std::uint32_t number_of_lowercase_intervals;
+    };
+
+    std::vector<SequenceEntry> sequences_;
+    std::vector<word_t> words_;
+    /// exception runs of uppercased characters, case is given by lowercase_intervals_
+    std::vector<ExceptionRun> exception_runs_;
+    std::vector<LowercaseInterval> lowercase_intervals_;
+};
+
+} // namespace io
+
+} // namespace genomeworks
+
+} // namespace claraparabricks
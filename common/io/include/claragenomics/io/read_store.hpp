@@ -0,0 +1,42 @@
+/*
+* Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#pragma once
+
+#include <string>
+
+namespace claraparabricks
+{
+
+namespace genomeworks
+{
+
+namespace io
+{
+
+class FastaParser;
+
+/// \brief Writes all reads of a parser to a read store file.
+///
+/// A read store is a binary file with a table of read offsets, all names and all basepairs, which
+/// create_read_store_parser() maps into memory without parsing. Reads are written in parser order,
+/// so the parser should usually be created without shuffling and without a minimum sequence length.
+///
+/// \param parser Parser with reads to write.
+/// \param read_store_file Path to the output file, overwritten if it exists.
+/// \throw std::invalid_argument if the file cannot be written
+void write_read_store(const FastaParser& parser,
+                      const std::string& read_store_file);
+
+} // namespace io
+
+} // namespace genomeworks
+
+} // namespace claraparabricks
@@ -0,0 +1,240 @@
+/*
+* Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#include "bgzf.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include <zlib.h>
+
+#include <claragenomics/utils/run_in_parallel.hpp>
+
+namespace claraparabricks
+{
+
+namespace genomeworks
+{
+
+namespace io
+{
+
+namespace
+{
+
+/// gzip header up to and including XLEN
+constexpr std::size_t fixed_header_size = 12;
+/// CRC32 and ISIZE
+constexpr std::size_t trailer_size = 8;
+/// fixed header, XLEN of 6 with the BC subfield, compressed data and trailer
+constexpr std::size_t bgzf_overhead = fixed_header_size + 6 + trailer_size;
+/// bgzip's amount of uncompressed data per block, it always fits into a block after compression
+constexpr std::size_t uncompressed_block_size = 0xff00;
+/// number of consecutive blocks inflated by one task
+constexpr std::size_t blocks_per_task = 64;
+
+/// BgzfBlock - position of one block in the compressed and uncompressed data
+struct BgzfBlock
+{
+    std::size_t compressed_data_offset;
+    std::uint32_t compressed_data_size;
+    std::uint32_t crc;
+    std::size_t uncompressed_offset;
+    std::uint32_t uncompressed_size;
+};
+
+std::uint32_t read_uint16(const char* const data)
+{
+    const unsigned char* const bytes = reinterpret_cast<const unsigned char*>(data);
+    return bytes[0] | (bytes[1] << 8);
+}
+
+std::uint32_t read_uint32(const char* const data)
+{
+    const unsigned char* const bytes = reinterpret_cast<const unsigned char*>(data);
+    return bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | (static_cast<std::uint32_t>(bytes[3]) << 24);
+}
+
+void write_uint16(const std::uint32_t value, std::vector<char>& destination)
+{
+    destination.push_back(static_cast<char>(value & 0xff));
+    destination.push_back(static_cast<char>((value >> 8) & 0xff));
+}
+
+void write_uint32(const std::uint32_t value, std::vector<char>& destination)
+{
+    write_uint16(value & 0xffff, destination);
+    write_uint16(value >> 16, destination);
+}
+
+/// \brief returns the total size of the block starting at data, or 0 if there is no complete BGZF block
+std::size_t bgzf_block_size(const char* const data,
+                            const std::size_t size)
+{
+    // ID1, ID2, CM = deflate, FLG = FEXTRA only
+    if (size < fixed_header_size || data[0] != '\x1f' || data[1] != '\x8b' || data[2] != 8 || data[3] != 4)
+    {
+        return 0;
+    }
+
+    const std::size_t extra_size = read_uint16(data + 10);
+    if (size < fixed_header_size + extra_size)
+    {
+        return 0;
+    }
+
+    // look for the BC subfield, which holds the block size minus 1
+    std::size_t subfield = fixed_header_size;
+    while (subfield + 4 <= fixed_header_size + extra_size)
+    {
+        const std::size_t subfield_size = read_uint16(data + subfield + 2);
+        if (data[subfield] == 'B' && data[subfield + 1] == 'C' && subfield_size == 2)
+        {
+            const std::size_t block_size = read_uint16(data + subfield + 4) + 1;
+            return (block_size >= fixed_header_size + extra_size + trailer_size && block_size <= size) ? block_size : 0;
+        }
+        subfield += 4 + subfield_size;
+    }
+    return 0;
+}
+
+} // namespace
+
+bool is_bgzf(const char* const data,
+             const std::size_t size)
+{
+    return bgzf_block_size(data, size) != 0;
+}
+
+std::vector<char> inflate_bgzf(const char* const data,
+                               const std::size_t size,
+                               const std::string& file_path,
+                               const std::int32_t number_of_threads)
+{
+    // find all blocks, their positions in the output follow from the uncompressed sizes in their trailers
+    std::vector<BgzfBlock> blocks;
+    std::size_t uncompressed_size = 0;
+    for (std::size_t block_begin = 0; block_begin < size;)
+    {
+        const std::size_t block_size = bgzf_block_size(data + block_begin, size - block_begin);
+        if (0 == block_size)
+        {
+            throw std::invalid_argument("Error: invalid or truncated BGZF block at byte " + std::to_string(block_begin) + " of " + file_path + " !");
+        }
+        const std::size_t extra_size = read_uint16(data + block_begin + 10);
+        const char* const trailer    = data + block_begin + block_size - trailer_size;
+        BgzfBlock block;
+        block.compressed_data_offset = block_begin + fixed_header_size + extra_size;
+        block.compressed_data_size   = static_cast<std::uint32_t>(block_size - fixed_header_size - extra_size - trailer_size);
+        block.crc                    = read_uint32(trailer);
+        block.uncompressed_offset    = uncompressed_size;
+        block.uncompressed_size      = read_uint32(trailer + 4);
+        blocks.push_back(block);
+
+        uncompressed_size += block.uncompressed_size;
+        block_begin += block_size;
+    }
+
+    std::vector<char> uncompressed(uncompressed_size);
+    const std::size_t number_of_tasks = (blocks.size() + blocks_per_task - 1) / blocks_per_task;
+    run_in_parallel(number_of_threads,
+                    number_of_tasks,
+                    [&](const std::size_t task_id) {
+                        z_stream stream = {};
+                        // negative window bits for raw deflate data, gzip headers have already been parsed
+                        if (inflateInit2(&stream, -MAX_WBITS) != Z_OK)
+                        {
+                            throw std::runtime_error("Error: cannot initialize zlib !");
+                        }
+
+                        const std::size_t first_block = task_id * blocks_per_task;
+                        const std::size_t last_block  = std::min(first_block + blocks_per_task, blocks.size());
+                        bool valid                    = true;
+                        std::size_t block_id          = first_block;
+                        for (; valid && block_id < last_block; ++block_id)
+                        {
+                            const BgzfBlock& block = blocks[block_id];
+                            char empty_output;
+                            char* const output = (block.uncompressed_size > 0) ? uncompressed.data() + block.uncompressed_offset : &empty_output;
+
+                            inflateReset(&stream);
+                            stream.next_in   = reinterpret_cast<Bytef*>(const_cast<char*>(data + block.compressed_data_offset));
+                            stream.avail_in  = block.compressed_data_size;
+                            stream.next_out  = reinterpret_cast<Bytef*>(output);
+                            stream.avail_out = block.uncompressed_size;
+
+                            valid = inflate(&stream, Z_FINISH) == Z_STREAM_END &&
+                                    stream.avail_out == 0 &&
+                                    crc32(0, reinterpret_cast<const Bytef*>(output), block.uncompressed_size) == block.crc;
+                        }
+                        inflateEnd(&stream);
+
+                        if (!valid)
+                        {
+                            throw std::invalid_argument("Error: corrupted BGZF block at byte " + std::to_string(blocks[block_id - 1].compressed_data_offset) + " of " + file_path + " !");
+                        }
+                    });
+
+    return uncompressed;
+}
+
+std::vector<char> deflate_bgzf(const char* const data,
+                               const std::size_t size)
+{
+    std::vector<char> compressed;
+    std::vector<char> compressed_block(compressBound(uncompressed_block_size));
+
+    z_stream stream = {};
+    if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+    {
+        throw std::runtime_error("Error: cannot initialize zlib !");
+    }
+
+    // the last block is always empty and marks the end of the file
+    std::size_t block_begin = 0;
+    bool last_block         = false;
+    while (!last_block)
+    {
+        const std::size_t block_size = std::min(uncompressed_block_size, size - block_begin);
+        last_block                   = (0 == block_size);
+        char empty_input;
+        const char* const input = (block_size > 0) ? data + block_begin : &empty_input;
+
+        deflateReset(&stream);
+        stream.next_in   = reinterpret_cast<Bytef*>(const_cast<char*>(input));
+        stream.avail_in  = static_cast<uInt>(block_size);
+        stream.next_out  = reinterpret_cast<Bytef*>(compressed_block.data());
+        stream.avail_out = static_cast<uInt>(compressed_block.size());
+        if (deflate(&stream, Z_FINISH) != Z_STREAM_END)
+        {
+            deflateEnd(&stream);
+            throw std::runtime_error("Error: cannot compress BGZF block !");
+        }
+        const std::size_t compressed_size = compressed_block.size() - stream.avail_out;
+
+        const char header[] = {'\x1f', '\x8b', 8, 4, 0, 0, 0, 0, 0, '\xff', 6, 0, 'B', 'C', 2, 0};
+        compressed.insert(std::end(compressed), std::begin(header), std::end(header));
+        write_uint16(static_cast<std::uint32_t>(compressed_size + bgzf_overhead - 1), compressed);
+        compressed.insert(std::end(compressed), compressed_block.data(), compressed_block.data() + compressed_size);
+        write_uint32(crc32(0, reinterpret_cast<const Bytef*>(input), static_cast<uInt>(block_size)), compressed);
+        write_uint32(static_cast<std::uint32_t>(block_size), compressed);
+
+        block_begin += block_size;
+    }
+    deflateEnd(&stream);
+
+    return compressed;
+}
+
+} // namespace io
+
+} // namespace genomeworks
+
+} // namespace claraparabricks
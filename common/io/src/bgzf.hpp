@@ -0,0 +1,57 @@
+/*
+* Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace claraparabricks
+{
+
+namespace genomeworks
+{
+
+namespace io
+{
+
+/// \brief returns true if data starts with a BGZF block, i.e. if it has been compressed with bgzip
+/// \param data
+/// \param size
+bool is_bgzf(const char* data,
+             std::size_t size);
+
+/// \brief inflates a BGZF file on multiple threads
+/// BGZF files are series of gzip members of at most 64kB, each of which stores its compressed and uncompressed size.
+/// Block boundaries are found by following the compressed sizes, blocks are then inflated concurrently, each directly
+/// into its position in the output.
+/// \param data BGZF data
+/// \param size size of data
+/// \param file_path path of the file data was read from, used in error messages
+/// \param number_of_threads number of threads to inflate with
+/// \return uncompressed data
+/// \throw std::invalid_argument if data is not valid BGZF
+std::vector<char> inflate_bgzf(const char* data,
+                               std::size_t size,
+                               const std::string& file_path,
+                               std::int32_t number_of_threads);
+
+/// \brief compresses data to BGZF, including the empty end-of-file block
+/// \param data
+/// \param size
+/// \return compressed data
+std::vector<char> deflate_bgzf(const char* data,
+                               std::size_t size);
+
+} // namespace io
+
+} // namespace genomeworks
+
+} // namespace claraparabricks
@@ -0,0 +1,252 @@
+/*
+* Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#include "fasta_index.hpp"
+
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+#include <sys/stat.h>
+
+#include <claragenomics/io/memory_mapped_file.hpp>
+
+namespace claraparabricks
+{
+
+namespace genomeworks
+{
+
+namespace io
+{
+
+namespace
+{
+
+/// \brief returns true if file_path exists and was not modified before reference_path
+bool is_up_to_date(const std::string& file_path,
+                   const std::string& reference_path)
+{
+    struct stat file_stats;
+    struct stat reference_stats;
+    if (stat(file_path.c_str(), &file_stats) != 0 || stat(reference_path.c_str(), &reference_stats) != 0)
+    {
+        return false;
+    }
+    return file_stats.st_mtime >= reference_stats.st_mtime;
+}
+
+/// \brief parses one unsigned integer column of a .fai line
+std::uint64_t parse_fai_column(const std::string& column,
+                               const std::string& fai_path)
+{
+    char* end                  = nullptr;
+    const std::uint64_t result = std::strtoull(column.c_str(), &end, 10);
+    if (column.empty() || *end != '\0')
+    {
+        throw std::invalid_argument("Error: malformed FASTA index " + fai_path + " !");
+    }
+    return result;
+}
+
+} // namespace
+
+FastaIndex FastaIndex::load_or_build(const MemoryMappedFile& fasta_file,
+                                     const std::string& fai_path)
+{
+    if (is_up_to_date(fai_path, fasta_file.path()))
+    {
+        return load(fai_path);
+    }
+
+    FastaIndex index = build(fasta_file.data(), fasta_file.size(), fasta_file.path());
+    // the index can still be used if the directory is not writable
+    index.save(fai_path);
+    return index;
+}
+
+FastaIndex FastaIndex::build(const char* const data,
+                             const std::size_t size,
+                             const std::string& file_path)
+{
+    FastaIndex index;
+
+    std::size_t pos = 0;
+    while (pos < size)
+    {
+        if (data[pos] != '>')
+        {
+            throw std::invalid_argument("Error: " + file_path + " is not an uncompressed FASTA file, expected '>' at byte " + std::to_string(pos) + " !");
+        }
+
+        // header line, name ends at the first whitespace
+        const char* const header_end_ptr = static_cast<const char*>(std::memchr(data + pos, '\n', size - pos));
+        const std::size_t header_end     = (nullptr != header_end_ptr) ? header_end_ptr - data : size;
+        std::size_t name_end             = pos + 1;
+        while (name_end < header_end && !std::isspace(static_cast<unsigned char>(data[name_end])))
+        {
+            ++name_end;
+        }
+        const char* const name        = data + pos + 1;
+        const std::uint32_t name_size = static_cast<std::uint32_t>(name_end - pos - 1);
+        pos                           = (nullptr != header_end_ptr) ? header_end + 1 : size;
+
+        // sequence lines until the next header
+        const std::uint64_t offset = pos;
+        std::uint64_t length       = 0;
+        std::uint32_t line_bases   = 0;
+        std::uint32_t line_width   = 0;
+        bool first_line            = true;
+        while (pos < size && data[pos] != '>')
+        {
+            const char* const line_end_ptr = static_cast<const char*>(std::memchr(data + pos, '\n', size - pos));
+            const std::size_t line_end     = (nullptr != line_end_ptr) ? line_end_ptr - data : size;
+            const std::size_t next_line    = (nullptr != line_end_ptr) ? line_end + 1 : size;
+            std::size_t bases_end          = line_end;
+            if (bases_end > pos && data[bases_end - 1] == '\r')
+            {
+                --bases_end;
+            }
+            if (first_line)
+            {
+                line_bases = static_cast<std::uint32_t>(bases_end - pos);
+                line_width = static_cast<std::uint32_t>(next_line - pos);
+                first_line = false;
+            }
+            length += bases_end - pos;
+            pos = next_line;
+        }
+
+        if (length > std::numeric_limits<number_of_basepairs_t>::max())
+        {
+            throw std::invalid_argument("Error: sequence " + std::string(name, name_size) + " in " + file_path + " is too long !");
+        }
+
+        index.add_entry(name,
+                        name_size,
+                        static_cast<number_of_basepairs_t>(length),
+                        offset,
+                        line_bases,
+                        line_width);
+    }
+
+    return index;
+}
+
+FastaIndex FastaIndex::load(const std::string& fai_path)
+{
+    std::ifstream fai_file(fai_path);
+    if (!fai_file)
+    {
+        throw std::invalid_argument("Error: "
+                                    "cannot open FASTA index " +
+                                    fai_path + " !");
+    }
+
+    FastaIndex index;
+    std::string line;
+    std::vector<std::string> columns;
+    while (std::getline(fai_file, line))
+    {
+        if (line.empty())
+        {
+            continue;
+        }
+
+        columns.clear();
+        std::istringstream line_stream(line);
+        std::string column;
+        while (std::getline(line_stream, column, '\t'))
+        {
+            columns.push_back(column);
+        }
+
+        // FASTQ indices have 6 columns, those are not supported
+        if (columns.size() != 5)
+        {
+            throw std::invalid_argument("Error: " + fai_path + " is not a FASTA index !");
+        }
+
+        const std::uint64_t length = parse_fai_column(columns[1], fai_path);
+        if (length > std::numeric_limits<number_of_basepairs_t>::max())
+        {
+            throw std::invalid_argument("Error: sequence " + columns[0] + " in " + fai_path + " is too long !");
+        }
+
+        index.add_entry(columns[0].data(),
+                        static_cast<std::uint32_t>(columns[0].size()),
+                        static_cast<number_of_basepairs_t>(length),
+                        parse_fai_column(columns[2], fai_path),
+                        static_cast<std::uint32_t>(parse_fai_column(columns[3], fai_path)),
+                        static_cast<std::uint32_t>(parse_fai_column(columns[4], fai_path)));
+    }
+
+    return index;
+}
+
+bool FastaIndex::save(const std::string& fai_path) const
+{
+    std::ofstream fai_file(fai_path);
+    if (!fai_file)
+    {
+        return false;
+    }
+
+    for (read_id_t entry_id = 0; entry_id < number_of_entries(); ++entry_id)
+    {
+        const Entry& e = entries_[entry_id];
+        fai_file.write(names_.data() + e.name_offset, e.name_length);
+        fai_file << '\t' << e.length << '\t' << e.offset << '\t' << e.line_bases << '\t' << e.line_width << '\n';
+    }
+
+    return static_cast<bool>(fai_file);
+}
+
+number_of_reads_t FastaIndex::number_of_entries() const
+{
+    return static_cast<number_of_reads_t>(entries_.size());
+}
+
+const FastaIndex::Entry& FastaIndex::entry(const read_id_t entry_id) const
+{
+    return entries_[entry_id];
+}
+
+cga_string_view_t FastaIndex::name(const read_id_t entry_id) const
+{
+    const Entry& e = entries_[entry_id];
+    return cga_string_view_t(names_.data() + e.name_offset, e.name_length);
+}
+
+void FastaIndex::add_entry(const char* const name,
+                           const std::uint32_t name_length,
+                           const number_of_basepairs_t length,
+                           const std::uint64_t offset,
+                           const std::uint32_t line_bases,
+                           const std::uint32_t line_width)
+{
+    entries_.push_back({names_.size(),
+                        name_length,
+                        length,
+                        offset,
+                        line_bases,
+                        line_width});
+    names_.insert(std::end(names_), name, name + name_length);
+}
+
+} // namespace io
+
+} // namespace genomeworks
+
+} // namespace claraparabricks
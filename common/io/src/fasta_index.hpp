@@ -0,0 +1,112 @@
+/*
+* Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <claragenomics/types.hpp>
+
+namespace claraparabricks
+{
+
+namespace genomeworks
+{
+
+namespace io
+{
+
+class MemoryMappedFile;
+
+/// FastaIndex - samtools-style index (.fai) of an uncompressed FASTA file
+///
+/// Every entry describes one sequence: its name, number of basepairs, offset of its first basepair in the file
+/// and the layout of its lines. Names of all entries are kept in one contiguous buffer.
+class FastaIndex
+{
+public:
+    /// Entry - one line of a .fai file
+    struct Entry
+    {
+        /// offset of the name in the names buffer
+        std::uint64_t name_offset;
+        /// number of characters in the name
+        std::uint32_t name_length;
+        /// number of basepairs in the sequence
+        number_of_basepairs_t length;
+        /// offset of the first basepair in the FASTA file
+        std::uint64_t offset;
+        /// number of basepairs in the first line of the sequence
+        std::uint32_t line_bases;
+        /// number of bytes in the first line of the sequence, including the line terminator
+        std::uint32_t line_width;
+    };
+
+    /// \brief Loads the index from fai_path if it exists and is not older than the FASTA file, builds it otherwise
+    ///
+    /// A newly built index is saved to fai_path if possible. Failing to save it is not an error.
+    ///
+    /// \param fasta_file mapped FASTA file
+    /// \param fai_path path of the .fai file
+    /// \return the index
+    /// \throw std::invalid_argument if the FASTA file or the existing .fai file are malformed
+    static FastaIndex load_or_build(const MemoryMappedFile& fasta_file,
+                                    const std::string& fai_path);
+
+    /// \brief Builds the index by scanning a FASTA file in memory
+    /// \param data FASTA file content
+    /// \param size number of bytes in data
+    /// \param file_path used in error messages
+    /// \return the index
+    /// \throw std::invalid_argument if the content is not valid FASTA
+    static FastaIndex build(const char* data,
+                            std::size_t size,
+                            const std::string& file_path);
+
+    /// \brief Loads the index from a .fai file
+    /// \param fai_path path of the .fai file
+    /// \return the index
+    /// \throw std::invalid_argument if the file cannot be read or is malformed
+    static FastaIndex load(const std::string& fai_path);
+
+    /// \brief Saves the index in .fai format
+    /// \param fai_path path of the .fai file
+    /// \return true if the index has been saved
+    bool save(const std::string& fai_path) const;
+
+    /// \brief returns the number of sequences in the index
+    number_of_reads_t number_of_entries() const;
+
+    /// \brief returns one entry
+    const Entry& entry(read_id_t entry_id) const;
+
+    /// \brief returns the name of one entry, view into the names buffer
+    cga_string_view_t name(read_id_t entry_id) const;
+
+private:
+    /// \brief adds an entry
+    void add_entry(const char* name,
+                   std::uint32_t name_length,
+                   number_of_basepairs_t length,
+                   std::uint64_t offset,
+                   std::uint32_t line_bases,
+                   std::uint32_t line_width);
+
+    std::vector<Entry> entries_;
+    std::vector<char> names_;
+};
+
+} // namespace io
+
+} // namespace genomeworks
+
+} // namespace claraparabricks
@@ -8,11 +8,30 @@
 * license agreement from NVIDIA CORPORATION is strictly prohibited.
 */
 
+#include "bgzf.hpp"
 #include "kseqpp_fasta_parser.hpp"
+#include "mmap_fasta_parser.hpp"
+#include "multi_file_fasta_parser.hpp"
+#include "ordered_fasta_parser.hpp"
+#include "packed_fasta_parser.hpp"
+#include "parallel_fasta_parser.hpp"
+#include "read_name_index.hpp"
+#include "read_store_format.hpp"
+#include "read_store_parser.hpp"
+#include "windowed_fasta_parser.hpp"
 
 #include "claragenomics/io/fasta_parser.hpp"
 
+#include <algorithm>
+#include <cassert>
+#include <fstream>
+#include <iterator>
 #include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <claragenomics/utils/signed_integer_utils.hpp>
 
 namespace claraparabricks
 {
@@ -23,6 +42,100 @@ namespace genomeworks
 namespace io
 {
 
+FastaParser::FastaParser() = default;
+
+FastaParser::~FastaParser() = default;
+
+number_of_basepairs_t FastaParser::get_sequence_length_by_id(const read_id_t sequence_id) const
+{
+    return get_size<number_of_basepairs_t>(get_sequence_by_id(sequence_id).seq);
+}
+
+cga_string_view_t FastaParser::get_name_view_by_id(const read_id_t sequence_id) const
+{
+    return get_sequence_by_id(sequence_id).name;
+}
+
+cga_string_view_t FastaParser::get_sequence_view_by_id(const read_id_t sequence_id) const
+{
+    return get_sequence_by_id(sequence_id).seq;
+}
+
+void FastaParser::copy_sequence_by_id(const read_id_t sequence_id,
+                                      const position_in_read_t first_basepair,
+                                      const number_of_basepairs_t number_of_basepairs,
+                                      char* const destination) const
+{
+    const cga_string_view_t sequence = get_sequence_view_by_id(sequence_id);
+    assert(static_cast<std::size_t>(first_basepair) + number_of_basepairs <= sequence.size());
+    std::copy_n(sequence.data() + first_basepair, number_of_basepairs, destination);
+}
+
+const PackedSequenceStore* FastaParser::get_packed_sequences() const
+{
+    return nullptr;
+}
+
+void FastaParser::prefetch_sequences(const read_id_t,
+                                     const number_of_reads_t) const
+{
+}
+
+void FastaParser::prefetch_sequences_by_ids(const std::vector<read_id_t>& sequence_ids) const
+{
+    std::vector<read_id_t> sorted_ids(sequence_ids);
+    std::sort(std::begin(sorted_ids), std::end(sorted_ids));
+    sorted_ids.erase(std::unique(std::begin(sorted_ids), std::end(sorted_ids)), std::end(sorted_ids));
+
+    for (std::size_t run_begin = 0; run_begin < sorted_ids.size();)
+    {
+        std::size_t run_end = run_begin + 1;
+        while (run_end < sorted_ids.size() && sorted_ids[run_end] == sorted_ids[run_end - 1] + 1)
+        {
+            ++run_end;
+        }
+        prefetch_sequences(sorted_ids[run_begin], run_end - run_begin);
+        run_begin = run_end;
+    }
+}
+
+read_id_t FastaParser::get_sequence_id_by_name(const cga_string_view_t name) const
+{
+    std::call_once(read_name_index_flag_, [this]() {
+        read_name_index_ = std::make_unique<ReadNameIndex>(*this);
+    });
+
+    read_id_t sequence_id = 0;
+    if (!read_name_index_->find(name, sequence_id))
+    {
+        throw std::out_of_range("Error: no sequence named " + std::string(name.data(), name.size()) + " !");
+    }
+    return sequence_id;
+}
+
+InputFileFormat detect_input_file_format(const std::string& file)
+{
+    std::ifstream stream(file, std::ios::binary);
+    if (!stream)
+    {
+        throw std::invalid_argument("Error: cannot open " + file + " !");
+    }
+
+    // BGZF blocks are at most 64kB, the whole first block is needed to recognize it
+    std::vector<char> first_bytes(1 << 16);
+    stream.read(first_bytes.data(), first_bytes.size());
+    const std::size_t size = stream.gcount();
+    if (size >= 2 && first_bytes[0] == '\x1f' && first_bytes[1] == '\x8b')
+    {
+        return is_bgzf(first_bytes.data(), size) ? InputFileFormat::bgzip : InputFileFormat::gzip;
+    }
+    if (size >= sizeof(read_store::magic) && std::equal(std::begin(read_store::magic), std::end(read_store::magic), first_bytes.data()))
+    {
+        return InputFileFormat::read_store;
+    }
+    return InputFileFormat::uncompressed;
+}
+
 std::unique_ptr<FastaParser> create_kseq_fasta_parser(const std::string& fasta_file,
                                                       const number_of_basepairs_t min_sequence_length,
                                                       const bool shuffle)
@@ -32,6 +145,103 @@ std::unique_ptr<FastaParser> create_kseq_fasta_parser(const std::string& fasta_f
                                                shuffle);
 }
 
+std::unique_ptr<FastaParser> create_mmap_fasta_parser(const std::string& fasta_file,
+                                                      const number_of_basepairs_t min_sequence_length,
+                                                      const bool shuffle)
+{
+    return std::make_unique<FastaParserMmap>(fasta_file,
+                                             min_sequence_length,
+                                             shuffle);
+}
+
+std::unique_ptr<FastaParser> create_packed_fasta_parser(const std::string& fasta_file,
+                                                        const number_of_basepairs_t min_sequence_length,
+                                                        const bool shuffle)
+{
+    return std::make_unique<FastaParserPacked>(fasta_file,
+                                               min_sequence_length,
+                                               shuffle);
+}
+
+std::unique_ptr<FastaParser> create_parallel_fasta_parser(const std::string& fasta_file,
+                                                          const number_of_basepairs_t min_sequence_length,
+                                                          const bool shuffle,
+                                                          const std::int32_t number_of_threads)
+{
+    return std::make_unique<FastaParserParallel>(fasta_file,
+                                                 min_sequence_length,
+                                                 shuffle,
+                                                 number_of_threads);
+}
+
+std::unique_ptr<FastaParser> create_windowed_fasta_parser(const std::string& fasta_file,
+                                                          const number_of_basepairs_t min_sequence_length,
+                                                          const bool shuffle,
+                                                          const std::size_t max_resident_basepairs)
+{
+    return std::make_unique<FastaParserWindowed>(fasta_file,
+                                                 min_sequence_length,
+                                                 shuffle,
+                                                 max_resident_basepairs);
+}
+
+std::unique_ptr<FastaParser> create_read_store_parser(const std::string& read_store_file,
+                                                      const number_of_basepairs_t min_sequence_length,
+                                                      const bool shuffle)
+{
+    return std::make_unique<FastaParserReadStore>(read_store_file,
+                                                  min_sequence_length,
+                                                  shuffle);
+}
+
+std::unique_ptr<FastaParser> create_ordered_fasta_parser(std::unique_ptr<FastaParser> parser,
+                                                         const ReadOrdering ordering)
+{
+    return std::make_unique<FastaParserOrdered>(std::move(parser),
+                                                ordering);
+}
+
+std::unique_ptr<FastaParser> create_multi_file_fasta_parser(const std::vector<std::string>& fasta_files,
+                                                            const std::function<std::unique_ptr<FastaParser>(const std::string&)>& create_file_parser,
+                                                            const std::int32_t number_of_threads)
+{
+    return std::make_unique<FastaParserMultiFile>(fasta_files,
+                                                  create_file_parser,
+                                                  number_of_threads);
+}
+
+std::vector<std::string> read_file_of_filenames(const std::string& file_of_filenames)
+{
+    std::ifstream file(file_of_filenames);
+    if (!file)
+    {
+        throw std::invalid_argument("Error: cannot open " + file_of_filenames + " !");
+    }
+
+    const std::string::size_type last_slash = file_of_filenames.find_last_of('/');
+    const std::string directory             = (last_slash == std::string::npos) ? "" : file_of_filenames.substr(0, last_slash + 1);
+
+    std::vector<std::string> filenames;
+    std::string line;
+    while (std::getline(file, line))
+    {
+        // trim whitespace, including '\r' of files with Windows line endings
+        const std::string::size_type first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos || line[first] == '#')
+        {
+            continue;
+        }
+        const std::string filename = line.substr(first, line.find_last_not_of(" \t\r") - first + 1);
+        filenames.push_back(filename[0] == '/' ? filename : directory + filename);
+    }
+
+    if (filenames.empty())
+    {
+        throw std::invalid_argument("Error: no files listed in " + file_of_filenames + " !");
+    }
+    return filenames;
+}
+
 } // namespace io
 
 } // namespace genomeworks
@@ -35,8 +35,6 @@ FastaParserKseqpp::FastaParserKseqpp(const std::string& fasta_file,
     klibpp::KSeq record;
     klibpp::SeqStreamIn iss(fasta_file.data());
 
-    std::vector<FastaSequence> seqs;
-
     iss >> record;
     if (iss.fail())
     {
@@ -47,11 +45,13 @@ FastaParserKseqpp::FastaParserKseqpp(const std::string& fasta_file,
 
     do
     {
-        FastaSequence seq                     = {record.name, record.seq};
         number_of_basepairs_t sequence_length = get_size<number_of_basepairs_t>(record.seq);
         if (sequence_length >= min_sequencece_length)
         {
-            reads_.push_back(std::move(seq));
+            reads_.add_read(record.name.data(),
+                            get_size<std::uint32_t>(record.name),
+                            record.seq.data(),
+                            sequence_length);
         }
     } while (iss >> record);
 
@@ -59,18 +59,45 @@ FastaParserKseqpp::FastaParserKseqpp(const std::string& fasta_file,
     if (shuffle)
     {
         std::mt19937 g(0); // seed for deterministic behaviour
-        std::shuffle(reads_.begin(), reads_.end(), g);
+        reads_.shuffle(g);
     }
+
+    reads_.shrink_to_fit();
 }
 
 number_of_reads_t FastaParserKseqpp::get_num_seqences() const
 {
-    return reads_.size();
+    return reads_.number_of_reads();
 }
 
 const FastaSequence& FastaParserKseqpp::get_sequence_by_id(const read_id_t sequence_id) const
 {
-    return reads_[sequence_id];
+    if (sequence_id >= get_num_seqences())
+    {
+        throw std::out_of_range("Error: sequence_id " + std::to_string(sequence_id) + " is out of range !");
+    }
+
+    return materialized_sequences_.get_or_create(sequence_id, [this, sequence_id]() {
+        const cga_string_view_t name = reads_.name(sequence_id);
+        const cga_string_view_t seq  = reads_.basepairs(sequence_id);
+        return FastaSequence{std::string(name.data(), name.size()),
+                             std::string(seq.data(), seq.size())};
+    });
+}
+
+number_of_basepairs_t FastaParserKseqpp::get_sequence_length_by_id(const read_id_t sequence_id) const
+{
+    return reads_.number_of_basepairs(sequence_id);
+}
+
+cga_string_view_t FastaParserKseqpp::get_name_view_by_id(const read_id_t sequence_id) const
+{
+    return reads_.name(sequence_id);
+}
+
+cga_string_view_t FastaParserKseqpp::get_sequence_view_by_id(const read_id_t sequence_id) const
+{
+    return reads_.basepairs(sequence_id);
 }
 
 } // namespace io
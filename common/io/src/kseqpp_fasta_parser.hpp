@@ -11,8 +11,10 @@
 
 #include "claragenomics/io/fasta_parser.hpp"
 
+#include "per_read_cache.hpp"
+#include "read_table.hpp"
+
 #include <string>
-#include <vector>
 
 namespace claraparabricks
 {
@@ -39,15 +41,35 @@ public:
     number_of_reads_t get_num_seqences() const override;
 
     /// \brief Fetch an entry from the FASTA file by index position in file.
+    /// The entry is copied out of the read table on first access and kept for the lifetime of the parser,
+    /// use get_name_view_by_id() and get_sequence_view_by_id() to avoid the copy.
     /// \param sequence_id Position of sequence in file. If sequence_id is invalid an error is thrown.
     /// \return A reference to FastaSequence describing the entry.
     const FastaSequence& get_sequence_by_id(read_id_t sequence_id) const override;
 
+    /// \brief Return the number of basepairs of an entry.
+    /// \param sequence_id Position of sequence in file.
+    /// \return Number of basepairs in the entry.
+    number_of_basepairs_t get_sequence_length_by_id(read_id_t sequence_id) const override;
+
+    /// \brief Fetch the name of an entry without copying it.
+    /// \param sequence_id Position of sequence in file.
+    /// \return A view of the name, valid for the lifetime of the parser.
+    cga_string_view_t get_name_view_by_id(read_id_t sequence_id) const override;
+
+    /// \brief Fetch the basepairs of an entry without copying them.
+    /// \param sequence_id Position of sequence in file.
+    /// \return A view of the basepairs, valid for the lifetime of the parser.
+    cga_string_view_t get_sequence_view_by_id(read_id_t sequence_id) const override;
+
 private:
     /// All the reads from the FASTA file are stored in host RAM
     /// given a sufficiently-large FASTA file, there may not be enough host RAM
     /// on the system
-    std::vector<FastaSequence> reads_;
+    ReadTable reads_;
+
+    /// entries requested through get_sequence_by_id()
+    PerReadCache<FastaSequence> materialized_sequences_;
 };
 
 } // namespace io
@@ -0,0 +1,129 @@
+/*
+* Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#include "claragenomics/io/memory_mapped_file.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace claraparabricks
+{
+
+namespace genomeworks
+{
+
+namespace io
+{
+
+MemoryMappedFile::MemoryMappedFile(const std::string& file_path)
+    : file_path_(file_path)
+    , data_(nullptr)
+    , size_(0)
+{
+    const int fd = open(file_path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        throw std::invalid_argument("Error: "
+                                    "cannot open file " +
+                                    file_path + " !");
+    }
+
+    struct stat file_stats;
+    if (fstat(fd, &file_stats) != 0)
+    {
+        const std::string error = std::strerror(errno);
+        close(fd);
+        throw std::runtime_error("Error: cannot stat file " + file_path + ": " + error);
+    }
+
+    size_ = static_cast<std::size_t>(file_stats.st_size);
+
+    // mmap() does not accept zero-length mappings, empty files are represented by nullptr
+    if (size_ > 0)
+    {
+        void* mapping = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (MAP_FAILED == mapping)
+        {
+            const std::string error = std::strerror(errno);
+            close(fd);
+            throw std::runtime_error("Error: cannot map file " + file_path + ": " + error);
+        }
+        data_ = static_cast<const char*>(mapping);
+    }
+
+    // the mapping keeps its own reference to the file
+    close(fd);
+}
+
+MemoryMappedFile::~MemoryMappedFile()
+{
+    unmap();
+}
+
+MemoryMappedFile::MemoryMappedFile(MemoryMappedFile&& rhs) noexcept
+    : file_path_(std::move(rhs.file_path_))
+    , data_(rhs.data_)
+    , size_(rhs.size_)
+{
+    rhs.data_ = nullptr;
+    rhs.size_ = 0;
+}
+
+MemoryMappedFile& MemoryMappedFile::operator=(MemoryMappedFile&& rhs) noexcept
+{
+    if (this != &rhs)
+    {
+        unmap();
+        file_path_ = std::move(rhs.file_path_);
+        data_      = rhs.data_;
+        size_      = rhs.size_;
+        rhs.data_  = nullptr;
+        rhs.size_  = 0;
+    }
+    return *this;
+}
+
+const char* MemoryMappedFile::data() const
+{
+    return data_;
+}
+
+std::size_t MemoryMappedFile::size() const
+{
+    return size_;
+}
+
+const std::string& MemoryMappedFile::path() const
+{
+    return file_path_;
+}
+
+void MemoryMappedFile::unmap()
+{
+    if (nullptr != data_)
+    {
+        munmap(const_cast<char*>(data_), size_);
+        data_ = nullptr;
+        size_ = 0;
+    }
+}
+
+} // namespace io
+
+} // namespace genomeworks
+
+} // namespace claraparabricks
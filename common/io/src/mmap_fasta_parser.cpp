@@ -0,0 +1,181 @@
+/*
+* Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#include "mmap_fasta_parser.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <random>
+#include <stdexcept>
+
+namespace claraparabricks
+{
+
+namespace genomeworks
+{
+
+namespace io
+{
+
+FastaParserMmap::FastaParserMmap(const std::string& fasta_file,
+                                 const number_of_basepairs_t min_sequence_length,
+                                 const bool shuffle)
+    : fasta_file_(fasta_file)
+{
+    if (0 == fasta_file_.size())
+    {
+        throw std::invalid_argument("Error: "
+                                    "non-existent or empty file " +
+                                    fasta_file + " !");
+    }
+
+    if (fasta_file_.size() >= 2 && fasta_file_.data()[0] == '\x1f' && fasta_file_.data()[1] == '\x8b')
+    {
+        throw std::invalid_argument("Error: " + fasta_file + " is compressed, use create_kseq_fasta_parser() for compressed files !");
+    }
+
+    index_ = FastaIndex::load_or_build(fasta_file_, fasta_file + ".fai");
+
+    read_id_to_entry_.reserve(index_.number_of_entries());
+    for (read_id_t entry_id = 0; entry_id < index_.number_of_entries(); ++entry_id)
+    {
+        const FastaIndex::Entry& e = index_.entry(entry_id);
+        if (e.offset + e.length > fasta_file_.size())
+        {
+            throw std::invalid_argument("Error: FASTA index " + fasta_file + ".fai does not match " + fasta_file + " !");
+        }
+        if (e.length >= min_sequence_length)
+        {
+            read_id_to_entry_.push_back(entry_id);
+        }
+    }
+
+    // Same shuffle as FastaParserKseqpp, so both parsers assign the same read_ids
+    if (shuffle)
+    {
+        std::mt19937 g(0); // seed for deterministic behaviour
+        std::shuffle(read_id_to_entry_.begin(), read_id_to_entry_.end(), g);
+    }
+}
+
+number_of_reads_t FastaParserMmap::get_num_seqences() const
+{
+    return read_id_to_entry_.size();
+}
+
+const FastaSequence& FastaParserMmap::get_sequence_by_id(const read_id_t sequence_id) const
+{
+    return materialized_sequences_.get_or_create(sequence_id, [this, sequence_id]() {
+        const cga_string_view_t name = get_name_view_by_id(sequence_id);
+        const cga_string_view_t seq  = get_sequence_view_by_id(sequence_id);
+        return FastaSequence{std::string(name.data(), name.size()),
+                             std::string(seq.data(), seq.size())};
+    });
+}
+
+number_of_basepairs_t FastaParserMmap::get_sequence_length_by_id(const read_id_t sequence_id) const
+{
+    return entry(sequence_id).length;
+}
+
+cga_string_view_t FastaParserMmap::get_name_view_by_id(const read_id_t sequence_id) const
+{
+    return index_.name(read_id_to_entry_.at(sequence_id));
+}
+
+cga_string_view_t FastaParserMmap::get_sequence_view_by_id(const read_id_t sequence_id) const
+{
+    const FastaIndex::Entry& e = entry(sequence_id);
+    const char* const first_bp = fasta_file_.data() + e.offset;
+
+    // the whole sequence is on one line, no need to copy it
+    if (e.length <= e.line_bases)
+    {
+        return cga_string_view_t(first_bp, e.length);
+    }
+
+    const char* const file_end = fasta_file_.data() + fasta_file_.size();
+
+    const std::string& joined_sequence = joined_sequences_.get_or_create(sequence_id, [this, &e, first_bp, file_end]() {
+        std::string sequence;
+        sequence.reserve(e.length);
+        for (const char* c = first_bp; c < file_end && sequence.size() < e.length; ++c)
+        {
+            if (*c != '\n' && *c != '\r')
+            {
+                sequence.push_back(*c);
+            }
+        }
+        if (sequence.size() != e.length)
+        {
+            throw std::invalid_argument("Error: FASTA index " + fasta_file_.path() + ".fai does not match " + fasta_file_.path() + " !");
+        }
+        return sequence;
+    });
+
+    return joined_sequence;
+}
+
+void FastaParserMmap::copy_sequence_by_id(const read_id_t sequence_id,
+                                          const position_in_read_t first_basepair,
+                                          const number_of_basepairs_t number_of_basepairs,
+                                          char* const destination) const
+{
+    const FastaIndex::Entry& e = entry(sequence_id);
+    assert(static_cast<std::size_t>(first_basepair) + number_of_basepairs <= e.length);
+
+    // jump to the line containing first_basepair instead of going through the lines before it
+    const std::size_t lines_before = (e.line_bases > 0) ? first_basepair / e.line_bases : 0;
+    const char* basepair           = fasta_file_.data() + e.offset + lines_before * e.line_width + (first_basepair - lines_before * e.line_bases);
+    const char* const file_end     = fasta_file_.data() + fasta_file_.size();
+
+    number_of_basepairs_t copied_basepairs = 0;
+    while (basepair < file_end && copied_basepairs < number_of_basepairs)
+    {
+        if (*basepair == '\n' || *basepair == '\r')
+        {
+            ++basepair;
+            continue;
+        }
+        const char* newline  = static_cast<const char*>(std::memchr(basepair, '\n', file_end - basepair));
+        const char* line_end = (nullptr != newline) ? newline : file_end;
+        if (line_end > basepair && *(line_end - 1) == '\r')
+        {
+            --line_end;
+        }
+        const std::size_t to_copy = std::min(static_cast<std::size_t>(line_end - basepair),
+                                             static_cast<std::size_t>(number_of_basepairs - copied_basepairs));
+        std::copy_n(basepair, to_copy, destination + copied_basepairs);
+        copied_basepairs += to_copy;
+        basepair = line_end;
+    }
+
+    if (copied_basepairs != number_of_basepairs)
+    {
+        throw std::invalid_argument("Error: FASTA index " + fasta_file_.path() + ".fai does not match " + fasta_file_.path() + " !");
+    }
+}
+
+std::size_t FastaParserMmap::number_of_joined_sequences() const
+{
+    return joined_sequences_.size();
+}
+
+const FastaIndex::Entry& FastaParserMmap::entry(const read_id_t sequence_id) const
+{
+    return index_.entry(read_id_to_entry_.at(sequence_id));
+}
+
+} // namespace io
+
+} // namespace genomeworks
+
+} // namespace claraparabricks
@@ -0,0 +1,107 @@
+/*
+* Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+#pragma once
+
+#include "claragenomics/io/fasta_parser.hpp"
+#include "claragenomics/io/memory_mapped_file.hpp"
+
+#include "fasta_index.hpp"
+#include "per_read_cache.hpp"
+
+#include <string>
+#include <vector>
+
+namespace claraparabricks
+{
+
+namespace genomeworks
+{
+
+namespace io
+{
+
+/// FastaParserMmap - FASTA parser which serves sequences directly from a memory-mapped file
+///
+/// Only the .fai index is kept in host memory. Basepairs stay in the mapping and are paged in by the OS on demand.
+class FastaParserMmap : public FastaParser
+{
+public:
+    /// \brief Constructor
+    /// \param fasta_file Path to uncompressed FASTA file. Index is read from or written to <fasta_file>.fai
+    /// \param min_sequence_length Minimum length a sequence needs to be to be parsed. Shorter sequences are ignored.
+    /// \param shuffle Enables shuffling reads
+    FastaParserMmap(const std::string& fasta_file,
+                    number_of_basepairs_t min_sequence_length,
+                    bool shuffle);
+
+    /// \brief Return number of sequences in FASTA file
+    /// \return Sequence count in file
+    number_of_reads_t get_num_seqences() const override;
+
+    /// \brief Fetch an entry from the FASTA file by index position in file.
+    /// The entry is copied out of the mapping on first access and kept for the lifetime of the parser,
+    /// use get_name_view_by_id() and get_sequence_view_by_id() to avoid the copy.
+    /// \param sequence_id Position of sequence in file. If sequence_id is invalid an error is thrown.
+    /// \return A reference to FastaSequence describing the entry.
+    const FastaSequence& get_sequence_by_id(read_id_t sequence_id) const override;
+
+    /// \brief Return the number of basepairs of an entry.
+    /// \param sequence_id Position of sequence in file.
+    /// \return Number of basepairs in the entry.
+    number_of_basepairs_t get_sequence_length_by_id(read_id_t sequence_id) const override;
+
+    /// \brief Fetch the name of an entry without copying it.
+    /// \param sequence_id Position of sequence in file.
+    /// \return A view of the name, valid for the lifetime of the parser.
+    cga_string_view_t get_name_view_by_id(read_id_t sequence_id) const override;
+
+    /// \brief Fetch the basepairs of an entry without copying them.
+    /// Sequences written on one line are viewed directly in the mapping, other sequences have their line breaks removed on first access.
+    /// \param sequence_id Position of sequence in file.
+    /// \return A view of the basepairs, valid for the lifetime of the parser.
+    cga_string_view_t get_sequence_view_by_id(read_id_t sequence_id) const override;
+
+    /// \brief Copy a section of the basepairs of an entry into a buffer owned by the caller.
+    /// Basepairs are copied straight from the mapping, line breaks are skipped and nothing is kept after the call.
+    /// As in any .fai index, all lines of an entry but the last one are expected to hold the same number of basepairs.
+    /// \param sequence_id Position of sequence in file.
+    /// \param first_basepair First basepair to copy.
+    /// \param number_of_basepairs Number of basepairs to copy, section must not go past the end of the entry.
+    /// \param destination Buffer with space for at least number_of_basepairs characters. No null-terminator is written.
+    void copy_sequence_by_id(read_id_t sequence_id,
+                             position_in_read_t first_basepair,
+                             number_of_basepairs_t number_of_basepairs,
+                             char* destination) const override;
+
+    /// \brief Return the number of multi-line sequences kept with their line breaks removed.
+    /// Only get_sequence_view_by_id() and get_sequence_by_id() add sequences.
+    /// \return Number of joined sequences.
+    std::size_t number_of_joined_sequences() const;
+
+private:
+    /// \brief returns the index entry of a read
+    const FastaIndex::Entry& entry(read_id_t sequence_id) const;
+
+    MemoryMappedFile fasta_file_;
+    FastaIndex index_;
+    /// for each read_id the corresponding entry in index_, after filtering and shuffling
+    std::vector<read_id_t> read_id_to_entry_;
+
+    /// sequences spanning multiple lines, with line breaks removed
+    PerReadCache<std::string> joined_sequences_;
+    /// entries requested through get_sequence_by_id()
+    PerReadCache<FastaSequence> materialized_sequences_;
+};
+
+} // namespace io
+
+} // namespace genomeworks
+
+} // namespace claraparabricks
@@ -0,0 +1,162 @@
+/*
+* Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#include "multi_file_fasta_parser.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+
+#include <claragenomics/utils/run_in_parallel.hpp>
+
+namespace claraparabricks
+{
+
+namespace genomeworks
+{
+
+namespace io
+{
+
+FastaParserMultiFile::FastaParserMultiFile(const std::vector<std::string>& fasta_files,
+                                           const std::function<std::unique_ptr<FastaParser>(const std::string&)>& create_file_parser,
+                                           std::int32_t number_of_threads)
+    : parsers_(fasta_files.size())
+{
+    if (fasta_files.empty())
+    {
+        throw std::invalid_argument("Error: no input files !");
+    }
+
+    number_of_threads = get_number_of_host_threads(number_of_threads);
+
+    run_in_parallel(number_of_threads,
+                    fasta_files.size(),
+                    [&](const std::size_t file_id) {
+                        parsers_[file_id] = create_file_parser(fasta_files[file_id]);
+                    });
+
+    std::uint64_t number_of_reads = 0;
+    first_read_id_.reserve(parsers_.size() + 1);
+    for (std::size_t file_id = 0; file_id < parsers_.size(); ++file_id)
+    {
+        first_read_id_.push_back(static_cast<read_id_t>(number_of_reads));
+        number_of_reads += parsers_[file_id]->get_num_seqences();
+        if (number_of_reads > std::numeric_limits<number_of_reads_t>::max())
+        {
+            throw std::invalid_argument("Error: too many reads in " + fasta_files[file_id] + " and the files before it !");
+        }
+    }
+    first_read_id_.push_back(static_cast<read_id_t>(number_of_reads));
+}
+
+number_of_reads_t FastaParserMultiFile::get_num_seqences() const
+{
+    return first_read_id_.back();
+}
+
+const FastaSequence& FastaParserMultiFile::get_sequence_by_id(const read_id_t sequence_id) const
+{
+    if (sequence_id >= get_num_seqences())
+    {
+        throw std::out_of_range("Error: sequence_id " + std::to_string(sequence_id) + " is out of range !");
+    }
+
+    const std::size_t id = file_id(sequence_id);
+    return parsers_[id]->get_sequence_by_id(sequence_id - first_read_id_[id]);
+}
+
+number_of_basepairs_t FastaParserMultiFile::get_sequence_length_by_id(const read_id_t sequence_id) const
+{
+    const std::size_t id = file_id(sequence_id);
+    return parsers_[id]->get_sequence_length_by_id(sequence_id - first_read_id_[id]);
+}
+
+cga_string_view_t FastaParserMultiFile::get_name_view_by_id(const read_id_t sequence_id) const
+{
+    const std::size_t id = file_id(sequence_id);
+    return parsers_[id]->get_name_view_by_id(sequence_id - first_read_id_[id]);
+}
+
+cga_string_view_t FastaParserMultiFile::get_sequence_view_by_id(const read_id_t sequence_id) const
+{
+    const std::size_t id = file_id(sequence_id);
+    return parsers_[id]->get_sequence_view_by_id(sequence_id - first_read_id_[id]);
+}
+
+void FastaParserMultiFile::copy_sequence_by_id(const read_id_t sequence_id,
+                                               const position_in_read_t first_basepair,
+                                               const number_of_basepairs_t number_of_basepairs,
+                                               char* const destination) const
+{
+    const std::size_t id = file_id(sequence_id);
+    parsers_[id]->copy_sequence_by_id(sequence_id - first_read_id_[id], first_basepair, number_of_basepairs, destination);
+}
+
+void FastaParserMultiFile::prefetch_sequences(const read_id_t first_sequence_id,
+                                              const number_of_reads_t number_of_sequences) const
+{
+    if (static_cast<std::size_t>(first_sequence_id) + number_of_sequences > get_num_seqences())
+    {
+        throw std::out_of_range("Error: sequence range " + std::to_string(first_sequence_id) + " + " + std::to_string(number_of_sequences) + " is out of range !");
+    }
+
+    if (0 == number_of_sequences)
+    {
+        return;
+    }
+
+    const read_id_t range_end = first_sequence_id + number_of_sequences;
+    for (std::size_t id = file_id(first_sequence_id); id < parsers_.size() && first_read_id_[id] < range_end; ++id)
+    {
+        const read_id_t file_range_begin = std::max(first_sequence_id, first_read_id_[id]);
+        const read_id_t file_range_end   = std::min(range_end, first_read_id_[id + 1]);
+        parsers_[id]->prefetch_sequences(file_range_begin - first_read_id_[id], file_range_end - file_range_begin);
+    }
+}
+
+void FastaParserMultiFile::prefetch_sequences_by_ids(const std::vector<read_id_t>& sequence_ids) const
+{
+    std::vector<read_id_t> sorted_ids(sequence_ids);
+    std::sort(std::begin(sorted_ids), std::end(sorted_ids));
+    if (!sorted_ids.empty() && sorted_ids.back() >= get_num_seqences())
+    {
+        throw std::out_of_range("Error: sequence_id " + std::to_string(sorted_ids.back()) + " is out of range !");
+    }
+
+    // sorted ids of one file are consecutive
+    std::vector<read_id_t> file_ids;
+    for (auto file_begin = std::begin(sorted_ids); file_begin != std::end(sorted_ids);)
+    {
+        const std::size_t id  = file_id(*file_begin);
+        const auto file_end   = std::lower_bound(file_begin, std::end(sorted_ids), first_read_id_[id + 1]);
+        file_ids.clear();
+        std::transform(file_begin, file_end, std::back_inserter(file_ids), [this, id](const read_id_t read_id) {
+            return read_id - first_read_id_[id];
+        });
+        parsers_[id]->prefetch_sequences_by_ids(file_ids);
+        file_begin = file_end;
+    }
+}
+
+std::size_t FastaParserMultiFile::file_id(const read_id_t sequence_id) const
+{
+    // last file whose first read_id is not larger than sequence_id, files without reads are skipped that way
+    return std::distance(std::begin(first_read_id_),
+                         std::upper_bound(std::begin(first_read_id_), std::end(first_read_id_) - 1, sequence_id)) -
+           1;
+}
+
+} // namespace io
+
+} // namespace genomeworks
+
+} // namespace claraparabricks
@@ -0,0 +1,102 @@
+/*
+* Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+#pragma once
+
+#include "claragenomics/io/fasta_parser.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace claraparabricks
+{
+
+namespace genomeworks
+{
+
+namespace io
+{
+
+/// FastaParserMultiFile - parser which presents the reads of several files as one file
+///
+/// Files are parsed concurrently by parsers of another type. Reads of the first file get the lowest read_ids, followed
+/// by the reads of the second file and so on. All calls are forwarded to the parser of the file the read is in.
+class FastaParserMultiFile : public FastaParser
+{
+public:
+    /// \brief Constructor
+    /// \param fasta_files Paths to the files, in the order their reads get read_ids
+    /// \param create_file_parser Function which creates the parser for one file, called concurrently for different files
+    /// \param number_of_threads Number of files to parse concurrently, 0 to use one thread per hardware thread
+    FastaParserMultiFile(const std::vector<std::string>& fasta_files,
+                         const std::function<std::unique_ptr<FastaParser>(const std::string&)>& create_file_parser,
+                         std::int32_t number_of_threads);
+
+    /// \brief Return number of sequences in all files
+    /// \return Sequence count in all files
+    number_of_reads_t get_num_seqences() const override;
+
+    /// \brief Fetch an entry by its read_id.
+    /// \param sequence_id Position of sequence in all files. If sequence_id is invalid an error is thrown.
+    /// \return A reference to FastaSequence describing the entry.
+    const FastaSequence& get_sequence_by_id(read_id_t sequence_id) const override;
+
+    /// \brief Return the number of basepairs of an entry.
+    /// \param sequence_id Position of sequence in all files.
+    /// \return Number of basepairs in the entry.
+    number_of_basepairs_t get_sequence_length_by_id(read_id_t sequence_id) const override;
+
+    /// \brief Fetch the name of an entry without copying it.
+    /// \param sequence_id Position of sequence in all files.
+    /// \return A view of the name, valid as long as views of the parser of the file are.
+    cga_string_view_t get_name_view_by_id(read_id_t sequence_id) const override;
+
+    /// \brief Fetch the basepairs of an entry without copying them.
+    /// \param sequence_id Position of sequence in all files.
+    /// \return A view of the basepairs, valid as long as views of the parser of the file are.
+    cga_string_view_t get_sequence_view_by_id(read_id_t sequence_id) const override;
+
+    /// \brief Copy a section of the basepairs of an entry into a buffer owned by the caller.
+    /// \param sequence_id Position of sequence in all files.
+    /// \param first_basepair First basepair to copy.
+    /// \param number_of_basepairs Number of basepairs to copy, section must not go past the end of the entry.
+    /// \param destination Buffer with space for at least number_of_basepairs characters. No null-terminator is written.
+    void copy_sequence_by_id(read_id_t sequence_id,
+                             position_in_read_t first_basepair,
+                             number_of_basepairs_t number_of_basepairs,
+                             char* destination) const override;
+
+    /// \brief Forwards the hint to the parsers of all files the range overlaps.
+    /// \param first_sequence_id First entry in the range.
+    /// \param number_of_sequences Number of entries in the range.
+    void prefetch_sequences(read_id_t first_sequence_id,
+                            number_of_reads_t number_of_sequences) const override;
+
+    /// \brief Forwards the hint to the parsers of all files the set has entries in, each as one set.
+    /// \param sequence_ids Entries in the set, in any order.
+    void prefetch_sequences_by_ids(const std::vector<read_id_t>& sequence_ids) const override;
+
+private:
+    /// \brief returns the id of the file the read is in
+    std::size_t file_id(read_id_t sequence_id) const;
+
+    /// parser of each file
+    std::vector<std::unique_ptr<FastaParser>> parsers_;
+    /// read_id of the first read of each file, followed by the total number of reads
+    std::vector<read_id_t> first_read_id_;
+};
+
+} // namespace io
+
+} // namespace genomeworks
+
+} // namespace claraparabricks
@@ -0,0 +1,111 @@
+/*
+* Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#include "ordered_fasta_parser.hpp"
+
+#include "read_ordering.hpp"
+
+#include <iterator>
+#include <stdexcept>
+#include <string>
+
+namespace claraparabricks
+{
+
+namespace genomeworks
+{
+
+namespace io
+{
+
+FastaParserOrdered::FastaParserOrdered(std::unique_ptr<FastaParser> parser,
+                                       const ReadOrdering ordering)
+    : parser_(std::move(parser))
+{
+    std::vector<number_of_basepairs_t> read_lengths(parser_->get_num_seqences());
+    for (read_id_t read_id = 0; read_id < read_lengths.size(); ++read_id)
+    {
+        read_lengths[read_id] = parser_->get_sequence_length_by_id(read_id);
+    }
+    new_to_old_id_ = compute_read_order(read_lengths, ordering);
+}
+
+number_of_reads_t FastaParserOrdered::get_num_seqences() const
+{
+    return parser_->get_num_seqences();
+}
+
+const FastaSequence& FastaParserOrdered::get_sequence_by_id(const read_id_t sequence_id) const
+{
+    if (sequence_id >= get_num_seqences())
+    {
+        throw std::out_of_range("Error: sequence_id " + std::to_string(sequence_id) + " is out of range !");
+    }
+
+    return parser_->get_sequence_by_id(new_to_old_id_[sequence_id]);
+}
+
+number_of_basepairs_t FastaParserOrdered::get_sequence_length_by_id(const read_id_t sequence_id) const
+{
+    return parser_->get_sequence_length_by_id(new_to_old_id_[sequence_id]);
+}
+
+cga_string_view_t FastaParserOrdered::get_name_view_by_id(const read_id_t sequence_id) const
+{
+    return parser_->get_name_view_by_id(new_to_old_id_[sequence_id]);
+}
+
+cga_string_view_t FastaParserOrdered::get_sequence_view_by_id(const read_id_t sequence_id) const
+{
+    return parser_->get_sequence_view_by_id(new_to_old_id_[sequence_id]);
+}
+
+void FastaParserOrdered::copy_sequence_by_id(const read_id_t sequence_id,
+                                             const position_in_read_t first_basepair,
+                                             const number_of_basepairs_t number_of_basepairs,
+                                             char* const destination) const
+{
+    parser_->copy_sequence_by_id(new_to_old_id_[sequence_id], first_basepair, number_of_basepairs, destination);
+}
+
+void FastaParserOrdered::prefetch_sequences(const read_id_t first_sequence_id,
+                                            const number_of_reads_t number_of_sequences) const
+{
+    if (static_cast<std::size_t>(first_sequence_id) + number_of_sequences > get_num_seqences())
+    {
+        throw std::out_of_range("Error: sequence range " + std::to_string(first_sequence_id) + " + " + std::to_string(number_of_sequences) + " is out of range !");
+    }
+
+    // reordered reads are scattered over the wrapped parser, which is given all of them at once so that it can load them together
+    std::vector<read_id_t> old_ids(std::next(std::begin(new_to_old_id_), first_sequence_id),
+                                   std::next(std::begin(new_to_old_id_), first_sequence_id + number_of_sequences));
+    parser_->prefetch_sequences_by_ids(old_ids);
+}
+
+void FastaParserOrdered::prefetch_sequences_by_ids(const std::vector<read_id_t>& sequence_ids) const
+{
+    std::vector<read_id_t> old_ids;
+    old_ids.reserve(sequence_ids.size());
+    for (const read_id_t read_id : sequence_ids)
+    {
+        if (read_id >= get_num_seqences())
+        {
+            throw std::out_of_range("Error: sequence_id " + std::to_string(read_id) + " is out of range !");
+        }
+        old_ids.push_back(new_to_old_id_[read_id]);
+    }
+    parser_->prefetch_sequences_by_ids(old_ids);
+}
+
+} // namespace io
+
+} // namespace genomeworks
+
+} // namespace claraparabricks
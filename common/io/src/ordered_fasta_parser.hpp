@@ -0,0 +1,92 @@
+/*
+* Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+#pragma once
+
+#include "claragenomics/io/fasta_parser.hpp"
+
+#include <memory>
+#include <vector>
+
+namespace claraparabricks
+{
+
+namespace genomeworks
+{
+
+namespace io
+{
+
+/// FastaParserOrdered - parser which assigns new read_ids to the reads of another parser
+///
+/// All calls are forwarded to the wrapped parser with read_ids translated.
+class FastaParserOrdered : public FastaParser
+{
+public:
+    /// \brief Constructor
+    /// \param parser Parser whose reads get reordered
+    /// \param ordering Strategy for assigning new read_ids
+    FastaParserOrdered(std::unique_ptr<FastaParser> parser,
+                       ReadOrdering ordering);
+
+    /// \brief Return number of sequences in FASTA file
+    /// \return Sequence count in file
+    number_of_reads_t get_num_seqences() const override;
+
+    /// \brief Fetch an entry from the FASTA file by index position in file.
+    /// \param sequence_id Position of sequence in file. If sequence_id is invalid an error is thrown.
+    /// \return A reference to FastaSequence describing the entry.
+    const FastaSequence& get_sequence_by_id(read_id_t sequence_id) const override;
+
+    /// \brief Return the number of basepairs of an entry.
+    /// \param sequence_id Position of sequence in file.
+    /// \return Number of basepairs in the entry.
+    number_of_basepairs_t get_sequence_length_by_id(read_id_t sequence_id) const override;
+
+    /// \brief Fetch the name of an entry without copying it.
+    /// \param sequence_id Position of sequence in file.
+    /// \return A view of the name, valid as long as views of the wrapped parser are.
+    cga_string_view_t get_name_view_by_id(read_id_t sequence_id) const override;
+
+    /// \brief Fetch the basepairs of an entry without copying them.
+    /// \param sequence_id Position of sequence in file.
+    /// \return A view of the basepairs, valid as long as views of the wrapped parser are.
+    cga_string_view_t get_sequence_view_by_id(read_id_t sequence_id) const override;
+
+    /// \brief Copy a section of the basepairs of an entry into a buffer owned by the caller.
+    /// \param sequence_id Position of sequence in file.
+    /// \param first_basepair First basepair to copy.
+    /// \param number_of_basepairs Number of basepairs to copy, section must not go past the end of the entry.
+    /// \param destination Buffer with space for at least number_of_basepairs characters. No null-terminator is written.
+    void copy_sequence_by_id(read_id_t sequence_id,
+                             position_in_read_t first_basepair,
+                             number_of_basepairs_t number_of_basepairs,
+                             char* destination) const override;
+
+    /// \brief Forwards the hint to the wrapped parser as one set of read_ids of the wrapped parser.
+    /// \param first_sequence_id First entry in the range.
+    /// \param number_of_sequences Number of entries in the range.
+    void prefetch_sequences(read_id_t first_sequence_id,
+                            number_of_reads_t number_of_sequences) const override;
+
+    /// \brief Forwards the hint to the wrapped parser as one set of read_ids of the wrapped parser.
+    /// \param sequence_ids Entries in the set, in any order.
+    void prefetch_sequences_by_ids(const std::vector<read_id_t>& sequence_ids) const override;
+
+private:
+    std::unique_ptr<FastaParser> parser_;
+    /// for each read_id the read_id in parser_
+    std::vector<read_id_t> new_to_old_id_;
+};
+
+} // namespace io
+
+} // namespace genomeworks
+
+} // namespace claraparabricks
@@ -0,0 +1,140 @@
+/*
+* Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#include "packed_fasta_parser.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include "seqio.h" //TODO add this to 3rdparty
+#include <claragenomics/utils/signed_integer_utils.hpp>
+
+namespace claraparabricks
+{
+
+namespace genomeworks
+{
+
+namespace io
+{
+
+FastaParserPacked::FastaParserPacked(const std::string& fasta_file,
+                                     const number_of_basepairs_t min_sequence_length,
+                                     const bool shuffle)
+    : name_offsets_(1, 0)
+{
+    klibpp::KSeq record;
+    klibpp::SeqStreamIn iss(fasta_file.data());
+
+    iss >> record;
+    if (iss.fail())
+    {
+        throw std::invalid_argument("Error: "
+                                    "non-existent or empty file " +
+                                    fasta_file + " !");
+    }
+
+    do
+    {
+        const number_of_basepairs_t sequence_length = get_size<number_of_basepairs_t>(record.seq);
+        if (sequence_length >= min_sequence_length)
+        {
+            sequences_.add_sequence(record.seq.data(), sequence_length);
+            names_.insert(std::end(names_), std::begin(record.name), std::end(record.name));
+            name_offsets_.push_back(names_.size());
+        }
+    } while (iss >> record);
+
+    // Same shuffle as FastaParserKseqpp, so both parsers assign the same read_ids
+    if (shuffle)
+    {
+        std::vector<read_id_t> new_to_old_id(sequences_.number_of_sequences());
+        std::iota(std::begin(new_to_old_id), std::end(new_to_old_id), 0);
+        std::mt19937 g(0); // seed for deterministic behaviour
+        std::shuffle(new_to_old_id.begin(), new_to_old_id.end(), g);
+
+        sequences_ = sequences_.reordered(new_to_old_id);
+
+        std::vector<char> shuffled_names;
+        shuffled_names.reserve(names_.size());
+        std::vector<std::size_t> shuffled_name_offsets(1, 0);
+        shuffled_name_offsets.reserve(name_offsets_.size());
+        for (const read_id_t old_id : new_to_old_id)
+        {
+            shuffled_names.insert(std::end(shuffled_names),
+                                  std::next(std::begin(names_), name_offsets_[old_id]),
+                                  std::next(std::begin(names_), name_offsets_[old_id + 1]));
+            shuffled_name_offsets.push_back(shuffled_names.size());
+        }
+        names_        = std::move(shuffled_names);
+        name_offsets_ = std::move(shuffled_name_offsets);
+    }
+
+    sequences_.shrink_to_fit();
+    names_.shrink_to_fit();
+    name_offsets_.shrink_to_fit();
+}
+
+number_of_reads_t FastaParserPacked::get_num_seqences() const
+{
+    return sequences_.number_of_sequences();
+}
+
+const FastaSequence& FastaParserPacked::get_sequence_by_id(const read_id_t sequence_id) const
+{
+    if (sequence_id >= get_num_seqences())
+    {
+        throw std::out_of_range("Error: sequence_id " + std::to_string(sequence_id) + " is out of range !");
+    }
+
+    return materialized_sequences_.get_or_create(sequence_id, [this, sequence_id]() {
+        const cga_string_view_t name = get_name_view_by_id(sequence_id);
+        FastaSequence sequence{std::string(name.data(), name.size()),
+                               std::string(sequences_.sequence_length(sequence_id), '\0')};
+        sequences_.decode(sequence_id, 0, sequences_.sequence_length(sequence_id), &sequence.seq[0]);
+        return sequence;
+    });
+}
+
+number_of_basepairs_t FastaParserPacked::get_sequence_length_by_id(const read_id_t sequence_id) const
+{
+    return sequences_.sequence_length(sequence_id);
+}
+
+cga_string_view_t FastaParserPacked::get_name_view_by_id(const read_id_t sequence_id) const
+{
+    return cga_string_view_t(names_.data() + name_offsets_[sequence_id],
+                             name_offsets_[sequence_id + 1] - name_offsets_[sequence_id]);
+}
+
+cga_string_view_t FastaParserPacked::get_sequence_view_by_id(const read_id_t sequence_id) const
+{
+    return get_sequence_by_id(sequence_id).seq;
+}
+
+void FastaParserPacked::copy_sequence_by_id(const read_id_t sequence_id,
+                                            const position_in_read_t first_basepair,
+                                            const number_of_basepairs_t number_of_basepairs,
+                                            char* const destination) const
+{
+    sequences_.decode(sequence_id, first_basepair, number_of_basepairs, destination);
+}
+
+const PackedSequenceStore* FastaParserPacked::get_packed_sequences() const
+{
+    return &sequences_;
+}
+
+} // namespace io
+
+} // namespace genomeworks
+
+} // namespace claraparabricks
@@ -0,0 +1,99 @@
+/*
+* Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+#pragma once
+
+#include "claragenomics/io/fasta_parser.hpp"
+#include "claragenomics/io/packed_sequence_store.hpp"
+
+#include "per_read_cache.hpp"
+
+#include <string>
+#include <vector>
+
+namespace claraparabricks
+{
+
+namespace genomeworks
+{
+
+namespace io
+{
+
+/// FastaParserPacked - FASTA parser which keeps basepairs packed to 2 bits per basepair
+///
+/// Names are kept as plain text, basepairs are decoded on access.
+class FastaParserPacked : public FastaParser
+{
+public:
+    /// \brief Constructor
+    /// \param fasta_file Path to FASTA(.gz) file. If .gz, it must be zipped with bgzip.
+    /// \param min_sequence_length Minimum length a sequence needs to be to be parsed. Shorter sequences are ignored.
+    /// \param shuffle Enables shuffling reads
+    FastaParserPacked(const std::string& fasta_file,
+                      number_of_basepairs_t min_sequence_length,
+                      bool shuffle);
+
+    /// \brief Return number of sequences in FASTA file
+    /// \return Sequence count in file
+    number_of_reads_t get_num_seqences() const override;
+
+    /// \brief Fetch an entry from the FASTA file by index position in file.
+    /// The entry is decoded on first access and kept for the lifetime of the parser, use copy_sequence_by_id() to avoid that.
+    /// \param sequence_id Position of sequence in file. If sequence_id is invalid an error is thrown.
+    /// \return A reference to FastaSequence describing the entry.
+    const FastaSequence& get_sequence_by_id(read_id_t sequence_id) const override;
+
+    /// \brief Return the number of basepairs of an entry.
+    /// \param sequence_id Position of sequence in file.
+    /// \return Number of basepairs in the entry.
+    number_of_basepairs_t get_sequence_length_by_id(read_id_t sequence_id) const override;
+
+    /// \brief Fetch the name of an entry without copying it.
+    /// \param sequence_id Position of sequence in file.
+    /// \return A view of the name, valid for the lifetime of the parser.
+    cga_string_view_t get_name_view_by_id(read_id_t sequence_id) const override;
+
+    /// \brief Fetch the basepairs of an entry.
+    /// The entry is decoded on first access and kept for the lifetime of the parser, use copy_sequence_by_id() to avoid that.
+    /// \param sequence_id Position of sequence in file.
+    /// \return A view of the basepairs, valid for the lifetime of the parser.
+    cga_string_view_t get_sequence_view_by_id(read_id_t sequence_id) const override;
+
+    /// \brief Decode a section of the basepairs of an entry into a buffer owned by the caller.
+    /// \param sequence_id Position of sequence in file.
+    /// \param first_basepair First basepair to copy.
+    /// \param number_of_basepairs Number of basepairs to copy, section must not go past the end of the entry.
+    /// \param destination Buffer with space for at least number_of_basepairs characters. No null-terminator is written.
+    void copy_sequence_by_id(read_id_t sequence_id,
+                             position_in_read_t first_basepair,
+                             number_of_basepairs_t number_of_basepairs,
+                             char* destination) const override;
+
+    /// \brief Return packed basepairs of all entries.
+    /// \return A pointer to the store valid for the lifetime of the parser.
+    const PackedSequenceStore* get_packed_sequences() const override;
+
+private:
+    PackedSequenceStore sequences_;
+
+    /// names of all reads, one after another without separators
+    std::vector<char> names_;
+    /// name of read i is in names_[name_offsets_[i], name_offsets_[i+1])
+    std::vector<std::size_t> name_offsets_;
+
+    /// entries requested through get_sequence_by_id() or get_sequence_view_by_id()
+    PerReadCache<FastaSequence> materialized_sequences_;
+};
+
+} // namespace io
+
+} // namespace genomeworks
+
+} // namespace claraparabricks
@@ -0,0 +1,275 @@
+/*
+* Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#include "claragenomics/io/packed_sequence_store.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <iterator>
+
+namespace claraparabricks
+{
+
+namespace genomeworks
+{
+
+namespace io
+{
+
+namespace
+{
+
+/// code of characters which are not packed
+constexpr std::uint8_t exception_code = 0xFF;
+
+/// \brief returns a table mapping characters to their 2-bit code, or exception_code if they are stored as exceptions
+const std::array<std::uint8_t, 256>& basepair_to_code()
+{
+    static const std::array<std::uint8_t, 256> table = []() {
+        std::array<std::uint8_t, 256> t;
+        t.fill(exception_code);
+        t['A'] = 0b00;
+        t['C'] = 0b01;
+        t['G'] = 0b10;
+        t['T'] = 0b11;
+        return t;
+    }();
+    return table;
+}
+
+constexpr char code_to_basepair[4] = {'A', 'C', 'G', 'T'};
+
+std::size_t number_of_words(const number_of_basepairs_t number_of_basepairs)
+{
+    return (static_cast<std::size_t>(number_of_basepairs) + PackedSequenceStore::basepairs_per_word - 1) / PackedSequenceStore::basepairs_per_word;
+}
+
+bool is_lowercase(const char c)
+{
+    return c >= 'a' && c <= 'z';
+}
+
+/// \brief calls f(interval, first, past_the_last) with the part [first, past_the_last) of every interval which lies in [first_basepair, past_the_last_basepair)
+/// Intervals have to be sorted and must not overlap
+template <typename Iterator, typename Function>
+void for_each_overlapping_interval(const Iterator intervals_begin,
+                                   const Iterator intervals_end,
+                                   const position_in_read_t first_basepair,
+                                   const position_in_read_t past_the_last_basepair,
+                                   Function f)
+{
+    using interval_t = typename std::iterator_traits<Iterator>::value_type;
+    auto interval    = std::partition_point(intervals_begin,
+                                            intervals_end,
+                                            [first_basepair](const interval_t& i) {
+                                                return i.first_basepair + i.number_of_basepairs <= first_basepair;
+                                            });
+    for (; interval != intervals_end && interval->first_basepair < past_the_last_basepair; ++interval)
+    {
+        f(*interval,
+          std::max(interval->first_basepair, first_basepair),
+          std::min(interval->first_basepair + interval->number_of_basepairs, past_the_last_basepair));
+    }
+}
+
+} // namespace
+
+read_id_t PackedSequenceStore::add_sequence(const char* const sequence,
+                                            const number_of_basepairs_t number_of_basepairs)
+{
+    SequenceEntry entry;
+    entry.first_word                    = words_.size();
+    entry.first_exception_run           = exception_runs_.size();
+    entry.first_lowercase_interval      = lowercase_intervals_.size();
+    entry.number_of_basepairs           = number_of_basepairs;
+    entry.number_of_exception_runs      = 0;
+    entry.number_of_lowercase_intervals = 0;
+
+    words_.resize(words_.size() + number_of_words(number_of_basepairs), 0);
+    word_t* const words = words_.data() + entry.first_word;
+
+    const std::array<std::uint8_t, 256>& to_code = basepair_to_code();
+    for (position_in_read_t i = 0; i < number_of_basepairs; ++i)
+    {
+        char basepair = sequence[i];
+        if (is_lowercase(basepair))
+        {
+            basepair = static_cast<char>(basepair - 'a' + 'A');
+            if (lowercase_intervals_.size() > entry.first_lowercase_interval &&
+                lowercase_intervals_.back().first_basepair + lowercase_intervals_.back().number_of_basepairs == i)
+            {
+                ++lowercase_intervals_.back().number_of_basepairs;
+            }
+            else
+            {
+                lowercase_intervals_.push_back({i, 1});
+            }
+        }
+
+        const std::uint8_t code = to_code[static_cast<unsigned char>(basepair)];
+        if (code != exception_code)
+        {
+            words[i / basepairs_per_word] |= static_cast<word_t>(code) << (2 * (i % basepairs_per_word));
+        }
+        else if (exception_runs_.size() > entry.first_exception_run &&
+                 exception_runs_.back().basepair == basepair &&
+                 exception_runs_.back().first_basepair + exception_runs_.back().number_of_basepairs == i)
+        {
+            ++exception_runs_.back().number_of_basepairs;
+        }
+        else
+        {
+            exception_runs_.push_back({i, 1, basepair});
+        }
+    }
+    entry.number_of_exception_runs      = static_cast<std::uint32_t>(exception_runs_.size() - entry.first_exception_run);
+    entry.number_of_lowercase_intervals = static_cast<std::uint32_t>(lowercase_intervals_.size() - entry.first_lowercase_interval);
+
+    sequences_.push_back(entry);
+    return static_cast<read_id_t>(sequences_.size() - 1);
+}
+
+PackedSequenceStore PackedSequenceStore::reordered(const std::vector<read_id_t>& new_to_old_id) const
+{
+    PackedSequenceStore store;
+    store.sequences_.reserve(new_to_old_id.size());
+    store.words_.reserve(words_.size());
+    store.exception_runs_.reserve(exception_runs_.size());
+    store.lowercase_intervals_.reserve(lowercase_intervals_.size());
+
+    for (const read_id_t old_id : new_to_old_id)
+    {
+        const SequenceEntry& old_entry = sequences_.at(old_id);
+
+        SequenceEntry new_entry            = old_entry;
+        new_entry.first_word               = store.words_.size();
+        new_entry.first_exception_run      = store.exception_runs_.size();
+        new_entry.first_lowercase_interval = store.lowercase_intervals_.size();
+
+        const auto first_word = std::next(std::begin(words_), old_entry.first_word);
+        store.words_.insert(std::end(store.words_),
+                            first_word,
+                            std::next(first_word, number_of_words(old_entry.number_of_basepairs)));
+        const auto first_exception_run = std::next(std::begin(exception_runs_), old_entry.first_exception_run);
+        store.exception_runs_.insert(std::end(store.exception_runs_),
+                                     first_exception_run,
+                                     std::next(first_exception_run, old_entry.number_of_exception_runs));
+        const auto first_lowercase_interval = std::next(std::begin(lowercase_intervals_), old_entry.first_lowercase_interval);
+        store.lowercase_intervals_.insert(std::end(store.lowercase_intervals_),
+                                          first_lowercase_interval,
+                                          std::next(first_lowercase_interval, old_entry.number_of_lowercase_intervals));
+
+        store.sequences_.push_back(new_entry);
+    }
+
+    return store;
+}
+
+number_of_reads_t PackedSequenceStore::number_of_sequences() const
+{
+    return static_cast<number_of_reads_t>(sequences_.size());
+}
+
+number_of_basepairs_t PackedSequenceStore::sequence_length(const read_id_t sequence_id) const
+{
+    return sequences_[sequence_id].number_of_basepairs;
+}
+
+void PackedSequenceStore::decode(const read_id_t sequence_id,
+                                 const position_in_read_t first_basepair,
+                                 const number_of_basepairs_t number_of_basepairs,
+                                 char* const destination) const
+{
+    const SequenceEntry& entry = sequences_[sequence_id];
+    assert(static_cast<std::uint64_t>(first_basepair) + number_of_basepairs <= entry.number_of_basepairs);
+
+    // unpack one word at a time
+    const word_t* const words    = words_.data() + entry.first_word;
+    position_in_read_t position  = first_basepair;
+    char* output                 = destination;
+    const char* const output_end = destination + number_of_basepairs;
+    while (output != output_end)
+    {
+        const std::uint32_t position_in_word    = position % basepairs_per_word;
+        const std::uint32_t basepairs_to_unpack = std::min(static_cast<std::uint32_t>(basepairs_per_word - position_in_word),
+                                                           static_cast<std::uint32_t>(output_end - output));
+        word_t word                             = words[position / basepairs_per_word] >> (2 * position_in_word);
+        for (std::uint32_t i = 0; i < basepairs_to_unpack; ++i)
+        {
+            *output++ = code_to_basepair[word & 0b11];
+            word >>= 2;
+        }
+        position += basepairs_to_unpack;
+    }
+
+    const position_in_read_t past_the_last_basepair = first_basepair + number_of_basepairs;
+
+    // overwrite exceptions, runs are sorted and do not overlap
+    const auto runs_begin = std::next(std::begin(exception_runs_), entry.first_exception_run);
+    for_each_overlapping_interval(runs_begin,
+                                  std::next(runs_begin, entry.number_of_exception_runs),
+                                  first_basepair,
+                                  past_the_last_basepair,
+                                  [destination, first_basepair](const ExceptionRun& run, const position_in_read_t run_begin, const position_in_read_t run_end) {
+                                      std::fill(destination + (run_begin - first_basepair),
+                                                destination + (run_end - first_basepair),
+                                                run.basepair);
+                                  });
+
+    // restore case, all lowercase characters are uppercase letters at this point
+    const auto intervals_begin = std::next(std::begin(lowercase_intervals_), entry.first_lowercase_interval);
+    for_each_overlapping_interval(intervals_begin,
+                                  std::next(intervals_begin, entry.number_of_lowercase_intervals),
+                                  first_basepair,
+                                  past_the_last_basepair,
+                                  [destination, first_basepair](const LowercaseInterval&, const position_in_read_t interval_begin, const position_in_read_t interval_end) {
+                                      std::for_each(destination + (interval_begin - first_basepair),
+                                                    destination + (interval_end - first_basepair),
+                                                    [](char& basepair) { basepair = static_cast<char>(basepair - 'A' + 'a'); });
+                                  });
+}
+
+const PackedSequenceStore::word_t* PackedSequenceStore::packed_words(const read_id_t sequence_id) const
+{
+    return words_.data() + sequences_[sequence_id].first_word;
+}
+
+std::size_t PackedSequenceStore::number_of_packed_words(const read_id_t sequence_id) const
+{
+    return number_of_words(sequences_[sequence_id].number_of_basepairs);
+}
+
+bool PackedSequenceStore::has_exceptions(const read_id_t sequence_id) const
+{
+    return sequences_[sequence_id].number_of_exception_runs != 0;
+}
+
+std::size_t PackedSequenceStore::memory_usage_bytes() const
+{
+    return sequences_.capacity() * sizeof(SequenceEntry) +
+           words_.capacity() * sizeof(word_t) +
+           exception_runs_.capacity() * sizeof(ExceptionRun) +
+           lowercase_intervals_.capacity() * sizeof(LowercaseInterval);
+}
+
+void PackedSequenceStore::shrink_to_fit()
+{
+    sequences_.shrink_to_fit();
+    words_.shrink_to_fit();
+    exception_runs_.shrink_to_fit();
+    lowercase_intervals_.shrink_to_fit();
+}
+
+} // namespace io
+
+} // namespace genomeworks
+
+} // namespace claraparabricks
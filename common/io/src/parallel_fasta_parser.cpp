@@ -0,0 +1,314 @@
+/*
+* Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#include "parallel_fasta_parser.hpp"
+
+#include "bgzf.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <random>
+#include <stdexcept>
+
+#include <claragenomics/io/memory_mapped_file.hpp>
+#include <claragenomics/utils/run_in_parallel.hpp>
+
+namespace claraparabricks
+{
+
+namespace genomeworks
+{
+
+namespace io
+{
+
+namespace
+{
+
+enum class FileFormat
+{
+    fasta,
+    fastq
+};
+
+/// ranges smaller than this are not split further
+constexpr std::size_t min_range_size = 1 << 20;
+
+/// every thread gets a few ranges so that threads which finish early can help with the remaining ones
+constexpr std::size_t ranges_per_thread = 4;
+
+/// \brief returns the beginning of the line after the line position is in, or size if there is no such line
+std::size_t next_line(const char* const data,
+                      const std::size_t size,
+                      const std::size_t position)
+{
+    const char* const newline = static_cast<const char*>(std::memchr(data + position, '\n', size - position));
+    return (nullptr != newline) ? newline - data + 1 : size;
+}
+
+/// \brief returns the end of the content of the line, excluding line break
+std::size_t line_content_end(const char* const data,
+                             const std::size_t line_begin,
+                             const std::size_t next_line_begin)
+{
+    std::size_t content_end = next_line_begin;
+    if (content_end > line_begin && data[content_end - 1] == '\n')
+    {
+        --content_end;
+    }
+    if (content_end > line_begin && data[content_end - 1] == '\r')
+    {
+        --content_end;
+    }
+    return content_end;
+}
+
+/// \brief returns true if the line starting at position is the header of a record
+/// In FASTQ files quality lines can also start with '@', so the line after the sequence has to start with '+'
+bool is_record_start(const char* const data,
+                     const std::size_t size,
+                     const std::size_t position,
+                     const FileFormat format)
+{
+    if (format == FileFormat::fasta)
+    {
+        return data[position] == '>';
+    }
+
+    if (data[position] != '@')
+    {
+        return false;
+    }
+    const std::size_t sequence_line = next_line(data, size, position);
+    if (sequence_line >= size)
+    {
+        return false;
+    }
+    const std::size_t separator_line = next_line(data, size, sequence_line);
+    return separator_line < size && data[separator_line] == '+';
+}
+
+/// \brief returns the beginning of the first record which starts at or after position, or size if there is no such record
+std::size_t find_record_start(const char* const data,
+                              const std::size_t size,
+                              const std::size_t position,
+                              const FileFormat format)
+{
+    if (0 == position)
+    {
+        return 0;
+    }
+
+    std::size_t line = (data[position - 1] == '\n') ? position : next_line(data, size, position);
+    while (line < size && !is_record_start(data, size, line, format))
+    {
+        line = next_line(data, size, line);
+    }
+    return line;
+}
+
+/// \brief parses all records in [begin, end), begin has to be the beginning of a record and no record can cross end
+void parse_range(const char* const data,
+                 const std::size_t begin,
+                 const std::size_t end,
+                 const FileFormat format,
+                 const number_of_basepairs_t min_sequence_length,
+                 const std::string& file_path,
+                 ReadTable& parsed_range)
+{
+    const char header_marker = (format == FileFormat::fasta) ? '>' : '@';
+
+    // there cannot be more basepairs than bytes, reserving avoids reallocations of large ranges
+    parsed_range.reserve_basepairs(end - begin);
+
+    std::size_t position = begin;
+    while (position < end)
+    {
+        if (data[position] != header_marker)
+        {
+            throw std::invalid_argument("Error: unexpected character at byte " + std::to_string(position) + " of " + file_path + ", expected '" + header_marker + "' !");
+        }
+
+        // header, name ends at the first whitespace
+        const std::size_t sequence_begin = next_line(data, end, position);
+        const std::size_t header_end     = line_content_end(data, position, sequence_begin);
+        std::size_t name_end             = position + 1;
+        while (name_end < header_end && !std::isspace(static_cast<unsigned char>(data[name_end])))
+        {
+            ++name_end;
+        }
+        const std::size_t name_begin = position + 1;
+        position                     = sequence_begin;
+
+        // sequence lines
+        const char sequence_end_marker = (format == FileFormat::fasta) ? '>' : '+';
+        while (position < end && data[position] != sequence_end_marker)
+        {
+            const std::size_t line_end = next_line(data, end, position);
+            parsed_range.append_basepairs(data + position,
+                                          data + line_content_end(data, position, line_end));
+            position = line_end;
+        }
+        const std::size_t number_of_basepairs = parsed_range.number_of_pending_basepairs();
+
+        // quality lines, they can start with any character so they are skipped by length
+        if (format == FileFormat::fastq)
+        {
+            if (position >= end)
+            {
+                throw std::invalid_argument("Error: truncated record " + std::string(data + name_begin, name_end - name_begin) + " in " + file_path + " !");
+            }
+            position                   = next_line(data, end, position);
+            std::size_t quality_length = 0;
+            while (quality_length < number_of_basepairs && position < end)
+            {
+                const std::size_t line_end = next_line(data, end, position);
+                quality_length += line_content_end(data, position, line_end) - position;
+                position = line_end;
+            }
+            if (quality_length != number_of_basepairs)
+            {
+                throw std::invalid_argument("Error: quality and sequence lengths of " + std::string(data + name_begin, name_end - name_begin) + " in " + file_path + " do not match !");
+            }
+        }
+
+        if (number_of_basepairs < min_sequence_length)
+        {
+            parsed_range.discard_read();
+        }
+        else
+        {
+            parsed_range.commit_read(data + name_begin, static_cast<std::uint32_t>(name_end - name_begin));
+        }
+    }
+}
+
+} // namespace
+
+FastaParserParallel::FastaParserParallel(const std::string& fasta_file,
+                                         const number_of_basepairs_t min_sequence_length,
+                                         const bool shuffle,
+                                         std::int32_t number_of_threads)
+{
+    const MemoryMappedFile file(fasta_file);
+    const char* data = file.data();
+    std::size_t size = file.size();
+
+    if (0 == size)
+    {
+        throw std::invalid_argument("Error: "
+                                    "non-existent or empty file " +
+                                    fasta_file + " !");
+    }
+
+    number_of_threads = get_number_of_host_threads(number_of_threads);
+
+    // BGZF blocks are inflated in parallel into one buffer, which is then parsed like an uncompressed file
+    std::vector<char> inflated_file;
+    if (size >= 2 && data[0] == '\x1f' && data[1] == '\x8b')
+    {
+        if (!is_bgzf(data, size))
+        {
+            throw std::invalid_argument("Error: " + fasta_file + " is not compressed with bgzip, use create_kseq_fasta_parser() for other compressed files !");
+        }
+        inflated_file = inflate_bgzf(data, size, fasta_file, number_of_threads);
+        data          = inflated_file.data();
+        size          = inflated_file.size();
+        if (0 == size)
+        {
+            throw std::invalid_argument("Error: "
+                                        "empty file " +
+                                        fasta_file + " !");
+        }
+    }
+
+    FileFormat format;
+    switch (data[0])
+    {
+    case '>':
+        format = FileFormat::fasta;
+        break;
+    case '@':
+        format = FileFormat::fastq;
+        break;
+    default:
+        throw std::invalid_argument("Error: " + fasta_file + " is neither a FASTA nor a FASTQ file !");
+    }
+
+    const std::size_t number_of_ranges = std::max(static_cast<std::size_t>(1),
+                                                  std::min(size / min_range_size,
+                                                           ranges_per_thread * number_of_threads));
+    const std::size_t range_size       = size / number_of_ranges;
+
+    // parse ranges, every range starts at its first record and ends where the first record of the next range starts
+    std::vector<ReadTable> parsed_ranges(number_of_ranges);
+    run_in_parallel(number_of_threads,
+                    number_of_ranges,
+                    [&](const std::size_t range_id) {
+                        const std::size_t begin = find_record_start(data, size, range_id * range_size, format);
+                        const std::size_t end   = (range_id + 1 == number_of_ranges) ? size : find_record_start(data, size, (range_id + 1) * range_size, format);
+                        if (begin < end)
+                        {
+                            parse_range(data, begin, end, format, min_sequence_length, fasta_file, parsed_ranges[range_id]);
+                        }
+                    });
+
+    reads_ = ReadTable::concatenate(parsed_ranges, number_of_threads);
+    reads_.shrink_to_fit();
+
+    // Same shuffle as FastaParserKseqpp, so both parsers assign the same read_ids
+    if (shuffle)
+    {
+        std::mt19937 g(0); // seed for deterministic behaviour
+        reads_.shuffle(g);
+    }
+}
+
+number_of_reads_t FastaParserParallel::get_num_seqences() const
+{
+    return reads_.number_of_reads();
+}
+
+const FastaSequence& FastaParserParallel::get_sequence_by_id(const read_id_t sequence_id) const
+{
+    if (sequence_id >= get_num_seqences())
+    {
+        throw std::out_of_range("Error: sequence_id " + std::to_string(sequence_id) + " is out of range !");
+    }
+
+    return materialized_sequences_.get_or_create(sequence_id, [this, sequence_id]() {
+        const cga_string_view_t name = reads_.name(sequence_id);
+        const cga_string_view_t seq  = reads_.basepairs(sequence_id);
+        return FastaSequence{std::string(name.data(), name.size()),
+                             std::string(seq.data(), seq.size())};
+    });
+}
+
+number_of_basepairs_t FastaParserParallel::get_sequence_length_by_id(const read_id_t sequence_id) const
+{
+    return reads_.number_of_basepairs(sequence_id);
+}
+
+cga_string_view_t FastaParserParallel::get_name_view_by_id(const read_id_t sequence_id) const
+{
+    return reads_.name(sequence_id);
+}
+
+cga_string_view_t FastaParserParallel::get_sequence_view_by_id(const read_id_t sequence_id) const
+{
+    return reads_.basepairs(sequence_id);
+}
+
+} // namespace io
+
+} // namespace genomeworks
+
+} // namespace claraparabricks
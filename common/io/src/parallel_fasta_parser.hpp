@@ -0,0 +1,85 @@
+/*
+* Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+#pragma once
+
+#include "claragenomics/io/fasta_parser.hpp"
+
+#include "per_read_cache.hpp"
+#include "read_table.hpp"
+
+#include <cstdint>
+#include <string>
+
+namespace claraparabricks
+{
+
+namespace genomeworks
+{
+
+namespace io
+{
+
+/// FastaParserParallel - FASTA/FASTQ parser which parses byte ranges of the file on multiple threads
+///
+/// The file is split into ranges, every range is moved forward to the first record which starts in it and records of
+/// all ranges are parsed concurrently. Parsed ranges are then stitched into one contiguous table, in file order.
+/// Files compressed with bgzip are inflated block by block on the same threads before being split into ranges.
+class FastaParserParallel : public FastaParser
+{
+public:
+    /// \brief Constructor
+    /// \param fasta_file Path to FASTA or FASTQ file, uncompressed or compressed with bgzip.
+    /// \param min_sequence_length Minimum length a sequence needs to be to be parsed. Shorter sequences are ignored.
+    /// \param shuffle Enables shuffling reads
+    /// \param number_of_threads Number of threads to parse with, 0 to use one thread per hardware thread
+    FastaParserParallel(const std::string& fasta_file,
+                        number_of_basepairs_t min_sequence_length,
+                        bool shuffle,
+                        std::int32_t number_of_threads);
+
+    /// \brief Return number of sequences in FASTA file
+    /// \return Sequence count in file
+    number_of_reads_t get_num_seqences() const override;
+
+    /// \brief Fetch an entry from the FASTA file by index position in file.
+    /// The entry is copied out of the table on first access and kept for the lifetime of the parser,
+    /// use get_name_view_by_id() and get_sequence_view_by_id() to avoid the copy.
+    /// \param sequence_id Position of sequence in file. If sequence_id is invalid an error is thrown.
+    /// \return A reference to FastaSequence describing the entry.
+    const FastaSequence& get_sequence_by_id(read_id_t sequence_id) const override;
+
+    /// \brief Return the number of basepairs of an entry.
+    /// \param sequence_id Position of sequence in file.
+    /// \return Number of basepairs in the entry.
+    number_of_basepairs_t get_sequence_length_by_id(read_id_t sequence_id) const override;
+
+    /// \brief Fetch the name of an entry without copying it.
+    /// \param sequence_id Position of sequence in file.
+    /// \return A view of the name, valid for the lifetime of the parser.
+    cga_string_view_t get_name_view_by_id(read_id_t sequence_id) const override;
+
+    /// \brief Fetch the basepairs of an entry without copying them.
+    /// \param sequence_id Position of sequence in file.
+    /// \return A view of the basepairs, valid for the lifetime of the parser.
+    cga_string_view_t get_sequence_view_by_id(read_id_t sequence_id) const override;
+
+private:
+    /// reads in read_id order
+    ReadTable reads_;
+
+    /// entries requested through get_sequence_by_id()
+    PerReadCache<FastaSequence> materialized_sequences_;
+};
+
+} // namespace io
+
+} // namespace genomeworks
+
+} // namespace claraparabricks
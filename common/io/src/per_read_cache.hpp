@@ -0,0 +1,70 @@
+/*
+* Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#pragma once
+
+#include <mutex>
+#include <unordered_map>
+
+#include <claragenomics/types.hpp>
+
+namespace claraparabricks
+{
+
+namespace genomeworks
+{
+
+namespace io
+{
+
+/// PerReadCache - threadsafe, lazily filled map of values derived from single reads
+///
+/// Parsers which do not keep reads as std::strings use it to materialize data on first access (e.g. FastaSequence
+/// for get_sequence_by_id()). Values are never evicted, so returned references are valid for the lifetime of the cache.
+///
+/// \tparam T type of cached values
+template <typename T>
+class PerReadCache
+{
+public:
+    /// \brief returns cached value for read_id, creates it by calling create() if it is not cached yet
+    /// \param read_id
+    /// \param create callable returning T, called at most once per read_id
+    /// \return reference to cached value
+    template <typename Create>
+    const T& get_or_create(const read_id_t read_id, Create create) const
+    {
+        std::lock_guard<std::mutex> lg(mutex_);
+        auto it = values_.find(read_id);
+        if (it == values_.end())
+        {
+            it = values_.emplace(read_id, create()).first;
+        }
+        // references to elements of unordered_map are not invalidated by rehashing
+        return it->second;
+    }
+
+    /// \brief returns the number of cached values
+    std::size_t size() const
+    {
+        std::lock_guard<std::mutex> lg(mutex_);
+        return values_.size();
+    }
+
+private:
+    mutable std::mutex mutex_;
+    mutable std::unordered_map<read_id_t, T> values_;
+};
+
+} // namespace io
+
+} // namespace genomeworks
+
+} // namespace claraparabricks
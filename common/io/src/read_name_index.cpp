@@ -0,0 +1,96 @@
+/*
+* Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#include "read_name_index.hpp"
+
+#include <claragenomics/io/fasta_parser.hpp>
+
+namespace claraparabricks
+{
+
+namespace genomeworks
+{
+
+namespace io
+{
+
+constexpr read_id_t ReadNameIndex::empty_slot;
+
+ReadNameIndex::ReadNameIndex(const FastaParser& parser)
+    : parser_(parser)
+{
+    // at most half of the slots are used, which keeps probe sequences short
+    const number_of_reads_t number_of_reads = parser_.get_num_seqences();
+    std::uint64_t number_of_slots           = 1;
+    while (number_of_slots < 2 * static_cast<std::uint64_t>(number_of_reads))
+    {
+        number_of_slots *= 2;
+    }
+    slots_.assign(number_of_slots, {0, empty_slot});
+    slot_mask_ = number_of_slots - 1;
+
+    for (read_id_t read_id = 0; read_id < number_of_reads; ++read_id)
+    {
+        const cga_string_view_t name    = parser_.get_name_view_by_id(read_id);
+        const std::uint64_t name_hash   = hash(name);
+        const std::uint32_t fingerprint = static_cast<std::uint32_t>(name_hash >> 32);
+        for (std::uint64_t slot_id = name_hash & slot_mask_;; slot_id = (slot_id + 1) & slot_mask_)
+        {
+            Slot& slot = slots_[slot_id];
+            if (slot.read_id == empty_slot)
+            {
+                slot = {fingerprint, read_id};
+                break;
+            }
+            if (slot.fingerprint == fingerprint && parser_.get_name_view_by_id(slot.read_id) == name)
+            {
+                // keep the first read with this name
+                break;
+            }
+        }
+    }
+}
+
+bool ReadNameIndex::find(const cga_string_view_t name,
+                         read_id_t& read_id) const
+{
+    const std::uint64_t name_hash   = hash(name);
+    const std::uint32_t fingerprint = static_cast<std::uint32_t>(name_hash >> 32);
+    for (std::uint64_t slot_id = name_hash & slot_mask_;; slot_id = (slot_id + 1) & slot_mask_)
+    {
+        const Slot& slot = slots_[slot_id];
+        if (slot.read_id == empty_slot)
+        {
+            return false;
+        }
+        if (slot.fingerprint == fingerprint && parser_.get_name_view_by_id(slot.read_id) == name)
+        {
+            read_id = slot.read_id;
+            return true;
+        }
+    }
+}
+
+std::uint64_t ReadNameIndex::hash(const cga_string_view_t name)
+{
+    std::uint64_t name_hash = 14695981039346656037ull;
+    for (const char c : name)
+    {
+        name_hash ^= static_cast<unsigned char>(c);
+        name_hash *= 1099511628211ull;
+    }
+    return name_hash;
+}
+
+} // namespace io
+
+} // namespace genomeworks
+
+} // namespace claraparabricks
@@ -0,0 +1,72 @@
+/*
+* Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <claragenomics/types.hpp>
+
+namespace claraparabricks
+{
+
+namespace genomeworks
+{
+
+namespace io
+{
+
+class FastaParser;
+
+/// ReadNameIndex - hash table from read names to read_ids
+///
+/// Open addressing with linear probing. Slots only hold read_ids and a part of the hash of the name, names themselves
+/// are compared through the name views of the parser, so no name is copied.
+class ReadNameIndex
+{
+public:
+    /// \brief Builds the index for all reads of a parser
+    /// If several reads have the same name the one with the lowest read_id is found.
+    /// \param parser the index keeps a reference to the parser, which has to outlive it
+    explicit ReadNameIndex(const FastaParser& parser);
+
+    /// \brief Looks up a name
+    /// \param name
+    /// \param read_id set to the read_id of the read if it is found
+    /// \return true if a read with the given name exists
+    bool find(cga_string_view_t name,
+              read_id_t& read_id) const;
+
+private:
+    /// Slot - one entry of the hash table
+    struct Slot
+    {
+        /// upper half of the hash of the name, checked before comparing names
+        std::uint32_t fingerprint;
+        /// read_id of the read, empty_slot if the slot is empty
+        read_id_t read_id;
+    };
+
+    static constexpr read_id_t empty_slot = ~read_id_t(0);
+
+    /// \brief returns a 64-bit FNV-1a hash of the name
+    static std::uint64_t hash(cga_string_view_t name);
+
+    const FastaParser& parser_;
+    std::vector<Slot> slots_;
+    /// number of slots - 1, number of slots is a power of two
+    std::uint64_t slot_mask_;
+};
+
+} // namespace io
+
+} // namespace genomeworks
+
+} // namespace claraparabricks
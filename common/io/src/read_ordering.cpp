@@ -0,0 +1,150 @@
+/*
+* Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#include "read_ordering.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+
+namespace claraparabricks
+{
+
+namespace genomeworks
+{
+
+namespace io
+{
+
+namespace
+{
+
+/// \brief returns read_ids sorted by length, longest first, ties in current order
+std::vector<read_id_t> sort_by_length(const std::vector<number_of_basepairs_t>& read_lengths)
+{
+    std::vector<read_id_t> sorted_ids(read_lengths.size());
+    std::iota(std::begin(sorted_ids), std::end(sorted_ids), 0);
+    std::stable_sort(std::begin(sorted_ids),
+                     std::end(sorted_ids),
+                     [&read_lengths](const read_id_t a, const read_id_t b) {
+                         return read_lengths[a] > read_lengths[b];
+                     });
+    return sorted_ids;
+}
+
+std::vector<read_id_t> length_striped_order(const std::vector<number_of_basepairs_t>& read_lengths)
+{
+    const std::vector<read_id_t> sorted_ids = sort_by_length(read_lengths);
+
+    std::vector<read_id_t> new_to_old_id;
+    new_to_old_id.reserve(sorted_ids.size());
+    std::size_t longest  = 0;
+    std::size_t shortest = sorted_ids.size();
+    while (longest < shortest)
+    {
+        new_to_old_id.push_back(sorted_ids[longest++]);
+        if (longest < shortest)
+        {
+            new_to_old_id.push_back(sorted_ids[--shortest]);
+        }
+    }
+    return new_to_old_id;
+}
+
+std::vector<read_id_t> length_bucketed_order(const std::vector<number_of_basepairs_t>& read_lengths)
+{
+    // bucket i holds reads with lengths in [2^i, 2^(i+1)), reads of length 0 go to bucket 0
+    std::vector<std::vector<read_id_t>> buckets;
+    for (read_id_t read_id = 0; read_id < read_lengths.size(); ++read_id)
+    {
+        std::size_t bucket_id = 0;
+        for (number_of_basepairs_t length = read_lengths[read_id]; length > 1; length >>= 1)
+        {
+            ++bucket_id;
+        }
+        if (bucket_id >= buckets.size())
+        {
+            buckets.resize(bucket_id + 1);
+        }
+        buckets[bucket_id].push_back(read_id);
+    }
+
+    // reads within a bucket are shuffled so that neighbouring reads in the file do not stay together,
+    // longest bucket first so that the longest reads get the lowest read_ids
+    std::mt19937 g(0); // seed for deterministic behaviour
+    for (std::vector<read_id_t>& bucket : buckets)
+    {
+        std::shuffle(std::begin(bucket), std::end(bucket), g);
+    }
+    std::reverse(std::begin(buckets), std::end(buckets));
+
+    // every round takes the next read of each bucket, with larger buckets contributing proportionally more reads
+    // so that all buckets run out at the same time
+    std::vector<read_id_t> new_to_old_id;
+    new_to_old_id.reserve(read_lengths.size());
+    std::vector<std::size_t> taken_from_bucket(buckets.size(), 0);
+    while (new_to_old_id.size() < read_lengths.size())
+    {
+        // pick the bucket which is furthest behind its proportional share
+        std::size_t next_bucket = buckets.size();
+        double smallest_share   = 2.0;
+        for (std::size_t bucket_id = 0; bucket_id < buckets.size(); ++bucket_id)
+        {
+            if (taken_from_bucket[bucket_id] < buckets[bucket_id].size())
+            {
+                const double share = static_cast<double>(taken_from_bucket[bucket_id]) / buckets[bucket_id].size();
+                if (share < smallest_share)
+                {
+                    smallest_share = share;
+                    next_bucket    = bucket_id;
+                }
+            }
+        }
+        new_to_old_id.push_back(buckets[next_bucket][taken_from_bucket[next_bucket]++]);
+    }
+    return new_to_old_id;
+}
+
+} // namespace
+
+std::vector<read_id_t> compute_read_order(const std::vector<number_of_basepairs_t>& read_lengths,
+                                          const ReadOrdering ordering)
+{
+    switch (ordering)
+    {
+    case ReadOrdering::file_order:
+    {
+        std::vector<read_id_t> new_to_old_id(read_lengths.size());
+        std::iota(std::begin(new_to_old_id), std::end(new_to_old_id), 0);
+        return new_to_old_id;
+    }
+    case ReadOrdering::random:
+    {
+        // Same shuffle as FastaParserKseqpp, so both parsers assign the same read_ids
+        std::vector<read_id_t> new_to_old_id(read_lengths.size());
+        std::iota(std::begin(new_to_old_id), std::end(new_to_old_id), 0);
+        std::mt19937 g(0); // seed for deterministic behaviour
+        std::shuffle(new_to_old_id.begin(), new_to_old_id.end(), g);
+        return new_to_old_id;
+    }
+    case ReadOrdering::length_striped:
+        return length_striped_order(read_lengths);
+    case ReadOrdering::length_bucketed:
+        return length_bucketed_order(read_lengths);
+    }
+    throw std::invalid_argument("Error: unknown read ordering !");
+}
+
+} // namespace io
+
+} // namespace genomeworks
+
+} // namespace claraparabricks
@@ -0,0 +1,36 @@
+/*
+* Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+#pragma once
+
+#include "claragenomics/io/fasta_parser.hpp"
+
+#include <vector>
+
+namespace claraparabricks
+{
+
+namespace genomeworks
+{
+
+namespace io
+{
+
+/// \brief returns the order of reads for the given strategy
+/// \param read_lengths number of basepairs of each read, in the current order
+/// \param ordering
+/// \return for every new read_id the current read_id of that read
+std::vector<read_id_t> compute_read_order(const std::vector<number_of_basepairs_t>& read_lengths,
+                                          ReadOrdering ordering);
+
+} // namespace io
+
+} // namespace genomeworks
+
+} // namespace claraparabricks
@@ -0,0 +1,120 @@
+/*
+* Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#include "claragenomics/io/read_store.hpp"
+
+#include "read_store_format.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+#include <claragenomics/io/fasta_parser.hpp>
+
+namespace claraparabricks
+{
+
+namespace genomeworks
+{
+
+namespace io
+{
+
+namespace
+{
+
+/// \brief writes zeros until the stream position is a multiple of read_store::section_alignment
+void pad_to_section(std::ofstream& file,
+                    std::uint64_t& position)
+{
+    const std::uint64_t aligned_position = read_store::align_section(position);
+    const std::vector<char> zeros(aligned_position - position, 0);
+    file.write(zeros.data(), zeros.size());
+    position = aligned_position;
+}
+
+} // namespace
+
+void write_read_store(const FastaParser& parser,
+                      const std::string& read_store_file)
+{
+    std::ofstream file(read_store_file, std::ios::binary | std::ios::trunc);
+    if (!file)
+    {
+        throw std::invalid_argument("Error: cannot open " + read_store_file + " for writing !");
+    }
+
+    const number_of_reads_t number_of_reads = parser.get_num_seqences();
+
+    read_store::ReadStoreHeader header;
+    std::memcpy(header.magic, read_store::magic, sizeof(header.magic));
+    header.version            = read_store::current_version;
+    header.basepairs_encoding = 0;
+    header.number_of_reads    = number_of_reads;
+    header.entries_offset     = read_store::align_section(sizeof(read_store::ReadStoreHeader));
+
+    // entries can be calculated before writing anything as names and basepairs are written in read order
+    std::vector<read_store::ReadStoreEntry> entries(number_of_reads);
+    std::uint64_t names_size     = 0;
+    std::uint64_t basepairs_size = 0;
+    for (read_id_t read_id = 0; read_id < number_of_reads; ++read_id)
+    {
+        read_store::ReadStoreEntry& entry = entries[read_id];
+        entry.name_offset                 = names_size;
+        entry.basepairs_offset            = basepairs_size;
+        entry.name_length                 = static_cast<std::uint32_t>(parser.get_name_view_by_id(read_id).size());
+        entry.number_of_basepairs         = parser.get_sequence_length_by_id(read_id);
+        names_size += entry.name_length;
+        basepairs_size += entry.number_of_basepairs;
+    }
+    header.names_offset     = read_store::align_section(header.entries_offset + entries.size() * sizeof(read_store::ReadStoreEntry));
+    header.names_size       = names_size;
+    header.basepairs_offset = read_store::align_section(header.names_offset + names_size);
+    header.basepairs_size   = basepairs_size;
+
+    std::uint64_t position = 0;
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    position += sizeof(header);
+
+    pad_to_section(file, position);
+    file.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(read_store::ReadStoreEntry));
+    position += entries.size() * sizeof(read_store::ReadStoreEntry);
+
+    pad_to_section(file, position);
+    for (read_id_t read_id = 0; read_id < number_of_reads; ++read_id)
+    {
+        const cga_string_view_t name = parser.get_name_view_by_id(read_id);
+        file.write(name.data(), name.size());
+    }
+    position += names_size;
+
+    pad_to_section(file, position);
+    std::vector<char> basepairs;
+    for (read_id_t read_id = 0; read_id < number_of_reads; ++read_id)
+    {
+        // copy_sequence_by_id() works without materializing reads in every parser
+        basepairs.resize(entries[read_id].number_of_basepairs);
+        parser.copy_sequence_by_id(read_id, 0, entries[read_id].number_of_basepairs, basepairs.data());
+        file.write(basepairs.data(), basepairs.size());
+    }
+
+    if (!file)
+    {
+        throw std::invalid_argument("Error: cannot write " + read_store_file + " !");
+    }
+}
+
+} // namespace io
+
+} // namespace genomeworks
+
+} // namespace claraparabricks
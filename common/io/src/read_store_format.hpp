@@ -0,0 +1,76 @@
+/*
+* Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+#pragma once
+
+#include <cstdint>
+
+namespace claraparabricks
+{
+
+namespace genomeworks
+{
+
+namespace io
+{
+
+namespace read_store
+{
+
+/// Layout of a read store file, all values are in host byte order
+///
+/// | ReadStoreHeader | ReadStoreEntry x number_of_reads | names | basepairs |
+///
+/// Sections start at offsets which are multiples of section_alignment.
+/// Names and basepairs are stored without separators or null-terminators, basepairs as plain text.
+
+/// identifies read store files
+constexpr char magic[8] = {'C', 'G', 'A', 'R', 'E', 'A', 'D', 'S'};
+
+/// incremented on every incompatible change of the layout
+constexpr std::uint32_t current_version = 1;
+
+/// alignment of all sections in bytes
+constexpr std::uint64_t section_alignment = 64;
+
+struct ReadStoreHeader
+{
+    char magic[8];
+    std::uint32_t version;
+    /// encoding of basepairs, only plain text (0) is supported
+    std::uint32_t basepairs_encoding;
+    std::uint64_t number_of_reads;
+    std::uint64_t entries_offset;
+    std::uint64_t names_offset;
+    std::uint64_t names_size;
+    std::uint64_t basepairs_offset;
+    std::uint64_t basepairs_size;
+};
+
+struct ReadStoreEntry
+{
+    std::uint64_t name_offset;
+    std::uint64_t basepairs_offset;
+    std::uint32_t name_length;
+    std::uint32_t number_of_basepairs;
+};
+
+/// \brief rounds offset up to the next multiple of section_alignment
+inline std::uint64_t align_section(const std::uint64_t offset)
+{
+    return (offset + section_alignment - 1) / section_alignment * section_alignment;
+}
+
+} // namespace read_store
+
+} // namespace io
+
+} // namespace genomeworks
+
+} // namespace claraparabricks
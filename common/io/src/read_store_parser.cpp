@@ -0,0 +1,135 @@
+/*
+* Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#include "read_store_parser.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <string>
+
+namespace claraparabricks
+{
+
+namespace genomeworks
+{
+
+namespace io
+{
+
+FastaParserReadStore::FastaParserReadStore(const std::string& read_store_file,
+                                           const number_of_basepairs_t min_sequence_length,
+                                           const bool shuffle)
+    : read_store_file_(read_store_file)
+{
+    const char* const data   = read_store_file_.data();
+    const std::uint64_t size = read_store_file_.size();
+
+    read_store::ReadStoreHeader header;
+    if (size < sizeof(header))
+    {
+        throw std::invalid_argument("Error: " + read_store_file + " is not a read store !");
+    }
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, read_store::magic, sizeof(header.magic)) != 0)
+    {
+        throw std::invalid_argument("Error: " + read_store_file + " is not a read store !");
+    }
+    if (header.version != read_store::current_version || header.basepairs_encoding != 0)
+    {
+        throw std::invalid_argument("Error: " + read_store_file + " was written by an incompatible version !");
+    }
+
+    const std::uint64_t entries_size = header.number_of_reads * sizeof(read_store::ReadStoreEntry);
+    if (header.number_of_reads > std::numeric_limits<number_of_reads_t>::max() ||
+        header.entries_offset % alignof(read_store::ReadStoreEntry) != 0 ||
+        header.entries_offset + entries_size > size ||
+        header.names_offset + header.names_size > size ||
+        header.basepairs_offset + header.basepairs_size > size)
+    {
+        throw std::invalid_argument("Error: " + read_store_file + " is truncated or corrupted !");
+    }
+
+    entries_   = reinterpret_cast<const read_store::ReadStoreEntry*>(data + header.entries_offset);
+    names_     = data + header.names_offset;
+    basepairs_ = data + header.basepairs_offset;
+
+    read_id_to_entry_.reserve(header.number_of_reads);
+    for (read_id_t entry_id = 0; entry_id < header.number_of_reads; ++entry_id)
+    {
+        const read_store::ReadStoreEntry& e = entries_[entry_id];
+        if (e.name_offset + e.name_length > header.names_size ||
+            e.basepairs_offset + e.number_of_basepairs > header.basepairs_size)
+        {
+            throw std::invalid_argument("Error: " + read_store_file + " is truncated or corrupted !");
+        }
+        if (e.number_of_basepairs >= min_sequence_length)
+        {
+            read_id_to_entry_.push_back(entry_id);
+        }
+    }
+
+    // Same shuffle as FastaParserKseqpp, so both parsers assign the same read_ids
+    if (shuffle)
+    {
+        std::mt19937 g(0); // seed for deterministic behaviour
+        std::shuffle(read_id_to_entry_.begin(), read_id_to_entry_.end(), g);
+    }
+}
+
+number_of_reads_t FastaParserReadStore::get_num_seqences() const
+{
+    return static_cast<number_of_reads_t>(read_id_to_entry_.size());
+}
+
+const FastaSequence& FastaParserReadStore::get_sequence_by_id(const read_id_t sequence_id) const
+{
+    if (sequence_id >= get_num_seqences())
+    {
+        throw std::out_of_range("Error: sequence_id " + std::to_string(sequence_id) + " is out of range !");
+    }
+
+    return materialized_sequences_.get_or_create(sequence_id, [this, sequence_id]() {
+        const cga_string_view_t name = get_name_view_by_id(sequence_id);
+        const cga_string_view_t seq  = get_sequence_view_by_id(sequence_id);
+        return FastaSequence{std::string(name.data(), name.size()),
+                             std::string(seq.data(), seq.size())};
+    });
+}
+
+number_of_basepairs_t FastaParserReadStore::get_sequence_length_by_id(const read_id_t sequence_id) const
+{
+    return entry(sequence_id).number_of_basepairs;
+}
+
+cga_string_view_t FastaParserReadStore::get_name_view_by_id(const read_id_t sequence_id) const
+{
+    const read_store::ReadStoreEntry& e = entry(sequence_id);
+    return cga_string_view_t(names_ + e.name_offset, e.name_length);
+}
+
+cga_string_view_t FastaParserReadStore::get_sequence_view_by_id(const read_id_t sequence_id) const
+{
+    const read_store::ReadStoreEntry& e = entry(sequence_id);
+    return cga_string_view_t(basepairs_ + e.basepairs_offset, e.number_of_basepairs);
+}
+
+const read_store::ReadStoreEntry& FastaParserReadStore::entry(const read_id_t sequence_id) const
+{
+    return entries_[read_id_to_entry_[sequence_id]];
+}
+
+} // namespace io
+
+} // namespace genomeworks
+
+} // namespace claraparabricks
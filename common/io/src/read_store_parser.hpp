@@ -0,0 +1,90 @@
+/*
+* Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+#pragma once
+
+#include "claragenomics/io/fasta_parser.hpp"
+#include "claragenomics/io/memory_mapped_file.hpp"
+
+#include "per_read_cache.hpp"
+#include "read_store_format.hpp"
+
+#include <string>
+#include <vector>
+
+namespace claraparabricks
+{
+
+namespace genomeworks
+{
+
+namespace io
+{
+
+/// FastaParserReadStore - parser which serves reads directly from a memory-mapped read store file
+///
+/// Nothing is parsed, opening a read store only validates its offset table. As the file is mapped read-only,
+/// all processes using the same read store share one copy of it in the page cache.
+class FastaParserReadStore : public FastaParser
+{
+public:
+    /// \brief Constructor
+    /// \param read_store_file Path to a file written by write_read_store()
+    /// \param min_sequence_length Minimum length a sequence needs to be to be parsed. Shorter sequences are ignored.
+    /// \param shuffle Enables shuffling reads
+    FastaParserReadStore(const std::string& read_store_file,
+                         number_of_basepairs_t min_sequence_length,
+                         bool shuffle);
+
+    /// \brief Return number of sequences in the read store
+    /// \return Sequence count in file
+    number_of_reads_t get_num_seqences() const override;
+
+    /// \brief Fetch an entry from the read store by index position in file.
+    /// The entry is copied out of the mapping on first access and kept for the lifetime of the parser,
+    /// use get_name_view_by_id() and get_sequence_view_by_id() to avoid the copy.
+    /// \param sequence_id Position of sequence in file. If sequence_id is invalid an error is thrown.
+    /// \return A reference to FastaSequence describing the entry.
+    const FastaSequence& get_sequence_by_id(read_id_t sequence_id) const override;
+
+    /// \brief Return the number of basepairs of an entry.
+    /// \param sequence_id Position of sequence in file.
+    /// \return Number of basepairs in the entry.
+    number_of_basepairs_t get_sequence_length_by_id(read_id_t sequence_id) const override;
+
+    /// \brief Fetch the name of an entry without copying it.
+    /// \param sequence_id Position of sequence in file.
+    /// \return A view of the name, valid for the lifetime of the parser.
+    cga_string_view_t get_name_view_by_id(read_id_t sequence_id) const override;
+
+    /// \brief Fetch the basepairs of an entry without copying them.
+    /// \param sequence_id Position of sequence in file.
+    /// \return A view of the basepairs, valid for the lifetime of the parser.
+    cga_string_view_t get_sequence_view_by_id(read_id_t sequence_id) const override;
+
+private:
+    /// \brief returns the entry of a read
+    const read_store::ReadStoreEntry& entry(read_id_t sequence_id) const;
+
+    MemoryMappedFile read_store_file_;
+    const read_store::ReadStoreEntry* entries_;
+    const char* names_;
+    const char* basepairs_;
+    /// for each read_id the corresponding entry in entries_, after filtering and shuffling
+    std::vector<read_id_t> read_id_to_entry_;
+
+    /// entries requested through get_sequence_by_id()
+    PerReadCache<FastaSequence> materialized_sequences_;
+};
+
+} // namespace io
+
+} // namespace genomeworks
+
+} // namespace claraparabricks
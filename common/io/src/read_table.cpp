@@ -0,0 +1,171 @@
+/*
+* Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#include "read_table.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+#include <claragenomics/utils/run_in_parallel.hpp>
+
+namespace claraparabricks
+{
+
+namespace genomeworks
+{
+
+namespace io
+{
+
+read_id_t ReadTable::add_read(const char* const name,
+                              const std::uint32_t name_length,
+                              const char* const basepairs,
+                              const number_of_basepairs_t number_of_basepairs)
+{
+    append_basepairs(basepairs, basepairs + number_of_basepairs);
+    return commit_read(name, name_length);
+}
+
+void ReadTable::append_basepairs(const char* const first,
+                                 const char* const last)
+{
+    basepairs_.insert(std::end(basepairs_), first, last);
+}
+
+std::size_t ReadTable::number_of_pending_basepairs() const
+{
+    return basepairs_.size() - pending_basepairs_begin_;
+}
+
+read_id_t ReadTable::commit_read(const char* const name,
+                                 const std::uint32_t name_length)
+{
+    if (number_of_pending_basepairs() > std::numeric_limits<number_of_basepairs_t>::max())
+    {
+        throw std::invalid_argument("Error: sequence " + std::string(name, name_length) + " is too long !");
+    }
+
+    reads_.push_back({names_.size(),
+                      pending_basepairs_begin_,
+                      name_length,
+                      static_cast<number_of_basepairs_t>(number_of_pending_basepairs())});
+    names_.insert(std::end(names_), name, name + name_length);
+    pending_basepairs_begin_ = basepairs_.size();
+
+    return static_cast<read_id_t>(reads_.size() - 1);
+}
+
+void ReadTable::discard_read()
+{
+    basepairs_.resize(pending_basepairs_begin_);
+}
+
+void ReadTable::reserve_basepairs(const std::size_t number_of_basepairs)
+{
+    basepairs_.reserve(number_of_basepairs);
+}
+
+ReadTable ReadTable::concatenate(std::vector<ReadTable>& tables,
+                                 const std::int32_t number_of_threads)
+{
+    if (tables.size() == 1)
+    {
+        ReadTable table = std::move(tables.front());
+        tables.front()  = ReadTable();
+        return table;
+    }
+
+    std::vector<std::size_t> first_name(tables.size() + 1, 0);
+    std::vector<std::size_t> first_basepair(tables.size() + 1, 0);
+    std::vector<std::size_t> first_read(tables.size() + 1, 0);
+    for (std::size_t table_id = 0; table_id < tables.size(); ++table_id)
+    {
+        first_name[table_id + 1]     = first_name[table_id] + tables[table_id].names_.size();
+        first_basepair[table_id + 1] = first_basepair[table_id] + tables[table_id].pending_basepairs_begin_;
+        first_read[table_id + 1]     = first_read[table_id] + tables[table_id].reads_.size();
+    }
+
+    if (first_read.back() > std::numeric_limits<number_of_reads_t>::max())
+    {
+        throw std::invalid_argument("Error: too many reads !");
+    }
+
+    ReadTable result;
+    result.names_.resize(first_name.back());
+    result.basepairs_.resize(first_basepair.back());
+    result.reads_.resize(first_read.back());
+    result.pending_basepairs_begin_ = result.basepairs_.size();
+
+    run_in_parallel(number_of_threads,
+                    tables.size(),
+                    [&](const std::size_t table_id) {
+                        ReadTable& table = tables[table_id];
+                        std::copy(std::begin(table.names_),
+                                  std::end(table.names_),
+                                  std::next(std::begin(result.names_), first_name[table_id]));
+                        std::copy_n(std::begin(table.basepairs_),
+                                    table.pending_basepairs_begin_,
+                                    std::next(std::begin(result.basepairs_), first_basepair[table_id]));
+                        std::transform(std::begin(table.reads_),
+                                       std::end(table.reads_),
+                                       std::next(std::begin(result.reads_), first_read[table_id]),
+                                       [&](ReadEntry read) {
+                                           read.name_offset += first_name[table_id];
+                                           read.basepairs_offset += first_basepair[table_id];
+                                           return read;
+                                       });
+                        table = ReadTable();
+                    });
+
+    return result;
+}
+
+void ReadTable::shuffle(std::mt19937& generator)
+{
+    std::shuffle(std::begin(reads_), std::end(reads_), generator);
+}
+
+number_of_reads_t ReadTable::number_of_reads() const
+{
+    return static_cast<number_of_reads_t>(reads_.size());
+}
+
+cga_string_view_t ReadTable::name(const read_id_t read_id) const
+{
+    const ReadEntry& read = reads_[read_id];
+    return cga_string_view_t(names_.data() + read.name_offset, read.name_length);
+}
+
+cga_string_view_t ReadTable::basepairs(const read_id_t read_id) const
+{
+    const ReadEntry& read = reads_[read_id];
+    return cga_string_view_t(basepairs_.data() + read.basepairs_offset, read.number_of_basepairs);
+}
+
+number_of_basepairs_t ReadTable::number_of_basepairs(const read_id_t read_id) const
+{
+    return reads_[read_id].number_of_basepairs;
+}
+
+void ReadTable::shrink_to_fit()
+{
+    discard_read();
+    names_.shrink_to_fit();
+    basepairs_.shrink_to_fit();
+    reads_.shrink_to_fit();
+}
+
+} // namespace io
+
+} // namespace genomeworks
+
+} // namespace claraparabricks
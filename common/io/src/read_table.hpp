@@ -0,0 +1,121 @@
+/*
+* Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+#pragma once
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <claragenomics/types.hpp>
+
+namespace claraparabricks
+{
+
+namespace genomeworks
+{
+
+namespace io
+{
+
+/// ReadTable - arena storage for names and basepairs of many reads
+///
+/// All names are stored in one contiguous buffer and all basepairs in another, reads only keep offsets and lengths.
+/// This avoids two heap allocations per read and keeps reads which are next to each other in read_id order close in memory.
+class ReadTable
+{
+public:
+    /// \brief adds a read to the end of the table
+    /// \param name
+    /// \param name_length
+    /// \param basepairs
+    /// \param number_of_basepairs
+    /// \return read_id of the added read
+    read_id_t add_read(const char* name,
+                       std::uint32_t name_length,
+                       const char* basepairs,
+                       number_of_basepairs_t number_of_basepairs);
+
+    /// \brief appends basepairs to the read which is being built, used when basepairs of a read are not contiguous in the input
+    /// \param first first basepair
+    /// \param last past the last basepair
+    void append_basepairs(const char* first,
+                          const char* last);
+
+    /// \brief returns number of basepairs appended since the last read was committed or discarded
+    std::size_t number_of_pending_basepairs() const;
+
+    /// \brief adds the read which is being built to the end of the table
+    /// \param name
+    /// \param name_length
+    /// \throw std::invalid_argument if the read has more basepairs than number_of_basepairs_t can represent
+    /// \return read_id of the added read
+    read_id_t commit_read(const char* name,
+                          std::uint32_t name_length);
+
+    /// \brief drops basepairs of the read which is being built
+    void discard_read();
+
+    /// \brief reserves space for basepairs
+    /// \param number_of_basepairs
+    void reserve_basepairs(std::size_t number_of_basepairs);
+
+    /// \brief concatenates tables, read_ids of the second table follow the read_ids of the first one and so on
+    /// \param tables tables to concatenate, they are emptied
+    /// \param number_of_threads number of threads used to copy the tables
+    /// \return concatenated table
+    static ReadTable concatenate(std::vector<ReadTable>& tables,
+                                 std::int32_t number_of_threads);
+
+    /// \brief shuffles reads, same as shuffling a vector with one element per read
+    /// \param generator
+    void shuffle(std::mt19937& generator);
+
+    /// \brief returns number of reads in the table
+    number_of_reads_t number_of_reads() const;
+
+    /// \brief returns name of a read
+    /// \param read_id
+    /// \return view valid for the lifetime of the table
+    cga_string_view_t name(read_id_t read_id) const;
+
+    /// \brief returns basepairs of a read
+    /// \param read_id
+    /// \return view valid for the lifetime of the table
+    cga_string_view_t basepairs(read_id_t read_id) const;
+
+    /// \brief returns number of basepairs of a read
+    /// \param read_id
+    number_of_basepairs_t number_of_basepairs(read_id_t read_id) const;
+
+    /// \brief releases unused capacity of internal buffers
+    void shrink_to_fit();
+
+private:
+    /// location of one read in names_ and basepairs_
+    struct ReadEntry
+    {
+        std::size_t name_offset;
+        std::size_t basepairs_offset;
+        std::uint32_t name_length;
+        number_of_basepairs_t number_of_basepairs;
+    };
+
+    std::vector<char> names_;
+    std::vector<char> basepairs_;
+    std::vector<ReadEntry> reads_;
+    /// basepairs_[pending_basepairs_begin_, basepairs_.size()) belong to the read which is being built
+    std::size_t pending_basepairs_begin_ = 0;
+};
+
+} // namespace io
+
+} // namespace genomeworks
+
+} // namespace claraparabricks
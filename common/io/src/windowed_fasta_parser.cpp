@@ -0,0 +1,339 @@
+/*
+* Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#include "windowed_fasta_parser.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <iterator>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+
+namespace claraparabricks
+{
+
+namespace genomeworks
+{
+
+namespace io
+{
+
+namespace
+{
+
+/// ranges are loaded by copying from the memory-mapped file, which is limited by the disk rather than by the number of threads
+constexpr std::size_t number_of_loader_threads = 2;
+
+} // namespace
+
+FastaParserWindowed::FastaParserWindowed(const std::string& fasta_file,
+                                         const number_of_basepairs_t min_sequence_length,
+                                         const bool shuffle,
+                                         const std::size_t max_resident_basepairs)
+    : fasta_file_(fasta_file)
+    , max_resident_basepairs_(max_resident_basepairs)
+    , resident_basepairs_(0)
+{
+    if (0 == fasta_file_.size())
+    {
+        throw std::invalid_argument("Error: "
+                                    "non-existent or empty file " +
+                                    fasta_file + " !");
+    }
+
+    if (fasta_file_.size() >= 2 && fasta_file_.data()[0] == '\x1f' && fasta_file_.data()[1] == '\x8b')
+    {
+        throw std::invalid_argument("Error: " + fasta_file + " is compressed, use create_kseq_fasta_parser() for compressed files !");
+    }
+
+    index_ = FastaIndex::load_or_build(fasta_file_, fasta_file + ".fai");
+
+    read_id_to_entry_.reserve(index_.number_of_entries());
+    for (read_id_t entry_id = 0; entry_id < index_.number_of_entries(); ++entry_id)
+    {
+        const FastaIndex::Entry& e = index_.entry(entry_id);
+        if (e.offset + e.length > fasta_file_.size())
+        {
+            throw std::invalid_argument("Error: FASTA index " + fasta_file + ".fai does not match " + fasta_file + " !");
+        }
+        if (e.length >= min_sequence_length)
+        {
+            read_id_to_entry_.push_back(entry_id);
+        }
+    }
+
+    // Same shuffle as FastaParserKseqpp, so both parsers assign the same read_ids
+    if (shuffle)
+    {
+        std::mt19937 g(0); // seed for deterministic behaviour
+        std::shuffle(read_id_to_entry_.begin(), read_id_to_entry_.end(), g);
+    }
+}
+
+FastaParserWindowed::~FastaParserWindowed()
+{
+    {
+        // nobody can wait for ranges which are not resident, loader threads skip those which have not been loaded yet
+        std::lock_guard<std::mutex> lock(mutex_);
+        resident_reads_.clear();
+        resident_ranges_.clear();
+    }
+    ranges_to_load_.signal_pushed_last_element();
+    for (std::thread& loader_thread : loader_threads_)
+    {
+        loader_thread.join();
+    }
+}
+
+number_of_reads_t FastaParserWindowed::get_num_seqences() const
+{
+    return read_id_to_entry_.size();
+}
+
+const FastaSequence& FastaParserWindowed::get_sequence_by_id(const read_id_t sequence_id) const
+{
+    if (sequence_id >= get_num_seqences())
+    {
+        throw std::out_of_range("Error: sequence_id " + std::to_string(sequence_id) + " is out of range !");
+    }
+
+    // a reference into a resident range would dangle once the range is evicted, e.g. by a prefetch on another thread
+    return materialized_sequences_.get_or_create(sequence_id, [this, sequence_id]() {
+        const cga_string_view_t name = get_name_view_by_id(sequence_id);
+        FastaSequence sequence{std::string(name.data(), name.size()),
+                               std::string(get_sequence_length_by_id(sequence_id), '\0')};
+        copy_sequence_by_id(sequence_id, 0, sequence.seq.size(), &sequence.seq[0]);
+        return sequence;
+    });
+}
+
+number_of_basepairs_t FastaParserWindowed::get_sequence_length_by_id(const read_id_t sequence_id) const
+{
+    return entry(sequence_id).length;
+}
+
+cga_string_view_t FastaParserWindowed::get_name_view_by_id(const read_id_t sequence_id) const
+{
+    return index_.name(read_id_to_entry_.at(sequence_id));
+}
+
+cga_string_view_t FastaParserWindowed::get_sequence_view_by_id(const read_id_t sequence_id) const
+{
+    return get_sequence_by_id(sequence_id).seq;
+}
+
+void FastaParserWindowed::copy_sequence_by_id(const read_id_t sequence_id,
+                                              const position_in_read_t first_basepair,
+                                              const number_of_basepairs_t number_of_basepairs,
+                                              char* const destination) const
+{
+    assert(static_cast<std::size_t>(first_basepair) + number_of_basepairs <= get_sequence_length_by_id(sequence_id));
+
+    // the range stays alive while being copied from even if it gets evicted meanwhile
+    std::shared_ptr<const ResidentRange> range;
+    number_of_reads_t position_in_range = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto read = resident_reads_.find(sequence_id);
+        if (read != std::end(resident_reads_))
+        {
+            resident_ranges_.splice(std::begin(resident_ranges_), resident_ranges_, read->second.range);
+            range             = *read->second.range;
+            position_in_range = read->second.position_in_range;
+        }
+    }
+
+    if (range)
+    {
+        // waits if the range is still being loaded, rethrows if loading failed
+        range->loaded.get();
+        std::copy_n(range->basepairs.data() + range->basepair_offsets[position_in_range] + first_basepair,
+                    number_of_basepairs,
+                    destination);
+    }
+    else
+    {
+        copy_from_file(entry(sequence_id), first_basepair, number_of_basepairs, destination);
+    }
+}
+
+void FastaParserWindowed::prefetch_sequences(const read_id_t first_sequence_id,
+                                             const number_of_reads_t number_of_sequences) const
+{
+    if (0 == number_of_sequences)
+    {
+        return;
+    }
+    if (static_cast<std::size_t>(first_sequence_id) + number_of_sequences > get_num_seqences())
+    {
+        throw std::out_of_range("Error: sequence range " + std::to_string(first_sequence_id) + " + " + std::to_string(number_of_sequences) + " is out of range !");
+    }
+
+    std::vector<read_id_t> read_ids(number_of_sequences);
+    std::iota(std::begin(read_ids), std::end(read_ids), first_sequence_id);
+    add_range(std::move(read_ids));
+}
+
+void FastaParserWindowed::prefetch_sequences_by_ids(const std::vector<read_id_t>& sequence_ids) const
+{
+    if (sequence_ids.empty())
+    {
+        return;
+    }
+
+    std::vector<read_id_t> read_ids(sequence_ids);
+    std::sort(std::begin(read_ids), std::end(read_ids));
+    read_ids.erase(std::unique(std::begin(read_ids), std::end(read_ids)), std::end(read_ids));
+    if (read_ids.back() >= get_num_seqences())
+    {
+        throw std::out_of_range("Error: sequence_id " + std::to_string(read_ids.back()) + " is out of range !");
+    }
+
+    add_range(std::move(read_ids));
+}
+
+const FastaIndex::Entry& FastaParserWindowed::entry(const read_id_t sequence_id) const
+{
+    return index_.entry(read_id_to_entry_.at(sequence_id));
+}
+
+void FastaParserWindowed::copy_from_file(const FastaIndex::Entry& e,
+                                         const position_in_read_t first_basepair,
+                                         const number_of_basepairs_t number_of_basepairs,
+                                         char* const destination) const
+{
+    const char* const file_end = fasta_file_.data() + fasta_file_.size();
+
+    // go through the sequence line by line, skipping lines before first_basepair
+    std::size_t basepairs_before_line = 0;
+    std::size_t copied_basepairs      = 0;
+    for (const char* line = fasta_file_.data() + e.offset; line < file_end && copied_basepairs < number_of_basepairs;)
+    {
+        const char* newline         = static_cast<const char*>(std::memchr(line, '\n', file_end - line));
+        const char* const next_line = (nullptr != newline) ? newline + 1 : file_end;
+        const char* line_end        = (nullptr != newline) ? newline : file_end;
+        if (line_end > line && *(line_end - 1) == '\r')
+        {
+            --line_end;
+        }
+
+        const std::size_t line_basepairs = line_end - line;
+        const std::size_t first_in_line  = std::max(static_cast<std::size_t>(first_basepair) + copied_basepairs, basepairs_before_line) - basepairs_before_line;
+        if (first_in_line < line_basepairs)
+        {
+            const std::size_t to_copy = std::min(line_basepairs - first_in_line, number_of_basepairs - copied_basepairs);
+            std::copy_n(line + first_in_line, to_copy, destination + copied_basepairs);
+            copied_basepairs += to_copy;
+        }
+        basepairs_before_line += line_basepairs;
+        line = next_line;
+    }
+
+    if (copied_basepairs != number_of_basepairs)
+    {
+        throw std::invalid_argument("Error: FASTA index " + fasta_file_.path() + ".fai does not match " + fasta_file_.path() + " !");
+    }
+}
+
+void FastaParserWindowed::add_range(std::vector<read_id_t> read_ids) const
+{
+    assert(std::is_sorted(std::begin(read_ids), std::end(read_ids)));
+
+    // evicted ranges are destroyed after mutex_ has been released
+    std::vector<std::shared_ptr<ResidentRange>> evicted_ranges;
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // the same range is resident if all reads are in it and it has no other reads
+    const auto first_read = resident_reads_.find(read_ids.front());
+    if (first_read != std::end(resident_reads_) && (*first_read->second.range)->read_ids == read_ids)
+    {
+        resident_ranges_.splice(std::begin(resident_ranges_), resident_ranges_, first_read->second.range);
+        return;
+    }
+
+    auto range = std::make_shared<ResidentRange>();
+    range->basepair_offsets.reserve(read_ids.size() + 1);
+    range->basepair_offsets.push_back(0);
+    for (const read_id_t read_id : read_ids)
+    {
+        range->basepair_offsets.push_back(range->basepair_offsets.back() + get_sequence_length_by_id(read_id));
+    }
+    range->read_ids = std::move(read_ids);
+    range->loaded   = range->loaded_promise.get_future().share();
+
+    resident_basepairs_ += range->basepair_offsets.back();
+    resident_ranges_.push_front(range);
+    for (number_of_reads_t i = 0; i < range->read_ids.size(); ++i)
+    {
+        resident_reads_[range->read_ids[i]] = {std::begin(resident_ranges_), i};
+    }
+
+    // the new range is never evicted, even if it is larger than the limit on its own
+    while (resident_basepairs_ > max_resident_basepairs_ && resident_ranges_.size() > 1)
+    {
+        const auto evicted_range = std::prev(std::end(resident_ranges_));
+        for (const read_id_t read_id : (*evicted_range)->read_ids)
+        {
+            // reads which have been added again with a newer range stay resident
+            const auto read = resident_reads_.find(read_id);
+            if (read != std::end(resident_reads_) && read->second.range == evicted_range)
+            {
+                resident_reads_.erase(read);
+            }
+        }
+        resident_basepairs_ -= (*evicted_range)->basepair_offsets.back();
+        evicted_ranges.push_back(std::move(*evicted_range));
+        resident_ranges_.erase(evicted_range);
+    }
+
+    if (loader_threads_.empty())
+    {
+        for (std::size_t i = 0; i < number_of_loader_threads; ++i)
+        {
+            loader_threads_.emplace_back(&FastaParserWindowed::load_ranges, this);
+        }
+    }
+    ranges_to_load_.add_new_element(std::move(range));
+}
+
+void FastaParserWindowed::load_ranges() const
+{
+    while (cga_optional_t<std::shared_ptr<ResidentRange>> range = ranges_to_load_.get_next_element())
+    {
+        ResidentRange& r = *range.value();
+        // only the queue held the range, so it has been evicted and nobody can wait for it anymore
+        if (range.value().use_count() == 1)
+        {
+            continue;
+        }
+        try
+        {
+            r.basepairs.resize(r.basepair_offsets.back());
+            for (std::size_t i = 0; i < r.read_ids.size(); ++i)
+            {
+                const FastaIndex::Entry& e = entry(r.read_ids[i]);
+                copy_from_file(e, 0, e.length, r.basepairs.data() + r.basepair_offsets[i]);
+            }
+            r.loaded_promise.set_value();
+        }
+        catch (...)
+        {
+            r.loaded_promise.set_exception(std::current_exception());
+        }
+    }
+}
+
+} // namespace io
+
+} // namespace genomeworks
+
+} // namespace claraparabricks
@@ -0,0 +1,176 @@
+/*
+* Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+#pragma once
+
+#include "claragenomics/io/fasta_parser.hpp"
+#include "claragenomics/io/memory_mapped_file.hpp"
+
+#include "fasta_index.hpp"
+#include "per_read_cache.hpp"
+
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <claragenomics/utils/threadsafe_containers.hpp>
+
+namespace claraparabricks
+{
+
+namespace genomeworks
+{
+
+namespace io
+{
+
+/// FastaParserWindowed - FASTA parser which keeps only a bounded number of basepairs in host memory
+///
+/// Only the .fai index and the names are always in host memory. Basepairs are loaded in ranges of reads through
+/// prefetch_sequences() and prefetch_sequences_by_ids(), reads which are not resident are copied directly from the file.
+/// Ranges are loaded in the background by a small pool of threads, started on first prefetch.
+/// Resident ranges are evicted in least recently used order once they hold more than max_resident_basepairs.
+/// Reads requested through get_sequence_by_id() or get_sequence_view_by_id() are copied out of the ranges and kept
+/// for the lifetime of the parser, so that references to them stay valid when ranges are evicted.
+class FastaParserWindowed : public FastaParser
+{
+public:
+    /// \brief Constructor
+    /// \param fasta_file Path to uncompressed FASTA file. Index is read from or written to <fasta_file>.fai
+    /// \param min_sequence_length Minimum length a sequence needs to be to be parsed. Shorter sequences are ignored.
+    /// \param shuffle Enables shuffling reads
+    /// \param max_resident_basepairs Number of basepairs above which least recently used ranges are evicted
+    FastaParserWindowed(const std::string& fasta_file,
+                        number_of_basepairs_t min_sequence_length,
+                        bool shuffle,
+                        std::size_t max_resident_basepairs);
+
+    /// \brief Destructor, waits for the ranges which are being loaded
+    ~FastaParserWindowed() override;
+
+    /// \brief Return number of sequences in FASTA file
+    /// \return Sequence count in file
+    number_of_reads_t get_num_seqences() const override;
+
+    /// \brief Fetch an entry from the FASTA file by index position in file.
+    /// The entry is copied on first access and kept, independently of max_resident_basepairs.
+    /// \param sequence_id Position of sequence in file. If sequence_id is invalid an error is thrown.
+    /// \return A reference to FastaSequence describing the entry, valid for the lifetime of the parser.
+    const FastaSequence& get_sequence_by_id(read_id_t sequence_id) const override;
+
+    /// \brief Return the number of basepairs of an entry.
+    /// \param sequence_id Position of sequence in file.
+    /// \return Number of basepairs in the entry.
+    number_of_basepairs_t get_sequence_length_by_id(read_id_t sequence_id) const override;
+
+    /// \brief Fetch the name of an entry without copying it.
+    /// \param sequence_id Position of sequence in file.
+    /// \return A view of the name, valid for the lifetime of the parser.
+    cga_string_view_t get_name_view_by_id(read_id_t sequence_id) const override;
+
+    /// \brief Fetch the basepairs of an entry.
+    /// Like get_sequence_by_id() the entry is copied on first access and kept.
+    /// \param sequence_id Position of sequence in file.
+    /// \return A view of the basepairs, valid for the lifetime of the parser.
+    cga_string_view_t get_sequence_view_by_id(read_id_t sequence_id) const override;
+
+    /// \brief Copy a section of the basepairs of an entry into a buffer owned by the caller.
+    /// Basepairs are copied from the resident range containing the entry, or directly from the file if there is none.
+    /// Nothing is kept after the call.
+    /// \param sequence_id Position of sequence in file.
+    /// \param first_basepair First basepair to copy.
+    /// \param number_of_basepairs Number of basepairs to copy, section must not go past the end of the entry.
+    /// \param destination Buffer with space for at least number_of_basepairs characters. No null-terminator is written.
+    void copy_sequence_by_id(read_id_t sequence_id,
+                             position_in_read_t first_basepair,
+                             number_of_basepairs_t number_of_basepairs,
+                             char* destination) const override;
+
+    /// \brief Starts loading a range of entries in the background and marks it as most recently used.
+    /// \param first_sequence_id First entry in the range.
+    /// \param number_of_sequences Number of entries in the range.
+    void prefetch_sequences(read_id_t first_sequence_id,
+                            number_of_reads_t number_of_sequences) const override;
+
+    /// \brief Starts loading the given entries in the background as one range and marks it as most recently used.
+    /// \param sequence_ids Entries in the range, in any order.
+    void prefetch_sequences_by_ids(const std::vector<read_id_t>& sequence_ids) const override;
+
+private:
+    /// ResidentRange - basepairs of a set of reads, loaded in the background
+    struct ResidentRange
+    {
+        /// sorted read_ids of the reads in the range
+        std::vector<read_id_t> read_ids;
+        /// basepairs of read_ids[i] are basepairs[basepair_offsets[i], basepair_offsets[i + 1])
+        std::vector<std::size_t> basepair_offsets;
+        /// filled by a loader thread, only to be accessed after loaded is ready
+        std::vector<char> basepairs;
+        std::promise<void> loaded_promise;
+        std::shared_future<void> loaded;
+    };
+
+    using ResidentRanges = std::list<std::shared_ptr<ResidentRange>>;
+
+    /// ResidentRead - position of a resident read
+    struct ResidentRead
+    {
+        ResidentRanges::iterator range;
+        number_of_reads_t position_in_range;
+    };
+
+    /// \brief returns the index entry of a read
+    const FastaIndex::Entry& entry(read_id_t sequence_id) const;
+
+    /// \brief copies basepairs of an index entry from the file, skipping line breaks
+    void copy_from_file(const FastaIndex::Entry& e,
+                        position_in_read_t first_basepair,
+                        number_of_basepairs_t number_of_basepairs,
+                        char* destination) const;
+
+    /// \brief adds a range as most recently used range, unless the same range is already resident, and evicts ranges over the limit
+    /// \param read_ids sorted read_ids without duplicates
+    void add_range(std::vector<read_id_t> read_ids) const;
+
+    /// \brief loads ranges from ranges_to_load_ until it is empty and no more ranges are going to be added
+    void load_ranges() const;
+
+    MemoryMappedFile fasta_file_;
+    FastaIndex index_;
+    /// for each read_id the corresponding entry in index_, after filtering and shuffling
+    std::vector<read_id_t> read_id_to_entry_;
+
+    std::size_t max_resident_basepairs_;
+
+    /// entries requested through get_sequence_by_id() or get_sequence_view_by_id()
+    PerReadCache<FastaSequence> materialized_sequences_;
+
+    mutable std::mutex mutex_;
+    /// resident ranges, most recently used first
+    mutable ResidentRanges resident_ranges_;
+    mutable std::size_t resident_basepairs_;
+    /// position of every read in the range it was last added with, used instead of searching resident_ranges_
+    mutable std::unordered_map<read_id_t, ResidentRead> resident_reads_;
+
+    /// ranges which are waiting for a loader thread
+    mutable ThreadsafeProducerConsumer<std::shared_ptr<ResidentRange>> ranges_to_load_;
+    /// started on first prefetch
+    mutable std::vector<std::thread> loader_threads_;
+};
+
+} // namespace io
+
+} // namespace genomeworks
+
+} // namespace claraparabricks
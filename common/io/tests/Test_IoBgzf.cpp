@@ -0,0 +1,94 @@
+/*
+* Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#include "gtest/gtest.h"
+
+#include "../src/bgzf.hpp"
+
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace claraparabricks
+{
+
+namespace genomeworks
+{
+
+namespace io
+{
+
+namespace
+{
+
+std::vector<char> generate_data(const std::size_t size)
+{
+    std::minstd_rand rng(1);
+    std::uniform_int_distribution<std::int32_t> character('A', 'Z');
+    std::vector<char> data(size);
+    for (char& c : data)
+    {
+        c = static_cast<char>(character(rng));
+    }
+    return data;
+}
+
+} // namespace
+
+TEST(TestIoBgzf, test_round_trip)
+{
+    // empty, single byte, exactly one block and several blocks with a partial last one
+    for (const std::size_t size : {0, 1, 0xff00, 3 * 0xff00 + 17, 200 * 0xff00})
+    {
+        const std::vector<char> data       = generate_data(size);
+        const std::vector<char> compressed = deflate_bgzf(data.data(), data.size());
+        ASSERT_TRUE(is_bgzf(compressed.data(), compressed.size())) << "size: " << size;
+        for (const std::int32_t number_of_threads : {1, 3})
+        {
+            const std::vector<char> inflated = inflate_bgzf(compressed.data(), compressed.size(), "test", number_of_threads);
+            ASSERT_EQ(inflated, data) << "size: " << size << ", number_of_threads: " << number_of_threads;
+        }
+    }
+}
+
+TEST(TestIoBgzf, test_not_bgzf)
+{
+    // plain gzip header without extra field
+    const std::vector<char> gzip_header = {'\x1f', '\x8b', 8, 0, 0, 0, 0, 0, 0, '\xff', 3, 0};
+    EXPECT_FALSE(is_bgzf(gzip_header.data(), gzip_header.size()));
+    EXPECT_THROW(inflate_bgzf(gzip_header.data(), gzip_header.size(), "test", 1), std::invalid_argument);
+
+    const std::string text = ">read_0\nACGT\n";
+    EXPECT_FALSE(is_bgzf(text.data(), text.size()));
+}
+
+TEST(TestIoBgzf, test_truncated)
+{
+    const std::vector<char> data       = generate_data(3 * 0xff00);
+    const std::vector<char> compressed = deflate_bgzf(data.data(), data.size());
+    EXPECT_THROW(inflate_bgzf(compressed.data(), compressed.size() - 1, "test", 1), std::invalid_argument);
+}
+
+TEST(TestIoBgzf, test_corrupted)
+{
+    const std::vector<char> data = generate_data(3 * 0xff00);
+    std::vector<char> compressed = deflate_bgzf(data.data(), data.size());
+    // last byte of the CRC of the first block
+    const std::size_t first_block_size = static_cast<unsigned char>(compressed[16]) + (static_cast<unsigned char>(compressed[17]) << 8) + 1;
+    compressed[first_block_size - 5] ^= 1;
+    EXPECT_THROW(inflate_bgzf(compressed.data(), compressed.size(), "test", 3), std::invalid_argument);
+}
+
+} // namespace io
+
+} // namespace genomeworks
+
+} // namespace claraparabricks
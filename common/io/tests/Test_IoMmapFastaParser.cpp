@@ -0,0 +1,223 @@
+/*
+* Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#include "gtest/gtest.h"
+
+#include "../src/fasta_index.hpp"
+#include "../src/mmap_fasta_parser.hpp"
+
+#include <claragenomics/io/fasta_parser.hpp>
+#include <claragenomics/io/memory_mapped_file.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace claraparabricks
+{
+
+namespace genomeworks
+{
+
+namespace io
+{
+
+namespace
+{
+
+std::string write_test_file(const std::string& file_name, const std::string& content)
+{
+    const std::string file_path = ::testing::TempDir() + file_name;
+    std::ofstream file(file_path, std::ios::binary);
+    file << content;
+    std::remove((file_path + ".fai").c_str());
+    return file_path;
+}
+
+const std::string multiline_fasta = ">read_0 some description\n"
+                                    "ACGTA\n"
+                                    "CGTAC\n"
+                                    "GT\n"
+                                    ">read_1\n"
+                                    "AC\n"
+                                    ">read_2\r\n"
+                                    "ACGT\r\n"
+                                    "TTGG\r\n"
+                                    ">read_3\n"
+                                    "ACGTACGTAC\n";
+
+} // namespace
+
+TEST(TestIoFastaIndex, test_build_index)
+{
+    const FastaIndex index = FastaIndex::build(multiline_fasta.data(), multiline_fasta.size(), "multiline.fasta");
+
+    ASSERT_EQ(index.number_of_entries(), 4u);
+
+    ASSERT_EQ(index.name(0), "read_0");
+    ASSERT_EQ(index.entry(0).length, 12u);
+    ASSERT_EQ(index.entry(0).offset, 25u);
+    ASSERT_EQ(index.entry(0).line_bases, 5u);
+    ASSERT_EQ(index.entry(0).line_width, 6u);
+
+    ASSERT_EQ(index.name(1), "read_1");
+    ASSERT_EQ(index.entry(1).length, 2u);
+
+    ASSERT_EQ(index.name(2), "read_2");
+    ASSERT_EQ(index.entry(2).length, 8u);
+    ASSERT_EQ(index.entry(2).line_bases, 4u);
+    ASSERT_EQ(index.entry(2).line_width, 6u);
+
+    ASSERT_EQ(index.name(3), "read_3");
+    ASSERT_EQ(index.entry(3).length, 10u);
+}
+
+TEST(TestIoFastaIndex, test_save_and_load_index)
+{
+    const FastaIndex built_index = FastaIndex::build(multiline_fasta.data(), multiline_fasta.size(), "multiline.fasta");
+    const std::string fai_path   = ::testing::TempDir() + "test_save_and_load_index.fai";
+    ASSERT_TRUE(built_index.save(fai_path));
+
+    const FastaIndex loaded_index = FastaIndex::load(fai_path);
+    ASSERT_EQ(loaded_index.number_of_entries(), built_index.number_of_entries());
+    for (read_id_t i = 0; i < built_index.number_of_entries(); ++i)
+    {
+        ASSERT_EQ(loaded_index.name(i), built_index.name(i)) << "i: " << i;
+        ASSERT_EQ(loaded_index.entry(i).length, built_index.entry(i).length) << "i: " << i;
+        ASSERT_EQ(loaded_index.entry(i).offset, built_index.entry(i).offset) << "i: " << i;
+        ASSERT_EQ(loaded_index.entry(i).line_bases, built_index.entry(i).line_bases) << "i: " << i;
+        ASSERT_EQ(loaded_index.entry(i).line_width, built_index.entry(i).line_width) << "i: " << i;
+    }
+}
+
+TEST(TestIoFastaIndex, test_build_index_not_fasta)
+{
+    const std::string fastq = "@read_0\nACGT\n+\n!!!!\n";
+    ASSERT_THROW(FastaIndex::build(fastq.data(), fastq.size(), "reads.fastq"), std::invalid_argument);
+}
+
+TEST(TestIoMmapFastaParser, test_sequences_no_shuffle)
+{
+    const std::string fasta_path = write_test_file("test_sequences_no_shuffle.fasta", multiline_fasta);
+
+    std::unique_ptr<FastaParser> parser = create_mmap_fasta_parser(fasta_path, 0, false);
+
+    ASSERT_EQ(parser->get_num_seqences(), 4u);
+
+    ASSERT_EQ(parser->get_name_view_by_id(0), "read_0");
+    ASSERT_EQ(parser->get_sequence_view_by_id(0), "ACGTACGTACGT");
+    ASSERT_EQ(parser->get_sequence_length_by_id(0), 12u);
+
+    ASSERT_EQ(parser->get_name_view_by_id(1), "read_1");
+    ASSERT_EQ(parser->get_sequence_view_by_id(1), "AC");
+
+    ASSERT_EQ(parser->get_name_view_by_id(2), "read_2");
+    ASSERT_EQ(parser->get_sequence_view_by_id(2), "ACGTTTGG");
+
+    ASSERT_EQ(parser->get_name_view_by_id(3), "read_3");
+    ASSERT_EQ(parser->get_sequence_view_by_id(3), "ACGTACGTAC");
+
+    const FastaSequence& read_2 = parser->get_sequence_by_id(2);
+    ASSERT_EQ(read_2.name, "read_2");
+    ASSERT_EQ(read_2.seq, "ACGTTTGG");
+    // the same object is returned every time
+    ASSERT_EQ(&read_2, &parser->get_sequence_by_id(2));
+}
+
+TEST(TestIoMmapFastaParser, test_copy_sequence_does_not_join_lines)
+{
+    const std::string fasta_path = write_test_file("test_copy_sequence_does_not_join_lines.fasta", multiline_fasta);
+
+    const FastaParserMmap parser(fasta_path, 0, false);
+
+    const std::vector<std::string> expected_sequences = {"ACGTACGTACGT", "AC", "ACGTTTGG", "ACGTACGTAC"};
+    for (read_id_t read_id = 0; read_id < expected_sequences.size(); ++read_id)
+    {
+        const std::string& expected_sequence = expected_sequences[read_id];
+        // every section, including ones starting or ending at line breaks
+        for (std::size_t first_basepair = 0; first_basepair <= expected_sequence.size(); ++first_basepair)
+        {
+            for (std::size_t number_of_basepairs = 0; first_basepair + number_of_basepairs <= expected_sequence.size(); ++number_of_basepairs)
+            {
+                std::string section(number_of_basepairs, '\0');
+                parser.copy_sequence_by_id(read_id, first_basepair, number_of_basepairs, &section[0]);
+                ASSERT_EQ(section, expected_sequence.substr(first_basepair, number_of_basepairs)) << "read_id: " << read_id << ", first_basepair: " << first_basepair;
+            }
+        }
+    }
+
+    ASSERT_EQ(parser.number_of_joined_sequences(), 0u);
+    ASSERT_EQ(parser.get_sequence_view_by_id(0), expected_sequences[0]);
+    ASSERT_EQ(parser.number_of_joined_sequences(), 1u);
+}
+
+TEST(TestIoMmapFastaParser, test_min_sequence_length)
+{
+    const std::string fasta_path = write_test_file("test_min_sequence_length.fasta", multiline_fasta);
+
+    std::unique_ptr<FastaParser> parser = create_mmap_fasta_parser(fasta_path, 8, false);
+
+    ASSERT_EQ(parser->get_num_seqences(), 3u);
+    ASSERT_EQ(parser->get_name_view_by_id(0), "read_0");
+    ASSERT_EQ(parser->get_name_view_by_id(1), "read_2");
+    ASSERT_EQ(parser->get_name_view_by_id(2), "read_3");
+}
+
+TEST(TestIoMmapFastaParser, test_index_is_saved_and_reused)
+{
+    const std::string fasta_path = write_test_file("test_index_is_saved_and_reused.fasta", multiline_fasta);
+
+    {
+        std::unique_ptr<FastaParser> parser = create_mmap_fasta_parser(fasta_path, 0, false);
+    }
+    std::ifstream fai_file(fasta_path + ".fai");
+    ASSERT_TRUE(static_cast<bool>(fai_file));
+
+    std::unique_ptr<FastaParser> parser = create_mmap_fasta_parser(fasta_path, 0, false);
+    ASSERT_EQ(parser->get_num_seqences(), 4u);
+    ASSERT_EQ(parser->get_sequence_view_by_id(2), "ACGTTTGG");
+}
+
+TEST(TestIoMmapFastaParser, test_shuffle_keeps_all_reads)
+{
+    const std::string fasta_path = write_test_file("test_shuffle_keeps_all_reads.fasta", multiline_fasta);
+
+    std::unique_ptr<FastaParser> parser = create_mmap_fasta_parser(fasta_path, 0, true);
+
+    ASSERT_EQ(parser->get_num_seqences(), 4u);
+    std::vector<std::string> names;
+    for (read_id_t i = 0; i < parser->get_num_seqences(); ++i)
+    {
+        const cga_string_view_t name = parser->get_name_view_by_id(i);
+        names.emplace_back(name.data(), name.size());
+        ASSERT_EQ(parser->get_sequence_length_by_id(i), parser->get_sequence_by_id(i).seq.size());
+    }
+    std::sort(std::begin(names), std::end(names));
+    ASSERT_EQ(names, (std::vector<std::string>{"read_0", "read_1", "read_2", "read_3"}));
+}
+
+TEST(TestIoMmapFastaParser, test_empty_file)
+{
+    const std::string fasta_path = write_test_file("test_empty_file.fasta", "");
+    ASSERT_THROW(create_mmap_fasta_parser(fasta_path), std::invalid_argument);
+}
+
+TEST(TestIoMmapFastaParser, test_non_existent_file)
+{
+    ASSERT_THROW(create_mmap_fasta_parser(::testing::TempDir() + "this_file_does_not_exist.fasta"), std::invalid_argument);
+}
+
+} // namespace io
+
+} // namespace genomeworks
+
+} // namespace claraparabricks
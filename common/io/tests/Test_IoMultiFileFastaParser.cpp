@@ -0,0 +1,154 @@
+/*
+* Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#include "gtest/gtest.h"
+
+#include <claragenomics/io/fasta_parser.hpp>
+#include <claragenomics/utils/genomeutils.hpp>
+
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace claraparabricks
+{
+
+namespace genomeworks
+{
+
+namespace io
+{
+
+namespace
+{
+
+/// \brief splits random reads into several files and also writes all of them into one file
+/// Files without reads get one read with a single basepair, as parsers do not accept empty files
+/// \return paths of the split files, path of the file with all reads is returned in concatenated_path
+std::vector<std::string> write_split_files(const std::string& file_name,
+                                           const std::vector<std::int32_t>& reads_per_file,
+                                           std::string& concatenated_path)
+{
+    concatenated_path = ::testing::TempDir() + file_name + ".fasta";
+    std::ofstream concatenated_file(concatenated_path);
+    std::vector<std::string> file_paths;
+    std::minstd_rand rng(1);
+    std::uniform_int_distribution<std::int32_t> read_length(2, 1000);
+    std::int32_t read_number = 0;
+    for (std::size_t file_id = 0; file_id < reads_per_file.size(); ++file_id)
+    {
+        file_paths.push_back(::testing::TempDir() + file_name + "_" + std::to_string(file_id) + ".fasta");
+        std::ofstream file(file_paths.back());
+        if (0 == reads_per_file[file_id])
+        {
+            file << ">filtered_out\nA\n";
+            concatenated_file << ">filtered_out\nA\n";
+        }
+        for (std::int32_t i = 0; i < reads_per_file[file_id]; ++i, ++read_number)
+        {
+            const std::string record = ">read_" + std::to_string(read_number) + "\n" + genomeutils::generate_random_genome(read_length(rng), rng) + "\n";
+            file << record;
+            concatenated_file << record;
+        }
+    }
+    return file_paths;
+}
+
+void check_same_reads(const FastaParser& expected_parser,
+                      const FastaParser& parser)
+{
+    ASSERT_EQ(parser.get_num_seqences(), expected_parser.get_num_seqences());
+    for (read_id_t i = 0; i < expected_parser.get_num_seqences(); ++i)
+    {
+        const FastaSequence& expected = expected_parser.get_sequence_by_id(i);
+        ASSERT_EQ(parser.get_name_view_by_id(i), expected.name) << "i: " << i;
+        ASSERT_EQ(parser.get_sequence_view_by_id(i), expected.seq) << "i: " << i;
+        ASSERT_EQ(parser.get_sequence_length_by_id(i), expected.seq.size()) << "i: " << i;
+        ASSERT_EQ(parser.get_sequence_by_id(i).seq, expected.seq) << "i: " << i;
+        std::string copied(expected.seq.size(), ' ');
+        parser.copy_sequence_by_id(i, 0, copied.size(), &copied[0]);
+        ASSERT_EQ(copied, expected.seq) << "i: " << i;
+    }
+}
+
+} // namespace
+
+TEST(TestIoMultiFileFastaParser, test_same_as_concatenated_file)
+{
+    std::string concatenated_path;
+    const std::vector<std::string> file_paths = write_split_files("test_same_as_concatenated_file", {100, 1, 0, 250, 37}, concatenated_path);
+
+    const auto create_file_parser = [](const std::string& file_path) {
+        return create_kseq_fasta_parser(file_path, 100, false);
+    };
+
+    for (const std::int32_t number_of_threads : {1, 3})
+    {
+        std::unique_ptr<FastaParser> parser = create_multi_file_fasta_parser(file_paths, create_file_parser, number_of_threads);
+        check_same_reads(*create_kseq_fasta_parser(concatenated_path, 100, false), *parser);
+
+        // shuffling on top of the concatenation gives the same read_ids as shuffling the concatenated file
+        parser = create_ordered_fasta_parser(std::move(parser), ReadOrdering::random);
+        check_same_reads(*create_kseq_fasta_parser(concatenated_path, 100, true), *parser);
+    }
+}
+
+TEST(TestIoMultiFileFastaParser, test_prefetch_and_out_of_range)
+{
+    std::string concatenated_path;
+    const std::vector<std::string> file_paths = write_split_files("test_prefetch_and_out_of_range", {10, 0, 10}, concatenated_path);
+
+    std::unique_ptr<FastaParser> parser = create_multi_file_fasta_parser(file_paths,
+                                                                         [](const std::string& file_path) {
+                                                                             return create_windowed_fasta_parser(file_path, 2, false, 1000);
+                                                                         });
+    ASSERT_EQ(parser->get_num_seqences(), 20u);
+    parser->prefetch_sequences(5, 10);
+    parser->prefetch_sequences(20, 0);
+    ASSERT_EQ(parser->get_name_view_by_id(15), "read_15");
+    ASSERT_THROW(parser->prefetch_sequences(15, 6), std::out_of_range);
+    ASSERT_THROW(parser->get_sequence_by_id(20), std::out_of_range);
+
+    // set of reads from both non-empty files
+    const std::unique_ptr<FastaParser> concatenated_parser = create_kseq_fasta_parser(concatenated_path, 2, false);
+    const std::vector<read_id_t> read_ids                  = {17, 3, 12, 4, 19, 0};
+    parser->prefetch_sequences_by_ids(read_ids);
+    for (const read_id_t read_id : read_ids)
+    {
+        const std::string& expected = concatenated_parser->get_sequence_by_id(read_id).seq;
+        std::string copy(expected.size(), '\0');
+        parser->copy_sequence_by_id(read_id, 0, expected.size(), &copy[0]);
+        ASSERT_EQ(copy, expected) << "read_id: " << read_id;
+    }
+    ASSERT_THROW(parser->prefetch_sequences_by_ids({3, 20}), std::out_of_range);
+}
+
+TEST(TestIoMultiFileFastaParser, test_read_file_of_filenames)
+{
+    const std::string fofn_path = ::testing::TempDir() + "test_read_file_of_filenames.fofn";
+    std::ofstream(fofn_path) << "# shards\nfirst.fasta\r\n\n  /data/second.fastq.gz  \n";
+
+    const std::vector<std::string> filenames = read_file_of_filenames(fofn_path);
+    ASSERT_EQ(filenames.size(), 2u);
+    ASSERT_EQ(filenames[0], ::testing::TempDir() + "first.fasta");
+    ASSERT_EQ(filenames[1], "/data/second.fastq.gz");
+
+    const std::string empty_fofn_path = ::testing::TempDir() + "test_read_file_of_filenames_empty.fofn";
+    std::ofstream(empty_fofn_path) << "# no files\n";
+    ASSERT_THROW(read_file_of_filenames(empty_fofn_path), std::invalid_argument);
+    ASSERT_THROW(read_file_of_filenames(::testing::TempDir() + "non_existent.fofn"), std::invalid_argument);
+}
+
+} // namespace io
+
+} // namespace genomeworks
+
+} // namespace claraparabricks
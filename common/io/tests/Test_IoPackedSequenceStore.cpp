@@ -0,0 +1,204 @@
+/*
+* Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#include "gtest/gtest.h"
+
+#include <claragenomics/io/fasta_parser.hpp>
+#include <claragenomics/io/packed_sequence_store.hpp>
+#include <claragenomics/utils/genomeutils.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace claraparabricks
+{
+
+namespace genomeworks
+{
+
+namespace io
+{
+
+namespace
+{
+
+std::string decode_section(const PackedSequenceStore& store,
+                           const read_id_t sequence_id,
+                           const position_in_read_t first_basepair,
+                           const number_of_basepairs_t number_of_basepairs)
+{
+    std::string decoded(number_of_basepairs, '\0');
+    store.decode(sequence_id, first_basepair, number_of_basepairs, &decoded[0]);
+    return decoded;
+}
+
+std::string decode_all(const PackedSequenceStore& store,
+                       const read_id_t sequence_id)
+{
+    return decode_section(store, sequence_id, 0, store.sequence_length(sequence_id));
+}
+
+} // namespace
+
+TEST(TestIoPackedSequenceStore, test_round_trip)
+{
+    const std::vector<std::string> sequences = {"ACGT",
+                                                "",
+                                                "TTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTGCA", // longer than one word
+                                                "ACNNNNNNGTRYacgtN",
+                                                "NNNN",
+                                                "aCgTnNryRYacgtAC"};
+
+    PackedSequenceStore store;
+    for (const std::string& sequence : sequences)
+    {
+        store.add_sequence(sequence.data(), static_cast<number_of_basepairs_t>(sequence.size()));
+    }
+
+    ASSERT_EQ(store.number_of_sequences(), sequences.size());
+    for (read_id_t i = 0; i < store.number_of_sequences(); ++i)
+    {
+        ASSERT_EQ(store.sequence_length(i), sequences[i].size()) << "i: " << i;
+        ASSERT_EQ(decode_all(store, i), sequences[i]) << "i: " << i;
+    }
+
+    ASSERT_FALSE(store.has_exceptions(0));
+    ASSERT_FALSE(store.has_exceptions(2));
+    ASSERT_TRUE(store.has_exceptions(3));
+    ASSERT_TRUE(store.has_exceptions(4));
+    ASSERT_TRUE(store.has_exceptions(5));
+}
+
+TEST(TestIoPackedSequenceStore, test_soft_masked_sequence)
+{
+    // lowercase stretch in the middle of the sequence, masked repeats often contain Ns
+    std::minstd_rand rng(1);
+    std::string sequence = genomeutils::generate_random_genome(10000, rng);
+    std::transform(std::begin(sequence) + 1000, std::begin(sequence) + 9000, std::begin(sequence) + 1000, [](const char c) {
+        return static_cast<char>(c - 'A' + 'a');
+    });
+    std::fill(std::begin(sequence) + 5000, std::begin(sequence) + 5100, 'n');
+
+    PackedSequenceStore store;
+    store.add_sequence(sequence.data(), static_cast<number_of_basepairs_t>(sequence.size()));
+    store.add_sequence("acgt", 4);
+    store.shrink_to_fit();
+
+    ASSERT_EQ(decode_all(store, 0), sequence);
+    ASSERT_EQ(decode_section(store, 0, 990, 20), sequence.substr(990, 20));
+    ASSERT_EQ(decode_section(store, 0, 5090, 20), sequence.substr(5090, 20));
+    ASSERT_EQ(decode_all(store, 1), "acgt");
+    ASSERT_TRUE(store.has_exceptions(0));
+    ASSERT_FALSE(store.has_exceptions(1));
+
+    // lowercase basepairs are packed like uppercase ones
+    ASSERT_EQ(store.packed_words(1)[0], 0b11100100u);
+
+    // about 2 bits per basepair, case and Ns only add a few intervals
+    ASSERT_LE(store.memory_usage_bytes(), (sequence.size() + 4) / 4 + 200);
+}
+
+TEST(TestIoPackedSequenceStore, test_decode_section)
+{
+    const std::string sequence = "ACGTNNNNACGTACGTACGTACGTACGTACGTAAAARCCCCGGGGTTTT";
+    PackedSequenceStore store;
+    store.add_sequence(sequence.data(), static_cast<number_of_basepairs_t>(sequence.size()));
+
+    for (position_in_read_t first_basepair = 0; first_basepair <= sequence.size(); ++first_basepair)
+    {
+        for (number_of_basepairs_t number_of_basepairs = 0; first_basepair + number_of_basepairs <= sequence.size(); ++number_of_basepairs)
+        {
+            ASSERT_EQ(decode_section(store, 0, first_basepair, number_of_basepairs), sequence.substr(first_basepair, number_of_basepairs))
+                << "first_basepair: " << first_basepair << ", number_of_basepairs: " << number_of_basepairs;
+        }
+    }
+}
+
+TEST(TestIoPackedSequenceStore, test_packed_words)
+{
+    // 33 basepairs -> 2 words
+    const std::string sequence = "ACGTAAAAAAAAAAAAAAAAAAAAAAAAAAAAG";
+    PackedSequenceStore store;
+    store.add_sequence("T", 1);
+    store.add_sequence(sequence.data(), static_cast<number_of_basepairs_t>(sequence.size()));
+
+    ASSERT_EQ(store.number_of_packed_words(0), 1u);
+    ASSERT_EQ(store.packed_words(0)[0], 0b11u);
+
+    ASSERT_EQ(store.number_of_packed_words(1), 2u);
+    const PackedSequenceStore::word_t* const words = store.packed_words(1);
+    // A = 0b00, C = 0b01, G = 0b10, T = 0b11, first basepair in the lowest bits
+    ASSERT_EQ(words[0], 0b11100100u);
+    ASSERT_EQ(words[1], 0b10u);
+}
+
+TEST(TestIoPackedSequenceStore, test_reordered)
+{
+    const std::vector<std::string> sequences = {"ACGTN", "GG", "TTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTN", "NACGT"};
+
+    PackedSequenceStore store;
+    for (const std::string& sequence : sequences)
+    {
+        store.add_sequence(sequence.data(), static_cast<number_of_basepairs_t>(sequence.size()));
+    }
+
+    const std::vector<read_id_t> new_to_old_id = {2, 0, 3, 1};
+    const PackedSequenceStore reordered_store  = store.reordered(new_to_old_id);
+
+    ASSERT_EQ(reordered_store.number_of_sequences(), sequences.size());
+    for (read_id_t i = 0; i < reordered_store.number_of_sequences(); ++i)
+    {
+        ASSERT_EQ(decode_all(reordered_store, i), sequences[new_to_old_id[i]]) << "i: " << i;
+    }
+}
+
+TEST(TestIoPackedFastaParser, test_same_as_kseq_parser)
+{
+    const std::string fasta_path = ::testing::TempDir() + "test_same_as_kseq_parser.fasta";
+    {
+        std::ofstream fasta_file(fasta_path);
+        fasta_file << ">read_0\nACGTACGTNNACGT\n"
+                   << ">read_1 description\nAC\nGT\n"
+                   << ">read_2\nTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTT\n"
+                   << ">read_3\nacgtRY\n"
+                   << ">read_4\nGGGG\n";
+    }
+
+    for (const bool shuffle : {false, true})
+    {
+        std::unique_ptr<FastaParser> kseq_parser   = create_kseq_fasta_parser(fasta_path, 3, shuffle);
+        std::unique_ptr<FastaParser> packed_parser = create_packed_fasta_parser(fasta_path, 3, shuffle);
+
+        ASSERT_EQ(packed_parser->get_num_seqences(), kseq_parser->get_num_seqences());
+        ASSERT_NE(packed_parser->get_packed_sequences(), nullptr);
+        ASSERT_EQ(kseq_parser->get_packed_sequences(), nullptr);
+        for (read_id_t i = 0; i < kseq_parser->get_num_seqences(); ++i)
+        {
+            const FastaSequence& expected = kseq_parser->get_sequence_by_id(i);
+            ASSERT_EQ(packed_parser->get_name_view_by_id(i), expected.name) << "i: " << i;
+            ASSERT_EQ(packed_parser->get_sequence_length_by_id(i), expected.seq.size()) << "i: " << i;
+
+            std::string copied(expected.seq.size() - 1, '\0');
+            packed_parser->copy_sequence_by_id(i, 1, static_cast<number_of_basepairs_t>(copied.size()), &copied[0]);
+            ASSERT_EQ(copied, expected.seq.substr(1)) << "i: " << i;
+
+            ASSERT_EQ(packed_parser->get_sequence_by_id(i).seq, expected.seq) << "i: " << i;
+        }
+    }
+}
+
+} // namespace io
+
+} // namespace genomeworks
+
+} // namespace claraparabricks
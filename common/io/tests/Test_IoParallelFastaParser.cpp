@@ -0,0 +1,196 @@
+/*
+* Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#include "gtest/gtest.h"
+
+#include "../src/bgzf.hpp"
+
+#include <claragenomics/io/fasta_parser.hpp>
+#include <claragenomics/utils/genomeutils.hpp>
+
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace claraparabricks
+{
+
+namespace genomeworks
+{
+
+namespace io
+{
+
+namespace
+{
+
+/// \brief writes a file large enough to be split into several ranges, with reads of random lengths
+/// Quality strings start with '@' and '>' to check that parsing does not resynchronise on them
+std::string write_reads_file(const std::string& file_name,
+                             const bool fastq,
+                             const std::int32_t number_of_reads)
+{
+    const std::string file_path = ::testing::TempDir() + file_name;
+    std::ofstream file(file_path);
+    std::minstd_rand rng(1);
+    std::uniform_int_distribution<std::int32_t> read_length(1, 10000);
+    for (std::int32_t i = 0; i < number_of_reads; ++i)
+    {
+        const std::string basepairs = genomeutils::generate_random_genome(read_length(rng), rng);
+        if (fastq)
+        {
+            file << "@read_" << i << " comment\n"
+                 << basepairs << "\n+\n"
+                 << std::string(basepairs.size(), (i % 2 == 0) ? '@' : '>') << "\n";
+        }
+        else
+        {
+            // multi-line FASTA
+            file << ">read_" << i << " comment\n";
+            for (std::size_t first = 0; first < basepairs.size(); first += 80)
+            {
+                file << basepairs.substr(first, 80) << "\n";
+            }
+        }
+    }
+    return file_path;
+}
+
+void check_same_reads(const FastaParser& expected_parser,
+                      const FastaParser& parser)
+{
+    ASSERT_EQ(parser.get_num_seqences(), expected_parser.get_num_seqences());
+    for (read_id_t i = 0; i < expected_parser.get_num_seqences(); ++i)
+    {
+        const FastaSequence& expected = expected_parser.get_sequence_by_id(i);
+        ASSERT_EQ(parser.get_name_view_by_id(i), expected.name) << "i: " << i;
+        ASSERT_EQ(parser.get_sequence_view_by_id(i), expected.seq) << "i: " << i;
+        ASSERT_EQ(parser.get_sequence_length_by_id(i), expected.seq.size()) << "i: " << i;
+    }
+}
+
+} // namespace
+
+TEST(TestIoParallelFastaParser, test_fasta_same_as_kseq_parser)
+{
+    const std::string fasta_path = write_reads_file("test_fasta_same_as_kseq_parser.fasta", false, 1000);
+
+    for (const bool shuffle : {false, true})
+    {
+        std::unique_ptr<FastaParser> kseq_parser = create_kseq_fasta_parser(fasta_path, 100, shuffle);
+        for (const std::int32_t number_of_threads : {1, 3, 8})
+        {
+            std::unique_ptr<FastaParser> parser = create_parallel_fasta_parser(fasta_path, 100, shuffle, number_of_threads);
+            check_same_reads(*kseq_parser, *parser);
+        }
+    }
+}
+
+TEST(TestIoParallelFastaParser, test_fastq_same_as_kseq_parser)
+{
+    const std::string fastq_path = write_reads_file("test_fastq_same_as_kseq_parser.fastq", true, 1000);
+
+    for (const bool shuffle : {false, true})
+    {
+        std::unique_ptr<FastaParser> kseq_parser = create_kseq_fasta_parser(fastq_path, 100, shuffle);
+        for (const std::int32_t number_of_threads : {1, 3, 8})
+        {
+            std::unique_ptr<FastaParser> parser = create_parallel_fasta_parser(fastq_path, 100, shuffle, number_of_threads);
+            check_same_reads(*kseq_parser, *parser);
+        }
+    }
+}
+
+TEST(TestIoParallelFastaParser, test_bgzf_same_as_uncompressed)
+{
+    const std::string fastq_path = write_reads_file("test_bgzf_same_as_uncompressed.fastq", true, 1000);
+    const std::string bgzf_path  = fastq_path + ".gz";
+    {
+        std::ifstream fastq_file(fastq_path, std::ios::binary);
+        const std::vector<char> fastq((std::istreambuf_iterator<char>(fastq_file)), std::istreambuf_iterator<char>());
+        const std::vector<char> compressed = deflate_bgzf(fastq.data(), fastq.size());
+        std::ofstream(bgzf_path, std::ios::binary).write(compressed.data(), compressed.size());
+    }
+
+    std::unique_ptr<FastaParser> uncompressed_parser = create_parallel_fasta_parser(fastq_path, 100, true, 1);
+    for (const std::int32_t number_of_threads : {1, 3, 8})
+    {
+        std::unique_ptr<FastaParser> parser = create_parallel_fasta_parser(bgzf_path, 100, true, number_of_threads);
+        check_same_reads(*uncompressed_parser, *parser);
+    }
+}
+
+TEST(TestIoParallelFastaParser, test_small_file)
+{
+    const std::string fasta_path = ::testing::TempDir() + "test_small_file.fasta";
+    {
+        std::ofstream fasta_file(fasta_path);
+        fasta_file << ">read_0\r\nACGT\r\nAC\r\n>read_1 description\nGGG";
+    }
+
+    std::unique_ptr<FastaParser> parser = create_parallel_fasta_parser(fasta_path, 0, false);
+    ASSERT_EQ(parser->get_num_seqences(), 2u);
+    ASSERT_EQ(parser->get_name_view_by_id(0), "read_0");
+    ASSERT_EQ(parser->get_sequence_view_by_id(0), "ACGTAC");
+    ASSERT_EQ(parser->get_name_view_by_id(1), "read_1");
+    ASSERT_EQ(parser->get_sequence_view_by_id(1), "GGG");
+    ASSERT_EQ(parser->get_sequence_by_id(1).seq, "GGG");
+}
+
+TEST(TestIoParallelFastaParser, test_invalid_files)
+{
+    const std::string empty_path = ::testing::TempDir() + "test_invalid_files_empty.fasta";
+    std::ofstream(empty_path).close();
+    ASSERT_THROW(create_parallel_fasta_parser(empty_path), std::invalid_argument);
+
+    const std::string text_path = ::testing::TempDir() + "test_invalid_files_text.fasta";
+    std::ofstream(text_path) << "this is not a FASTA file\n";
+    ASSERT_THROW(create_parallel_fasta_parser(text_path), std::invalid_argument);
+
+    const std::string truncated_path = ::testing::TempDir() + "test_invalid_files_truncated.fastq";
+    std::ofstream(truncated_path) << "@read_0\nACGT\n+\n!!\n";
+    ASSERT_THROW(create_parallel_fasta_parser(truncated_path), std::invalid_argument);
+
+    // gzip without BGZF blocks
+    const std::string gzip_path = ::testing::TempDir() + "test_invalid_files_gzip.fasta.gz";
+    std::ofstream(gzip_path, std::ios::binary) << std::string("\x1f\x8b\x08\x00\x00\x00\x00\x00\x00\xff", 10);
+    ASSERT_THROW(create_parallel_fasta_parser(gzip_path), std::invalid_argument);
+}
+
+TEST(TestIoParallelFastaParser, test_detect_input_file_format)
+{
+    const std::string fasta_path = ::testing::TempDir() + "test_detect_input_file_format.fasta";
+    std::ofstream(fasta_path) << ">read_0\nACGT\n";
+    ASSERT_EQ(detect_input_file_format(fasta_path), InputFileFormat::uncompressed);
+
+    const std::string empty_path = ::testing::TempDir() + "test_detect_input_file_format_empty.fasta";
+    std::ofstream(empty_path).close();
+    ASSERT_EQ(detect_input_file_format(empty_path), InputFileFormat::uncompressed);
+
+    const std::string gzip_path = ::testing::TempDir() + "test_detect_input_file_format.fasta.gz";
+    std::ofstream(gzip_path, std::ios::binary) << std::string("\x1f\x8b\x08\x00\x00\x00\x00\x00\x00\xff", 10);
+    ASSERT_EQ(detect_input_file_format(gzip_path), InputFileFormat::gzip);
+
+    const std::string bgzf_path        = ::testing::TempDir() + "test_detect_input_file_format_bgzf.fasta.gz";
+    const std::string reads            = ">read_0\nACGT\n";
+    const std::vector<char> compressed = deflate_bgzf(reads.data(), reads.size());
+    std::ofstream(bgzf_path, std::ios::binary).write(compressed.data(), compressed.size());
+    ASSERT_EQ(detect_input_file_format(bgzf_path), InputFileFormat::bgzip);
+
+    ASSERT_THROW(detect_input_file_format(::testing::TempDir() + "test_detect_input_file_format_missing.fasta"), std::invalid_argument);
+}
+
+} // namespace io
+
+} // namespace genomeworks
+
+} // namespace claraparabricks
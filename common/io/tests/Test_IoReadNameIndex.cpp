@@ -0,0 +1,123 @@
+/*
+* Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#include "gtest/gtest.h"
+
+#include <claragenomics/io/fasta_parser.hpp>
+
+#include <atomic>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace claraparabricks
+{
+
+namespace genomeworks
+{
+
+namespace io
+{
+
+namespace
+{
+
+std::string write_fasta_file(const std::string& file_name,
+                             const std::int32_t number_of_reads)
+{
+    const std::string file_path = ::testing::TempDir() + file_name;
+    std::ofstream file(file_path);
+    for (std::int32_t i = 0; i < number_of_reads; ++i)
+    {
+        file << ">read_" << i << " comment\nACGT\n";
+    }
+    return file_path;
+}
+
+} // namespace
+
+TEST(TestIoReadNameIndex, test_all_names_found)
+{
+    const std::string fasta_path = write_fasta_file("test_all_names_found.fasta", 10000);
+
+    for (const bool shuffle : {false, true})
+    {
+        std::unique_ptr<FastaParser> parser = create_parallel_fasta_parser(fasta_path, 0, shuffle, 1);
+        for (read_id_t i = 0; i < parser->get_num_seqences(); ++i)
+        {
+            ASSERT_EQ(parser->get_sequence_id_by_name(parser->get_name_view_by_id(i)), i);
+        }
+    }
+}
+
+TEST(TestIoReadNameIndex, test_missing_names)
+{
+    const std::string fasta_path = write_fasta_file("test_missing_names.fasta", 100);
+
+    std::unique_ptr<FastaParser> parser = create_parallel_fasta_parser(fasta_path, 0, true, 1);
+    ASSERT_THROW(parser->get_sequence_id_by_name("read_100"), std::out_of_range);
+    ASSERT_THROW(parser->get_sequence_id_by_name("read_1 comment"), std::out_of_range);
+    ASSERT_THROW(parser->get_sequence_id_by_name("read_"), std::out_of_range);
+    ASSERT_THROW(parser->get_sequence_id_by_name(""), std::out_of_range);
+}
+
+TEST(TestIoReadNameIndex, test_duplicate_names)
+{
+    const std::string fasta_path = ::testing::TempDir() + "test_duplicate_names.fasta";
+    std::ofstream(fasta_path) << ">read_0\nA\n>read_1\nC\n>read_0\nG\n>read_1\nT\n";
+
+    std::unique_ptr<FastaParser> parser = create_parallel_fasta_parser(fasta_path, 0, false, 1);
+    ASSERT_EQ(parser->get_sequence_id_by_name("read_0"), 0u);
+    ASSERT_EQ(parser->get_sequence_id_by_name("read_1"), 1u);
+}
+
+TEST(TestIoReadNameIndex, test_empty_file)
+{
+    const std::string fasta_path = ::testing::TempDir() + "test_empty_file.fasta";
+    std::ofstream(fasta_path) << ">read_0\nACGT\n";
+
+    // all reads are filtered out
+    std::unique_ptr<FastaParser> parser = create_parallel_fasta_parser(fasta_path, 10, false, 1);
+    ASSERT_EQ(parser->get_num_seqences(), 0u);
+    ASSERT_THROW(parser->get_sequence_id_by_name("read_0"), std::out_of_range);
+}
+
+TEST(TestIoReadNameIndex, test_concurrent_first_use)
+{
+    const std::string fasta_path = write_fasta_file("test_concurrent_first_use.fasta", 10000);
+
+    std::unique_ptr<FastaParser> parser = create_parallel_fasta_parser(fasta_path, 0, true, 1);
+    std::atomic<std::int32_t> number_of_mismatches(0);
+    std::vector<std::thread> threads;
+    for (std::int32_t thread_id = 0; thread_id < 4; ++thread_id)
+    {
+        threads.emplace_back([&parser, &number_of_mismatches, thread_id]() {
+            for (read_id_t i = thread_id; i < parser->get_num_seqences(); i += 4)
+            {
+                if (parser->get_sequence_id_by_name(parser->get_name_view_by_id(i)) != i)
+                {
+                    ++number_of_mismatches;
+                }
+            }
+        });
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+    ASSERT_EQ(number_of_mismatches, 0);
+}
+
+} // namespace io
+
+} // namespace genomeworks
+
+} // namespace claraparabricks
@@ -0,0 +1,218 @@
+/*
+* Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#include "gtest/gtest.h"
+
+#include "../src/read_ordering.hpp"
+
+#include <claragenomics/io/fasta_parser.hpp>
+#include <claragenomics/utils/genomeutils.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace claraparabricks
+{
+
+namespace genomeworks
+{
+
+namespace io
+{
+
+namespace
+{
+
+std::vector<number_of_basepairs_t> generate_read_lengths(const std::size_t number_of_reads)
+{
+    // mostly short reads with a few very long ones
+    std::minstd_rand rng(1);
+    std::lognormal_distribution<double> read_length(8.0, 1.5);
+    std::vector<number_of_basepairs_t> read_lengths(number_of_reads);
+    for (number_of_basepairs_t& length : read_lengths)
+    {
+        length = static_cast<number_of_basepairs_t>(read_length(rng)) + 1;
+    }
+    return read_lengths;
+}
+
+void check_is_permutation(const std::vector<read_id_t>& new_to_old_id,
+                          const std::size_t number_of_reads)
+{
+    std::vector<read_id_t> sorted_ids = new_to_old_id;
+    std::sort(std::begin(sorted_ids), std::end(sorted_ids));
+    std::vector<read_id_t> expected_ids(number_of_reads);
+    std::iota(std::begin(expected_ids), std::end(expected_ids), 0);
+    ASSERT_EQ(sorted_ids, expected_ids);
+}
+
+/// RecordingFastaParser - forwards to another parser and records prefetch hints
+class RecordingFastaParser : public FastaParser
+{
+public:
+    explicit RecordingFastaParser(std::unique_ptr<FastaParser> parser)
+        : parser_(std::move(parser))
+    {
+    }
+
+    number_of_reads_t get_num_seqences() const override
+    {
+        return parser_->get_num_seqences();
+    }
+
+    const FastaSequence& get_sequence_by_id(const read_id_t sequence_id) const override
+    {
+        return parser_->get_sequence_by_id(sequence_id);
+    }
+
+    void prefetch_sequences(const read_id_t first_sequence_id,
+                            const number_of_reads_t number_of_sequences) const override
+    {
+        std::vector<read_id_t> sequence_ids(number_of_sequences);
+        std::iota(std::begin(sequence_ids), std::end(sequence_ids), first_sequence_id);
+        prefetched_sets.push_back(sequence_ids);
+    }
+
+    void prefetch_sequences_by_ids(const std::vector<read_id_t>& sequence_ids) const override
+    {
+        prefetched_sets.push_back(sequence_ids);
+    }
+
+    mutable std::vector<std::vector<read_id_t>> prefetched_sets;
+
+private:
+    std::unique_ptr<FastaParser> parser_;
+};
+
+} // namespace
+
+TEST(TestIoReadOrdering, test_all_orderings_are_deterministic_permutations)
+{
+    const std::vector<number_of_basepairs_t> read_lengths = generate_read_lengths(1000);
+    for (const ReadOrdering ordering : {ReadOrdering::file_order, ReadOrdering::random, ReadOrdering::length_striped, ReadOrdering::length_bucketed})
+    {
+        const std::vector<read_id_t> new_to_old_id = compute_read_order(read_lengths, ordering);
+        check_is_permutation(new_to_old_id, read_lengths.size());
+        ASSERT_EQ(compute_read_order(read_lengths, ordering), new_to_old_id);
+    }
+
+    EXPECT_TRUE(compute_read_order({}, ReadOrdering::length_bucketed).empty());
+}
+
+TEST(TestIoReadOrdering, test_length_striped)
+{
+    const std::vector<number_of_basepairs_t> read_lengths = {5, 1, 9, 3, 7};
+    const std::vector<read_id_t> expected_order           = {2, 1, 4, 3, 0};
+    EXPECT_EQ(compute_read_order(read_lengths, ReadOrdering::length_striped), expected_order);
+}
+
+TEST(TestIoReadOrdering, test_length_bucketed_spreads_long_reads)
+{
+    const std::vector<number_of_basepairs_t> read_lengths = generate_read_lengths(10000);
+    const std::vector<read_id_t> new_to_old_id            = compute_read_order(read_lengths, ReadOrdering::length_bucketed);
+
+    // every tenth of the read_ids should have about a tenth of all basepairs
+    const std::size_t total_basepairs = std::accumulate(std::begin(read_lengths), std::end(read_lengths), static_cast<std::size_t>(0));
+    for (std::size_t part = 0; part < 10; ++part)
+    {
+        std::size_t part_basepairs = 0;
+        for (std::size_t read_id = part * 1000; read_id < (part + 1) * 1000; ++read_id)
+        {
+            part_basepairs += read_lengths[new_to_old_id[read_id]];
+        }
+        EXPECT_NEAR(static_cast<double>(part_basepairs) / total_basepairs, 0.1, 0.03) << "part: " << part;
+    }
+}
+
+TEST(TestIoReadOrdering, test_ordered_parser)
+{
+    const std::string fasta_path = ::testing::TempDir() + "test_ordered_parser.fasta";
+    {
+        std::ofstream fasta_file(fasta_path);
+        std::minstd_rand rng(1);
+        std::uniform_int_distribution<std::int32_t> read_length(1, 2000);
+        for (std::int32_t i = 0; i < 200; ++i)
+        {
+            fasta_file << ">read_" << i << "\n"
+                       << genomeutils::generate_random_genome(read_length(rng), rng) << "\n";
+        }
+    }
+
+    // random ordering is the same as shuffling in the parser
+    std::unique_ptr<FastaParser> shuffled_parser = create_parallel_fasta_parser(fasta_path, 0, true);
+    std::unique_ptr<FastaParser> ordered_parser  = create_ordered_fasta_parser(create_parallel_fasta_parser(fasta_path, 0, false), ReadOrdering::random);
+    ASSERT_EQ(ordered_parser->get_num_seqences(), shuffled_parser->get_num_seqences());
+    for (read_id_t i = 0; i < shuffled_parser->get_num_seqences(); ++i)
+    {
+        ASSERT_EQ(ordered_parser->get_name_view_by_id(i), shuffled_parser->get_name_view_by_id(i)) << "i: " << i;
+        ASSERT_EQ(ordered_parser->get_sequence_view_by_id(i), shuffled_parser->get_sequence_view_by_id(i)) << "i: " << i;
+        ASSERT_EQ(ordered_parser->get_sequence_by_id(i).seq, shuffled_parser->get_sequence_by_id(i).seq) << "i: " << i;
+    }
+
+    // longest read first
+    std::unique_ptr<FastaParser> striped_parser = create_ordered_fasta_parser(create_parallel_fasta_parser(fasta_path, 0, false), ReadOrdering::length_striped);
+    number_of_basepairs_t longest_read          = 0;
+    for (read_id_t i = 0; i < striped_parser->get_num_seqences(); ++i)
+    {
+        longest_read = std::max(longest_read, striped_parser->get_sequence_length_by_id(i));
+    }
+    EXPECT_EQ(striped_parser->get_sequence_length_by_id(0), longest_read);
+    std::string section(10, '\0');
+    striped_parser->copy_sequence_by_id(0, 5, 10, &section[0]);
+    EXPECT_EQ(section, std::string(striped_parser->get_sequence_view_by_id(0).substr(5, 10)));
+    EXPECT_EQ(striped_parser->get_packed_sequences(), nullptr);
+    EXPECT_THROW(striped_parser->get_sequence_by_id(200), std::out_of_range);
+}
+
+TEST(TestIoReadOrdering, test_ordered_parser_prefetches_reads_at_once)
+{
+    const std::string fasta_path = ::testing::TempDir() + "test_ordered_parser_prefetches_reads_at_once.fasta";
+    {
+        std::ofstream fasta_file(fasta_path);
+        std::minstd_rand rng(1);
+        std::uniform_int_distribution<std::int32_t> read_length(1, 2000);
+        for (std::int32_t i = 0; i < 100; ++i)
+        {
+            fasta_file << ">read_" << i << "\n"
+                       << genomeutils::generate_random_genome(read_length(rng), rng) << "\n";
+        }
+    }
+
+    auto recording_parser                           = std::make_unique<RecordingFastaParser>(create_parallel_fasta_parser(fasta_path, 0, false));
+    const RecordingFastaParser& recorded_prefetches = *recording_parser;
+    std::unique_ptr<FastaParser> ordered_parser     = create_ordered_fasta_parser(std::move(recording_parser), ReadOrdering::length_bucketed);
+
+    // reads of a range of new read_ids are scattered in the wrapped parser, but are passed to it with a single call
+    ordered_parser->prefetch_sequences(10, 50);
+    ASSERT_EQ(recorded_prefetches.prefetched_sets.size(), 1u);
+    ASSERT_EQ(recorded_prefetches.prefetched_sets[0].size(), 50u);
+    for (read_id_t i = 0; i < 50; ++i)
+    {
+        EXPECT_EQ(ordered_parser->get_name_view_by_id(10 + i), recorded_prefetches.get_name_view_by_id(recorded_prefetches.prefetched_sets[0][i])) << "i: " << i;
+    }
+
+    ordered_parser->prefetch_sequences_by_ids({3, 1, 2});
+    ASSERT_EQ(recorded_prefetches.prefetched_sets.size(), 2u);
+    EXPECT_EQ(recorded_prefetches.prefetched_sets[1].size(), 3u);
+
+    EXPECT_THROW(ordered_parser->prefetch_sequences(60, 41), std::out_of_range);
+    EXPECT_THROW(ordered_parser->prefetch_sequences_by_ids({5, 100}), std::out_of_range);
+}
+
+} // namespace io
+
+} // namespace genomeworks
+
+} // namespace claraparabricks
@@ -0,0 +1,145 @@
+/*
+* Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#include "gtest/gtest.h"
+
+#include <claragenomics/io/fasta_parser.hpp>
+#include <claragenomics/io/read_store.hpp>
+#include <claragenomics/utils/genomeutils.hpp>
+
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+
+namespace claraparabricks
+{
+
+namespace genomeworks
+{
+
+namespace io
+{
+
+namespace
+{
+
+/// \brief writes a multi-line FASTA file with reads of random lengths
+std::string write_fasta_file(const std::string& file_name,
+                             const std::int32_t number_of_reads)
+{
+    const std::string file_path = ::testing::TempDir() + file_name;
+    std::ofstream file(file_path);
+    std::minstd_rand rng(1);
+    std::uniform_int_distribution<std::int32_t> read_length(1, 1000);
+    for (std::int32_t i = 0; i < number_of_reads; ++i)
+    {
+        const std::string basepairs = genomeutils::generate_random_genome(read_length(rng), rng);
+        file << ">read_" << i << " comment\n";
+        for (std::size_t first = 0; first < basepairs.size(); first += 80)
+        {
+            file << basepairs.substr(first, 80) << "\n";
+        }
+    }
+    return file_path;
+}
+
+void check_same_reads(const FastaParser& expected_parser,
+                      const FastaParser& parser)
+{
+    ASSERT_EQ(parser.get_num_seqences(), expected_parser.get_num_seqences());
+    for (read_id_t i = 0; i < expected_parser.get_num_seqences(); ++i)
+    {
+        const FastaSequence& expected = expected_parser.get_sequence_by_id(i);
+        ASSERT_EQ(parser.get_name_view_by_id(i), expected.name) << "i: " << i;
+        ASSERT_EQ(parser.get_sequence_view_by_id(i), expected.seq) << "i: " << i;
+        ASSERT_EQ(parser.get_sequence_length_by_id(i), expected.seq.size()) << "i: " << i;
+        ASSERT_EQ(parser.get_sequence_by_id(i).seq, expected.seq) << "i: " << i;
+    }
+}
+
+} // namespace
+
+TEST(TestIoReadStore, test_same_as_kseq_parser)
+{
+    const std::string fasta_file      = write_fasta_file("read_store_input.fasta", 500);
+    const std::string read_store_file = ::testing::TempDir() + "read_store_input.cgareads";
+    write_read_store(*create_kseq_fasta_parser(fasta_file, 0, false), read_store_file);
+
+    check_same_reads(*create_kseq_fasta_parser(fasta_file, 0, false),
+                     *create_read_store_parser(read_store_file, 0, false));
+    check_same_reads(*create_kseq_fasta_parser(fasta_file, 0, true),
+                     *create_read_store_parser(read_store_file, 0, true));
+    check_same_reads(*create_kseq_fasta_parser(fasta_file, 300, true),
+                     *create_read_store_parser(read_store_file, 300, true));
+}
+
+TEST(TestIoReadStore, test_detect_read_store)
+{
+    const std::string fasta_file      = write_fasta_file("read_store_detect_input.fasta", 10);
+    const std::string read_store_file = ::testing::TempDir() + "read_store_detect.cgareads";
+    write_read_store(*create_kseq_fasta_parser(fasta_file, 0, false), read_store_file);
+
+    EXPECT_EQ(detect_input_file_format(read_store_file), InputFileFormat::read_store);
+    EXPECT_EQ(detect_input_file_format(fasta_file), InputFileFormat::uncompressed);
+}
+
+TEST(TestIoReadStore, test_empty_read_store)
+{
+    const std::string fasta_file      = write_fasta_file("read_store_empty_input.fasta", 1);
+    const std::string read_store_file = ::testing::TempDir() + "read_store_empty.cgareads";
+    write_read_store(*create_kseq_fasta_parser(fasta_file, 1000000, false), read_store_file);
+
+    EXPECT_EQ(create_read_store_parser(read_store_file)->get_num_seqences(), 0u);
+}
+
+TEST(TestIoReadStore, test_out_of_range_sequence_id)
+{
+    const std::string fasta_file      = write_fasta_file("read_store_out_of_range_input.fasta", 3);
+    const std::string read_store_file = ::testing::TempDir() + "read_store_out_of_range.cgareads";
+    write_read_store(*create_kseq_fasta_parser(fasta_file, 0, false), read_store_file);
+
+    const std::unique_ptr<FastaParser> parser = create_read_store_parser(read_store_file);
+    EXPECT_THROW(parser->get_sequence_by_id(3), std::out_of_range);
+}
+
+TEST(TestIoReadStore, test_not_a_read_store)
+{
+    const std::string fasta_file = write_fasta_file("read_store_not_a_read_store.fasta", 10);
+
+    EXPECT_THROW(create_read_store_parser(fasta_file), std::invalid_argument);
+}
+
+TEST(TestIoReadStore, test_truncated_read_store)
+{
+    const std::string fasta_file      = write_fasta_file("read_store_truncated_input.fasta", 10);
+    const std::string read_store_file = ::testing::TempDir() + "read_store_truncated.cgareads";
+    write_read_store(*create_kseq_fasta_parser(fasta_file, 0, false), read_store_file);
+
+    std::string content;
+    {
+        std::ifstream file(read_store_file, std::ios::binary);
+        content.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+    {
+        std::ofstream file(read_store_file, std::ios::binary | std::ios::trunc);
+        file.write(content.data(), content.size() - 1);
+    }
+
+    EXPECT_THROW(create_read_store_parser(read_store_file), std::invalid_argument);
+}
+
+} // namespace io
+
+} // namespace genomeworks
+
+} // namespace claraparabricks
@@ -0,0 +1,116 @@
+/*
+* Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#include "gtest/gtest.h"
+
+#include "../src/read_table.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace claraparabricks
+{
+
+namespace genomeworks
+{
+
+namespace io
+{
+
+TEST(TestIoReadTable, test_add_and_build_reads)
+{
+    ReadTable table;
+    ASSERT_EQ(table.add_read("read_0", 6, "ACGT", 4), 0u);
+
+    const std::string first_line  = "AAAA";
+    const std::string second_line = "CC";
+    table.append_basepairs(first_line.data(), first_line.data() + first_line.size());
+    table.append_basepairs(second_line.data(), second_line.data() + second_line.size());
+    ASSERT_EQ(table.number_of_pending_basepairs(), 6u);
+    ASSERT_EQ(table.commit_read("read_1", 6), 1u);
+
+    table.append_basepairs(first_line.data(), first_line.data() + first_line.size());
+    table.discard_read();
+    ASSERT_EQ(table.number_of_pending_basepairs(), 0u);
+
+    ASSERT_EQ(table.add_read("", 0, "", 0), 2u);
+
+    ASSERT_EQ(table.number_of_reads(), 3u);
+    ASSERT_EQ(table.name(0), "read_0");
+    ASSERT_EQ(table.basepairs(0), "ACGT");
+    ASSERT_EQ(table.number_of_basepairs(0), 4u);
+    ASSERT_EQ(table.name(1), "read_1");
+    ASSERT_EQ(table.basepairs(1), "AAAACC");
+    ASSERT_EQ(table.number_of_basepairs(1), 6u);
+    ASSERT_EQ(table.name(2), "");
+    ASSERT_EQ(table.basepairs(2), "");
+}
+
+TEST(TestIoReadTable, test_concatenate)
+{
+    std::vector<ReadTable> tables(4);
+    std::vector<std::string> expected_names;
+    std::vector<std::string> expected_basepairs;
+    for (std::size_t table_id = 0; table_id < tables.size(); ++table_id)
+    {
+        // table 2 is left empty
+        const std::size_t number_of_reads = (table_id == 2) ? 0 : table_id + 1;
+        for (std::size_t i = 0; i < number_of_reads; ++i)
+        {
+            const std::string name      = "read_" + std::to_string(table_id) + "_" + std::to_string(i);
+            const std::string basepairs = std::string(i + 1, "ACGT"[table_id]);
+            tables[table_id].add_read(name.data(), static_cast<std::uint32_t>(name.size()), basepairs.data(), static_cast<number_of_basepairs_t>(basepairs.size()));
+            expected_names.push_back(name);
+            expected_basepairs.push_back(basepairs);
+        }
+    }
+    // pending basepairs are not part of the table
+    tables[1].append_basepairs(expected_basepairs[0].data(), expected_basepairs[0].data() + expected_basepairs[0].size());
+
+    const ReadTable table = ReadTable::concatenate(tables, 2);
+
+    ASSERT_EQ(table.number_of_reads(), expected_names.size());
+    for (read_id_t i = 0; i < table.number_of_reads(); ++i)
+    {
+        ASSERT_EQ(table.name(i), expected_names[i]) << "i: " << i;
+        ASSERT_EQ(table.basepairs(i), expected_basepairs[i]) << "i: " << i;
+    }
+}
+
+TEST(TestIoReadTable, test_shuffle_same_as_vector_shuffle)
+{
+    ReadTable table;
+    std::vector<read_id_t> expected_order(100);
+    std::iota(std::begin(expected_order), std::end(expected_order), 0);
+    for (const read_id_t read_id : expected_order)
+    {
+        const std::string name = std::to_string(read_id);
+        table.add_read(name.data(), static_cast<std::uint32_t>(name.size()), "A", 1);
+    }
+
+    std::mt19937 table_generator(0);
+    table.shuffle(table_generator);
+    std::mt19937 vector_generator(0);
+    std::shuffle(std::begin(expected_order), std::end(expected_order), vector_generator);
+
+    for (read_id_t i = 0; i < table.number_of_reads(); ++i)
+    {
+        ASSERT_EQ(table.name(i), std::to_string(expected_order[i])) << "i: " << i;
+    }
+}
+
+} // namespace io
+
+} // namespace genomeworks
+
+} // namespace claraparabricks
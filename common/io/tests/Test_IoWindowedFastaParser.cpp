@@ -0,0 +1,238 @@
+/*
+* Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#include "gtest/gtest.h"
+
+#include <claragenomics/io/fasta_parser.hpp>
+#include <claragenomics/utils/genomeutils.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace claraparabricks
+{
+
+namespace genomeworks
+{
+
+namespace io
+{
+
+namespace
+{
+
+/// \brief writes a FASTA file with reads of random lengths, every fifth read is written on multiple lines
+std::string write_fasta_file(const std::string& file_name,
+                             const std::int32_t number_of_reads)
+{
+    const std::string file_path = ::testing::TempDir() + file_name;
+    std::ofstream file(file_path, std::ios::binary);
+    std::minstd_rand rng(1);
+    std::uniform_int_distribution<std::int32_t> read_length(1, 1000);
+    for (std::int32_t i = 0; i < number_of_reads; ++i)
+    {
+        const std::string basepairs = genomeutils::generate_random_genome(read_length(rng), rng);
+        file << ">read_" << i << " comment\n";
+        const std::size_t line_length = (i % 5 == 0) ? 60 : basepairs.size();
+        for (std::size_t first = 0; first < basepairs.size(); first += line_length)
+        {
+            file << basepairs.substr(first, line_length) << ((i % 7 == 0) ? "\r\n" : "\n");
+        }
+    }
+    std::remove((file_path + ".fai").c_str());
+    return file_path;
+}
+
+} // namespace
+
+TEST(TestIoWindowedFastaParser, test_same_as_kseq_parser)
+{
+    const std::string fasta_path = write_fasta_file("test_windowed_same_as_kseq_parser.fasta", 300);
+
+    for (const bool shuffle : {false, true})
+    {
+        std::unique_ptr<FastaParser> kseq_parser = create_kseq_fasta_parser(fasta_path, 100, shuffle);
+        // a few reads at most are resident at any time
+        std::unique_ptr<FastaParser> parser = create_windowed_fasta_parser(fasta_path, 100, shuffle, 2000);
+        ASSERT_EQ(parser->get_num_seqences(), kseq_parser->get_num_seqences());
+        for (read_id_t i = 0; i < kseq_parser->get_num_seqences(); ++i)
+        {
+            const FastaSequence& expected = kseq_parser->get_sequence_by_id(i);
+            ASSERT_EQ(parser->get_name_view_by_id(i), expected.name) << "i: " << i;
+            ASSERT_EQ(parser->get_sequence_length_by_id(i), expected.seq.size()) << "i: " << i;
+            ASSERT_EQ(parser->get_sequence_view_by_id(i), expected.seq) << "i: " << i;
+            ASSERT_EQ(parser->get_sequence_by_id(i).seq, expected.seq) << "i: " << i;
+        }
+    }
+}
+
+TEST(TestIoWindowedFastaParser, test_copy_sections)
+{
+    const std::string fasta_path = write_fasta_file("test_windowed_copy_sections.fasta", 100);
+
+    std::unique_ptr<FastaParser> kseq_parser = create_kseq_fasta_parser(fasta_path, 0, true);
+    std::unique_ptr<FastaParser> parser      = create_windowed_fasta_parser(fasta_path, 0, true, 5000);
+
+    // first half is resident, second half is copied from the file
+    parser->prefetch_sequences(0, kseq_parser->get_num_seqences() / 2);
+    for (read_id_t i = 0; i < kseq_parser->get_num_seqences(); ++i)
+    {
+        const std::string& expected = kseq_parser->get_sequence_by_id(i).seq;
+        for (const std::size_t first_basepair : {static_cast<std::size_t>(0), expected.size() / 3, expected.size() - 1})
+        {
+            const std::size_t number_of_basepairs = (expected.size() - first_basepair) / 2 + 1;
+            std::string section(number_of_basepairs, '\0');
+            parser->copy_sequence_by_id(i, first_basepair, number_of_basepairs, &section[0]);
+            ASSERT_EQ(section, expected.substr(first_basepair, number_of_basepairs)) << "i: " << i << ", first_basepair: " << first_basepair;
+        }
+    }
+}
+
+TEST(TestIoWindowedFastaParser, test_prefetch_by_ids)
+{
+    const std::string fasta_path = write_fasta_file("test_windowed_prefetch_by_ids.fasta", 200);
+
+    std::unique_ptr<FastaParser> kseq_parser = create_kseq_fasta_parser(fasta_path, 0, false);
+    std::unique_ptr<FastaParser> parser      = create_windowed_fasta_parser(fasta_path, 0, false, 20000);
+
+    // every seventh read, in reverse order and with duplicates
+    std::vector<read_id_t> read_ids;
+    for (read_id_t read_id = 0; read_id < kseq_parser->get_num_seqences(); read_id += 7)
+    {
+        read_ids.insert(std::begin(read_ids), {read_id, read_id});
+    }
+    parser->prefetch_sequences_by_ids(read_ids);
+    // prefetching the same set again only marks it as most recently used
+    parser->prefetch_sequences_by_ids(read_ids);
+    parser->prefetch_sequences(5, 3);
+    for (read_id_t i = 0; i < kseq_parser->get_num_seqences(); ++i)
+    {
+        const std::string& expected = kseq_parser->get_sequence_by_id(i).seq;
+        std::string copy(expected.size(), '\0');
+        parser->copy_sequence_by_id(i, 0, expected.size(), &copy[0]);
+        ASSERT_EQ(copy, expected) << "i: " << i;
+    }
+
+    parser->prefetch_sequences_by_ids({});
+    EXPECT_THROW(parser->prefetch_sequences_by_ids({0, 200}), std::out_of_range);
+}
+
+TEST(TestIoWindowedFastaParser, test_prefetch_from_multiple_threads)
+{
+    const std::string fasta_path = write_fasta_file("test_windowed_prefetch_from_multiple_threads.fasta", 400);
+
+    std::unique_ptr<FastaParser> kseq_parser = create_kseq_fasta_parser(fasta_path, 0, true);
+    std::unique_ptr<FastaParser> parser      = create_windowed_fasta_parser(fasta_path, 0, true, 20000);
+
+    const number_of_reads_t number_of_threads = 4;
+    const number_of_reads_t reads_per_thread  = kseq_parser->get_num_seqences() / number_of_threads;
+    std::vector<std::thread> threads;
+    std::vector<std::int32_t> mismatches(number_of_threads, 0);
+    for (number_of_reads_t thread_id = 0; thread_id < number_of_threads; ++thread_id)
+    {
+        threads.emplace_back([&, thread_id]() {
+            for (read_id_t first_read = thread_id * reads_per_thread; first_read < (thread_id + 1) * reads_per_thread; first_read += 10)
+            {
+                parser->prefetch_sequences(first_read, 10);
+                for (read_id_t i = first_read; i < first_read + 10; ++i)
+                {
+                    const std::string& expected = kseq_parser->get_sequence_by_id(i).seq;
+                    std::string copy(expected.size(), '\0');
+                    parser->copy_sequence_by_id(i, 0, expected.size(), &copy[0]);
+                    mismatches[thread_id] += (copy != expected);
+                }
+            }
+        });
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    for (const std::int32_t thread_mismatches : mismatches)
+    {
+        EXPECT_EQ(thread_mismatches, 0);
+    }
+}
+
+TEST(TestIoWindowedFastaParser, test_access_while_ranges_are_evicted)
+{
+    const std::string fasta_path = write_fasta_file("test_windowed_access_while_ranges_are_evicted.fasta", 400);
+
+    std::unique_ptr<FastaParser> kseq_parser = create_kseq_fasta_parser(fasta_path, 0, true);
+    // only a few ranges fit, so prefetches keep evicting ranges other threads are reading from
+    std::unique_ptr<FastaParser> parser = create_windowed_fasta_parser(fasta_path, 0, true, 5000);
+
+    const number_of_reads_t number_of_reads   = kseq_parser->get_num_seqences();
+    const number_of_reads_t number_of_threads = 4;
+    std::vector<std::thread> threads;
+    std::vector<std::int32_t> mismatches(number_of_threads, 0);
+    for (number_of_reads_t thread_id = 0; thread_id < number_of_threads; ++thread_id)
+    {
+        threads.emplace_back([&, thread_id]() {
+            std::minstd_rand rng(thread_id);
+            std::uniform_int_distribution<read_id_t> random_read(0, number_of_reads - 1);
+            // views are kept and checked after the ranges they came from are likely to have been evicted
+            std::vector<std::pair<read_id_t, cga_string_view_t>> views;
+            for (std::int32_t i = 0; i < 200; ++i)
+            {
+                const read_id_t first_read = random_read(rng) % (number_of_reads - 10);
+                parser->prefetch_sequences(first_read, 10);
+
+                const read_id_t read_id = random_read(rng);
+                views.emplace_back(read_id, parser->get_sequence_view_by_id(read_id));
+
+                const read_id_t copied_read_id = first_read + i % 10;
+                const std::string& expected    = kseq_parser->get_sequence_by_id(copied_read_id).seq;
+                std::string copy(expected.size(), '\0');
+                parser->copy_sequence_by_id(copied_read_id, 0, expected.size(), &copy[0]);
+                mismatches[thread_id] += (copy != expected);
+            }
+            for (const auto& view : views)
+            {
+                mismatches[thread_id] += (view.second != kseq_parser->get_sequence_by_id(view.first).seq);
+            }
+        });
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    for (const std::int32_t thread_mismatches : mismatches)
+    {
+        EXPECT_EQ(thread_mismatches, 0);
+    }
+}
+
+TEST(TestIoWindowedFastaParser, test_invalid_arguments)
+{
+    const std::string fasta_path = write_fasta_file("test_windowed_invalid_arguments.fasta", 10);
+
+    std::unique_ptr<FastaParser> parser = create_windowed_fasta_parser(fasta_path, 0, false, 1000);
+    EXPECT_THROW(parser->get_sequence_by_id(10), std::out_of_range);
+    EXPECT_THROW(parser->prefetch_sequences(5, 6), std::out_of_range);
+
+    const std::string empty_path = ::testing::TempDir() + "test_windowed_invalid_arguments_empty.fasta";
+    std::ofstream(empty_path).close();
+    EXPECT_THROW(create_windowed_fasta_parser(empty_path), std::invalid_argument);
+}
+
+} // namespace io
+
+} // namespace genomeworks
+
+} // namespace claraparabricks
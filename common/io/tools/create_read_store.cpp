@@ -0,0 +1,71 @@
+/*
+* Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#include <claragenomics/io/fasta_parser.hpp>
+#include <claragenomics/io/read_store.hpp>
+
+#include "../src/bgzf.hpp"
+
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+/// \brief returns true if file is compressed with gzip, but not with bgzip
+bool is_gzipped_not_bgzf(const std::string& file_path)
+{
+    // a BGZF block is at most 64kB
+    std::ifstream file(file_path, std::ios::binary);
+    std::vector<char> first_block(1 << 16);
+    file.read(first_block.data(), first_block.size());
+    const std::size_t size = file.gcount();
+    return size >= 2 && first_block[0] == '\x1f' && first_block[1] == '\x8b' &&
+           !claraparabricks::genomeworks::io::is_bgzf(first_block.data(), size);
+}
+
+} // namespace
+
+/// Converts a FASTA/FASTQ file into a read store, which can then be loaded with create_read_store_parser()
+int main(int argc, char* argv[])
+{
+    using namespace claraparabricks::genomeworks;
+
+    if (argc != 3)
+    {
+        std::cerr << "Usage: create_read_store <input FASTA/FASTQ(.gz)> <output read store>" << std::endl;
+        return EXIT_FAILURE;
+    }
+    const std::string input_file  = argv[1];
+    const std::string output_file = argv[2];
+
+    try
+    {
+        // reads are stored in file order, filtering and shuffling is done when the read store is loaded
+        // the parallel parser handles uncompressed and bgzip-compressed files
+        const std::unique_ptr<io::FastaParser> parser = is_gzipped_not_bgzf(input_file)
+                                                            ? io::create_kseq_fasta_parser(input_file, 0, false)
+                                                            : io::create_parallel_fasta_parser(input_file, 0, false);
+        io::write_read_store(*parser, output_file);
+        std::cerr << "Wrote " << parser->get_num_seqences() << " reads to " << output_file << std::endl;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,257 @@
+/*
+* Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#include <claragenomics/cudamapper/index.hpp>
+#include <claragenomics/io/fasta_parser.hpp>
+#include <claragenomics/utils/genomeutils.hpp>
+
+#include "../src/index_cpu.hpp"
+#include "../src/paf_formatter.hpp"
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace claraparabricks
+{
+
+namespace genomeworks
+{
+
+namespace cudamapper
+{
+
+/// ReadsFile - FASTA file with 1'000 random reads of 10'000 basepairs, deleted when the benchmark finishes
+class ReadsFile
+{
+public:
+    ReadsFile()
+        : file_path_("benchmark_cudamapper_reads.fasta")
+    {
+        std::ofstream file(file_path_);
+        std::minstd_rand rng(1);
+        for (std::int32_t i = 0; i < number_of_reads; ++i)
+        {
+            file << ">read_" << i << "\n"
+                 << genomeutils::generate_random_genome(read_length, rng) << "\n";
+        }
+    }
+
+    ~ReadsFile()
+    {
+        std::remove(file_path_.c_str());
+    }
+
+    const std::string& path() const
+    {
+        return file_path_;
+    }
+
+    static constexpr std::int32_t number_of_reads = 1000;
+    static constexpr std::int32_t read_length     = 10000;
+
+private:
+    std::string file_path_;
+};
+
+const io::FastaParser& get_parser()
+{
+    static const ReadsFile reads_file;
+    static const std::unique_ptr<io::FastaParser> parser = io::create_kseq_fasta_parser(reads_file.path(), 0, false);
+    return *parser;
+}
+
+static void BM_FindMinimizers(benchmark::State& state)
+{
+    const io::FastaParser& parser          = get_parser();
+    const std::uint64_t kmer_size          = state.range(0);
+    const std::uint64_t window_size        = state.range(1);
+    const bool hash_representations        = state.range(2);
+    const std::int64_t number_of_basepairs = std::int64_t(ReadsFile::number_of_reads) * ReadsFile::read_length;
+
+    details::index_cpu::MinimizerWorkspace workspace;
+    std::vector<details::index_cpu::HostSketchElement> sketch_elements;
+    for (auto _ : state)
+    {
+        for (read_id_t read_id = 0; read_id < parser.get_num_seqences(); ++read_id)
+        {
+            const cga_string_view_t basepairs = parser.get_sequence_view_by_id(read_id);
+            sketch_elements.clear();
+            details::index_cpu::find_minimizers_of_read(basepairs.data(),
+                                                        basepairs.size(),
+                                                        read_id,
+                                                        kmer_size,
+                                                        window_size,
+                                                        hash_representations,
+                                                        workspace,
+                                                        sketch_elements);
+            benchmark::DoNotOptimize(sketch_elements.data());
+        }
+    }
+
+    state.counters["basepairs_per_second_per_core"] = benchmark::Counter(static_cast<double>(state.iterations() * number_of_basepairs),
+                                                                         benchmark::Counter::kIsRate);
+}
+
+static void BM_IndexCPU(benchmark::State& state)
+{
+    const io::FastaParser& parser          = get_parser();
+    const std::int32_t number_of_threads   = state.range(0);
+    const std::int64_t number_of_basepairs = std::int64_t(ReadsFile::number_of_reads) * ReadsFile::read_length;
+
+    for (auto _ : state)
+    {
+        std::unique_ptr<IndexHostCopyBase> index = IndexHostCopyBase::create_index_on_host(parser,
+                                                                                           0,
+                                                                                           parser.get_num_seqences(),
+                                                                                           15,
+                                                                                           15,
+                                                                                           true,
+                                                                                           1.0,
+                                                                                           number_of_threads);
+        benchmark::DoNotOptimize(index->representations().data());
+    }
+
+    state.counters["basepairs_per_second_per_core"] = benchmark::Counter(static_cast<double>(state.iterations() * number_of_basepairs) / number_of_threads,
+                                                                         benchmark::Counter::kIsRate);
+}
+
+/// \brief returns random overlaps between reads of get_parser()
+const std::vector<Overlap>& get_overlaps()
+{
+    static const std::vector<Overlap> overlaps = []() {
+        std::minstd_rand rng(1);
+        std::uniform_int_distribution<read_id_t> read_id_distribution(0, ReadsFile::number_of_reads - 1);
+        std::uniform_int_distribution<position_in_read_t> position_distribution(0, ReadsFile::read_length - 1);
+        std::vector<Overlap> overlaps(100000);
+        for (Overlap& overlap : overlaps)
+        {
+            overlap.query_read_id_                 = read_id_distribution(rng);
+            overlap.target_read_id_                = read_id_distribution(rng);
+            overlap.query_start_position_in_read_  = position_distribution(rng);
+            overlap.query_end_position_in_read_    = position_distribution(rng);
+            overlap.target_start_position_in_read_ = position_distribution(rng);
+            overlap.target_end_position_in_read_   = position_distribution(rng);
+            overlap.relative_strand                = (rng() % 2) ? RelativeStrand::Forward : RelativeStrand::Reverse;
+            overlap.num_residues_                  = position_distribution(rng) / 15;
+        }
+        return overlaps;
+    }();
+    return overlaps;
+}
+
+/// \brief formats overlaps the way cudamapper did before PafFormatter, used as a baseline
+void format_paf_with_sprintf(const std::vector<Overlap>& overlaps,
+                             const io::FastaParser& parser,
+                             const std::int32_t kmer_size,
+                             std::vector<char>& buffer)
+{
+    buffer.resize(150 * overlaps.size());
+    std::int64_t chars_in_buffer = 0;
+
+    for (const Overlap& overlap : overlaps)
+    {
+        const cga_string_view_t query_read_name  = parser.get_name_view_by_id(overlap.query_read_id_);
+        const cga_string_view_t target_read_name = parser.get_name_view_by_id(overlap.target_read_id_);
+        const std::int64_t expected_chars        = 150 + query_read_name.size() + target_read_name.size();
+        if (static_cast<std::int64_t>(buffer.size()) - chars_in_buffer < expected_chars)
+        {
+            buffer.resize(buffer.size() * 2 + expected_chars);
+        }
+        chars_in_buffer += std::sprintf(buffer.data() + chars_in_buffer,
+                                        "%.*s\t%u\t%i\t%i\t%c\t%.*s\t%u\t%i\t%i\t%i\t%ld\t%i",
+                                        static_cast<int>(query_read_name.size()),
+                                        query_read_name.data(),
+                                        parser.get_sequence_length_by_id(overlap.query_read_id_),
+                                        overlap.query_start_position_in_read_,
+                                        overlap.query_end_position_in_read_,
+                                        static_cast<unsigned char>(overlap.relative_strand),
+                                        static_cast<int>(target_read_name.size()),
+                                        target_read_name.data(),
+                                        parser.get_sequence_length_by_id(overlap.target_read_id_),
+                                        overlap.target_start_position_in_read_,
+                                        overlap.target_end_position_in_read_,
+                                        overlap.num_residues_ * kmer_size,
+                                        std::max(std::abs(static_cast<std::int64_t>(overlap.target_start_position_in_read_) - static_cast<std::int64_t>(overlap.target_end_position_in_read_)),
+                                                 std::abs(static_cast<std::int64_t>(overlap.query_start_position_in_read_) - static_cast<std::int64_t>(overlap.query_end_position_in_read_))),
+                                        255);
+        buffer[chars_in_buffer] = '\n';
+        ++chars_in_buffer;
+    }
+
+    buffer.resize(chars_in_buffer);
+}
+
+static void BM_PafSprintf(benchmark::State& state)
+{
+    const io::FastaParser& parser        = get_parser();
+    const std::vector<Overlap>& overlaps = get_overlaps();
+
+    std::vector<char> buffer;
+    for (auto _ : state)
+    {
+        format_paf_with_sprintf(overlaps, parser, 15, buffer);
+        benchmark::DoNotOptimize(buffer.data());
+    }
+
+    state.counters["records_per_second"] = benchmark::Counter(static_cast<double>(state.iterations() * overlaps.size()),
+                                                              benchmark::Counter::kIsRate);
+}
+
+static void BM_PafFormatter(benchmark::State& state)
+{
+    const io::FastaParser& parser        = get_parser();
+    const std::vector<Overlap>& overlaps = get_overlaps();
+    const PafFormatter formatter(parser, parser, 15);
+
+    std::vector<char> buffer;
+    for (auto _ : state)
+    {
+        buffer.clear();
+        formatter.append_paf(overlaps, {}, buffer);
+        benchmark::DoNotOptimize(buffer.data());
+    }
+
+    state.counters["records_per_second"] = benchmark::Counter(static_cast<double>(state.iterations() * overlaps.size()),
+                                                              benchmark::Counter::kIsRate);
+}
+
+// Register the functions as a benchmark
+BENCHMARK(BM_FindMinimizers)
+    ->Unit(benchmark::kMillisecond)
+    ->Args({15, 15, 1})
+    ->Args({15, 15, 0})
+    ->Args({19, 10, 1})
+    ->Args({24, 50, 1});
+
+BENCHMARK(BM_IndexCPU)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime()
+    ->RangeMultiplier(2)
+    ->Range(1, std::max(1, static_cast<int>(std::thread::hardware_concurrency())));
+
+BENCHMARK(BM_PafSprintf)
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK(BM_PafFormatter)
+    ->Unit(benchmark::kMillisecond);
+
+} // namespace cudamapper
+
+} // namespace genomeworks
+
+} // namespace claraparabricks
+
+BENCHMARK_MAIN();
@@ -0,0 +1,189 @@
+/*
+* Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <claragenomics/cudamapper/types.hpp>
+
+namespace claraparabricks
+{
+
+namespace genomeworks
+{
+
+namespace io
+{
+class FastaParser;
+} // namespace io
+
+namespace cudamapper
+{
+/// \addtogroup cudamapper
+/// \{
+
+/// Binary overlaps file format
+///
+/// Alternative to PAF for programs which process cudamapper output further, overlaps take 32 bytes instead of roughly 150 characters
+/// and do not have to be formatted and parsed. All values are stored in native byte order.
+///
+/// The file starts with BinaryOverlapsFileHeader followed by the read table of query reads and, unless query and target reads are the same,
+/// the read table of target reads. A read table consists of the length of every read (number_of_reads x std::uint32_t), the offset of every
+/// read name (number_of_reads + 1 x std::uint64_t) and all read names one after another.
+///
+/// The rest of the file are blocks of overlaps, every block starts with BinaryOverlapsBlockHeader followed by number_of_overlaps BinaryOverlapRecords.
+/// If the block has CIGAR strings they follow the records as an index of their offsets (number_of_overlaps + 1 x std::uint64_t) and all
+/// CIGAR strings one after another. Blocks are independent of each other, so the file can be written by several threads and streamed.
+
+/// BinaryOverlapsFileHeader - beginning of the file
+struct BinaryOverlapsFileHeader
+{
+    /// binary_overlaps_magic
+    char magic[8];
+    /// binary_overlaps_version
+    std::uint32_t version;
+    /// kmer size, PAF reports num_residues x kmer_size as the number of matching bases
+    std::int32_t kmer_size;
+    /// number of reads in query read table
+    std::uint32_t number_of_query_reads;
+    /// number of reads in target read table
+    std::uint32_t number_of_target_reads;
+    /// 1 if query and target reads are the same and there is only one read table, 0 otherwise
+    std::uint32_t same_query_and_target;
+    /// always 0
+    std::uint32_t reserved;
+};
+
+/// BinaryOverlapsBlockHeader - beginning of every block of overlaps
+struct BinaryOverlapsBlockHeader
+{
+    /// number of BinaryOverlapRecords in this block
+    std::uint64_t number_of_overlaps;
+    /// number of characters of all CIGAR strings in this block, 0 if the block has no CIGAR strings
+    std::uint64_t number_of_cigar_chars;
+    /// 1 if the block has CIGAR strings, 0 otherwise
+    std::uint32_t has_cigars;
+    /// always 0
+    std::uint32_t reserved;
+};
+
+/// BinaryOverlapRecord - one overlap, fixed-width counterpart of Overlap
+struct BinaryOverlapRecord
+{
+    /// read id in query read table
+    std::uint32_t query_read_id;
+    /// read id in target read table
+    std::uint32_t target_read_id;
+    /// start position in the query
+    std::uint32_t query_start_position_in_read;
+    /// end position in the query
+    std::uint32_t query_end_position_in_read;
+    /// start position in the target
+    std::uint32_t target_start_position_in_read;
+    /// end position in the target
+    std::uint32_t target_end_position_in_read;
+    /// number of residues (e.g anchors) between the two reads
+    std::uint32_t num_residues;
+    /// RelativeStrand, '+' or '-'
+    std::uint8_t relative_strand;
+    /// always 0
+    std::uint8_t reserved[3];
+};
+
+static_assert(sizeof(BinaryOverlapsFileHeader) == 32, "Binary overlaps file format has changed");
+static_assert(sizeof(BinaryOverlapsBlockHeader) == 24, "Binary overlaps file format has changed");
+static_assert(sizeof(BinaryOverlapRecord) == 32, "Binary overlaps file format has changed");
+
+/// first bytes of every binary overlaps file
+constexpr char binary_overlaps_magic[8] = {'C', 'G', 'A', 'O', 'V', 'L', 'P', '\0'};
+/// version of the file format, incremented on every change of the format
+constexpr std::uint32_t binary_overlaps_version = 1;
+
+/// \brief appends file header and read tables to buffer
+/// \param query_parser
+/// \param target_parser if it is the same object as query_parser only one read table is written
+/// \param kmer_size
+/// \param buffer existing content is kept
+void append_binary_overlaps_header(const io::FastaParser& query_parser,
+                                   const io::FastaParser& target_parser,
+                                   std::int32_t kmer_size,
+                                   std::vector<char>& buffer);
+
+/// \brief appends one block with all overlaps to buffer, nothing is appended if there are no overlaps
+/// \param overlaps
+/// \param cigars empty or one CIGAR string per overlap
+/// \param buffer existing content is kept
+void append_binary_overlaps_block(const std::vector<Overlap>& overlaps,
+                                  const std::vector<std::string>& cigars,
+                                  std::vector<char>& buffer);
+
+/// BinaryOverlapsReader - reads binary overlaps files block by block
+class BinaryOverlapsReader
+{
+public:
+    /// \brief Constructor, reads file header and read tables
+    /// \param file_path
+    /// \throw std::runtime_error if the file cannot be opened or is not a binary overlaps file of a supported version
+    explicit BinaryOverlapsReader(const std::string& file_path);
+
+    /// \brief reads next block of overlaps
+    /// \param overlaps overlaps of the block, previous content is replaced
+    /// \param cigars CIGAR strings of the block or empty if the block does not have them, previous content is replaced
+    /// \return false if there are no more blocks
+    /// \throw std::runtime_error if the file is truncated or corrupted
+    bool read_next_block(std::vector<Overlap>& overlaps,
+                         std::vector<std::string>& cigars);
+
+    /// \brief returns kmer size used to generate the overlaps
+    std::int32_t kmer_size() const;
+
+    /// \brief returns names of query reads, indexed by Overlap::query_read_id_
+    const std::vector<std::string>& query_read_names() const;
+    /// \brief returns lengths of query reads, indexed by Overlap::query_read_id_
+    const std::vector<number_of_basepairs_t>& query_read_lengths() const;
+    /// \brief returns names of target reads, indexed by Overlap::target_read_id_, same object as query_read_names() if query and target reads are the same
+    const std::vector<std::string>& target_read_names() const;
+    /// \brief returns lengths of target reads, indexed by Overlap::target_read_id_, same object as query_read_lengths() if query and target reads are the same
+    const std::vector<number_of_basepairs_t>& target_read_lengths() const;
+
+private:
+    /// \brief reads exactly size bytes
+    /// \throw std::runtime_error if the file ends before
+    void read_data(void* destination,
+                   std::size_t size);
+
+    /// \brief reads one read table
+    void read_read_table(std::uint32_t number_of_reads,
+                         std::vector<std::string>& read_names,
+                         std::vector<number_of_basepairs_t>& read_lengths);
+
+    const std::string file_path_;
+    std::ifstream file_;
+    BinaryOverlapsFileHeader file_header_;
+    std::vector<std::string> query_read_names_;
+    std::vector<number_of_basepairs_t> query_read_lengths_;
+    std::vector<std::string> target_read_names_;
+    std::vector<number_of_basepairs_t> target_read_lengths_;
+    std::vector<BinaryOverlapRecord> records_;
+    std::vector<std::uint64_t> cigar_offsets_;
+    std::vector<char> cigar_chars_;
+};
+
+/// \}
+
+} // namespace cudamapper
+
+} // namespace genomeworks
+
+} // namespace claraparabricks
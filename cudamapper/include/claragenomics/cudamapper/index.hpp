@@ -117,7 +117,7 @@ public:
     /// \param cuda_stream H2D copy is done on this stream. Device arrays are also associated with this stream and will not be freed at least until all work issued on this stream before calling their destructor is done
     /// \return a pointer to genomeworks::cudamapper::Index
     virtual std::unique_ptr<Index> copy_index_to_device(DefaultDeviceAllocator allocator,
-                                                        const cudaStream_t cuda_stream = 0) const = 0;
+                                                        const cudaStream_t cuda_stream = 0) const;
 
     /// \brief virtual destructor
     virtual ~IndexHostCopyBase() = default;
@@ -179,6 +179,29 @@ public:
                                                            const std::uint64_t kmer_size,
                                                            const std::uint64_t window_size,
                                                            const cudaStream_t cuda_stream = 0);
+
+    /// \brief generates an index on the host, without using the GPU
+    ///
+    /// Generated arrays are the same as the ones of an index generated by Index::create_index() with the same parameters
+    /// and copied to the host, so the index can be used interchangeably with indices created by create_cache()
+    ///
+    /// \param parser parser for the whole input file (part that goes into this index is determined by first_read_id and past_the_last_read_id)
+    /// \param first_read_id read_id of the first read to the included in this index
+    /// \param past_the_last_read_id read_id+1 of the last read to be included in this index
+    /// \param kmer_size k - the kmer length
+    /// \param window_size w - the length of the sliding window used to find sketch elements (i.e. the number of adjacent k-mers in a window, adjacent = shifted by one basepair)
+    /// \param hash_representations - if true, hash kmer representations
+    /// \param filtering_parameter - filter out all representations for which number_of_sketch_elements_with_that_representation/total_skech_elements >= filtering_parameter, filtering_parameter == 1.0 disables filtering
+    /// \param number_of_threads - number of host threads to use, 0 to use one thread per hardware thread
+    /// \return - an instance of IndexHostCopyBase
+    static std::unique_ptr<IndexHostCopyBase> create_index_on_host(const io::FastaParser& parser,
+                                                                   const read_id_t first_read_id,
+                                                                   const read_id_t past_the_last_read_id,
+                                                                   const std::uint64_t kmer_size,
+                                                                   const std::uint64_t window_size,
+                                                                   const bool hash_representations      = true,
+                                                                   const double filtering_parameter     = 1.0,
+                                                                   const std::int32_t number_of_threads = 0);
 };
 
 } // namespace cudamapper
@@ -9,13 +9,17 @@
 */
 
 #include "application_parameters.hpp"
+#include "index_disk_cache.hpp"
 
+#include <algorithm>
 #include <getopt.h>
 #include <iostream>
 #include <string>
+#include <vector>
 
 #include <claragenomics/cudamapper/index.hpp>
 #include <claragenomics/io/fasta_parser.hpp>
+#include <claragenomics/utils/run_in_parallel.hpp>
 #include <claragenomics/utils/signed_integer_utils.hpp>
 #include <claragenomics/version.hpp>
 
@@ -49,11 +53,25 @@ ApplicationParameters::ApplicationParameters(int argc, char* argv[])
         {"query-indices-in-device-memory", required_argument, 0, 'q'},
         {"target-indices-in-host-memory", required_argument, 0, 'C'},
         {"target-indices-in-device-memory", required_argument, 0, 'q'},
+        {"packed-reads", no_argument, 0, 'P'},
+        {"max-resident-reads", required_argument, 0, 'W'},
+        {"input-parser", required_argument, 0, 'L'},
+        {"read-ordering", required_argument, 0, 'O'},
+        {"index-cache-dir", required_argument, 0, 'I'},
+        {"host-index-cache-memory", required_argument, 0, 'M'},
+        {"index-prefetch-depth", required_argument, 0, 'p'},
+        {"tile-order", required_argument, 0, 'T'},
+        {"output-file", required_argument, 0, 'o'},
+        {"checkpoint-journal", required_argument, 0, 'J'},
+        {"sort-output-dir", required_argument, 0, 's'},
+        {"sort-memory", required_argument, 0, 'S'},
+        {"output-format", required_argument, 0, 'f'},
+        {"output-queue-capacity", required_argument, 0, 'B'},
         {"version", no_argument, 0, 'v'},
         {"help", no_argument, 0, 'h'},
     };
 
-    std::string optstring = "k:w:d:m:i:t:F:a:r:l:b:z:RDQ:q:C:c:vh";
+    std::string optstring = "k:w:d:m:i:t:F:a:r:l:b:z:RDQ:q:C:c:PW:L:O:I:M:p:T:o:J:s:S:f:B:vh";
 
     bool target_indices_in_host_memory_set   = false;
     bool target_indices_in_device_memory_set = false;
@@ -123,6 +141,120 @@ ApplicationParameters::ApplicationParameters(int argc, char* argv[])
             target_indices_in_device_memory     = std::stoi(optarg);
             target_indices_in_device_memory_set = true;
             break;
+        case 'P':
+            packed_reads = true;
+            break;
+        case 'W':
+            max_resident_reads = std::stoi(optarg);
+            break;
+        case 'L':
+            if (std::string(optarg) == "auto")
+            {
+                input_parser = InputParser::automatic;
+            }
+            else if (std::string(optarg) == "kseq")
+            {
+                input_parser = InputParser::kseq;
+            }
+            else if (std::string(optarg) == "parallel")
+            {
+                input_parser = InputParser::parallel;
+            }
+            else if (std::string(optarg) == "mmap")
+            {
+                input_parser = InputParser::mmap;
+            }
+            else
+            {
+                std::cerr << "-L / --input-parser must be one of auto, kseq, parallel or mmap" << std::endl;
+                exit(1);
+            }
+            break;
+        case 'O':
+            if (std::string(optarg) == "random")
+            {
+                read_ordering = io::ReadOrdering::random;
+            }
+            else if (std::string(optarg) == "file")
+            {
+                read_ordering = io::ReadOrdering::file_order;
+            }
+            else if (std::string(optarg) == "length-striped")
+            {
+                read_ordering = io::ReadOrdering::length_striped;
+            }
+            else if (std::string(optarg) == "length-bucketed")
+            {
+                read_ordering = io::ReadOrdering::length_bucketed;
+            }
+            else
+            {
+                std::cerr << "-O / --read-ordering must be one of random, file, length-striped or length-bucketed" << std::endl;
+                exit(1);
+            }
+            break;
+        case 'I':
+            index_cache_directory = std::string(optarg);
+            break;
+        case 'M':
+            host_index_cache_memory = std::stoi(optarg);
+            break;
+        case 'p':
+            index_prefetch_depth = std::stoi(optarg);
+            break;
+        case 'T':
+            if (std::string(optarg) == "row-major")
+            {
+                tile_order = TileOrder::row_major;
+            }
+            else if (std::string(optarg) == "serpentine")
+            {
+                tile_order = TileOrder::serpentine;
+            }
+            else if (std::string(optarg) == "hilbert")
+            {
+                tile_order = TileOrder::hilbert;
+            }
+            else if (std::string(optarg) == "auto")
+            {
+                tile_order = TileOrder::automatic;
+            }
+            else
+            {
+                std::cerr << "-T / --tile-order must be one of row-major, serpentine, hilbert or auto" << std::endl;
+                exit(1);
+            }
+            break;
+        case 'o':
+            output_filepath = std::string(optarg);
+            break;
+        case 'J':
+            checkpoint_journal_path = std::string(optarg);
+            break;
+        case 's':
+            sort_output_directory = std::string(optarg);
+            break;
+        case 'S':
+            sort_memory = std::stoi(optarg);
+            break;
+        case 'f':
+            if (std::string(optarg) == "paf")
+            {
+                binary_output = false;
+            }
+            else if (std::string(optarg) == "binary")
+            {
+                binary_output = true;
+            }
+            else
+            {
+                std::cerr << "-f / --output-format must be one of paf or binary" << std::endl;
+                exit(1);
+            }
+            break;
+        case 'B':
+            output_queue_capacity = std::stoi(optarg);
+            break;
         case 'v':
             print_version();
         case 'h':
@@ -150,6 +282,66 @@ ApplicationParameters::ApplicationParameters(int argc, char* argv[])
         exit(1);
     }
 
+    if (max_resident_reads < 0)
+    {
+        std::cerr << "-W / --max-resident-reads must not be negative" << std::endl;
+        exit(1);
+    }
+
+    if (host_index_cache_memory < 0)
+    {
+        std::cerr << "-M / --host-index-cache-memory must not be negative" << std::endl;
+        exit(1);
+    }
+
+    if (index_prefetch_depth < 0)
+    {
+        std::cerr << "-p / --index-prefetch-depth must not be negative" << std::endl;
+        exit(1);
+    }
+
+    if (!checkpoint_journal_path.empty() && output_filepath.empty())
+    {
+        std::cerr << "-J / --checkpoint-journal requires -o / --output-file" << std::endl;
+        exit(1);
+    }
+
+    if (!sort_output_directory.empty() && !checkpoint_journal_path.empty())
+    {
+        std::cerr << "-s / --sort-output-dir cannot be used together with -J / --checkpoint-journal" << std::endl;
+        exit(1);
+    }
+
+    if (binary_output && (!checkpoint_journal_path.empty() || !sort_output_directory.empty()))
+    {
+        std::cerr << "-f / --output-format binary cannot be used together with -J / --checkpoint-journal or -s / --sort-output-dir" << std::endl;
+        exit(1);
+    }
+
+    if (output_queue_capacity < 0)
+    {
+        std::cerr << "-B / --output-queue-capacity must not be negative" << std::endl;
+        exit(1);
+    }
+
+    if (sort_memory <= 0)
+    {
+        std::cerr << "-S / --sort-memory must be positive" << std::endl;
+        exit(1);
+    }
+
+    if (max_resident_reads > 0 && packed_reads)
+    {
+        std::cerr << "-W / --max-resident-reads cannot be used together with -P / --packed-reads" << std::endl;
+        exit(1);
+    }
+
+    if (input_parser != InputParser::automatic && (max_resident_reads > 0 || packed_reads))
+    {
+        std::cerr << "-L / --input-parser cannot be used together with -W / --max-resident-reads or -P / --packed-reads" << std::endl;
+        exit(1);
+    }
+
     // Check remaining argument count.
     if ((argc - optind) < 2)
     {
@@ -202,7 +394,76 @@ void ApplicationParameters::create_input_parsers(std::shared_ptr<io::FastaParser
     assert(query_parser == nullptr);
     assert(target_parser == nullptr);
 
-    query_parser = io::create_kseq_fasta_parser(query_filepath, kmer_size + windows_size - 1);
+    const number_of_basepairs_t min_sequence_length = kmer_size + windows_size - 1;
+
+    const auto create_file_parser = [this, min_sequence_length](const std::string& filepath,
+                                                                const bool shuffle,
+                                                                const std::size_t number_of_files) -> std::unique_ptr<io::FastaParser> {
+        const io::InputFileFormat format = io::detect_input_file_format(filepath);
+        if (format == io::InputFileFormat::read_store)
+        {
+            // read stores can only be read by the read store parser, which memory-maps them without parsing
+            return io::create_read_store_parser(filepath, min_sequence_length, shuffle);
+        }
+        else if (max_resident_reads > 0)
+        {
+            // windowed parser keeps only recently used reads in host memory and loads the others from the file on demand,
+            // the limit is shared by all files of one input
+            return io::create_windowed_fasta_parser(filepath, min_sequence_length, shuffle, static_cast<std::size_t>(max_resident_reads) * 1'000'000 / number_of_files);
+        }
+        else if (packed_reads)
+        {
+            // packed parser keeps reads in a quarter of the host memory, at the cost of decoding them on access
+            return io::create_packed_fasta_parser(filepath, min_sequence_length, shuffle);
+        }
+        else if (input_parser == InputParser::mmap)
+        {
+            // mmap parser serves reads from the page cache and keeps only a samtools-style index in host memory
+            return io::create_mmap_fasta_parser(filepath, min_sequence_length, shuffle);
+        }
+        else if (input_parser == InputParser::parallel ||
+                 (input_parser == InputParser::automatic && format != io::InputFileFormat::gzip))
+        {
+            // parallel parser uses all host threads, also for inflating bgzip-compressed files,
+            // threads are shared by the files of one input as they are parsed concurrently
+            const std::int32_t number_of_threads = std::max(1, get_number_of_host_threads(0) / static_cast<std::int32_t>(number_of_files));
+            return io::create_parallel_fasta_parser(filepath, min_sequence_length, shuffle, number_of_threads);
+        }
+        else
+        {
+            return io::create_kseq_fasta_parser(filepath, min_sequence_length, shuffle);
+        }
+    };
+
+    const auto create_parser = [this, &create_file_parser](const std::string& input) -> std::unique_ptr<io::FastaParser> {
+        const std::vector<std::string> filepaths = get_input_files(input);
+        std::unique_ptr<io::FastaParser> parser;
+        if (filepaths.size() == 1)
+        {
+            // random ordering is done by the parsers themselves, other orderings are applied on top of reads in file order
+            parser = create_file_parser(filepaths.front(), read_ordering == io::ReadOrdering::random, 1);
+            if (read_ordering != io::ReadOrdering::random && read_ordering != io::ReadOrdering::file_order)
+            {
+                parser = io::create_ordered_fasta_parser(std::move(parser), read_ordering);
+            }
+        }
+        else
+        {
+            // files are parsed concurrently and their reads get consecutive read_ids, as if the files were concatenated,
+            // all orderings are then applied on top of the concatenation
+            parser = io::create_multi_file_fasta_parser(filepaths,
+                                                        [&create_file_parser, &filepaths](const std::string& filepath) {
+                                                            return create_file_parser(filepath, false, filepaths.size());
+                                                        });
+            if (read_ordering != io::ReadOrdering::file_order)
+            {
+                parser = io::create_ordered_fasta_parser(std::move(parser), read_ordering);
+            }
+        }
+        return parser;
+    };
+
+    query_parser = create_parser(query_filepath);
 
     if (all_to_all)
     {
@@ -210,13 +471,42 @@ void ApplicationParameters::create_input_parsers(std::shared_ptr<io::FastaParser
     }
     else
     {
-        target_parser = io::create_kseq_fasta_parser(target_filepath, kmer_size + windows_size - 1);
+        target_parser = create_parser(target_filepath);
+    }
+
+    // indices saved to disk and checkpoint journals are only valid for the same input files and the same order of reads
+    if (!index_cache_directory.empty() || !checkpoint_journal_path.empty())
+    {
+        query_input_fingerprint  = compute_input_fingerprint(get_input_files(query_filepath), read_ordering);
+        target_input_fingerprint = all_to_all ? query_input_fingerprint : compute_input_fingerprint(get_input_files(target_filepath), read_ordering);
     }
 
     std::cerr << "Query file: " << query_filepath << ", number of reads: " << query_parser->get_num_seqences() << std::endl;
     std::cerr << "Target file: " << target_filepath << ", number of reads: " << target_parser->get_num_seqences() << std::endl;
 }
 
+std::vector<std::string> ApplicationParameters::get_input_files(const std::string& input)
+{
+    if (input.size() > 5 && input.compare(input.size() - 5, 5, ".fofn") == 0)
+    {
+        return io::read_file_of_filenames(input);
+    }
+
+    std::vector<std::string> filepaths;
+    std::string::size_type first = 0;
+    while (true)
+    {
+        const std::string::size_type comma = input.find(',', first);
+        filepaths.push_back(input.substr(first, comma - first));
+        if (comma == std::string::npos)
+        {
+            break;
+        }
+        first = comma + 1;
+    }
+    return filepaths;
+}
+
 int64_t ApplicationParameters::get_max_cached_memory_bytes()
 {
 #ifdef CGA_ENABLE_CACHING_ALLOCATOR
@@ -260,8 +550,12 @@ void ApplicationParameters::help(int32_t exit_code)
     std::cerr <<
         R"(Usage: cudamapper [options ...] <query_sequences> <target_sequences>
      <sequences>
-        Input file in FASTA/FASTQ format (can be compressed with gzip)
-        containing sequences used for all-to-all overlapping
+        Input file in FASTA/FASTQ format (can be compressed with gzip) or read store created by create_read_store
+        containing sequences used for all-to-all overlapping. Read stores are recognized by their content and are
+        always read by memory-mapping them, independently of -P, -W and -L.
+        Several files can be given as a comma-separated list or as a file-of-filenames
+        with extension .fofn listing one file per line, they are parsed concurrently
+        and their reads are numbered as if the files were concatenated
      options:
         -k, --kmer-size
             length of kmer to use for minimizers [15] (Max=)"
@@ -318,6 +612,79 @@ void ApplicationParameters::help(int32_t exit_code)
         -c, --target-indices-in-device-memory
             number of target indices to keep in device memory [5])"
               << R"(
+        -P, --packed-reads
+            keep reads in host memory packed to 2 bits per basepair, reduces host memory usage at the cost of decoding reads on access)"
+              << R"(
+        -W, --max-resident-reads
+            maximum size of reads kept in host memory (in MB) for the query input and the same again for the target input,
+            if an input consists of multiple files the limit is divided evenly among them. Other reads are read from the file on demand.
+            Only for uncompressed FASTA files, should be large enough for the reads of one batch of indices in host memory per device.
+            0 keeps all reads in host memory [0])"
+              << R"(
+        -L, --input-parser
+            parser for input files, one of:
+            auto - parallel for uncompressed and bgzip-compressed files, kseq for other compressed files
+            kseq - single-threaded parser, supports all FASTA/FASTQ files, also if compressed with gzip
+            parallel - parses and inflates on all host threads, supports uncompressed and bgzip-compressed FASTA/FASTQ files.
+                       Needs host memory for the whole uncompressed file while parsing
+            mmap - memory-maps the file and locates reads through a samtools-style index (<file>.fai), which is built
+                   if needed. Starts fast and shares memory with other processes, supports uncompressed FASTA files
+            Cannot be used together with -P or -W [auto])"
+              << R"(
+        -O, --read-ordering
+            order in which reads are grouped into indices, one of:
+            random - fixed pseudo-random shuffle
+            file - order of reads in the input file
+            length-striped - reads sorted by length, interleaving longest and shortest reads
+            length-bucketed - reads of similar lengths are bucketed, indices take reads from all buckets in turn
+            Length-based orderings spread long reads evenly over all indices [random])"
+              << R"(
+        -I, --index-cache-dir
+            directory in which indices are saved and from which they are loaded in later runs with the same
+            input files, -k, -w, -F and -O instead of being generated again. Not used if not set)"
+              << R"(
+        -M, --host-index-cache-memory
+            host memory (in MB) for indices of previous batches, shared by all devices, least recently used indices are discarded first.
+            Indices used by more than one batch are then not generated again. 0 discards indices after every batch [0])"
+              << R"(
+        -p, --index-prefetch-depth
+            number of batches per device whose host indices are generated in the background while the current batch
+            is being processed. Requires additional host and device memory for the indices of those batches [0])"
+              << R"(
+        -T, --tile-order
+            order in which query x target tiles are processed as batches, one of:
+            row-major - all target sections of one query section, then the next query section
+            serpentine - like row-major, but every other query section walks target sections backwards
+            hilbert - along a Hilbert curve, consecutive batches share indices in both directions
+            auto - the order which needs the fewest index builds with the indices kept in host memory (see -M)
+            Unless row-major, every device processes one contiguous run of batches instead of the most expensive batches first [row-major])"
+              << R"(
+        -o, --output-file
+            file to which overlaps are written instead of stdout)"
+              << R"(
+        -J, --checkpoint-journal
+            file in which batches with completely written output are recorded. Requires -o. If the file exists and was
+            written by a run with the same input and parameters, recorded batches are skipped and output is appended to the
+            output file after the last recorded batch. Output of every batch is kept in host memory until the batch is finished)"
+              << R"(
+        -s, --sort-output-dir
+            sort output by query name and then by target name. Sorted runs of overlaps are written to a temporary
+            directory created in this directory and merged once all batches are done. Output is not sorted if not set)"
+              << R"(
+        -S, --sort-memory
+            host memory (in MB) for overlaps which are being sorted and for reading sorted runs while merging [1000])"
+              << R"(
+        -f, --output-format
+            format of the output, one of:
+            paf - PAF text format
+            binary - binary overlaps, 32 bytes per overlap plus CIGAR strings and a table of read names and lengths.
+            Can be read with the BinaryOverlapsReader class or pyclaragenomics and converted to PAF with cudamapper-view.
+            Cannot be used together with -J or -s [paf])"
+              << R"(
+        -B, --output-queue-capacity
+            maximum number of tiles per device whose overlaps have been found but not yet written. Once it is reached the device
+            waits for postprocess and write threads instead of keeping more overlaps in host memory. 0 means no limit [8])"
+              << R"(
         -v, --version
             Version information)"
               << std::endl;
@@ -9,22 +9,35 @@
 */
 
 #include <memory>
+#include <string>
+#include <vector>
 
+#include <claragenomics/io/fasta_parser.hpp>
 #include <claragenomics/utils/allocator.hpp>
 
+#include "tile_order.hpp"
+
 namespace claraparabricks
 {
 
 namespace genomeworks
 {
 
-namespace io
+namespace cudamapper
 {
-class FastaParser;
-} // namespace io
 
-namespace cudamapper
+/// @brief parsers which can be selected for input files
+enum class InputParser
 {
+    /// parallel parser for uncompressed and bgzip-compressed files, kseq parser for other compressed files
+    automatic,
+    /// single-threaded KSEQPP parser, supports all FASTA/FASTQ files
+    kseq,
+    /// multi-threaded parser, supports uncompressed and bgzip-compressed FASTA/FASTQ files
+    parallel,
+    /// memory-mapping parser, supports uncompressed FASTA files
+    mmap
+};
 
 /// @brief application parameteres, default or passed through command line
 class ApplicationParameters
@@ -35,27 +48,43 @@ public:
     /// @param argv
     ApplicationParameters(int argc, char* argv[]);
 
-    uint32_t kmer_size                      = 15;    // k
-    uint32_t windows_size                   = 15;    // w
-    int32_t num_devices                     = 1;     // d
-    int32_t max_cached_memory               = 0;     // m
-    int32_t index_size                      = 30;    // i
-    int32_t target_index_size               = 30;    // t
-    double filtering_parameter              = 1.0;   // F
-    int32_t alignment_engines               = 0;     // a
-    int32_t min_residues                    = 10;    // r
-    int32_t min_overlap_len                 = 500;   // l
-    int32_t min_bases_per_residue           = 100;   // b
-    float min_overlap_fraction              = 0.95;  // z
-    bool perform_overlap_end_rescue         = false; // R
-    bool drop_fused_overlaps                = false; // D
-    int32_t query_indices_in_host_memory    = 10;    // Q
-    int32_t query_indices_in_device_memory  = 5;     // q
-    int32_t target_indices_in_host_memory   = 10;    // C
-    int32_t target_indices_in_device_memory = 5;     // c
+    uint32_t kmer_size                      = 15;                       // k
+    uint32_t windows_size                   = 15;                       // w
+    int32_t num_devices                     = 1;                        // d
+    int32_t max_cached_memory               = 0;                        // m
+    int32_t index_size                      = 30;                       // i
+    int32_t target_index_size               = 30;                       // t
+    double filtering_parameter              = 1.0;                      // F
+    int32_t alignment_engines               = 0;                        // a
+    int32_t min_residues                    = 10;                       // r
+    int32_t min_overlap_len                 = 500;                      // l
+    int32_t min_bases_per_residue           = 100;                      // b
+    float min_overlap_fraction              = 0.95;                     // z
+    bool perform_overlap_end_rescue         = false;                    // R
+    bool drop_fused_overlaps                = false;                    // D
+    int32_t query_indices_in_host_memory    = 10;                       // Q
+    int32_t query_indices_in_device_memory  = 5;                        // q
+    int32_t target_indices_in_host_memory   = 10;                       // C
+    int32_t target_indices_in_device_memory = 5;                        // c
+    bool packed_reads                       = false;                    // P
+    int32_t max_resident_reads              = 0;                        // W
+    InputParser input_parser                = InputParser::automatic;   // L
+    io::ReadOrdering read_ordering          = io::ReadOrdering::random; // O
+    std::string index_cache_directory;                                  // I
+    int32_t host_index_cache_memory         = 0;                        // M
+    int32_t index_prefetch_depth            = 0;                        // p
+    TileOrder tile_order                    = TileOrder::row_major;     // T
+    std::string output_filepath;                                        // o
+    std::string checkpoint_journal_path;                                // J
+    std::string sort_output_directory;                                  // s
+    int32_t sort_memory                     = 1000;                     // S
+    bool binary_output                      = false;                    // f
+    int32_t output_queue_capacity           = 8;                        // B
     bool all_to_all                         = false;
     std::string query_filepath;
     std::string target_filepath;
+    uint64_t query_input_fingerprint        = 0;
+    uint64_t target_input_fingerprint       = 0;
     std::shared_ptr<io::FastaParser> query_parser;
     std::shared_ptr<io::FastaParser> target_parser;
     int64_t max_cached_memory_bytes;
@@ -67,6 +96,11 @@ private:
     void create_input_parsers(std::shared_ptr<io::FastaParser>& query_parser,
                               std::shared_ptr<io::FastaParser>& target_parser);
 
+    /// \brief returns the files of one input
+    /// \param input path of a FASTA/FASTQ file, comma-separated list of paths or path of a file-of-filenames ending with .fofn
+    /// \return paths of all files of the input
+    static std::vector<std::string> get_input_files(const std::string& input);
+
     /// \brief gets max number of bytes to cache by device allocator
     ///
     /// If max_cached_memory is set that value is used, finds almost complete amount of available memory otherwise
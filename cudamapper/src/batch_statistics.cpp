@@ -0,0 +1,183 @@
+/*
+* Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#include "batch_statistics.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace claraparabricks
+{
+
+namespace genomeworks
+{
+
+namespace cudamapper
+{
+
+void SummaryStatistics::add(const double value)
+{
+    ++count_;
+    const double delta = value - mean_;
+    mean_ += delta / count_;
+    m2_ += delta * (value - mean_);
+    max_ = (1 == count_) ? value : std::max(max_, value);
+}
+
+std::int64_t SummaryStatistics::count() const
+{
+    return count_;
+}
+
+double SummaryStatistics::mean() const
+{
+    return mean_;
+}
+
+double SummaryStatistics::standard_deviation() const
+{
+    return (count_ > 0) ? std::sqrt(m2_ / count_) : 0.0;
+}
+
+double SummaryStatistics::max() const
+{
+    return max_;
+}
+
+void BatchStatistics::add_tile(const std::int64_t number_of_anchors)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    tile_anchors_.add(static_cast<double>(number_of_anchors));
+}
+
+void BatchStatistics::add_batch(const double wall_time_seconds)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    batch_wall_times_.add(wall_time_seconds);
+}
+
+void BatchStatistics::add_worker_busy_time(const std::int32_t worker_id,
+                                           const double busy_time_seconds)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (worker_id >= static_cast<std::int32_t>(worker_busy_times_.size()))
+    {
+        worker_busy_times_.resize(worker_id + 1, 0.0);
+    }
+    worker_busy_times_[worker_id] += busy_time_seconds;
+}
+
+void BatchStatistics::add_index_prefetch(const double generation_time_seconds,
+                                         const double wait_time_seconds)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    index_prefetch_generation_time_ += generation_time_seconds;
+    index_prefetch_wait_time_ += wait_time_seconds;
+}
+
+void BatchStatistics::add_output_queue(const std::int64_t capacity,
+                                       const ProducerConsumerStatistics& queue_statistics)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    output_queue_capacity_ = std::max(output_queue_capacity_, capacity);
+    output_queue_statistics_.high_water_mark = std::max(output_queue_statistics_.high_water_mark, queue_statistics.high_water_mark);
+    output_queue_statistics_.number_of_added_elements += queue_statistics.number_of_added_elements;
+    output_queue_statistics_.number_of_blocked_adds += queue_statistics.number_of_blocked_adds;
+    output_queue_statistics_.number_of_timed_out_adds += queue_statistics.number_of_timed_out_adds;
+    output_queue_statistics_.blocked_seconds += queue_statistics.blocked_seconds;
+}
+
+SummaryStatistics BatchStatistics::tile_anchors() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return tile_anchors_;
+}
+
+SummaryStatistics BatchStatistics::batch_wall_times() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return batch_wall_times_;
+}
+
+std::vector<double> BatchStatistics::worker_busy_times() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return worker_busy_times_;
+}
+
+double BatchStatistics::index_prefetch_efficiency() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (index_prefetch_generation_time_ <= 0.0)
+    {
+        return 0.0;
+    }
+    // generation time is measured in the background thread and does not include starting that thread, so waiting can take slightly longer
+    return std::max(0.0, 1.0 - index_prefetch_wait_time_ / index_prefetch_generation_time_);
+}
+
+ProducerConsumerStatistics BatchStatistics::output_queue_statistics() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return output_queue_statistics_;
+}
+
+void BatchStatistics::print(std::ostream& output) const
+{
+    const SummaryStatistics tiles      = tile_anchors();
+    const SummaryStatistics batches    = batch_wall_times();
+    double prefetch_generation_time    = 0.0;
+    std::int64_t output_queue_capacity = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        prefetch_generation_time = index_prefetch_generation_time_;
+        output_queue_capacity    = output_queue_capacity_;
+    }
+    output << "Anchors per tile: " << tiles.count() << " tiles"
+           << ", mean " << tiles.mean()
+           << ", stddev " << tiles.standard_deviation()
+           << ", max " << tiles.max() << "\n"
+           << "Wall time per batch: " << batches.count() << " batches"
+           << ", mean " << batches.mean() << " s"
+           << ", stddev " << batches.standard_deviation() << " s"
+           << ", max " << batches.max() << " s" << std::endl;
+    const std::vector<double> busy_times = worker_busy_times();
+    if (!busy_times.empty())
+    {
+        output << "Busy time per worker:";
+        for (std::size_t worker_id = 0; worker_id < busy_times.size(); ++worker_id)
+        {
+            output << (0 == worker_id ? " " : ", ") << worker_id << ": " << busy_times[worker_id] << " s";
+        }
+        output << std::endl;
+    }
+    if (prefetch_generation_time > 0.0)
+    {
+        output << "Index prefetch: " << prefetch_generation_time << " s of index generation in the background"
+               << ", " << 100.0 * index_prefetch_efficiency() << "% hidden" << std::endl;
+    }
+    const ProducerConsumerStatistics output_queue = output_queue_statistics();
+    if (output_queue.number_of_added_elements > 0)
+    {
+        output << "Output queue: at most " << output_queue.high_water_mark << " tiles waiting for writers";
+        if (output_queue_capacity > 0)
+        {
+            output << " (capacity " << output_queue_capacity << ")";
+        }
+        output << ", " << output_queue.number_of_blocked_adds << " of " << output_queue.number_of_added_elements
+               << " tiles waited " << output_queue.blocked_seconds << " s for a free slot" << std::endl;
+    }
+}
+
+} // namespace cudamapper
+
+} // namespace genomeworks
+
+} // namespace claraparabricks
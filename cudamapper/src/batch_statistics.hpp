@@ -0,0 +1,117 @@
+/*
+* Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+#include <claragenomics/utils/threadsafe_containers.hpp>
+
+namespace claraparabricks
+{
+
+namespace genomeworks
+{
+
+namespace cudamapper
+{
+
+/// SummaryStatistics - count, mean, standard deviation and maximum of a series of values
+class SummaryStatistics
+{
+public:
+    /// \brief adds a value
+    void add(double value);
+
+    /// \brief returns the number of values
+    std::int64_t count() const;
+
+    /// \brief returns the mean, 0 if there are no values
+    double mean() const;
+
+    /// \brief returns the population standard deviation, 0 if there are no values
+    double standard_deviation() const;
+
+    /// \brief returns the largest value, 0 if there are no values
+    double max() const;
+
+private:
+    std::int64_t count_ = 0;
+    double mean_        = 0.0;
+    /// sum of squared differences from the mean, updated with Welford's algorithm
+    double m2_          = 0.0;
+    double max_         = 0.0;
+};
+
+/// BatchStatistics - collects the number of anchors of every pair of query and target index (tile) and the wall time
+/// of every batch of indices, to show how evenly work is distributed, as well as how much of the index generation in
+/// the background was hidden behind the processing of previous batches and how full the queues between workers and writers got
+///
+/// All functions are thread-safe.
+class BatchStatistics
+{
+public:
+    /// \brief adds the number of anchors found for one pair of query and target index
+    void add_tile(std::int64_t number_of_anchors);
+
+    /// \brief adds the wall time of one batch of indices
+    void add_batch(double wall_time_seconds);
+
+    /// \brief adds time during which a worker was processing batches
+    void add_worker_busy_time(std::int32_t worker_id,
+                              double busy_time_seconds);
+
+    /// \brief adds the time it took to generate host indices of one batch in the background and the time the worker then still had to wait for them
+    void add_index_prefetch(double generation_time_seconds,
+                            double wait_time_seconds);
+
+    /// \brief adds statistics of one queue of overlaps between a worker and its postprocess_and_write_threads
+    /// \param capacity capacity of the queue, 0 if it is unbounded
+    /// \param queue_statistics
+    void add_output_queue(std::int64_t capacity,
+                          const ProducerConsumerStatistics& queue_statistics);
+
+    /// \brief returns statistics of anchors per tile
+    SummaryStatistics tile_anchors() const;
+
+    /// \brief returns statistics of wall time per batch
+    SummaryStatistics batch_wall_times() const;
+
+    /// \brief returns total busy time of every worker
+    std::vector<double> worker_busy_times() const;
+
+    /// \brief returns the fraction of index generation time in the background during which the worker did not have to wait, 0 if no indices were generated in the background
+    double index_prefetch_efficiency() const;
+
+    /// \brief returns combined statistics of all output queues, high water mark is the largest one of any queue
+    ProducerConsumerStatistics output_queue_statistics() const;
+
+    /// \brief prints a summary of all statistics
+    void print(std::ostream& output) const;
+
+private:
+    mutable std::mutex mutex_;
+    SummaryStatistics tile_anchors_;
+    SummaryStatistics batch_wall_times_;
+    std::vector<double> worker_busy_times_;
+    double index_prefetch_generation_time_ = 0.0;
+    double index_prefetch_wait_time_       = 0.0;
+    std::int64_t output_queue_capacity_    = 0;
+    ProducerConsumerStatistics output_queue_statistics_;
+};
+
+} // namespace cudamapper
+
+} // namespace genomeworks
+
+} // namespace claraparabricks
@@ -0,0 +1,311 @@
+/*
+* Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#include <claragenomics/cudamapper/binary_overlaps.hpp>
+
+#include <cassert>
+#include <cstring>
+#include <stdexcept>
+
+#include <claragenomics/io/fasta_parser.hpp>
+#include <claragenomics/utils/cudautils.hpp>
+
+namespace claraparabricks
+{
+
+namespace genomeworks
+{
+
+namespace cudamapper
+{
+
+namespace
+{
+
+/// \brief appends raw bytes of the values to buffer
+template <typename T>
+void append_values(const T* const values,
+                   const std::size_t number_of_values,
+                   std::vector<char>& buffer)
+{
+    const char* const data = reinterpret_cast<const char*>(values);
+    buffer.insert(end(buffer), data, data + number_of_values * sizeof(T));
+}
+
+/// \brief appends read table of all reads of the parser to buffer
+void append_read_table(const io::FastaParser& parser,
+                       std::vector<char>& buffer)
+{
+    const number_of_reads_t number_of_reads = parser.get_num_seqences();
+
+    std::vector<std::uint32_t> read_lengths(number_of_reads);
+    std::vector<std::uint64_t> name_offsets(number_of_reads + 1);
+    std::vector<char> names;
+    name_offsets[0] = 0;
+    for (read_id_t read_id = 0; read_id < number_of_reads; ++read_id)
+    {
+        const cga_string_view_t name = parser.get_name_view_by_id(read_id);
+        read_lengths[read_id]        = parser.get_sequence_length_by_id(read_id);
+        names.insert(end(names), begin(name), end(name));
+        name_offsets[read_id + 1] = names.size();
+    }
+
+    append_values(read_lengths.data(), read_lengths.size(), buffer);
+    append_values(name_offsets.data(), name_offsets.size(), buffer);
+    append_values(names.data(), names.size(), buffer);
+}
+
+} // namespace
+
+void append_binary_overlaps_header(const io::FastaParser& query_parser,
+                                   const io::FastaParser& target_parser,
+                                   const std::int32_t kmer_size,
+                                   std::vector<char>& buffer)
+{
+    const bool same_query_and_target = &query_parser == &target_parser;
+
+    BinaryOverlapsFileHeader file_header;
+    std::memcpy(file_header.magic, binary_overlaps_magic, sizeof(file_header.magic));
+    file_header.version                = binary_overlaps_version;
+    file_header.kmer_size              = kmer_size;
+    file_header.number_of_query_reads  = query_parser.get_num_seqences();
+    file_header.number_of_target_reads = target_parser.get_num_seqences();
+    file_header.same_query_and_target  = same_query_and_target ? 1 : 0;
+    file_header.reserved               = 0;
+    append_values(&file_header, 1, buffer);
+
+    append_read_table(query_parser, buffer);
+    if (!same_query_and_target)
+    {
+        append_read_table(target_parser, buffer);
+    }
+}
+
+void append_binary_overlaps_block(const std::vector<Overlap>& overlaps,
+                                  const std::vector<std::string>& cigars,
+                                  std::vector<char>& buffer)
+{
+    CGA_NVTX_RANGE(profiler, "append_binary_overlaps_block");
+
+    assert(cigars.empty() || (overlaps.size() == cigars.size()));
+
+    if (overlaps.empty())
+    {
+        return;
+    }
+
+    std::vector<std::uint64_t> cigar_offsets;
+    if (!cigars.empty())
+    {
+        cigar_offsets.reserve(cigars.size() + 1);
+        cigar_offsets.push_back(0);
+        for (const std::string& cigar : cigars)
+        {
+            cigar_offsets.push_back(cigar_offsets.back() + cigar.size());
+        }
+    }
+
+    BinaryOverlapsBlockHeader block_header;
+    block_header.number_of_overlaps    = overlaps.size();
+    block_header.number_of_cigar_chars = cigars.empty() ? 0 : cigar_offsets.back();
+    block_header.has_cigars            = cigars.empty() ? 0 : 1;
+    block_header.reserved              = 0;
+
+    buffer.reserve(buffer.size() +
+                   sizeof(BinaryOverlapsBlockHeader) +
+                   overlaps.size() * sizeof(BinaryOverlapRecord) +
+                   cigar_offsets.size() * sizeof(std::uint64_t) +
+                   block_header.number_of_cigar_chars);
+
+    append_values(&block_header, 1, buffer);
+
+    std::vector<BinaryOverlapRecord> records(overlaps.size());
+    for (std::size_t i = 0; i < overlaps.size(); ++i)
+    {
+        const Overlap& overlap               = overlaps[i];
+        BinaryOverlapRecord& record          = records[i];
+        record.query_read_id                 = overlap.query_read_id_;
+        record.target_read_id                = overlap.target_read_id_;
+        record.query_start_position_in_read  = overlap.query_start_position_in_read_;
+        record.query_end_position_in_read    = overlap.query_end_position_in_read_;
+        record.target_start_position_in_read = overlap.target_start_position_in_read_;
+        record.target_end_position_in_read   = overlap.target_end_position_in_read_;
+        record.num_residues                  = overlap.num_residues_;
+        record.relative_strand               = static_cast<std::uint8_t>(overlap.relative_strand);
+        record.reserved[0]                   = 0;
+        record.reserved[1]                   = 0;
+        record.reserved[2]                   = 0;
+    }
+    append_values(records.data(), records.size(), buffer);
+
+    if (!cigars.empty())
+    {
+        append_values(cigar_offsets.data(), cigar_offsets.size(), buffer);
+        for (const std::string& cigar : cigars)
+        {
+            buffer.insert(end(buffer), begin(cigar), end(cigar));
+        }
+    }
+}
+
+BinaryOverlapsReader::BinaryOverlapsReader(const std::string& file_path)
+    : file_path_(file_path)
+    , file_(file_path, std::ios::binary)
+{
+    if (!file_)
+    {
+        throw std::runtime_error("Cannot open binary overlaps file " + file_path_);
+    }
+
+    read_data(&file_header_, sizeof(file_header_));
+    if (0 != std::memcmp(file_header_.magic, binary_overlaps_magic, sizeof(binary_overlaps_magic)))
+    {
+        throw std::runtime_error(file_path_ + " is not a binary overlaps file");
+    }
+    if (binary_overlaps_version != file_header_.version)
+    {
+        throw std::runtime_error(file_path_ + " has binary overlaps format version " + std::to_string(file_header_.version) +
+                                 ", only version " + std::to_string(binary_overlaps_version) + " is supported");
+    }
+
+    read_read_table(file_header_.number_of_query_reads, query_read_names_, query_read_lengths_);
+    if (0 == file_header_.same_query_and_target)
+    {
+        read_read_table(file_header_.number_of_target_reads, target_read_names_, target_read_lengths_);
+    }
+}
+
+bool BinaryOverlapsReader::read_next_block(std::vector<Overlap>& overlaps,
+                                           std::vector<std::string>& cigars)
+{
+    CGA_NVTX_RANGE(profiler, "BinaryOverlapsReader::read_next_block");
+
+    overlaps.clear();
+    cigars.clear();
+
+    // end of file is only allowed between blocks
+    if (std::char_traits<char>::eof() == file_.peek())
+    {
+        return false;
+    }
+
+    BinaryOverlapsBlockHeader block_header;
+    read_data(&block_header, sizeof(block_header));
+
+    records_.resize(block_header.number_of_overlaps);
+    read_data(records_.data(), records_.size() * sizeof(BinaryOverlapRecord));
+
+    const number_of_reads_t number_of_target_reads = target_read_lengths().size();
+    overlaps.resize(records_.size());
+    for (std::size_t i = 0; i < records_.size(); ++i)
+    {
+        const BinaryOverlapRecord& record = records_[i];
+        if (record.query_read_id >= query_read_lengths_.size() || record.target_read_id >= number_of_target_reads)
+        {
+            throw std::runtime_error(file_path_ + " is corrupted, overlap with unknown read id");
+        }
+        Overlap& overlap                       = overlaps[i];
+        overlap.query_read_id_                 = record.query_read_id;
+        overlap.target_read_id_                = record.target_read_id;
+        overlap.query_start_position_in_read_  = record.query_start_position_in_read;
+        overlap.query_end_position_in_read_    = record.query_end_position_in_read;
+        overlap.target_start_position_in_read_ = record.target_start_position_in_read;
+        overlap.target_end_position_in_read_   = record.target_end_position_in_read;
+        overlap.num_residues_                  = record.num_residues;
+        overlap.relative_strand                = static_cast<RelativeStrand>(record.relative_strand);
+        overlap.overlap_complete               = true;
+    }
+
+    if (0 != block_header.has_cigars)
+    {
+        cigar_offsets_.resize(records_.size() + 1);
+        read_data(cigar_offsets_.data(), cigar_offsets_.size() * sizeof(std::uint64_t));
+        cigar_chars_.resize(block_header.number_of_cigar_chars);
+        read_data(cigar_chars_.data(), cigar_chars_.size());
+
+        cigars.reserve(records_.size());
+        for (std::size_t i = 0; i < records_.size(); ++i)
+        {
+            if (cigar_offsets_[i] > cigar_offsets_[i + 1] || cigar_offsets_[i + 1] > cigar_chars_.size())
+            {
+                throw std::runtime_error(file_path_ + " is corrupted, invalid CIGAR offset");
+            }
+            cigars.emplace_back(cigar_chars_.data() + cigar_offsets_[i], cigar_offsets_[i + 1] - cigar_offsets_[i]);
+        }
+    }
+
+    return true;
+}
+
+std::int32_t BinaryOverlapsReader::kmer_size() const
+{
+    return file_header_.kmer_size;
+}
+
+const std::vector<std::string>& BinaryOverlapsReader::query_read_names() const
+{
+    return query_read_names_;
+}
+
+const std::vector<number_of_basepairs_t>& BinaryOverlapsReader::query_read_lengths() const
+{
+    return query_read_lengths_;
+}
+
+const std::vector<std::string>& BinaryOverlapsReader::target_read_names() const
+{
+    return file_header_.same_query_and_target ? query_read_names_ : target_read_names_;
+}
+
+const std::vector<number_of_basepairs_t>& BinaryOverlapsReader::target_read_lengths() const
+{
+    return file_header_.same_query_and_target ? query_read_lengths_ : target_read_lengths_;
+}
+
+void BinaryOverlapsReader::read_data(void* const destination,
+                                     const std::size_t size)
+{
+    file_.read(static_cast<char*>(destination), size);
+    if (static_cast<std::size_t>(file_.gcount()) != size)
+    {
+        throw std::runtime_error(file_path_ + " is truncated");
+    }
+}
+
+void BinaryOverlapsReader::read_read_table(const std::uint32_t number_of_reads,
+                                           std::vector<std::string>& read_names,
+                                           std::vector<number_of_basepairs_t>& read_lengths)
+{
+    read_lengths.resize(number_of_reads);
+    read_data(read_lengths.data(), read_lengths.size() * sizeof(number_of_basepairs_t));
+
+    std::vector<std::uint64_t> name_offsets(number_of_reads + 1);
+    read_data(name_offsets.data(), name_offsets.size() * sizeof(std::uint64_t));
+
+    std::vector<char> names(name_offsets.back());
+    read_data(names.data(), names.size());
+
+    read_names.clear();
+    read_names.reserve(number_of_reads);
+    for (std::uint32_t read_id = 0; read_id < number_of_reads; ++read_id)
+    {
+        if (name_offsets[read_id] > name_offsets[read_id + 1] || name_offsets[read_id + 1] > names.size())
+        {
+            throw std::runtime_error(file_path_ + " is corrupted, invalid read name offset");
+        }
+        read_names.emplace_back(names.data() + name_offsets[read_id], name_offsets[read_id + 1] - name_offsets[read_id]);
+    }
+}
+
+} // namespace cudamapper
+
+} // namespace genomeworks
+
+} // namespace claraparabricks
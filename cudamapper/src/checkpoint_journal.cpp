@@ -0,0 +1,247 @@
+/*
+* Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#include "checkpoint_journal.hpp"
+
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <claragenomics/utils/signed_integer_utils.hpp>
+
+namespace claraparabricks
+{
+
+namespace genomeworks
+{
+
+namespace cudamapper
+{
+
+namespace
+{
+
+const std::string journal_header_prefix = "cudamapper-journal 1 ";
+
+/// \brief returns indices of one batch in the format used in the journal
+std::string batch_to_string(const std::vector<IndexDescriptor>& query_indices,
+                            const std::vector<IndexDescriptor>& target_indices)
+{
+    std::ostringstream batch;
+    auto write_indices = [&batch](const std::vector<IndexDescriptor>& indices) {
+        for (std::size_t i = 0; i < indices.size(); ++i)
+        {
+            batch << (i > 0 ? "," : "") << indices[i].first_read() << ':' << indices[i].number_of_reads();
+        }
+    };
+    write_indices(query_indices);
+    batch << ' ';
+    write_indices(target_indices);
+    return batch.str();
+}
+
+/// \brief throws std::runtime_error with the message of the last system error
+[[noreturn]] void throw_system_error(const std::string& message,
+                                     const std::string& path)
+{
+    throw std::runtime_error("CheckpointJournal: " + message + " " + path + ": " + std::strerror(errno));
+}
+
+/// \brief writes all bytes and flushes them to disk
+void write_and_sync(const int file_descriptor,
+                    const char* data,
+                    std::size_t size,
+                    const std::string& path)
+{
+    while (size > 0)
+    {
+        const ssize_t written = ::write(file_descriptor, data, size);
+        if (written < 0)
+        {
+            if (EINTR == errno)
+            {
+                continue;
+            }
+            throw_system_error("cannot write to", path);
+        }
+        data += written;
+        size -= written;
+    }
+    if (::fsync(file_descriptor) != 0)
+    {
+        throw_system_error("cannot flush", path);
+    }
+}
+
+} // namespace
+
+CheckpointJournal::CheckpointJournal(const std::string& journal_path,
+                                     const std::string& output_path,
+                                     const std::string& run_description)
+    : journal_path_(journal_path)
+    , output_path_(output_path)
+{
+    if (run_description.find('\n') != std::string::npos)
+    {
+        throw std::invalid_argument("CheckpointJournal: run_description must be one line");
+    }
+    const std::string header = journal_header_prefix + run_description + '\n';
+
+    // read the journal of a previous run
+    std::string journal;
+    {
+        std::ifstream journal_file(journal_path_, std::ios::binary);
+        if (journal_file)
+        {
+            journal.assign(std::istreambuf_iterator<char>(journal_file), std::istreambuf_iterator<char>());
+        }
+    }
+
+    // only complete lines are valid, if even the header is incomplete the previous run had not written any output
+    const std::size_t valid_journal_size = journal.rfind('\n') + 1; // 0 if there is no complete line
+    const bool resume                    = valid_journal_size > 0;
+
+    if (resume)
+    {
+        if (journal.compare(0, header.size(), header) != 0)
+        {
+            throw std::runtime_error("CheckpointJournal: " + journal_path_ + " belongs to a run with different input or parameters, remove it to start a new run");
+        }
+
+        std::istringstream batch_lines(journal.substr(header.size(), valid_journal_size - header.size()));
+        std::string batch_line;
+        while (std::getline(batch_lines, batch_line))
+        {
+            const std::size_t separator    = batch_line.find(' ');
+            std::int64_t batch_output_size = 0;
+            bool valid_output_size         = false;
+            if (std::string::npos != separator)
+            {
+                const char* const output_size_end   = batch_line.data() + separator;
+                const std::from_chars_result result = std::from_chars(batch_line.data(), output_size_end, batch_output_size);
+                // output only grows, so a smaller size than in the previous line can only come from a corrupted journal
+                valid_output_size = std::errc() == result.ec && output_size_end == result.ptr && batch_output_size >= output_size_;
+            }
+            if (!valid_output_size)
+            {
+                throw std::runtime_error("CheckpointJournal: malformed line in " + journal_path_ + ": " + batch_line);
+            }
+            output_size_ = batch_output_size;
+            completed_batches_.insert(batch_line.substr(separator + 1));
+        }
+
+        struct stat output_stats;
+        if (::stat(output_path_.c_str(), &output_stats) != 0)
+        {
+            // output file of a run which has not recorded any batch may have been removed, the run then starts over
+            if (ENOENT != errno || !completed_batches_.empty())
+            {
+                throw_system_error("cannot open", output_path_);
+            }
+            output_stats.st_size = 0;
+        }
+        if (output_stats.st_size < output_size_)
+        {
+            throw std::runtime_error("CheckpointJournal: " + output_path_ + " is shorter than recorded in " + journal_path_);
+        }
+
+        // discard output of incomplete batches and the incomplete last line of the journal
+        output_file_descriptor_ = ::open(output_path_.c_str(), O_WRONLY | O_APPEND | O_CREAT, 0644);
+        if (output_file_descriptor_ < 0)
+        {
+            throw_system_error("cannot open", output_path_);
+        }
+        if (::ftruncate(output_file_descriptor_, output_size_) != 0)
+        {
+            throw_system_error("cannot truncate", output_path_);
+        }
+        if (::truncate(journal_path_.c_str(), valid_journal_size) != 0)
+        {
+            throw_system_error("cannot truncate", journal_path_);
+        }
+
+        journal_file_descriptor_ = ::open(journal_path_.c_str(), O_WRONLY | O_APPEND);
+        if (journal_file_descriptor_ < 0)
+        {
+            throw_system_error("cannot open", journal_path_);
+        }
+    }
+    else
+    {
+        // output file is truncated before the journal is created, so a journal always refers to the output file of its own run
+        output_file_descriptor_ = ::open(output_path_.c_str(), O_WRONLY | O_APPEND | O_CREAT | O_TRUNC, 0644);
+        if (output_file_descriptor_ < 0)
+        {
+            throw_system_error("cannot create", output_path_);
+        }
+        if (::fsync(output_file_descriptor_) != 0)
+        {
+            throw_system_error("cannot flush", output_path_);
+        }
+
+        journal_file_descriptor_ = ::open(journal_path_.c_str(), O_WRONLY | O_APPEND | O_CREAT | O_TRUNC, 0644);
+        if (journal_file_descriptor_ < 0)
+        {
+            throw_system_error("cannot create", journal_path_);
+        }
+        write_and_sync(journal_file_descriptor_, header.data(), header.size(), journal_path_);
+    }
+}
+
+CheckpointJournal::~CheckpointJournal()
+{
+    if (journal_file_descriptor_ >= 0)
+    {
+        ::close(journal_file_descriptor_);
+    }
+    if (output_file_descriptor_ >= 0)
+    {
+        ::close(output_file_descriptor_);
+    }
+}
+
+bool CheckpointJournal::is_batch_completed(const std::vector<IndexDescriptor>& query_indices,
+                                           const std::vector<IndexDescriptor>& target_indices) const
+{
+    return completed_batches_.count(batch_to_string(query_indices, target_indices)) > 0;
+}
+
+std::int64_t CheckpointJournal::number_of_resumed_batches() const
+{
+    return get_size<std::int64_t>(completed_batches_);
+}
+
+void CheckpointJournal::write_batch(const std::vector<IndexDescriptor>& query_indices,
+                                    const std::vector<IndexDescriptor>& target_indices,
+                                    const std::vector<char>& output)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // output has to be on disk before the batch is recorded
+    write_and_sync(output_file_descriptor_, output.data(), output.size(), output_path_);
+    output_size_ += get_size<std::int64_t>(output);
+
+    const std::string batch_line = std::to_string(output_size_) + ' ' + batch_to_string(query_indices, target_indices) + '\n';
+    write_and_sync(journal_file_descriptor_, batch_line.data(), batch_line.size(), journal_path_);
+}
+
+} // namespace cudamapper
+
+} // namespace genomeworks
+
+} // namespace claraparabricks
@@ -0,0 +1,105 @@
+/*
+* Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "index_descriptor.hpp"
+
+namespace claraparabricks
+{
+
+namespace genomeworks
+{
+
+namespace cudamapper
+{
+
+/// CheckpointJournal - records batches whose output has been completely written, so that an interrupted run can be resumed
+///
+/// The journal is a text file. Its first line describes the run (input files and all parameters the output depends on),
+/// every following line records one completed batch:
+/// <output size after the batch> <query indices> <target indices>
+/// with indices written as first_read:number_of_reads and separated by commas.
+///
+/// Output of every batch is appended to the output file at once and flushed to disk before its line is appended to the journal and flushed.
+/// The first bytes of the output file of an interrupted run therefore contain the output of all batches in the journal, everything after
+/// the output size of the last recorded batch is the output of an incomplete batch and is discarded when the run is resumed.
+/// A partially written last line of the journal is discarded as well.
+class CheckpointJournal
+{
+public:
+    /// \brief Constructor, starts a new run or resumes the run recorded in the journal
+    ///
+    /// If the journal does not exist the output file is truncated and the journal is created.
+    /// If the journal exists the output file is truncated to the output size of the last recorded batch and output of new batches is appended to it.
+    /// If the journal does not record any batch a missing output file is created.
+    ///
+    /// \param journal_path
+    /// \param output_path
+    /// \param run_description one line describing the input and all parameters the output depends on
+    /// \throw std::runtime_error if a file cannot be opened, if the journal belongs to a different run or if the output file is shorter than recorded in the journal
+    CheckpointJournal(const std::string& journal_path,
+                      const std::string& output_path,
+                      const std::string& run_description);
+
+    /// \brief deleted copy constructor
+    CheckpointJournal(const CheckpointJournal&) = delete;
+    /// \brief deleted copy assignment operator
+    CheckpointJournal& operator=(const CheckpointJournal&) = delete;
+    /// \brief deleted move constructor
+    CheckpointJournal(CheckpointJournal&&) = delete;
+    /// \brief deleted move assignment operator
+    CheckpointJournal& operator=(CheckpointJournal&&) = delete;
+
+    /// \brief Destructor, closes the files
+    ~CheckpointJournal();
+
+    /// \brief returns true if the output of the batch has been written by a previous run
+    /// \param query_indices
+    /// \param target_indices
+    /// \return whether the batch is completed
+    bool is_batch_completed(const std::vector<IndexDescriptor>& query_indices,
+                            const std::vector<IndexDescriptor>& target_indices) const;
+
+    /// \brief returns the number of batches completed by previous runs
+    std::int64_t number_of_resumed_batches() const;
+
+    /// \brief appends output of one batch to the output file and records the batch in the journal, thread-safe
+    /// \param query_indices
+    /// \param target_indices
+    /// \param output
+    /// \throw std::runtime_error if writing fails
+    void write_batch(const std::vector<IndexDescriptor>& query_indices,
+                     const std::vector<IndexDescriptor>& target_indices,
+                     const std::vector<char>& output);
+
+private:
+    const std::string journal_path_;
+    const std::string output_path_;
+    int journal_file_descriptor_ = -1;
+    int output_file_descriptor_  = -1;
+    /// output file size after the last recorded batch
+    std::int64_t output_size_ = 0;
+    /// batches completed by previous runs, in the same format as in the journal
+    std::unordered_set<std::string> completed_batches_;
+    std::mutex mutex_;
+};
+
+} // namespace cudamapper
+
+} // namespace genomeworks
+
+} // namespace claraparabricks
@@ -10,7 +10,6 @@
 
 #pragma once
 
-#include <mutex>
 #include <vector>
 
 #include <claragenomics/cudamapper/types.hpp>
@@ -22,28 +21,9 @@ namespace claraparabricks
 namespace genomeworks
 {
 
-namespace io
-{
-class FastaParser;
-}; // namespace io
-
 namespace cudamapper
 {
 
-/// \brief prints overlaps to stdout in <a href="https://github.com/lh3/miniasm/blob/master/PAF.md">PAF format</a>
-/// \param overlaps vector of overlap objects
-/// \param cigar cigar strings
-/// \param query_parser needed for read names and lenghts
-/// \param target_parser needed for read names and lenghts
-/// \param kmer_size minimizer kmer size
-/// \param write_output_mutex mutex that enables exclusive access to output stream
-void print_paf(const std::vector<Overlap>& overlaps,
-               const std::vector<std::string>& cigar,
-               const io::FastaParser& query_parser,
-               const io::FastaParser& target_parser,
-               int32_t kmer_size,
-               std::mutex& write_output_mutex);
-
 /// \brief Given a string s, produce its kmers (length <kmer-length>) and return them as a vector of strings.
 /// \param s A string sequence to kmerize.
 /// \param kmer_size A kmer length to use for producing kmers.
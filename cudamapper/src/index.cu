@@ -44,6 +44,15 @@ std::unique_ptr<Index> Index::create_index(DefaultDeviceAllocator allocator,
                                                  cuda_stream);
 }
 
+std::unique_ptr<Index> IndexHostCopyBase::copy_index_to_device(DefaultDeviceAllocator allocator,
+                                                               const cudaStream_t cuda_stream) const
+{
+    CGA_NVTX_RANGE(profiler, "cache_H2D");
+    return std::make_unique<IndexGPU<Minimizer>>(allocator,
+                                                 *this,
+                                                 cuda_stream);
+}
+
 std::unique_ptr<IndexHostCopyBase> IndexHostCopyBase::create_cache(const Index& index,
                                                                    const read_id_t first_read_id,
                                                                    const std::uint64_t kmer_size,
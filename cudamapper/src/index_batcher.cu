@@ -11,6 +11,13 @@
 #include "index_batcher.cuh"
 
 #include <algorithm>
+#include <cstdlib>
+#include <list>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <claragenomics/utils/mathutils.hpp>
+#include <claragenomics/utils/signed_integer_utils.hpp>
 
 namespace claraparabricks
 {
@@ -21,6 +28,125 @@ namespace genomeworks
 namespace cudamapper
 {
 
+namespace
+{
+
+using sketch_elements_map_t = std::unordered_map<IndexDescriptor, double, IndexDescriptorHash>;
+
+/// \brief returns the expected number of sketch elements of all given indices, values for every index are cached in sketch_elements
+double expected_sketch_elements(const std::vector<IndexDescriptor>& indices,
+                                const genomeworks::io::FastaParser& parser,
+                                const std::uint64_t window_size,
+                                sketch_elements_map_t& sketch_elements)
+{
+    double total_sketch_elements = 0.0;
+    for (const IndexDescriptor& index : indices)
+    {
+        auto sketch_elements_iter = sketch_elements.find(index);
+        if (sketch_elements_iter == sketch_elements.end())
+        {
+            std::int64_t basepairs = 0;
+            for (read_id_t read_id = index.first_read(); read_id < index.first_read() + index.number_of_reads(); ++read_id)
+            {
+                basepairs += parser.get_sequence_length_by_id(read_id);
+            }
+            sketch_elements_iter = sketch_elements.emplace(index, 2.0 * basepairs / (window_size + 1)).first;
+        }
+        total_sketch_elements += sketch_elements_iter->second;
+    }
+    return total_sketch_elements;
+}
+
+/// \brief returns -1, 0 or 1 depending on the sign of value
+std::int64_t sign(const std::int64_t value)
+{
+    return (value > 0) - (value < 0);
+}
+
+/// \brief returns value / 2 rounded towards negative infinity
+std::int64_t floor_half(const std::int64_t value)
+{
+    return value >= 0 ? value / 2 : -((1 - value) / 2);
+}
+
+/// \brief appends the points of a generalized Hilbert curve which covers a rectangle of any size
+///
+/// The rectangle starts at (x, y) and is spanned by the major axis (ax, ay) and the minor axis (bx, by), one of the
+/// coordinates of each axis is 0. Rectangles are split in half along the major axis if they are much longer than wide
+/// and into three parts like the Hilbert curve otherwise, so every point is visited once in O(1) per point and
+/// consecutive points are neighbours, with a single diagonal step if the rectangle cannot be covered without one.
+///
+/// \param x
+/// \param y
+/// \param ax
+/// \param ay
+/// \param bx
+/// \param by
+/// \param points points of the curve are appended here
+void generalized_hilbert_curve(std::int64_t x,
+                               std::int64_t y,
+                               const std::int64_t ax,
+                               const std::int64_t ay,
+                               const std::int64_t bx,
+                               const std::int64_t by,
+                               std::vector<std::pair<std::int64_t, std::int64_t>>& points)
+{
+    const std::int64_t width  = std::abs(ax + ay);
+    const std::int64_t height = std::abs(bx + by);
+    const std::int64_t dax    = sign(ax);
+    const std::int64_t day    = sign(ay);
+    const std::int64_t dbx    = sign(bx);
+    const std::int64_t dby    = sign(by);
+
+    if (1 == height)
+    {
+        for (std::int64_t i = 0; i < width; ++i, x += dax, y += day)
+        {
+            points.emplace_back(x, y);
+        }
+        return;
+    }
+    if (1 == width)
+    {
+        for (std::int64_t i = 0; i < height; ++i, x += dbx, y += dby)
+        {
+            points.emplace_back(x, y);
+        }
+        return;
+    }
+
+    std::int64_t ax2 = floor_half(ax);
+    std::int64_t ay2 = floor_half(ay);
+    std::int64_t bx2 = floor_half(bx);
+    std::int64_t by2 = floor_half(by);
+
+    if (2 * width > 3 * height)
+    {
+        // long rectangle, split it into two halves along the major axis, preferring even halves
+        if (1 == std::abs(ax2 + ay2) % 2 && width > 2)
+        {
+            ax2 += dax;
+            ay2 += day;
+        }
+        generalized_hilbert_curve(x, y, ax2, ay2, bx, by, points);
+        generalized_hilbert_curve(x + ax2, y + ay2, ax - ax2, ay - ay2, bx, by, points);
+    }
+    else
+    {
+        // up along the first half of the minor axis, along the whole major axis and back down, preferring an even first half
+        if (1 == std::abs(bx2 + by2) % 2 && height > 2)
+        {
+            bx2 += dbx;
+            by2 += dby;
+        }
+        generalized_hilbert_curve(x, y, bx2, by2, ax2, ay2, points);
+        generalized_hilbert_curve(x + bx2, y + by2, ax, ay, bx - bx2, by - by2, points);
+        generalized_hilbert_curve(x + (ax - dax) + (bx2 - dbx), y + (ay - day) + (by2 - dby), -bx2, -by2, -(ax - ax2), -(ay - ay2), points);
+    }
+}
+
+} // namespace
+
 std::vector<BatchOfIndices> generate_batches_of_indices(const number_of_indices_t query_indices_per_host_batch,
                                                         const number_of_indices_t query_indices_per_device_batch,
                                                         const number_of_indices_t target_indices_per_host_batch,
@@ -29,7 +155,9 @@ std::vector<BatchOfIndices> generate_batches_of_indices(const number_of_indices_
                                                         const std::shared_ptr<const genomeworks::io::FastaParser> target_parser,
                                                         const number_of_basepairs_t query_basepairs_per_index,
                                                         const number_of_basepairs_t target_basepairs_per_index,
-                                                        const bool same_query_and_target)
+                                                        const bool same_query_and_target,
+                                                        const TileOrder tile_order,
+                                                        const number_of_indices_t index_cache_capacity)
 {
     if (same_query_and_target)
     {
@@ -58,11 +186,38 @@ std::vector<BatchOfIndices> generate_batches_of_indices(const number_of_indices_
                                                                                      target_basepairs_per_index);
 
     // find host batches
-    std::vector<IndexBatch> host_batches = details::index_batcher::group_into_batches(query_index_descriptors,
-                                                                                      target_index_descriptors,
-                                                                                      query_indices_per_host_batch,
-                                                                                      target_indices_per_host_batch,
-                                                                                      same_query_and_target);
+    std::vector<IndexBatch> host_batches;
+    if (TileOrder::automatic == tile_order)
+    {
+        // take the order which needs the fewest index builds, row-major if the orders are equally good
+        std::int64_t fewest_index_builds = 0;
+        for (const TileOrder candidate_tile_order : {TileOrder::row_major, TileOrder::serpentine, TileOrder::hilbert})
+        {
+            std::vector<IndexBatch> candidate_host_batches = details::index_batcher::group_into_batches(query_index_descriptors,
+                                                                                                        target_index_descriptors,
+                                                                                                        query_indices_per_host_batch,
+                                                                                                        target_indices_per_host_batch,
+                                                                                                        same_query_and_target,
+                                                                                                        candidate_tile_order);
+            const std::int64_t index_builds = simulate_index_builds(candidate_host_batches,
+                                                                    index_cache_capacity,
+                                                                    same_query_and_target);
+            if (TileOrder::row_major == candidate_tile_order || index_builds < fewest_index_builds)
+            {
+                fewest_index_builds = index_builds;
+                host_batches        = std::move(candidate_host_batches);
+            }
+        }
+    }
+    else
+    {
+        host_batches = details::index_batcher::group_into_batches(query_index_descriptors,
+                                                                  target_index_descriptors,
+                                                                  query_indices_per_host_batch,
+                                                                  target_indices_per_host_batch,
+                                                                  same_query_and_target,
+                                                                  tile_order);
+    }
 
     // create device batches for every host batch
     std::vector<BatchOfIndices> all_batches;
@@ -87,6 +242,122 @@ std::vector<BatchOfIndices> generate_batches_of_indices(const number_of_indices_
     return all_batches;
 }
 
+std::vector<double> estimate_batch_costs(const std::vector<BatchOfIndices>& batches,
+                                         const genomeworks::io::FastaParser& query_parser,
+                                         const genomeworks::io::FastaParser& target_parser,
+                                         const std::uint64_t window_size)
+{
+    // the same indices appear in many batches
+    sketch_elements_map_t query_sketch_elements;
+    sketch_elements_map_t target_sketch_elements;
+
+    std::vector<double> costs;
+    costs.reserve(batches.size());
+    for (const BatchOfIndices& batch : batches)
+    {
+        double cost = 0.0;
+        for (const IndexBatch& device_batch : batch.device_batches)
+        {
+            cost += expected_sketch_elements(device_batch.query_indices, query_parser, window_size, query_sketch_elements) *
+                    expected_sketch_elements(device_batch.target_indices, target_parser, window_size, target_sketch_elements);
+        }
+        costs.push_back(cost);
+    }
+    return costs;
+}
+
+std::int64_t simulate_index_builds(const std::vector<IndexBatch>& batches,
+                                   const number_of_indices_t index_cache_capacity,
+                                   const bool same_query_and_target)
+{
+    // (is_target, descriptor) of cached indices, most recently used first
+    using lru_list_t = std::list<std::pair<bool, IndexDescriptor>>;
+    using lru_map_t  = std::unordered_map<IndexDescriptor, lru_list_t::iterator, IndexDescriptorHash>;
+
+    lru_list_t lru_list;
+    lru_map_t query_lru_map;
+    lru_map_t target_lru_map;
+
+    std::int64_t index_builds = 0;
+
+    auto use_index = [&](const bool is_target, const IndexDescriptor& descriptor) {
+        lru_map_t& lru_map = is_target ? target_lru_map : query_lru_map;
+        auto lru_map_iter  = lru_map.find(descriptor);
+        if (lru_map_iter != lru_map.end())
+        {
+            lru_list.splice(lru_list.begin(), lru_list, lru_map_iter->second);
+        }
+        else
+        {
+            ++index_builds;
+            lru_list.push_front({is_target, descriptor});
+            lru_map[descriptor] = lru_list.begin();
+        }
+    };
+
+    for (const IndexBatch& batch : batches)
+    {
+        for (const IndexDescriptor& descriptor : batch.query_indices)
+        {
+            use_index(false, descriptor);
+        }
+        for (const IndexDescriptor& descriptor : batch.target_indices)
+        {
+            use_index(!same_query_and_target, descriptor);
+        }
+
+        // indices of the current batch are at the front of the list and are never discarded
+        const std::int64_t indices_to_keep = std::max<std::int64_t>(index_cache_capacity,
+                                                                    get_size<std::int64_t>(batch.query_indices) + get_size<std::int64_t>(batch.target_indices));
+        while (get_size<std::int64_t>(lru_list) > indices_to_keep)
+        {
+            (lru_list.back().first ? target_lru_map : query_lru_map).erase(lru_list.back().second);
+            lru_list.pop_back();
+        }
+    }
+
+    return index_builds;
+}
+
+IndexBatch find_indices_used_again(const IndexBatch& indices,
+                                   const std::vector<IndexBatch>& later_batches,
+                                   const bool same_query_and_target)
+{
+    using descriptor_set_t = std::unordered_set<IndexDescriptor, IndexDescriptorHash>;
+
+    descriptor_set_t later_query_indices;
+    descriptor_set_t later_target_indices;
+    for (const IndexBatch& later_batch : later_batches)
+    {
+        later_query_indices.insert(std::begin(later_batch.query_indices), std::end(later_batch.query_indices));
+        // query and target index are the same index, so a target index can be used again as query index and vice versa
+        (same_query_and_target ? later_query_indices : later_target_indices).insert(std::begin(later_batch.target_indices), std::end(later_batch.target_indices));
+    }
+    const descriptor_set_t& later_indices_of_target = same_query_and_target ? later_query_indices : later_target_indices;
+
+    IndexBatch indices_used_again;
+    descriptor_set_t added_query_indices;
+    descriptor_set_t added_target_indices;
+    // same index should not be returned both as query and as target index
+    descriptor_set_t& added_indices_of_target = same_query_and_target ? added_query_indices : added_target_indices;
+    for (const IndexDescriptor& descriptor : indices.query_indices)
+    {
+        if (later_query_indices.count(descriptor) != 0 && added_query_indices.insert(descriptor).second)
+        {
+            indices_used_again.query_indices.push_back(descriptor);
+        }
+    }
+    for (const IndexDescriptor& descriptor : indices.target_indices)
+    {
+        if (later_indices_of_target.count(descriptor) != 0 && added_indices_of_target.insert(descriptor).second)
+        {
+            indices_used_again.target_indices.push_back(descriptor);
+        }
+    }
+
+    return indices_used_again;
+}
+
 namespace details
 {
 
@@ -97,7 +368,8 @@ std::vector<IndexBatch> group_into_batches(const std::vector<IndexDescriptor>& q
                                            const std::vector<IndexDescriptor>& target_indices,
                                            const number_of_indices_t query_indices_per_batch,
                                            const number_of_indices_t target_indices_per_batch,
-                                           const bool same_query_and_target)
+                                           const bool same_query_and_target,
+                                           const TileOrder tile_order)
 {
     if (same_query_and_target)
     {
@@ -107,28 +379,96 @@ std::vector<IndexBatch> group_into_batches(const std::vector<IndexDescriptor>& q
         }
     }
 
+    const number_of_indices_t number_of_query_sections  = ceiling_divide(get_size<number_of_indices_t>(query_indices), query_indices_per_batch);
+    const number_of_indices_t number_of_target_sections = ceiling_divide(get_size<number_of_indices_t>(target_indices), target_indices_per_batch);
+
+    // if same_query_and_target only generate upper triangle of the query*target matrix instead of doing all-to-all
+    const std::vector<std::pair<number_of_indices_t, number_of_indices_t>> tiles = order_tiles(number_of_query_sections,
+                                                                                               number_of_target_sections,
+                                                                                               same_query_and_target,
+                                                                                               tile_order);
+
     std::vector<IndexBatch> batches;
-    for (auto query_it = begin(query_indices); query_it < end(query_indices); query_it += query_indices_per_batch)
+    batches.reserve(tiles.size());
+    for (const std::pair<number_of_indices_t, number_of_indices_t>& tile : tiles)
     {
-        // if same_query_and_target only generate upper triangle of the query*target matrix instead of doing all-to-all
-        auto t_begin = begin(target_indices) + (same_query_and_target ? distance(begin(query_indices), query_it) : 0);
-        for (auto target_it = t_begin; target_it < end(target_indices); target_it += target_indices_per_batch)
-        {
-            std::vector<IndexDescriptor> batch_query_indices(query_it,
-                                                             std::min(query_it + query_indices_per_batch,
-                                                                      end(query_indices)));
-            std::vector<IndexDescriptor> batch_target_indices(target_it,
-                                                              std::min(target_it + target_indices_per_batch,
-                                                                       end(target_indices)));
+        const auto query_it  = begin(query_indices) + tile.first * query_indices_per_batch;
+        const auto target_it = begin(target_indices) + tile.second * target_indices_per_batch;
 
-            batches.push_back({std::move(batch_query_indices),
-                               std::move(batch_target_indices)});
-        }
+        std::vector<IndexDescriptor> batch_query_indices(query_it,
+                                                         std::min(query_it + query_indices_per_batch,
+                                                                  end(query_indices)));
+        std::vector<IndexDescriptor> batch_target_indices(target_it,
+                                                          std::min(target_it + target_indices_per_batch,
+                                                                   end(target_indices)));
+
+        batches.push_back({std::move(batch_query_indices),
+                           std::move(batch_target_indices)});
     }
 
     return batches;
 }
 
+std::vector<std::pair<number_of_indices_t, number_of_indices_t>> order_tiles(const number_of_indices_t number_of_query_sections,
+                                                                             const number_of_indices_t number_of_target_sections,
+                                                                             const bool same_query_and_target,
+                                                                             const TileOrder tile_order)
+{
+    std::vector<std::pair<number_of_indices_t, number_of_indices_t>> tiles;
+
+    // first target section of every row
+    auto first_target_section = [same_query_and_target](const number_of_indices_t query_section) {
+        return same_query_and_target ? query_section : 0;
+    };
+
+    switch (tile_order)
+    {
+    case TileOrder::row_major:
+    case TileOrder::serpentine:
+        for (number_of_indices_t query_section = 0; query_section < number_of_query_sections; ++query_section)
+        {
+            const bool backwards = TileOrder::serpentine == tile_order && 1 == query_section % 2;
+            for (number_of_indices_t i = first_target_section(query_section); i < number_of_target_sections; ++i)
+            {
+                const number_of_indices_t target_section = backwards ? number_of_target_sections - 1 - (i - first_target_section(query_section)) : i;
+                tiles.emplace_back(query_section, target_section);
+            }
+        }
+        break;
+    case TileOrder::hilbert:
+    {
+        // the curve covers exactly the query x target matrix, so also skewed matrices take time proportional to their number of tiles
+        std::vector<std::pair<std::int64_t, std::int64_t>> points;
+        if (number_of_query_sections > 0 && number_of_target_sections > 0)
+        {
+            points.reserve(static_cast<std::size_t>(number_of_query_sections) * number_of_target_sections);
+            if (number_of_query_sections >= number_of_target_sections)
+            {
+                generalized_hilbert_curve(0, 0, number_of_query_sections, 0, 0, number_of_target_sections, points);
+            }
+            else
+            {
+                generalized_hilbert_curve(0, 0, 0, number_of_target_sections, number_of_query_sections, 0, points);
+            }
+        }
+        for (const std::pair<std::int64_t, std::int64_t>& point : points)
+        {
+            const number_of_indices_t query_section  = static_cast<number_of_indices_t>(point.first);
+            const number_of_indices_t target_section = static_cast<number_of_indices_t>(point.second);
+            if (target_section >= first_target_section(query_section))
+            {
+                tiles.emplace_back(query_section, target_section);
+            }
+        }
+        break;
+    }
+    case TileOrder::automatic:
+        throw std::invalid_argument("order_tiles: automatic tile order has to be resolved by the caller");
+    }
+
+    return tiles;
+}
+
 } // namespace index_batcher
 
 } // namespace details
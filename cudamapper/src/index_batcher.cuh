@@ -10,10 +10,12 @@
 
 #pragma once
 
+#include <utility>
 #include <vector>
 
 #include "index_cache.cuh"
 #include "index_descriptor.hpp"
+#include "tile_order.hpp"
 
 #include <claragenomics/io/fasta_parser.hpp>
 
@@ -88,6 +90,9 @@ using number_of_indices_t = std::int32_t;
 /// skipping q(30, 10), t(20, 10) due to symmetry with q( 20, 10), t(30, 10)
 /// q(30, 10), t(30, 10)
 ///
+/// Host batches are generated in the order given by tile_order, device batches of every host batch are always generated in row-major order.
+/// The examples above use TileOrder::row_major.
+///
 /// \param query_indices_per_host_batch
 /// \param query_indices_per_device_batch
 /// \param target_indices_per_host_batch
@@ -97,6 +102,8 @@ using number_of_indices_t = std::int32_t;
 /// \param query_basepairs_per_index
 /// \param target_basepairs_per_index
 /// \param same_query_and_target
+/// \param tile_order order of host batches
+/// \param index_cache_capacity number of indices kept in host memory, only used to choose the order if tile_order is TileOrder::automatic
 /// \throw std::invalid_argument if same_query_and_target is true and corresponding parameters for query and target are not the same
 /// \return generated batches
 std::vector<BatchOfIndices> generate_batches_of_indices(number_of_indices_t query_indices_per_host_batch,
@@ -107,7 +114,51 @@ std::vector<BatchOfIndices> generate_batches_of_indices(number_of_indices_t quer
                                                         const std::shared_ptr<const genomeworks::io::FastaParser> target_parser,
                                                         number_of_basepairs_t query_basepairs_per_index,
                                                         number_of_basepairs_t target_basepairs_per_index,
-                                                        bool same_query_and_target);
+                                                        bool same_query_and_target,
+                                                        TileOrder tile_order                     = TileOrder::row_major,
+                                                        number_of_indices_t index_cache_capacity = 0);
+
+/// \brief Estimates the relative cost of processing every batch
+///
+/// Most of the time is spent in matching and overlapping, whose work grows with the number of anchors. As indices have not been generated
+/// at this point the number of anchors of a pair of indices is estimated as the product of their expected numbers of sketch elements,
+/// about 2 * basepairs / (window_size + 1) for every index. Cost of a batch is the sum of these products over all its device batches.
+///
+/// \param batches
+/// \param query_parser
+/// \param target_parser
+/// \param window_size
+/// \return estimated cost of every batch, in the same order as batches
+std::vector<double> estimate_batch_costs(const std::vector<BatchOfIndices>& batches,
+                                         const genomeworks::io::FastaParser& query_parser,
+                                         const genomeworks::io::FastaParser& target_parser,
+                                         std::uint64_t window_size);
+
+/// \brief Counts how many indices have to be generated if batches are processed in the given order
+///
+/// Simulates a cache of indices which keeps up to index_cache_capacity indices, but always at least all indices of the current batch,
+/// and discards the least recently used index first. Every index of a batch which is not in the cache has to be generated.
+///
+/// \param batches
+/// \param index_cache_capacity
+/// \param same_query_and_target if true query and target index with the same descriptor are the same index
+/// \return number of generated indices
+std::int64_t simulate_index_builds(const std::vector<IndexBatch>& batches,
+                                   number_of_indices_t index_cache_capacity,
+                                   bool same_query_and_target);
+
+/// \brief Returns those of the given indices which are used again by any of later_batches
+///
+/// Pinning these indices in SharedIndexHostCache keeps them in host memory until the later batches are processed,
+/// instead of discarding them in favor of less recently used indices which are not needed anymore.
+///
+/// \param indices e.g. indices of the current batch
+/// \param later_batches
+/// \param same_query_and_target if true query and target index with the same descriptor are the same index
+/// \return indices used again, every index at most once
+IndexBatch find_indices_used_again(const IndexBatch& indices,
+                                   const std::vector<IndexBatch>& later_batches,
+                                   bool same_query_and_target);
 
 namespace details
 {
@@ -124,12 +175,30 @@ namespace index_batcher
 /// \param query_indices_per_batch
 /// \param target_indices_per_batch
 /// \param same_query_and_target
+/// \param tile_order
+/// \throw std::invalid_argument if tile_order is TileOrder::automatic
 /// \return generated batches
 std::vector<IndexBatch> group_into_batches(const std::vector<IndexDescriptor>& query_indices,
                                            const std::vector<IndexDescriptor>& target_indices,
                                            number_of_indices_t query_indices_per_batch,
                                            number_of_indices_t target_indices_per_batch,
-                                           bool same_query_and_target);
+                                           bool same_query_and_target,
+                                           TileOrder tile_order = TileOrder::row_major);
+
+/// \brief returns (query section, target section) pairs of all tiles in the given order
+///
+/// If same_query_and_target is true only tiles with target section >= query section are returned
+///
+/// \param number_of_query_sections
+/// \param number_of_target_sections
+/// \param same_query_and_target
+/// \param tile_order
+/// \throw std::invalid_argument if tile_order is TileOrder::automatic
+/// \return tiles
+std::vector<std::pair<number_of_indices_t, number_of_indices_t>> order_tiles(number_of_indices_t number_of_query_sections,
+                                                                             number_of_indices_t number_of_target_sections,
+                                                                             bool same_query_and_target,
+                                                                             TileOrder tile_order);
 
 } // namespace index_batcher
 
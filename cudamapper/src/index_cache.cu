@@ -10,6 +10,7 @@
 
 #include "index_cache.cuh"
 
+#include "index_disk_cache.hpp"
 #include "index_host_copy.cu"
 
 #include <unordered_set>
@@ -34,7 +35,10 @@ IndexCacheHost::IndexCacheHost(const bool same_query_and_target,
                                const std::uint64_t window_size,
                                const bool hash_representations,
                                const double filtering_parameter,
-                               const cudaStream_t cuda_stream)
+                               const cudaStream_t cuda_stream,
+                               std::shared_ptr<const IndexDiskCache> query_disk_cache,
+                               std::shared_ptr<const IndexDiskCache> target_disk_cache,
+                               std::shared_ptr<SharedIndexHostCache> shared_host_cache)
     : same_query_and_target_(same_query_and_target)
     , allocator_(allocator)
     , query_parser_(query_parser)
@@ -44,7 +48,20 @@ IndexCacheHost::IndexCacheHost(const bool same_query_and_target,
     , hash_representations_(hash_representations)
     , filtering_parameter_(filtering_parameter)
     , cuda_stream_(cuda_stream)
+    , query_disk_cache_(query_disk_cache)
+    , target_disk_cache_(target_disk_cache)
+    , shared_host_cache_(shared_host_cache)
 {
+    if (nullptr == shared_host_cache_)
+    {
+        shared_host_cache_ = std::make_shared<SharedIndexHostCache>(same_query_and_target_);
+    }
+}
+
+IndexCacheHost::~IndexCacheHost()
+{
+    release_indices(query_cache_, CacheSelector::query_cache);
+    release_indices(target_cache_, CacheSelector::target_cache);
 }
 
 void IndexCacheHost::generate_query_cache_content(const std::vector<IndexDescriptor>& descriptors_of_indices_to_cache,
@@ -89,10 +106,14 @@ void IndexCacheHost::generate_cache_content(const std::vector<IndexDescriptor>&
     assert(!skip_copy_to_host || (descriptors_of_indices_to_cache == descriptors_of_indices_to_keep_on_device));
 
     cache_type_t& cache_to_edit                           = (CacheSelector::query_cache == which_cache) ? query_cache_ : target_cache_;
-    const cache_type_t& cache_to_check                    = (CacheSelector::query_cache == which_cache) ? target_cache_ : query_cache_;
     device_cache_type_t& temp_device_cache_to_edit        = (CacheSelector::query_cache == which_cache) ? query_temp_device_cache_ : target_temp_device_cache_;
     const device_cache_type_t& temp_device_cache_to_check = (CacheSelector::query_cache == which_cache) ? target_temp_device_cache_ : query_temp_device_cache_;
     const genomeworks::io::FastaParser* parser            = (CacheSelector::query_cache == which_cache) ? query_parser_.get() : target_parser_.get();
+    const IndexDiskCache* disk_cache                      = (CacheSelector::query_cache == which_cache) ? query_disk_cache_.get() : target_disk_cache_.get();
+    const SharedIndexHostCache::Input input               = (CacheSelector::query_cache == which_cache) ? SharedIndexHostCache::Input::query : SharedIndexHostCache::Input::target;
+
+    // host copy is also needed to save the index to disk
+    const bool bypass_host_cache = skip_copy_to_host && nullptr == disk_cache;
 
     // convert descriptors_of_indices_to_keep_on_device into set for faster search
     std::unordered_set<IndexDescriptor, IndexDescriptorHash> descriptors_of_indices_to_keep_on_device_set(begin(descriptors_of_indices_to_keep_on_device),
@@ -109,67 +130,67 @@ void IndexCacheHost::generate_cache_content(const std::vector<IndexDescriptor>&
         std::shared_ptr<const IndexHostCopyBase> index_copy = nullptr;
         std::shared_ptr<Index> index_on_device              = nullptr;
 
-        if (same_query_and_target_)
+        if (same_query_and_target_ && keep_on_device)
         {
-            // check if the same index already exists in the other cache
-            auto existing_cache = cache_to_check.find(descriptor_of_index_to_cache);
-            if (existing_cache != cache_to_check.end())
+            // check if the same index is already kept on device by the other cache
+            auto existing_device_cache = temp_device_cache_to_check.find(descriptor_of_index_to_cache);
+            if (existing_device_cache != temp_device_cache_to_check.end())
             {
-                index_copy = existing_cache->second;
-                if (keep_on_device)
-                {
-                    auto existing_device_cache = temp_device_cache_to_check.find(descriptor_of_index_to_cache);
-                    if (existing_device_cache != temp_device_cache_to_check.end())
-                    {
-                        index_on_device = existing_device_cache->second;
-                    }
-                    else
-                    {
-                        index_on_device = index_copy->copy_index_to_device(allocator_, cuda_stream_);
-                    }
-                }
+                index_on_device = existing_device_cache->second;
             }
         }
 
-        if (nullptr == index_copy)
+        if (bypass_host_cache)
         {
-            // check if this index is already cached in this cache
-            auto existing_cache = cache_to_edit.find(descriptor_of_index_to_cache);
-            if (existing_cache != cache_to_edit.end())
+            if (nullptr == index_on_device)
             {
-                // index already cached
-                index_copy = existing_cache->second;
-                if (keep_on_device)
+                index_on_device = create_index_on_device(descriptor_of_index_to_cache, *parser);
+            }
+        }
+        else
+        {
+            // called if the index is not in shared_host_cache_ yet
+            auto load_or_create_index = [&]() -> std::shared_ptr<const IndexHostCopyBase> {
+                // try to load index saved by a previous run
+                std::shared_ptr<const IndexHostCopyBase> new_index_copy = nullptr;
+                if (nullptr != disk_cache)
                 {
-                    index_on_device = index_copy->copy_index_to_device(allocator_, cuda_stream_);
+                    new_index_copy = disk_cache->load(descriptor_of_index_to_cache);
                 }
-            }
-            else
-            {
-                // create index
-                index_on_device = Index::create_index(allocator_,
-                                                      *parser,
-                                                      descriptor_of_index_to_cache.first_read(),
-                                                      descriptor_of_index_to_cache.first_read() + descriptor_of_index_to_cache.number_of_reads(),
-                                                      kmer_size_,
-                                                      window_size_,
-                                                      hash_representations_,
-                                                      filtering_parameter_,
-                                                      cuda_stream_);
-                // copy it to host memory
-                if (!skip_copy_to_host)
+
+                if (nullptr == new_index_copy)
                 {
-                    index_copy = IndexHostCopy::create_cache(*index_on_device,
-                                                             descriptor_of_index_to_cache.first_read(),
-                                                             kmer_size_,
-                                                             window_size_,
-                                                             cuda_stream_);
+                    std::shared_ptr<Index> new_index_on_device = create_index_on_device(descriptor_of_index_to_cache, *parser);
+                    new_index_copy                             = IndexHostCopy::create_cache(*new_index_on_device,
+                                                                                             descriptor_of_index_to_cache.first_read(),
+                                                                                             kmer_size_,
+                                                                                             window_size_,
+                                                                                             cuda_stream_);
+                    if (nullptr != disk_cache)
+                    {
+                        disk_cache->store(descriptor_of_index_to_cache, *new_index_copy);
+                    }
+                    // no need to copy the index back to device later
+                    if (keep_on_device && nullptr == index_on_device)
+                    {
+                        index_on_device = new_index_on_device;
+                    }
                 }
+
+                return new_index_copy;
+            };
+
+            // if another thread is creating the same index at the moment this thread waits for it
+            index_copy = shared_host_cache_->acquire(input,
+                                                     descriptor_of_index_to_cache,
+                                                     load_or_create_index);
+
+            if (keep_on_device && nullptr == index_on_device)
+            {
+                index_on_device = index_copy->copy_index_to_device(allocator_, cuda_stream_);
             }
         }
 
-        assert(nullptr != index_copy);
-
         // save pointer to cached index
         new_cache[descriptor_of_index_to_cache] = index_copy;
         if (keep_on_device)
@@ -179,6 +200,9 @@ void IndexCacheHost::generate_cache_content(const std::vector<IndexDescriptor>&
     }
 
     std::swap(new_cache, cache_to_edit);
+
+    // indices of the new content have been acquired before releasing the old content so that indices in both are not discarded
+    release_indices(new_cache, which_cache);
 }
 
 std::shared_ptr<Index> IndexCacheHost::get_index_from_cache(const IndexDescriptor& descriptor_of_index_to_cache,
@@ -206,6 +230,34 @@ std::shared_ptr<Index> IndexCacheHost::get_index_from_cache(const IndexDescripto
     return index;
 }
 
+std::unique_ptr<Index> IndexCacheHost::create_index_on_device(const IndexDescriptor& descriptor,
+                                                              const genomeworks::io::FastaParser& parser) const
+{
+    return Index::create_index(allocator_,
+                               parser,
+                               descriptor.first_read(),
+                               descriptor.first_read() + descriptor.number_of_reads(),
+                               kmer_size_,
+                               window_size_,
+                               hash_representations_,
+                               filtering_parameter_,
+                               cuda_stream_);
+}
+
+void IndexCacheHost::release_indices(const cache_type_t& cache,
+                                     const CacheSelector which_cache)
+{
+    const SharedIndexHostCache::Input input = (CacheSelector::query_cache == which_cache) ? SharedIndexHostCache::Input::query : SharedIndexHostCache::Input::target;
+    for (const auto& descriptor_and_index : cache)
+    {
+        // indices which were only kept on device have not been acquired
+        if (nullptr != descriptor_and_index.second)
+        {
+            shared_host_cache_->release(input, descriptor_and_index.first);
+        }
+    }
+}
+
 IndexCacheDevice::IndexCacheDevice(const bool same_query_and_target,
                                    std::shared_ptr<IndexCacheHost> index_cache_host)
     : same_query_and_target_(same_query_and_target)
@@ -10,6 +10,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <memory>
 #include <unordered_map>
 
@@ -17,6 +18,7 @@
 #include <claragenomics/utils/allocator.hpp>
 
 #include "index_descriptor.hpp"
+#include "shared_index_host_cache.hpp"
 
 namespace claraparabricks
 {
@@ -34,12 +36,17 @@ namespace cudamapper
 
 class Index;
 class IndexHostCopyBase;
+class IndexDiskCache;
 
 /// IndexCacheHost - Creates Indices, stores them in host memory and on demand copies them back to device memory
 ///
 /// The user tells cache which Indices to keep in cache using generate_query_cache_content() and generate_target_cache_content() and
 /// retrieves indices using get_index_from_query_cache() and get_index_from_target_cache(). Trying to retrieve an
 /// Index which was not previously stored in cache results in an exception
+///
+/// Host copies are kept in a SharedIndexHostCache which can be shared by IndexCacheHosts of all devices, so every index is created only once
+/// and indices which are no longer part of the requested content can be reused by later calls while they fit into its memory budget.
+/// Indices which are part of the current query or target content are in use in SharedIndexHostCache.
 class IndexCacheHost
 {
 public:
@@ -53,21 +60,29 @@ public:
     /// \param hash_representations // see Index
     /// \param filtering_parameter // see Index
     /// \param cuda_stream // device memory used for Index copy will only we freed up once all previously scheduled work on this stream has finished
+    /// \param query_disk_cache if set query indices are loaded from it instead of being generated if possible, generated indices are saved to it
+    /// \param target_disk_cache if set target indices are loaded from it instead of being generated if possible, generated indices are saved to it
+    /// \param shared_host_cache host copies of indices are taken from it and saved to it, if nullptr a cache used only by this object and without memory budget is created
     IndexCacheHost(bool same_query_and_target,
                    genomeworks::DefaultDeviceAllocator allocator,
                    std::shared_ptr<genomeworks::io::FastaParser> query_parser,
                    std::shared_ptr<genomeworks::io::FastaParser> target_parser,
                    std::uint64_t kmer_size,
                    std::uint64_t window_size,
-                   bool hash_representations  = true,
-                   double filtering_parameter = 1.0,
-                   cudaStream_t cuda_stream   = 0);
+                   bool hash_representations                               = true,
+                   double filtering_parameter                              = 1.0,
+                   cudaStream_t cuda_stream                                = 0,
+                   std::shared_ptr<const IndexDiskCache> query_disk_cache  = nullptr,
+                   std::shared_ptr<const IndexDiskCache> target_disk_cache = nullptr,
+                   std::shared_ptr<SharedIndexHostCache> shared_host_cache = nullptr);
 
     IndexCacheHost(const IndexCacheHost&) = delete;
     IndexCacheHost& operator=(const IndexCacheHost&) = delete;
     IndexCacheHost(IndexCacheHost&&)                 = delete;
     IndexCacheHost& operator=(IndexCacheHost&&) = delete;
-    ~IndexCacheHost()                           = default;
+
+    /// \brief Destructor, releases indices in shared_host_cache
+    ~IndexCacheHost();
 
     /// \brief Discards previously cached query Indices, creates new Indices and copies them to host memory
     ///
@@ -133,7 +148,15 @@ private:
     std::shared_ptr<Index> get_index_from_cache(const IndexDescriptor& descriptor_of_index_to_cache,
                                                 CacheSelector which_cache);
 
-    /// Host copies of indices
+    /// \brief Creates index in device memory
+    std::unique_ptr<Index> create_index_on_device(const IndexDescriptor& descriptor,
+                                                  const genomeworks::io::FastaParser& parser) const;
+
+    /// \brief Releases all indices of the cache in shared_host_cache_
+    void release_indices(const cache_type_t& cache,
+                         CacheSelector which_cache);
+
+    /// Host copies of indices, acquired in shared_host_cache_. nullptr for indices only kept in device memory
     cache_type_t query_cache_;
     cache_type_t target_cache_;
     /// User can instruct cache to also keep certain indices in device memory until retrieved for the first time
@@ -149,6 +172,9 @@ private:
     const bool hash_representations_;
     const double filtering_parameter_;
     const cudaStream_t cuda_stream_;
+    std::shared_ptr<const IndexDiskCache> query_disk_cache_;
+    std::shared_ptr<const IndexDiskCache> target_disk_cache_;
+    std::shared_ptr<SharedIndexHostCache> shared_host_cache_;
 };
 
 /// IndexCacheDevice - Keeps copies of Indices in device memory
@@ -0,0 +1,541 @@
+/*
+* Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#include "index_cpu.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <string>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+#include <claragenomics/io/fasta_parser.hpp>
+#include <claragenomics/logging/logging.hpp>
+#include <claragenomics/utils/cudautils.hpp>
+#include <claragenomics/utils/run_in_parallel.hpp>
+
+namespace claraparabricks
+{
+
+namespace genomeworks
+{
+
+namespace cudamapper
+{
+
+namespace details
+{
+
+namespace index_cpu
+{
+
+namespace
+{
+
+/// \brief same hash as wang_hash64() in minimizer.cu
+representation_t wang_hash64(representation_t key)
+{
+    const std::uint64_t mask = (std::uint64_t(1) << 32) - 1;
+    key                      = (~key + (key << 21)) & mask;
+    key                      = key ^ key >> 24;
+    key                      = ((key + (key << 3)) + (key << 8)) & mask;
+    key                      = key ^ key >> 14;
+    key                      = ((key + (key << 2)) + (key << 4)) & mask;
+    key                      = key ^ key >> 28;
+    key                      = (key + (key << 31)) & mask;
+    return key;
+}
+
+#ifdef __AVX2__
+/// \brief wang_hash64() of four representations
+__m256i wang_hash64(__m256i key)
+{
+    const __m256i mask = _mm256_set1_epi64x((std::int64_t(1) << 32) - 1);
+    key                = _mm256_and_si256(_mm256_add_epi64(_mm256_xor_si256(key, _mm256_set1_epi64x(-1)), _mm256_slli_epi64(key, 21)), mask);
+    key                = _mm256_xor_si256(key, _mm256_srli_epi64(key, 24));
+    key                = _mm256_and_si256(_mm256_add_epi64(_mm256_add_epi64(key, _mm256_slli_epi64(key, 3)), _mm256_slli_epi64(key, 8)), mask);
+    key                = _mm256_xor_si256(key, _mm256_srli_epi64(key, 14));
+    key                = _mm256_and_si256(_mm256_add_epi64(_mm256_add_epi64(key, _mm256_slli_epi64(key, 2)), _mm256_slli_epi64(key, 4)), mask);
+    key                = _mm256_xor_si256(key, _mm256_srli_epi64(key, 28));
+    key                = _mm256_and_si256(_mm256_add_epi64(key, _mm256_slli_epi64(key, 31)), mask);
+    return key;
+}
+#endif
+
+/// \brief returns the lexical ordering hash of a basepair, A -> 0, C -> 1, G -> 2, T -> 3
+char forward_basepair_hash(const char bp)
+{
+    return 0b11 & (bp >> 2 ^ bp >> 1);
+}
+
+/// \brief returns the lexical ordering hash of the complement of a basepair
+char reverse_basepair_hash(const char bp)
+{
+    constexpr char forward_to_reverse_complement[8] = {0b0000, 0b0100, 0b0000, 0b0111, 0b0001, 0b0000, 0b0000, 0b0011};
+    return forward_basepair_hash(forward_to_reverse_complement[0b111 & bp]);
+}
+
+/// \brief turns 2-bit encoded kmer into representation the way minimizer kernels do it
+///
+/// Kernels shift basepair hashes as 32-bit ints before adding them to the 64-bit representation, so basepairs shifted
+/// by 32 bits or more are lost and the basepair shifted by 30 bits is sign-extended. This only changes representations
+/// of kmers longer than 15 basepairs and does not change hashed representations as the hash only uses the lower 32 bits.
+representation_t encoding_to_representation(const std::uint64_t encoding)
+{
+    return static_cast<representation_t>(static_cast<std::int64_t>(static_cast<std::int32_t>(static_cast<std::uint32_t>(encoding))));
+}
+
+/// \brief hashes representations (if requested) and keeps the smaller of forward and reverse representation
+/// \param forward_representations forward representations on input, representations of kmers on output
+/// \param reverse_representations reverse representations
+/// \param directions 0 if the kmer is read in forward direction, 1 if in reverse
+/// \param number_of_kmers number of kmers
+/// \param hash_representations if true, hash representations before comparing them
+void select_representations(representation_t* const forward_representations,
+                            const representation_t* const reverse_representations,
+                            char* const directions,
+                            const std::size_t number_of_kmers,
+                            const bool hash_representations)
+{
+    std::size_t kmer_index = 0;
+#ifdef __AVX2__
+    // AVX2 has no unsigned 64-bit comparison, flipping the sign bit of both values turns it into a signed one
+    const __m256i sign_bit = _mm256_set1_epi64x(std::numeric_limits<std::int64_t>::min());
+    for (; kmer_index + 4 <= number_of_kmers; kmer_index += 4)
+    {
+        __m256i forward = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(forward_representations + kmer_index));
+        __m256i reverse = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(reverse_representations + kmer_index));
+        if (hash_representations)
+        {
+            forward = wang_hash64(forward);
+            reverse = wang_hash64(reverse);
+        }
+        const __m256i reverse_smaller = _mm256_cmpgt_epi64(_mm256_xor_si256(forward, sign_bit),
+                                                           _mm256_xor_si256(reverse, sign_bit));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(forward_representations + kmer_index),
+                            _mm256_blendv_epi8(forward, reverse, reverse_smaller));
+        const int reverse_smaller_lanes = _mm256_movemask_pd(_mm256_castsi256_pd(reverse_smaller));
+        for (std::size_t lane = 0; lane < 4; ++lane)
+        {
+            directions[kmer_index + lane] = (reverse_smaller_lanes >> lane) & 1;
+        }
+    }
+#endif
+    for (; kmer_index < number_of_kmers; ++kmer_index)
+    {
+        representation_t forward_representation = forward_representations[kmer_index];
+        representation_t reverse_representation = reverse_representations[kmer_index];
+        if (hash_representations)
+        {
+            forward_representation = wang_hash64(forward_representation);
+            reverse_representation = wang_hash64(reverse_representation);
+        }
+
+        if (forward_representation <= reverse_representation)
+        {
+            forward_representations[kmer_index] = forward_representation;
+            directions[kmer_index]              = 0;
+        }
+        else
+        {
+            forward_representations[kmer_index] = reverse_representation;
+            directions[kmer_index]              = 1;
+        }
+    }
+}
+
+bool compare_representations(const HostSketchElement& a,
+                             const HostSketchElement& b)
+{
+    return a.representation_ < b.representation_;
+}
+
+} // namespace
+
+void find_minimizers_of_read(const char* const basepairs,
+                             const position_in_read_t number_of_basepairs,
+                             const read_id_t read_id,
+                             const std::uint64_t kmer_size,
+                             const std::uint64_t window_size,
+                             const bool hash_representations,
+                             MinimizerWorkspace& workspace,
+                             std::vector<HostSketchElement>& sketch_elements)
+{
+    const std::uint64_t number_of_kmers = number_of_basepairs - kmer_size + 1;
+
+    std::vector<representation_t>& kmer_representations    = workspace.forward_representations_;
+    std::vector<representation_t>& reverse_representations = workspace.reverse_representations_;
+    std::vector<char>& kmer_directions                     = workspace.directions_;
+    kmer_representations.resize(number_of_kmers);
+    reverse_representations.resize(number_of_kmers);
+    kmer_directions.resize(number_of_kmers);
+
+    // roll 2-bit encodings of both directions over the read, first basepair of the kmer is the most significant one
+    // in forward direction and the least significant one in reverse direction
+    const std::uint64_t encoding_mask = (kmer_size >= 32) ? ~std::uint64_t(0) : (std::uint64_t(1) << 2 * kmer_size) - 1;
+    const std::uint64_t reverse_shift = 2 * (kmer_size - 1);
+    std::uint64_t forward_encoding    = 0;
+    std::uint64_t reverse_encoding    = 0;
+    for (position_in_read_t i = 0; i < number_of_basepairs; ++i)
+    {
+        forward_encoding = ((forward_encoding << 2) | forward_basepair_hash(basepairs[i])) & encoding_mask;
+        reverse_encoding = (reverse_encoding >> 2) | (static_cast<std::uint64_t>(reverse_basepair_hash(basepairs[i])) << reverse_shift);
+        if (i + 1 >= kmer_size)
+        {
+            kmer_representations[i + 1 - kmer_size]    = encoding_to_representation(forward_encoding);
+            reverse_representations[i + 1 - kmer_size] = encoding_to_representation(reverse_encoding);
+        }
+    }
+
+    select_representations(kmer_representations.data(),
+                           reverse_representations.data(),
+                           kmer_directions.data(),
+                           number_of_kmers,
+                           hash_representations);
+
+    // Windows are processed in order front end windows [0, j], central windows [i, i + window_size - 1] and back end
+    // windows [number_of_kmers - window_size + 1 + j, number_of_kmers - 1], so both ends of windows never move back.
+    // Queue holds kmers of the current window which are smaller than all kmers that follow them in the window,
+    // so its front is the rightmost smallest kmer of the window. Every kmer enters the queue once, so a plain array
+    // is enough to hold it
+    std::vector<position_in_read_t>& candidates = workspace.candidates_;
+    candidates.resize(number_of_kmers);
+    std::uint64_t queue_front             = 0;
+    std::uint64_t queue_back              = 0;
+    std::uint64_t next_kmer_to_add        = 0;
+    std::uint64_t last_minimizer_position = number_of_kmers; // N/A
+    auto process_window                   = [&](const std::uint64_t first_kmer, const std::uint64_t last_kmer) {
+        for (; next_kmer_to_add <= last_kmer; ++next_kmer_to_add)
+        {
+            const representation_t representation = kmer_representations[next_kmer_to_add];
+            while (queue_back > queue_front && kmer_representations[candidates[queue_back - 1]] >= representation)
+            {
+                --queue_back;
+            }
+            candidates[queue_back++] = static_cast<position_in_read_t>(next_kmer_to_add);
+        }
+        while (candidates[queue_front] < first_kmer)
+        {
+            ++queue_front;
+        }
+        const std::uint64_t minimizer_position = candidates[queue_front];
+        // only write the first window of consecutive windows with the same minimizer
+        if (minimizer_position != last_minimizer_position)
+        {
+            sketch_elements.push_back({kmer_representations[minimizer_position],
+                                       read_id,
+                                       static_cast<position_in_read_t>(minimizer_position),
+                                       kmer_directions[minimizer_position]});
+            last_minimizer_position = minimizer_position;
+        }
+    };
+
+    for (std::uint64_t j = 0; j + 1 < window_size; ++j)
+    {
+        process_window(0, j);
+    }
+    for (std::uint64_t i = 0; i + window_size <= number_of_kmers; ++i)
+    {
+        process_window(i, i + window_size - 1);
+    }
+    for (std::uint64_t j = 0; j + 1 < window_size; ++j)
+    {
+        process_window(number_of_kmers - window_size + 1 + j, number_of_kmers - 1);
+    }
+}
+
+} // namespace index_cpu
+
+} // namespace details
+
+IndexCPU::IndexCPU(const io::FastaParser& parser,
+                   const read_id_t first_read_id,
+                   const read_id_t past_the_last_read_id,
+                   const std::uint64_t kmer_size,
+                   const std::uint64_t window_size,
+                   const bool hash_representations,
+                   const double filtering_parameter,
+                   std::int32_t number_of_threads)
+    : first_read_id_(first_read_id)
+    , kmer_size_(kmer_size)
+    , window_size_(window_size)
+{
+    using details::index_cpu::HostSketchElement;
+
+    // check if there are any reads to process
+    if (first_read_id >= past_the_last_read_id)
+    {
+        CGA_LOG_INFO("No Sketch Elements to be added to index");
+        return;
+    }
+
+    number_of_reads_ = past_the_last_read_id - first_read_id;
+
+    // reads shorter than one window have no minimizers
+    std::vector<read_id_t> indexed_reads;
+    std::uint64_t total_basepairs = 0;
+    for (read_id_t read_id = first_read_id; read_id < past_the_last_read_id; ++read_id)
+    {
+        const number_of_basepairs_t read_length = parser.get_sequence_length_by_id(read_id);
+        if (read_length >= window_size_ + kmer_size_ - 1)
+        {
+            indexed_reads.push_back(read_id);
+            total_basepairs += read_length;
+            number_of_basepairs_in_longest_read_ = std::max(number_of_basepairs_in_longest_read_, static_cast<position_in_read_t>(read_length));
+        }
+        else
+        {
+            const cga_string_view_t read_name = parser.get_name_view_by_id(read_id);
+            CGA_LOG_INFO("Skipping read {}. It has {} basepairs, one window covers {} basepairs",
+                         std::string(read_name.data(), read_name.size()),
+                         read_length,
+                         window_size_ + kmer_size_ - 1);
+        }
+    }
+
+    if (0 == total_basepairs)
+    {
+        CGA_LOG_INFO("Index for reads {} to past {} is empty",
+                     first_read_id,
+                     past_the_last_read_id);
+        number_of_reads_                     = 0;
+        number_of_basepairs_in_longest_read_ = 0;
+        return;
+    }
+
+    // *** generate minimizers ***
+    // Reads are split into consecutive ranges with roughly the same number of basepairs. Every range is processed on
+    // its own thread and its minimizers are stably sorted by representation
+    number_of_threads                  = get_number_of_host_threads(number_of_threads);
+    const std::size_t number_of_ranges = std::min(static_cast<std::size_t>(number_of_threads), indexed_reads.size());
+    std::vector<std::size_t> range_first_read(number_of_ranges + 1, indexed_reads.size());
+    {
+        std::uint64_t basepairs_so_far = 0;
+        std::size_t range_id           = 0;
+        for (std::size_t i = 0; i < indexed_reads.size() && range_id < number_of_ranges; ++i)
+        {
+            if (basepairs_so_far >= total_basepairs * range_id / number_of_ranges)
+            {
+                range_first_read[range_id++] = i;
+            }
+            basepairs_so_far += parser.get_sequence_length_by_id(indexed_reads[i]);
+        }
+    }
+
+    std::vector<std::vector<HostSketchElement>> range_sketch_elements(number_of_ranges);
+    run_in_parallel(number_of_threads,
+                    number_of_ranges,
+                    [&](const std::size_t range_id) {
+                        std::vector<HostSketchElement>& sketch_elements = range_sketch_elements[range_id];
+                        details::index_cpu::MinimizerWorkspace workspace;
+                        std::vector<char> basepairs;
+                        for (std::size_t i = range_first_read[range_id]; i < range_first_read[range_id + 1]; ++i)
+                        {
+                            const read_id_t read_id                         = indexed_reads[i];
+                            const number_of_basepairs_t number_of_basepairs = parser.get_sequence_length_by_id(read_id);
+                            basepairs.resize(number_of_basepairs);
+                            parser.copy_sequence_by_id(read_id, 0, number_of_basepairs, basepairs.data());
+                            details::index_cpu::find_minimizers_of_read(basepairs.data(),
+                                                                        number_of_basepairs,
+                                                                        read_id,
+                                                                        kmer_size_,
+                                                                        window_size_,
+                                                                        hash_representations,
+                                                                        workspace,
+                                                                        sketch_elements);
+                        }
+                        std::stable_sort(std::begin(sketch_elements),
+                                         std::end(sketch_elements),
+                                         details::index_cpu::compare_representations);
+                    });
+
+    // *** merge sorted ranges ***
+    // Ranges are concatenated in read_id order and merged pairwise, merges of one round running in parallel.
+    // As merges are stable sketch elements with the same representation remain sorted by read_id and position,
+    // which is the same order IndexGPU's stable sort produces
+    std::vector<std::size_t> range_first_element(number_of_ranges + 1, 0);
+    for (std::size_t range_id = 0; range_id < number_of_ranges; ++range_id)
+    {
+        range_first_element[range_id + 1] = range_first_element[range_id] + range_sketch_elements[range_id].size();
+    }
+    std::vector<HostSketchElement> sketch_elements(range_first_element.back());
+    run_in_parallel(number_of_threads,
+                    number_of_ranges,
+                    [&](const std::size_t range_id) {
+                        std::copy(std::begin(range_sketch_elements[range_id]),
+                                  std::end(range_sketch_elements[range_id]),
+                                  std::next(std::begin(sketch_elements), range_first_element[range_id]));
+                        range_sketch_elements[range_id].clear();
+                        range_sketch_elements[range_id].shrink_to_fit();
+                    });
+
+    for (std::size_t merged_ranges = 1; merged_ranges < number_of_ranges; merged_ranges *= 2)
+    {
+        // merge i merges ranges [2*i*merged_ranges, (2*i+1)*merged_ranges) and [(2*i+1)*merged_ranges, (2*i+2)*merged_ranges)
+        const std::size_t number_of_merges = (number_of_ranges + merged_ranges - 1) / (2 * merged_ranges);
+        run_in_parallel(number_of_threads,
+                        number_of_merges,
+                        [&](const std::size_t merge_id) {
+                            const std::size_t first_range  = 2 * merged_ranges * merge_id;
+                            const std::size_t middle_range = first_range + merged_ranges;
+                            const std::size_t past_range   = std::min(middle_range + merged_ranges, number_of_ranges);
+                            std::inplace_merge(std::next(std::begin(sketch_elements), range_first_element[first_range]),
+                                               std::next(std::begin(sketch_elements), range_first_element[middle_range]),
+                                               std::next(std::begin(sketch_elements), range_first_element[past_range]),
+                                               details::index_cpu::compare_representations);
+                        });
+    }
+
+    // *** split sketch elements into separate arrays ***
+    representations_.resize(sketch_elements.size());
+    read_ids_.resize(sketch_elements.size());
+    positions_in_reads_.resize(sketch_elements.size());
+    directions_of_reads_.resize(sketch_elements.size());
+    for (std::size_t i = 0; i < sketch_elements.size(); ++i)
+    {
+        representations_[i]     = sketch_elements[i].representation_;
+        read_ids_[i]            = sketch_elements[i].read_id_;
+        positions_in_reads_[i]  = sketch_elements[i].position_in_read_;
+        directions_of_reads_[i] = static_cast<SketchElement::DirectionOfRepresentation>(sketch_elements[i].direction_);
+    }
+    sketch_elements.clear();
+    sketch_elements.shrink_to_fit();
+
+    // *** find first occurrences of representations ***
+    for (std::size_t i = 0; i < representations_.size(); ++i)
+    {
+        if (0 == i || representations_[i] != representations_[i - 1])
+        {
+            unique_representations_.push_back(representations_[i]);
+            first_occurrence_of_representations_.push_back(static_cast<std::uint32_t>(i));
+        }
+    }
+    first_occurrence_of_representations_.push_back(static_cast<std::uint32_t>(representations_.size()));
+
+    // *** filter out most common representations ***
+    if (filtering_parameter < 1.0)
+    {
+        const std::size_t total_sketch_elements = representations_.size();
+        // + 0.001 is a hacky workaround for problems which may arise when multiplying doubles and then casting into int
+        const std::uint64_t filtering_threshold = static_cast<std::uint64_t>(total_sketch_elements * filtering_parameter + 0.001);
+
+        std::size_t elements_kept = 0;
+        std::size_t unique_kept   = 0;
+        for (std::size_t unique_index = 0; unique_index < unique_representations_.size(); ++unique_index)
+        {
+            const std::uint32_t first_element = first_occurrence_of_representations_[unique_index];
+            const std::uint32_t past_element  = first_occurrence_of_representations_[unique_index + 1];
+            if (past_element - first_element >= filtering_threshold)
+            {
+                continue;
+            }
+            unique_representations_[unique_kept]              = unique_representations_[unique_index];
+            first_occurrence_of_representations_[unique_kept] = static_cast<std::uint32_t>(elements_kept);
+            for (std::uint32_t i = first_element; i < past_element; ++i, ++elements_kept)
+            {
+                representations_[elements_kept]     = representations_[i];
+                read_ids_[elements_kept]            = read_ids_[i];
+                positions_in_reads_[elements_kept]  = positions_in_reads_[i];
+                directions_of_reads_[elements_kept] = directions_of_reads_[i];
+            }
+            ++unique_kept;
+        }
+        unique_representations_.resize(unique_kept);
+        first_occurrence_of_representations_.resize(unique_kept + 1);
+        first_occurrence_of_representations_.back() = static_cast<std::uint32_t>(elements_kept);
+        representations_.resize(elements_kept);
+        read_ids_.resize(elements_kept);
+        positions_in_reads_.resize(elements_kept);
+        directions_of_reads_.resize(elements_kept);
+    }
+}
+
+const std::vector<representation_t>& IndexCPU::representations() const
+{
+    return representations_;
+}
+
+const std::vector<read_id_t>& IndexCPU::read_ids() const
+{
+    return read_ids_;
+}
+
+const std::vector<position_in_read_t>& IndexCPU::positions_in_reads() const
+{
+    return positions_in_reads_;
+}
+
+const std::vector<SketchElement::DirectionOfRepresentation>& IndexCPU::directions_of_reads() const
+{
+    return directions_of_reads_;
+}
+
+const std::vector<representation_t>& IndexCPU::unique_representations() const
+{
+    return unique_representations_;
+}
+
+const std::vector<std::uint32_t>& IndexCPU::first_occurrence_of_representations() const
+{
+    return first_occurrence_of_representations_;
+}
+
+read_id_t IndexCPU::number_of_reads() const
+{
+    return number_of_reads_;
+}
+
+position_in_read_t IndexCPU::number_of_basepairs_in_longest_read() const
+{
+    return number_of_basepairs_in_longest_read_;
+}
+
+read_id_t IndexCPU::first_read_id() const
+{
+    return first_read_id_;
+}
+
+std::uint64_t IndexCPU::kmer_size() const
+{
+    return kmer_size_;
+}
+
+std::uint64_t IndexCPU::window_size() const
+{
+    return window_size_;
+}
+
+std::unique_ptr<IndexHostCopyBase> IndexHostCopyBase::create_index_on_host(const io::FastaParser& parser,
+                                                                           const read_id_t first_read_id,
+                                                                           const read_id_t past_the_last_read_id,
+                                                                           const std::uint64_t kmer_size,
+                                                                           const std::uint64_t window_size,
+                                                                           const bool hash_representations,
+                                                                           const double filtering_parameter,
+                                                                           const std::int32_t number_of_threads)
+{
+    CGA_NVTX_RANGE(profiler, "create_index_on_host");
+    return std::make_unique<IndexCPU>(parser,
+                                      first_read_id,
+                                      past_the_last_read_id,
+                                      kmer_size,
+                                      window_size,
+                                      hash_representations,
+                                      filtering_parameter,
+                                      number_of_threads);
+}
+
+} // namespace cudamapper
+
+} // namespace genomeworks
+
+} // namespace claraparabricks
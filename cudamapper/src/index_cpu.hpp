@@ -0,0 +1,181 @@
+/*
+* Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <claragenomics/cudamapper/index.hpp>
+
+namespace claraparabricks
+{
+
+namespace genomeworks
+{
+
+namespace cudamapper
+{
+
+/// IndexCPU - Builds an index on the host
+///
+/// Sketch elements are generated and grouped the same way IndexGPU does it, so that data arrays are bit-identical to
+/// those of an IndexGPU with the same parameters copied to the host. Reads are split into ranges whose minimizers are
+/// generated and sorted on different threads, sorted ranges are then merged.
+class IndexCPU : public IndexHostCopyBase
+{
+public:
+    /// \brief Constructor
+    ///
+    /// \param parser parser for the whole input file (part that goes into this index is determined by first_read_id and past_the_last_read_id)
+    /// \param first_read_id read_id of the first read to the included in this index
+    /// \param past_the_last_read_id read_id+1 of the last read to be included in this index
+    /// \param kmer_size k - the kmer length
+    /// \param window_size w - the length of the sliding window used to find sketch elements (i.e. the number of adjacent k-mers in a window, adjacent = shifted by one basepair)
+    /// \param hash_representations - if true, hash kmer representations
+    /// \param filtering_parameter - filter out all representations for which number_of_sketch_elements_with_that_representation/total_skech_elements >= filtering_parameter, filtering_parameter == 1.0 disables filtering
+    /// \param number_of_threads - number of threads to use, 0 to use one thread per hardware thread
+    IndexCPU(const io::FastaParser& parser,
+             const read_id_t first_read_id,
+             const read_id_t past_the_last_read_id,
+             const std::uint64_t kmer_size,
+             const std::uint64_t window_size,
+             const bool hash_representations,
+             const double filtering_parameter,
+             std::int32_t number_of_threads);
+
+    /// \brief returns an array of representations of sketch elements (stored on host)
+    /// \return an array of representations of sketch elements
+    const std::vector<representation_t>& representations() const override;
+
+    /// \brief returns an array of reads ids for sketch elements (stored on host)
+    /// \return an array of reads ids for sketch elements
+    const std::vector<read_id_t>& read_ids() const override;
+
+    /// \brief returns an array of starting positions of sketch elements in their reads (stored on host)
+    /// \return an array of starting positions of sketch elements in their reads
+    const std::vector<position_in_read_t>& positions_in_reads() const override;
+
+    /// \brief returns an array of directions in which sketch elements were read (stored on host)
+    /// \return an array of directions in which sketch elements were read
+    const std::vector<SketchElement::DirectionOfRepresentation>& directions_of_reads() const override;
+
+    /// \brief returns an array where each representation is recorded only once, sorted by representation (stored on host)
+    /// \return an array where each representation is recorded only once, sorted by representation
+    const std::vector<representation_t>& unique_representations() const override;
+
+    /// \brief returns first occurrence of corresponding representation from unique_representations(), plus one more element with the total number of sketch elements (stored on host)
+    /// \return first occurrence of corresponding representation from unique_representations(), plus one more element with the total number of sketch elements
+    const std::vector<std::uint32_t>& first_occurrence_of_representations() const override;
+
+    /// \brief returns number of reads in input data
+    /// \return number of reads in input data
+    read_id_t number_of_reads() const override;
+
+    /// \brief returns length of the longest read in this index
+    /// \return length of the longest read in this index
+    position_in_read_t number_of_basepairs_in_longest_read() const override;
+
+    /// \brief returns stored value in first_read_id_ representing smallest read_id in index
+    /// \return first_read_id_
+    read_id_t first_read_id() const override;
+
+    /// \brief returns k-mer size
+    /// \return kmer_size_
+    std::uint64_t kmer_size() const override;
+
+    /// \brief returns window size
+    /// \return window_size_
+    std::uint64_t window_size() const override;
+
+private:
+    std::vector<representation_t> representations_;
+    std::vector<read_id_t> read_ids_;
+    std::vector<position_in_read_t> positions_in_reads_;
+    std::vector<SketchElement::DirectionOfRepresentation> directions_of_reads_;
+
+    std::vector<representation_t> unique_representations_;
+    std::vector<std::uint32_t> first_occurrence_of_representations_;
+
+    read_id_t number_of_reads_                              = 0;
+    position_in_read_t number_of_basepairs_in_longest_read_ = 0;
+
+    const read_id_t first_read_id_   = 0;
+    const std::uint64_t kmer_size_   = 0;
+    const std::uint64_t window_size_ = 0;
+};
+
+namespace details
+{
+
+namespace index_cpu
+{
+
+/// HostSketchElement - one sketch element while the index is being built
+struct HostSketchElement
+{
+    /// representation of the kmer
+    representation_t representation_;
+    /// read the kmer is in
+    read_id_t read_id_;
+    /// position of the first basepair of the kmer in the read
+    position_in_read_t position_in_read_;
+    /// 0 - forward, 1 - reverse
+    char direction_;
+};
+
+/// MinimizerWorkspace - buffers used by find_minimizers_of_read(), reusing them between reads avoids reallocations
+struct MinimizerWorkspace
+{
+    /// representations of kmers in forward direction, later representations of kmers
+    std::vector<representation_t> forward_representations_;
+    /// representations of kmers in reverse direction
+    std::vector<representation_t> reverse_representations_;
+    /// 0 if the kmer is read in forward direction, 1 if in reverse
+    std::vector<char> directions_;
+    /// monotone queue of candidate minimizers
+    std::vector<position_in_read_t> candidates_;
+};
+
+/// \brief Appends the minimizers of one read to sketch_elements
+///
+/// Each window, including front end windows (starting at the first kmer and having 1 to window_size-1 kmers) and back end
+/// windows (ending at the last kmer and having window_size-1 to 1 kmers), selects its smallest kmer, the last one if
+/// several kmers have the same representation. A minimizer is only added for the first of consecutive windows which selected it.
+///
+/// Kmer representations are rolled over the read and hashed and compared in SIMD lanes if the CPU supports AVX2,
+/// window minimizers are found with a monotone queue, so the work per basepair does not depend on kmer_size or window_size.
+///
+/// \param basepairs basepairs of the read
+/// \param number_of_basepairs number of basepairs in the read, at least window_size + kmer_size - 1
+/// \param read_id read_id of the read
+/// \param kmer_size k - the kmer length
+/// \param window_size w - number of kmers in a central window
+/// \param hash_representations if true, hash kmer representations
+/// \param workspace buffers used for intermediate results
+/// \param sketch_elements minimizers are appended to this vector in order of their positions
+void find_minimizers_of_read(const char* basepairs,
+                             position_in_read_t number_of_basepairs,
+                             read_id_t read_id,
+                             std::uint64_t kmer_size,
+                             std::uint64_t window_size,
+                             bool hash_representations,
+                             MinimizerWorkspace& workspace,
+                             std::vector<HostSketchElement>& sketch_elements);
+
+} // namespace index_cpu
+
+} // namespace details
+
+} // namespace cudamapper
+
+} // namespace genomeworks
+
+} // namespace claraparabricks
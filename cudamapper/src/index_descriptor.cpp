@@ -10,8 +10,6 @@
 
 #include "index_descriptor.hpp"
 
-#include <claragenomics/utils/signed_integer_utils.hpp>
-
 namespace claraparabricks
 {
 
@@ -84,7 +82,7 @@ std::vector<IndexDescriptor> group_reads_into_indices(const io::FastaParser& par
     number_of_basepairs_t number_of_basepairs_in_current_index = 0;
     for (read_id_t read_id = 0; read_id < total_number_of_reads; read_id++)
     {
-        number_of_basepairs_t basepairs_in_this_read = get_size<number_of_basepairs_t>(parser.get_sequence_by_id(read_id).seq);
+        number_of_basepairs_t basepairs_in_this_read = parser.get_sequence_length_by_id(read_id);
         if (basepairs_in_this_read + number_of_basepairs_in_current_index > max_basepairs_per_index)
         {
             // adding this sequence would lead to index_descriptor being larger than max_basepairs_per_index
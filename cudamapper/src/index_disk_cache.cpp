@@ -0,0 +1,340 @@
+/*
+* Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#include "index_disk_cache.hpp"
+
+#include <cerrno>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <claragenomics/io/memory_mapped_file.hpp>
+#include <claragenomics/logging/logging.hpp>
+#include <claragenomics/utils/cudautils.hpp>
+
+namespace claraparabricks
+{
+
+namespace genomeworks
+{
+
+namespace cudamapper
+{
+
+namespace
+{
+
+constexpr std::uint64_t index_file_magic   = 0x5844494147435f00; // "\0_CGAIDX" in little endian
+constexpr std::uint64_t index_file_version = 1;
+
+/// IndexFileHeader - the first bytes of an index file, all fields are 64 bits wide so the struct has no padding
+struct IndexFileHeader
+{
+    std::uint64_t magic;
+    std::uint64_t version;
+    // parameters the content depends on
+    std::uint64_t input_fingerprint;
+    std::uint64_t descriptor_first_read;
+    std::uint64_t descriptor_number_of_reads;
+    std::uint64_t kmer_size;
+    std::uint64_t window_size;
+    std::uint64_t hash_representations;
+    double filtering_parameter;
+    // index
+    std::uint64_t number_of_reads;
+    std::uint64_t number_of_basepairs_in_longest_read;
+    std::uint64_t first_read_id;
+    std::uint64_t number_of_sketch_elements;
+    std::uint64_t number_of_unique_representations;
+    std::uint64_t number_of_first_occurrences; // number_of_unique_representations + 1, or 0 for empty indices
+};
+
+/// \brief rounds number of bytes up to the next multiple of 8
+std::size_t aligned_size(const std::size_t bytes)
+{
+    return (bytes + 7) / 8 * 8;
+}
+
+/// \brief returns the size of an index file with the given header
+std::size_t index_file_size(const IndexFileHeader& header)
+{
+    return sizeof(IndexFileHeader) +
+           aligned_size(header.number_of_sketch_elements * sizeof(representation_t)) +
+           aligned_size(header.number_of_sketch_elements * sizeof(read_id_t)) +
+           aligned_size(header.number_of_sketch_elements * sizeof(position_in_read_t)) +
+           aligned_size(header.number_of_sketch_elements * sizeof(SketchElement::DirectionOfRepresentation)) +
+           aligned_size(header.number_of_unique_representations * sizeof(representation_t)) +
+           aligned_size(header.number_of_first_occurrences * sizeof(std::uint32_t));
+}
+
+/// \brief 64-bit FNV-1a hash of a range of bytes, continuing from the given hash
+std::uint64_t fnv1a(const void* data,
+                    const std::size_t size,
+                    std::uint64_t hash = 0xcbf29ce484222325ull)
+{
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+/// \brief copies the next array from the mapped file and moves the pointer past it
+template <typename T>
+std::vector<T> read_array(const char*& data,
+                          const std::size_t number_of_elements)
+{
+    std::vector<T> array(number_of_elements);
+    if (number_of_elements > 0)
+    {
+        std::memcpy(array.data(), data, number_of_elements * sizeof(T));
+    }
+    data += aligned_size(number_of_elements * sizeof(T));
+    return array;
+}
+
+/// \brief writes an array and pads it to a multiple of 8 bytes
+template <typename T>
+void write_array(std::ofstream& file,
+                 const std::vector<T>& array)
+{
+    const std::size_t bytes = array.size() * sizeof(T);
+    file.write(reinterpret_cast<const char*>(array.data()), bytes);
+    const char padding[8] = {};
+    file.write(padding, aligned_size(bytes) - bytes);
+}
+
+/// IndexHostCopyFromFile - host copy of an index loaded from a file
+class IndexHostCopyFromFile : public IndexHostCopyBase
+{
+public:
+    IndexHostCopyFromFile(const IndexFileHeader& header,
+                          const char* data)
+        : representations_(read_array<representation_t>(data, header.number_of_sketch_elements))
+        , read_ids_(read_array<read_id_t>(data, header.number_of_sketch_elements))
+        , positions_in_reads_(read_array<position_in_read_t>(data, header.number_of_sketch_elements))
+        , directions_of_reads_(read_array<SketchElement::DirectionOfRepresentation>(data, header.number_of_sketch_elements))
+        , unique_representations_(read_array<representation_t>(data, header.number_of_unique_representations))
+        , first_occurrence_of_representations_(read_array<std::uint32_t>(data, header.number_of_first_occurrences))
+        , number_of_reads_(header.number_of_reads)
+        , number_of_basepairs_in_longest_read_(header.number_of_basepairs_in_longest_read)
+        , first_read_id_(header.first_read_id)
+        , kmer_size_(header.kmer_size)
+        , window_size_(header.window_size)
+    {
+    }
+
+    const std::vector<representation_t>& representations() const override { return representations_; }
+    const std::vector<read_id_t>& read_ids() const override { return read_ids_; }
+    const std::vector<position_in_read_t>& positions_in_reads() const override { return positions_in_reads_; }
+    const std::vector<SketchElement::DirectionOfRepresentation>& directions_of_reads() const override { return directions_of_reads_; }
+    const std::vector<representation_t>& unique_representations() const override { return unique_representations_; }
+    const std::vector<std::uint32_t>& first_occurrence_of_representations() const override { return first_occurrence_of_representations_; }
+    read_id_t number_of_reads() const override { return number_of_reads_; }
+    position_in_read_t number_of_basepairs_in_longest_read() const override { return number_of_basepairs_in_longest_read_; }
+    read_id_t first_read_id() const override { return first_read_id_; }
+    std::uint64_t kmer_size() const override { return kmer_size_; }
+    std::uint64_t window_size() const override { return window_size_; }
+
+private:
+    const std::vector<representation_t> representations_;
+    const std::vector<read_id_t> read_ids_;
+    const std::vector<position_in_read_t> positions_in_reads_;
+    const std::vector<SketchElement::DirectionOfRepresentation> directions_of_reads_;
+    const std::vector<representation_t> unique_representations_;
+    const std::vector<std::uint32_t> first_occurrence_of_representations_;
+    const read_id_t number_of_reads_;
+    const position_in_read_t number_of_basepairs_in_longest_read_;
+    const read_id_t first_read_id_;
+    const std::uint64_t kmer_size_;
+    const std::uint64_t window_size_;
+};
+
+} // namespace
+
+IndexDiskCache::IndexDiskCache(const std::string& directory,
+                               const std::uint64_t input_fingerprint,
+                               const std::uint64_t kmer_size,
+                               const std::uint64_t window_size,
+                               const bool hash_representations,
+                               const double filtering_parameter)
+    : directory_(directory)
+    , input_fingerprint_(input_fingerprint)
+    , kmer_size_(kmer_size)
+    , window_size_(window_size)
+    , hash_representations_(hash_representations)
+    , filtering_parameter_(filtering_parameter)
+{
+    // create all missing directories on the path
+    for (std::string::size_type slash = directory_.find('/', 1); true; slash = directory_.find('/', slash + 1))
+    {
+        const std::string path = directory_.substr(0, slash);
+        if (!path.empty() && mkdir(path.c_str(), 0755) != 0 && errno != EEXIST)
+        {
+            throw std::runtime_error("Error: cannot create directory " + path + ": " + std::strerror(errno));
+        }
+        if (slash == std::string::npos)
+        {
+            break;
+        }
+    }
+}
+
+std::unique_ptr<IndexHostCopyBase> IndexDiskCache::load(const IndexDescriptor& descriptor) const
+{
+    CGA_NVTX_RANGE(profiler, "index_disk_cache::load");
+
+    const std::string path = file_path(descriptor);
+    if (access(path.c_str(), R_OK) != 0)
+    {
+        return nullptr;
+    }
+
+    const io::MemoryMappedFile file(path);
+
+    IndexFileHeader header;
+    if (file.size() < sizeof(IndexFileHeader))
+    {
+        CGA_LOG_WARN("Ignoring index file {}, file is truncated", path);
+        return nullptr;
+    }
+    std::memcpy(&header, file.data(), sizeof(IndexFileHeader));
+
+    if (header.magic != index_file_magic ||
+        header.version != index_file_version ||
+        header.input_fingerprint != input_fingerprint_ ||
+        header.descriptor_first_read != descriptor.first_read() ||
+        header.descriptor_number_of_reads != descriptor.number_of_reads() ||
+        header.kmer_size != kmer_size_ ||
+        header.window_size != window_size_ ||
+        header.hash_representations != static_cast<std::uint64_t>(hash_representations_) ||
+        header.filtering_parameter != filtering_parameter_)
+    {
+        CGA_LOG_WARN("Ignoring index file {}, it was generated with different parameters or by a different version", path);
+        return nullptr;
+    }
+
+    if (file.size() != index_file_size(header))
+    {
+        CGA_LOG_WARN("Ignoring index file {}, expected {} bytes, found {}", path, index_file_size(header), file.size());
+        return nullptr;
+    }
+
+    return std::make_unique<IndexHostCopyFromFile>(header, file.data() + sizeof(IndexFileHeader));
+}
+
+void IndexDiskCache::store(const IndexDescriptor& descriptor,
+                           const IndexHostCopyBase& index) const
+{
+    CGA_NVTX_RANGE(profiler, "index_disk_cache::store");
+
+    IndexFileHeader header;
+    header.magic                               = index_file_magic;
+    header.version                             = index_file_version;
+    header.input_fingerprint                   = input_fingerprint_;
+    header.descriptor_first_read               = descriptor.first_read();
+    header.descriptor_number_of_reads          = descriptor.number_of_reads();
+    header.kmer_size                           = kmer_size_;
+    header.window_size                         = window_size_;
+    header.hash_representations                = hash_representations_;
+    header.filtering_parameter                 = filtering_parameter_;
+    header.number_of_reads                     = index.number_of_reads();
+    header.number_of_basepairs_in_longest_read = index.number_of_basepairs_in_longest_read();
+    header.first_read_id                       = index.first_read_id();
+    header.number_of_sketch_elements           = index.representations().size();
+    header.number_of_unique_representations    = index.unique_representations().size();
+    header.number_of_first_occurrences         = index.first_occurrence_of_representations().size();
+
+    // several threads or processes might be saving the same index at the same time, each of them writes its own temporary file
+    const std::string path      = file_path(descriptor);
+    const std::string temp_path = path + ".tmp." + std::to_string(getpid()) + "." + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+
+    {
+        std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(IndexFileHeader));
+        write_array(file, index.representations());
+        write_array(file, index.read_ids());
+        write_array(file, index.positions_in_reads());
+        write_array(file, index.directions_of_reads());
+        write_array(file, index.unique_representations());
+        write_array(file, index.first_occurrence_of_representations());
+        file.close();
+        if (!file)
+        {
+            CGA_LOG_WARN("Could not write index file {}", temp_path);
+            std::remove(temp_path.c_str());
+            return;
+        }
+    }
+
+    if (std::rename(temp_path.c_str(), path.c_str()) != 0)
+    {
+        CGA_LOG_WARN("Could not rename {} to {}: {}", temp_path, path, std::strerror(errno));
+        std::remove(temp_path.c_str());
+    }
+}
+
+std::string IndexDiskCache::file_path(const IndexDescriptor& descriptor) const
+{
+    std::uint64_t parameters_hash = fnv1a(&kmer_size_, sizeof(kmer_size_));
+    parameters_hash               = fnv1a(&window_size_, sizeof(window_size_), parameters_hash);
+    parameters_hash               = fnv1a(&hash_representations_, sizeof(hash_representations_), parameters_hash);
+    parameters_hash               = fnv1a(&filtering_parameter_, sizeof(filtering_parameter_), parameters_hash);
+
+    std::ostringstream file_name;
+    file_name << std::hex << "index_" << input_fingerprint_ << "_" << parameters_hash
+              << std::dec << "_" << descriptor.first_read() << "_" << descriptor.number_of_reads() << ".cgaidx";
+
+    return directory_ + "/" + file_name.str();
+}
+
+std::uint64_t compute_input_fingerprint(const std::vector<std::string>& file_paths,
+                                        const io::ReadOrdering read_ordering)
+{
+    std::uint64_t fingerprint = fnv1a(&read_ordering, sizeof(read_ordering));
+
+    for (const std::string& file_path : file_paths)
+    {
+        char absolute_path[PATH_MAX];
+        struct stat file_stats;
+        if (nullptr == realpath(file_path.c_str(), absolute_path) || stat(absolute_path, &file_stats) != 0)
+        {
+            throw std::invalid_argument("Error: "
+                                        "cannot open file " +
+                                        file_path + " !");
+        }
+
+        const std::uint64_t file_size         = file_stats.st_size;
+        const std::int64_t modification_time = file_stats.st_mtim.tv_sec * 1'000'000'000ll + file_stats.st_mtim.tv_nsec;
+
+        fingerprint = fnv1a(absolute_path, std::strlen(absolute_path) + 1, fingerprint); // including '\0' as separator
+        fingerprint = fnv1a(&file_size, sizeof(file_size), fingerprint);
+        fingerprint = fnv1a(&modification_time, sizeof(modification_time), fingerprint);
+    }
+
+    return fingerprint;
+}
+
+} // namespace cudamapper
+
+} // namespace genomeworks
+
+} // namespace claraparabricks
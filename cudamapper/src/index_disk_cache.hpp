@@ -0,0 +1,100 @@
+/*
+* Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <claragenomics/cudamapper/index.hpp>
+#include <claragenomics/io/fasta_parser.hpp>
+
+#include "index_descriptor.hpp"
+
+namespace claraparabricks
+{
+
+namespace genomeworks
+{
+
+namespace cudamapper
+{
+
+/// IndexDiskCache - Stores host copies of indices in a directory so that later runs on the same input can skip index generation
+///
+/// Content of an index only depends on the reads in it, k, w, hash_representations and filtering_parameter. Reads are identified by
+/// a fingerprint of the input and by the IndexDescriptor. Every index is saved in a separate file whose name is derived from all of these
+/// values, the values are also saved in the file itself and checked when loading.
+///
+/// File layout (native byte order): a header of 64-bit fields followed by representations, read_ids, positions_in_reads,
+/// directions_of_reads, unique_representations and first_occurrence_of_representations, every array starting at an 8-byte aligned offset.
+/// Files are memory mapped when loaded, so loading an index amounts to one copy of every array.
+class IndexDiskCache
+{
+public:
+    /// \brief Constructor, creates the directory if it does not exist
+    /// \param directory directory in which the files are saved
+    /// \param input_fingerprint fingerprint of the input reads, see compute_input_fingerprint()
+    /// \param kmer_size see Index
+    /// \param window_size see Index
+    /// \param hash_representations see Index
+    /// \param filtering_parameter see Index
+    /// \throw std::runtime_error if directory could not be created
+    IndexDiskCache(const std::string& directory,
+                   std::uint64_t input_fingerprint,
+                   std::uint64_t kmer_size,
+                   std::uint64_t window_size,
+                   bool hash_representations,
+                   double filtering_parameter);
+
+    /// \brief loads an index saved by a previous call to store()
+    /// \param descriptor
+    /// \return loaded index, nullptr if the index has not been saved or if the file does not match the parameters
+    std::unique_ptr<IndexHostCopyBase> load(const IndexDescriptor& descriptor) const;
+
+    /// \brief saves the index, the file is first written under a temporary name and then renamed, so concurrent readers never see incomplete files
+    /// Failing to save an index is not an error, it is only logged
+    /// \param descriptor
+    /// \param index
+    void store(const IndexDescriptor& descriptor,
+               const IndexHostCopyBase& index) const;
+
+    /// \brief returns the path of the file for the given index
+    /// \param descriptor
+    /// \return path of the file
+    std::string file_path(const IndexDescriptor& descriptor) const;
+
+private:
+    const std::string directory_;
+    const std::uint64_t input_fingerprint_;
+    const std::uint64_t kmer_size_;
+    const std::uint64_t window_size_;
+    const bool hash_representations_;
+    const double filtering_parameter_;
+};
+
+/// \brief computes fingerprint of an input from the paths, sizes and modification times of its files
+///
+/// read_ids depend on the order of files and on the read ordering, so both are included as well
+///
+/// \param file_paths all files of one input, in the order in which they are parsed
+/// \param read_ordering
+/// \throw std::invalid_argument if a file does not exist
+/// \return fingerprint
+std::uint64_t compute_input_fingerprint(const std::vector<std::string>& file_paths,
+                                        io::ReadOrdering read_ordering);
+
+} // namespace cudamapper
+
+} // namespace genomeworks
+
+} // namespace claraparabricks
@@ -82,7 +82,7 @@ public:
     /// \param index_host_copy is a copy of index for a set of reads which has been previously computed and stored on the host.
     /// \param cuda_stream CUDA stream on which the work is to be done. Device arrays are also associated with this stream and will not be freed at least until all work issued on this stream before calling their destructor is done
     IndexGPU(DefaultDeviceAllocator allocator,
-             const IndexHostCopy& index_host_copy,
+             const IndexHostCopyBase& index_host_copy,
              const cudaStream_t cuda_stream = 0);
 
     /// \brief returns an array of representations of sketch elements
@@ -581,7 +581,7 @@ IndexGPU<SketchElementImpl>::IndexGPU(DefaultDeviceAllocator allocator,
 
 template <typename SketchElementImpl>
 IndexGPU<SketchElementImpl>::IndexGPU(DefaultDeviceAllocator allocator,
-                                      const IndexHostCopy& index_host_copy,
+                                      const IndexHostCopyBase& index_host_copy,
                                       const cudaStream_t cuda_stream)
     : first_read_id_(index_host_copy.first_read_id())
     , kmer_size_(index_host_copy.kmer_size())
@@ -713,29 +713,27 @@ void IndexGPU<SketchElementImpl>::generate_index(const io::FastaParser& parser,
 
     std::uint64_t total_basepairs = 0;
     std::vector<ArrayBlock> read_id_to_basepairs_section_h;
-    std::vector<io::FastaSequence> fasta_reads;
 
     number_of_basepairs_in_longest_read_ = 0;
 
     // deterine the number of basepairs in each read and assign read_id to each read
     for (read_id_t read_id = first_read_id; read_id < past_the_last_read_id; ++read_id)
     {
-        fasta_reads.emplace_back(parser.get_sequence_by_id(read_id));
-        const std::string& read_basepairs = fasta_reads.back().seq;
-        const std::string& read_name      = fasta_reads.back().name;
-        if (read_basepairs.length() >= window_size_ + kmer_size_ - 1)
+        const number_of_basepairs_t read_length = parser.get_sequence_length_by_id(read_id);
+        if (read_length >= window_size_ + kmer_size_ - 1)
         {
             // TODO: make sure that no read is longer than what fits into position_in_read_t
-            read_id_to_basepairs_section_h.emplace_back(ArrayBlock{total_basepairs, static_cast<std::uint32_t>(read_basepairs.length())});
-            total_basepairs += read_basepairs.length();
-            number_of_basepairs_in_longest_read_ = std::max(number_of_basepairs_in_longest_read_, static_cast<position_in_read_t>(read_basepairs.length()));
+            read_id_to_basepairs_section_h.emplace_back(ArrayBlock{total_basepairs, static_cast<std::uint32_t>(read_length)});
+            total_basepairs += read_length;
+            number_of_basepairs_in_longest_read_ = std::max(number_of_basepairs_in_longest_read_, static_cast<position_in_read_t>(read_length));
         }
         else
         {
             // TODO: Implement this skipping in a correct manner
+            const cga_string_view_t read_name = parser.get_name_view_by_id(read_id);
             CGA_LOG_INFO("Skipping read {}. It has {} basepairs, one window covers {} basepairs",
-                         read_name,
-                         read_basepairs.length(),
+                         std::string(read_name.data(), read_name.size()),
+                         read_length,
                          window_size_ + kmer_size_ - 1);
         }
     }
@@ -752,17 +750,16 @@ void IndexGPU<SketchElementImpl>::generate_index(const io::FastaParser& parser,
 
     std::vector<char> merged_basepairs_h(total_basepairs);
 
-    // copy basepairs from each read into one big array
+    // copy basepairs from each read into one big array, parsers which do not keep reads as plain text decode them directly into it
     // read_id starts from first_read_id which can have an arbitrary value, local_read_id always starts from 0
     for (read_id_t local_read_id = 0; local_read_id < number_of_reads_; ++local_read_id)
     {
-        const std::string& read_basepairs = fasta_reads[local_read_id].seq;
-        std::copy(std::begin(read_basepairs),
-                  std::end(read_basepairs),
-                  std::next(std::begin(merged_basepairs_h), read_id_to_basepairs_section_h[local_read_id].first_element_));
+        const ArrayBlock& basepairs_section = read_id_to_basepairs_section_h[local_read_id];
+        parser.copy_sequence_by_id(first_read_id + local_read_id,
+                                   0,
+                                   basepairs_section.block_size_,
+                                   merged_basepairs_h.data() + basepairs_section.first_element_);
     }
-    fasta_reads.clear();
-    fasta_reads.shrink_to_fit();
 
     // move basepairs to the device
     CGA_LOG_INFO("Allocating {} bytes for read_id_to_basepairs_section_d", read_id_to_basepairs_section_h.size() * sizeof(decltype(read_id_to_basepairs_section_h)::value_type));
@@ -77,14 +77,6 @@ IndexHostCopy::IndexHostCopy(const Index& index,
     CGA_CU_CHECK_ERR(cudaStreamSynchronize(cuda_stream));
 }
 
-std::unique_ptr<Index> IndexHostCopy::copy_index_to_device(DefaultDeviceAllocator allocator,
-                                                           const cudaStream_t cuda_stream) const
-{
-    return std::make_unique<IndexGPU<Minimizer>>(allocator,
-                                                 *this,
-                                                 cuda_stream);
-}
-
 const std::vector<representation_t>& IndexHostCopy::representations() const
 {
     return representations_;
@@ -40,13 +40,6 @@ public:
                   const std::uint64_t window_size,
                   const cudaStream_t cuda_stream);
 
-    /// \brief copy cached index vectors from the host and create an object of Index on GPU
-    /// \param allocator pointer to asynchronous device allocator
-    /// \param cuda_stream H2D copy is done on this stream. Device arrays are also associated with this stream and will not be freed at least until all work issued on this stream before calling their destructor is done
-    /// \return a pointer to genomeworks::cudamapper::Index
-    std::unique_ptr<Index> copy_index_to_device(DefaultDeviceAllocator allocator,
-                                                const cudaStream_t cuda_stream = 0) const override;
-
     /// \brief returns an array of representations of sketch elements (stored on host)
     /// \return an array of representations of sketch elements
     const std::vector<representation_t>& representations() const override;
@@ -10,11 +10,17 @@
 
 #include <atomic>
 #include <algorithm>
+#include <chrono>
+#include <cstdio>
 #include <iostream>
 #include <future>
+#include <map>
 #include <mutex>
+#include <sstream>
 #include <string>
 #include <thread>
+#include <utility>
+#include <vector>
 
 #include <claragenomics/utils/cudautils.hpp>
 #include <claragenomics/utils/mathutils.hpp>
@@ -24,14 +30,21 @@
 #include <claragenomics/cudaaligner/aligner.hpp>
 #include <claragenomics/cudaaligner/alignment.hpp>
 
+#include <claragenomics/cudamapper/binary_overlaps.hpp>
 #include <claragenomics/cudamapper/index.hpp>
 #include <claragenomics/cudamapper/matcher.hpp>
 #include <claragenomics/cudamapper/overlapper.hpp>
 
 #include "application_parameters.hpp"
+#include "batch_statistics.hpp"
+#include "checkpoint_journal.hpp"
 #include "cudamapper_utils.hpp"
 #include "index_batcher.cuh"
+#include "index_disk_cache.hpp"
 #include "overlapper_triggered.hpp"
+#include "paf_formatter.hpp"
+#include "sorted_paf_writer.hpp"
+#include "work_stealing_scheduler.hpp"
 
 namespace claraparabricks
 {
@@ -67,6 +80,8 @@ void run_alignment_batch(DefaultDeviceAllocator allocator,
             allocator,
             stream,
             device_id);
+    std::vector<char> query_section;
+    std::vector<char> target_section;
     while (true)
     {
         int32_t idx_start = 0, idx_end = 0;
@@ -87,13 +102,15 @@ void run_alignment_batch(DefaultDeviceAllocator allocator,
         for (int32_t idx = idx_start; idx < idx_end; idx++)
         {
             const Overlap& overlap         = overlaps[idx];
-            const io::FastaSequence query  = query_parser.get_sequence_by_id(overlap.query_read_id_);
-            const io::FastaSequence target = target_parser.get_sequence_by_id(overlap.target_read_id_);
-            const char* query_start        = &query.seq[overlap.query_start_position_in_read_];
             const int32_t query_length     = overlap.query_end_position_in_read_ - overlap.query_start_position_in_read_;
-            const char* target_start       = &target.seq[overlap.target_start_position_in_read_];
             const int32_t target_length    = overlap.target_end_position_in_read_ - overlap.target_start_position_in_read_;
-            cudaaligner::StatusType status = batch->add_alignment(query_start, query_length, target_start, target_length,
+            // add_alignment() copies its input, so the same buffers can be reused for all overlaps
+            // parsers which do not keep reads as plain text only decode the overlapping section
+            query_section.resize(query_length);
+            target_section.resize(target_length);
+            query_parser.copy_sequence_by_id(overlap.query_read_id_, overlap.query_start_position_in_read_, query_length, query_section.data());
+            target_parser.copy_sequence_by_id(overlap.target_read_id_, overlap.target_start_position_in_read_, target_length, target_section.data());
+            cudaaligner::StatusType status = batch->add_alignment(query_section.data(), query_length, target_section.data(), target_length,
                                                                   false, overlap.relative_strand == RelativeStrand::Reverse);
             if (status != cudaaligner::success)
             {
@@ -183,24 +200,65 @@ void align_overlaps(DefaultDeviceAllocator allocator,
     }
 }
 
+/// BatchOutput - collects formatted output of one batch so that it can be written at once and recorded in CheckpointJournal
+struct BatchOutput
+{
+    IndexBatch host_batch;
+    std::mutex mutex;
+    std::vector<char> output;
+    /// parts of the output which have not been added yet, one part is held by the worker thread until all other parts have been created
+    int64_t pending_parts = 1;
+};
+
 /// OverlapsAndCigars - packs overlaps and cigars together so they can be passed to writer thread more easily
 struct OverlapsAndCigars
 {
     std::vector<Overlap> overlaps;
     std::vector<std::string> cigars;
+    /// batch these overlaps belong to if output is written batch by batch, nullptr otherwise
+    std::shared_ptr<BatchOutput> batch_output;
 };
 
+/// \brief adds one part of the output of a batch, once all parts have been added the output of the whole batch is written and recorded in the journal
+/// \param batch_output
+/// \param part formatted overlaps
+/// \param checkpoint_journal
+void add_batch_output_part(BatchOutput& batch_output,
+                           const std::vector<char>& part,
+                           CheckpointJournal& checkpoint_journal)
+{
+    bool last_part = false;
+    {
+        std::lock_guard<std::mutex> lock(batch_output.mutex);
+        batch_output.output.insert(end(batch_output.output), begin(part), end(part));
+        last_part = 0 == --batch_output.pending_parts;
+    }
+
+    // no other thread accesses batch_output after its last part has been added
+    if (last_part)
+    {
+        CGA_NVTX_RANGE(profiler, "main::write_batch_output");
+        checkpoint_journal.write_batch(batch_output.host_batch.query_indices,
+                                       batch_output.host_batch.target_indices,
+                                       batch_output.output);
+    }
+}
+
 /// \brief does overlapping and matching for pairs of query and target indices from device_batch
 /// \param device_batch
 /// \param device_cache data will be loaded into cache within the function
 /// \param application_parameters
-/// \param overlaps_and_cigars_to_process overlaps and cigars are output here and the then consumed by another thread
+/// \param overlaps_and_cigars_to_process overlaps and cigars are output here and the then consumed by another thread, waits if it is full
+/// \param batch_statistics number of anchors of every pair of indices is added here
+/// \param batch_output output of the batch this device batch belongs to if output is written batch by batch, nullptr otherwise
 /// \param cuda_stream
 void process_one_device_batch(const IndexBatch& device_batch,
                               IndexCacheDevice& device_cache,
                               const ApplicationParameters& application_parameters,
                               DefaultDeviceAllocator device_allocator,
                               ThreadsafeProducerConsumer<OverlapsAndCigars>& overlaps_and_cigars_to_process,
+                              BatchStatistics& batch_statistics,
+                              const std::shared_ptr<BatchOutput>& batch_output,
                               cudaStream_t cuda_stream)
 {
     CGA_NVTX_RANGE(profiler, "main::process_one_device_batch");
@@ -228,6 +286,7 @@ void process_one_device_batch(const IndexBatch& device_batch,
                                                        *query_index,
                                                        *target_index,
                                                        cuda_stream);
+                batch_statistics.add_tile(matcher->anchors().size());
 
                 std::vector<Overlap> overlaps;
                 OverlapperTriggered overlapper(device_allocator,
@@ -257,7 +316,12 @@ void process_one_device_batch(const IndexBatch& device_batch,
                 }
 
                 // pass overlaps and cigars to writer thread
-                overlaps_and_cigars_to_process.add_new_element({std::move(overlaps), std::move(cigar)});
+                if (batch_output)
+                {
+                    std::lock_guard<std::mutex> lock(batch_output->mutex);
+                    ++batch_output->pending_parts;
+                }
+                overlaps_and_cigars_to_process.add_new_element({std::move(overlaps), std::move(cigar), batch_output});
             }
         }
     }
@@ -269,6 +333,8 @@ void process_one_device_batch(const IndexBatch& device_batch,
 /// \param host_cache data will be loaded into cache within the function
 /// \param device_cache data will be loaded into cache within the function
 /// \param overlaps_and_cigars_to_process overlaps and cigars are output to this structure and the then consumed by another thread
+/// \param batch_statistics number of anchors of every pair of indices is added here
+/// \param batch_output collects output of the batch if output is written batch by batch, nullptr otherwise
 /// \param cuda_stream
 void process_one_batch(const BatchOfIndices& batch,
                        const ApplicationParameters& application_parameters,
@@ -276,6 +342,8 @@ void process_one_batch(const BatchOfIndices& batch,
                        IndexCacheHost& host_cache,
                        IndexCacheDevice& device_cache,
                        ThreadsafeProducerConsumer<OverlapsAndCigars>& overlaps_and_cigars_to_process,
+                       BatchStatistics& batch_statistics,
+                       const std::shared_ptr<BatchOutput>& batch_output,
                        cudaStream_t cuda_stream)
 {
     CGA_NVTX_RANGE(profiler, "main::process_one_batch");
@@ -283,14 +351,28 @@ void process_one_batch(const BatchOfIndices& batch,
     const std::vector<IndexBatch>& device_batches = batch.device_batches;
 
     // if there is only one device batch and it is the same as host bach (which should be the case then) there is no need to copy indices to host
-    // as they will be queried only once
-    const bool skip_copy_to_host = 1 == device_batches.size();
+    // as they will be queried only once, unless host copies can be reused by later batches or by other devices
+    const bool skip_copy_to_host = 1 == device_batches.size() &&
+                                   0 == application_parameters.host_index_cache_memory &&
+                                   0 == application_parameters.index_prefetch_depth &&
+                                   1 == application_parameters.num_devices;
     assert(!skip_copy_to_host || (host_batch.query_indices == device_batches.front().query_indices && host_batch.target_indices == device_batches.front().target_indices));
 
     // load indices into host memory
     {
         assert(!host_batch.query_indices.empty() && !host_batch.target_indices.empty() && !device_batches.empty());
 
+        // parsers which do not keep all reads in host memory start loading reads of all indices in the background,
+        // so reads of later indices are loaded while earlier indices are being generated
+        for (const IndexDescriptor& query_index : host_batch.query_indices)
+        {
+            application_parameters.query_parser->prefetch_sequences(query_index.first_read(), query_index.number_of_reads());
+        }
+        for (const IndexDescriptor& target_index : host_batch.target_indices)
+        {
+            application_parameters.target_parser->prefetch_sequences(target_index.first_read(), target_index.number_of_reads());
+        }
+
         CGA_NVTX_RANGE(profiler, "main::process_one_batch::host_indices");
         host_cache.generate_query_cache_content(host_batch.query_indices,
                                                 device_batches.front().query_indices,
@@ -308,24 +390,62 @@ void process_one_batch(const BatchOfIndices& batch,
                                  application_parameters,
                                  device_allocator,
                                  overlaps_and_cigars_to_process,
+                                 batch_statistics,
+                                 batch_output,
                                  cuda_stream);
     }
 }
 
+/// \brief writes output to output_file with as few system calls as possible and clears it
+/// \param output
+/// \param output_mutex controls access to output to prevent race conditions
+/// \param output_file
+void write_output(std::vector<char>& output,
+                  std::mutex& output_mutex,
+                  std::FILE* output_file)
+{
+    if (output.empty())
+    {
+        return;
+    }
+
+    CGA_NVTX_RANGE(profiler, "main::write_output");
+    {
+        std::lock_guard<std::mutex> lock(output_mutex);
+        write_to_file_descriptor(fileno(output_file), output.data(), output.size());
+    }
+    output.clear();
+}
+
 /// \brief does post-processing and writes data to output
 /// \param device_id
 /// \param application_parameters
+/// \param paf_formatter formats overlaps as PAF, nullptr if output is binary
 /// \param overlaps_and_cigars_to_process new data is added to this structure as it gets available, also signals when there is not going to be any new data
 /// \param output_mutex controls access to output to prevent race conditions
+/// \param output_file overlaps are written here if neither checkpoint_journal nor sorted_paf_writer is used
+/// \param checkpoint_journal writes output of every batch at once, nullptr if not used
+/// \param sorted_paf_writer sorts all overlaps before they are written, nullptr if not used
 void postprocess_and_write_thread_function(const int32_t device_id,
                                            const ApplicationParameters& application_parameters,
+                                           const PafFormatter* paf_formatter,
                                            ThreadsafeProducerConsumer<OverlapsAndCigars>& overlaps_and_cigars_to_process,
-                                           std::mutex& output_mutex)
+                                           std::mutex& output_mutex,
+                                           std::FILE* output_file,
+                                           CheckpointJournal* checkpoint_journal,
+                                           SortedPafWriter* sorted_paf_writer)
 {
     CGA_NVTX_RANGE(profiler, ("main::postprocess_and_write_thread_for_device_" + std::to_string(device_id)).c_str());
     // This function is expected to run in a separate thread so set current device in order to avoid problems
     CGA_CU_CHECK_ERR(cudaSetDevice(device_id));
 
+    // output is collected and written in chunks of at least this size in order to reduce the number of system calls and the time spent waiting for output_mutex
+    constexpr std::size_t min_output_write_size = 4 * 1024 * 1024;
+
+    // buffers are reused for all sets of overlaps
+    std::vector<char> paf;
+    std::vector<char> output;
+
     // keep processing data as it arrives
     cga_optional_t<OverlapsAndCigars> data_to_write;
     while (data_to_write = overlaps_and_cigars_to_process.get_next_element()) // if optional is empty that means that there will be no more overlaps to process and the thread can finish
@@ -355,31 +475,167 @@ void postprocess_and_write_thread_function(const int32_t device_id,
             // write to output
             {
                 CGA_NVTX_RANGE(profiler, "main::postprocess_and_write_thread::print_paf");
-                print_paf(overlaps,
-                          cigars,
-                          *application_parameters.query_parser,
-                          *application_parameters.query_parser,
-                          application_parameters.kmer_size,
-                          output_mutex);
+                if (data_to_write->batch_output)
+                {
+                    paf.clear();
+                    paf_formatter->append_paf(overlaps, cigars, paf);
+                    add_batch_output_part(*data_to_write->batch_output,
+                                          paf,
+                                          *checkpoint_journal);
+                }
+                else if (sorted_paf_writer)
+                {
+                    paf.clear();
+                    paf_formatter->append_paf(overlaps, cigars, paf);
+                    sorted_paf_writer->add_lines(paf);
+                }
+                else
+                {
+                    if (paf_formatter)
+                    {
+                        paf_formatter->append_paf(overlaps, cigars, output);
+                    }
+                    else
+                    {
+                        append_binary_overlaps_block(overlaps, cigars, output);
+                    }
+                    if (output.size() >= min_output_write_size)
+                    {
+                        write_output(output, output_mutex, output_file);
+                    }
+                }
             }
         }
     }
+
+    write_output(output, output_mutex, output_file);
+}
+
+/// \brief host indices of one batch generated in the background
+struct PrefetchedIndices
+{
+    /// indices are kept in shared host cache as long as this cache exists
+    std::unique_ptr<IndexCacheHost> host_cache;
+    /// time it took to generate the indices
+    double generation_time_seconds = 0.0;
+};
+
+/// \brief generates host indices of one batch, meant to be run in a background thread while the worker thread processes the previous batch
+/// \param device_id
+/// \param batch
+/// \param application_parameters
+/// \param device_allocator
+/// \param query_disk_cache
+/// \param target_disk_cache
+/// \param shared_host_cache indices are saved here, the worker thread then takes them from here once it processes the batch
+/// \return cache holding the indices
+PrefetchedIndices prefetch_host_indices(const int32_t device_id,
+                                        const BatchOfIndices& batch,
+                                        const ApplicationParameters& application_parameters,
+                                        DefaultDeviceAllocator device_allocator,
+                                        std::shared_ptr<const IndexDiskCache> query_disk_cache,
+                                        std::shared_ptr<const IndexDiskCache> target_disk_cache,
+                                        std::shared_ptr<SharedIndexHostCache> shared_host_cache)
+{
+    CGA_NVTX_RANGE(profiler, "main::prefetch_host_indices");
+
+    // This function is expected to run in a separate thread so set current device in order to avoid problems
+    CGA_CU_CHECK_ERR(cudaSetDevice(device_id));
+
+    const auto generation_start = std::chrono::steady_clock::now();
+
+    // separate stream so that index generation does not wait for the work of the current batch
+    cudaStream_t cuda_stream;
+    CGA_CU_CHECK_ERR(cudaStreamCreate(&cuda_stream));
+
+    PrefetchedIndices prefetched_indices;
+    prefetched_indices.host_cache = std::make_unique<IndexCacheHost>(application_parameters.all_to_all,
+                                                                     device_allocator,
+                                                                     application_parameters.query_parser,
+                                                                     application_parameters.target_parser,
+                                                                     application_parameters.kmer_size,
+                                                                     application_parameters.windows_size,
+                                                                     true, // hash_representations
+                                                                     application_parameters.filtering_parameter,
+                                                                     cuda_stream,
+                                                                     query_disk_cache,
+                                                                     target_disk_cache,
+                                                                     shared_host_cache);
+    prefetched_indices.host_cache->generate_query_cache_content(batch.host_batch.query_indices);
+    prefetched_indices.host_cache->generate_target_cache_content(batch.host_batch.target_indices);
+
+    // host_cache never uses the stream again as indices are only retrieved through shared_host_cache
+    CGA_CU_CHECK_ERR(cudaStreamSynchronize(cuda_stream));
+    CGA_CU_CHECK_ERR(cudaStreamDestroy(cuda_stream));
+
+    prefetched_indices.generation_time_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - generation_start).count();
+
+    return prefetched_indices;
+}
+
+/// \brief pins all given indices in shared_host_cache
+/// \param shared_host_cache
+/// \param indices
+void pin_indices(SharedIndexHostCache& shared_host_cache,
+                 const IndexBatch& indices)
+{
+    for (const IndexDescriptor& descriptor : indices.query_indices)
+    {
+        shared_host_cache.pin(SharedIndexHostCache::Input::query, descriptor);
+    }
+    for (const IndexDescriptor& descriptor : indices.target_indices)
+    {
+        shared_host_cache.pin(SharedIndexHostCache::Input::target, descriptor);
+    }
+}
+
+/// \brief undoes pin_indices()
+/// \param shared_host_cache
+/// \param indices
+void unpin_indices(SharedIndexHostCache& shared_host_cache,
+                   const IndexBatch& indices)
+{
+    for (const IndexDescriptor& descriptor : indices.query_indices)
+    {
+        shared_host_cache.unpin(SharedIndexHostCache::Input::query, descriptor);
+    }
+    for (const IndexDescriptor& descriptor : indices.target_indices)
+    {
+        shared_host_cache.unpin(SharedIndexHostCache::Input::target, descriptor);
+    }
 }
 
 /// \brief controls one GPU
 ///
 /// Each thread is resposible for one GPU. It takes one batch, processes it and passes it to postprocess_and_write_thread.
 /// It keeps doing this as long as there are available batches. It also controls the postprocess_and_write_thread.
+/// If index_prefetch_depth is set it also generates host indices of that many following batches of its queue in the background.
+/// Those batches stay in the queue, so they can still be stolen by other devices.
+/// Indices which the next index_pin_horizon batches of its queue use again are pinned in shared_host_cache until those batches are processed.
 ///
 /// \param device_id
-/// \param batches_of_indices
+/// \param batches_of_indices batches are taken from the queue of this device first, then stolen from other devices
 /// \param application_parameters
+/// \param paf_formatter formats overlaps as PAF, nullptr if output is binary
 /// \param output_mutex
+/// \param output_file overlaps are written here if neither checkpoint_journal nor sorted_paf_writer is used
+/// \param checkpoint_journal output of every batch is written at once and recorded here, nullptr if not used
+/// \param sorted_paf_writer sorts all overlaps before they are written, nullptr if not used
+/// \param batch_statistics number of anchors of every pair of indices and wall time of every batch are added here
+/// \param shared_host_cache host copies of indices shared by all devices
+/// \param index_pin_horizon number of following batches whose indices are kept pinned
 /// \param cuda_stream
 void worker_thread_function(const int32_t device_id,
-                            ThreadsafeDataProvider<BatchOfIndices>& batches_of_indices,
+                            WorkStealingScheduler<BatchOfIndices>& batches_of_indices,
                             const ApplicationParameters& application_parameters,
+                            const PafFormatter* paf_formatter,
                             std::mutex& output_mutex,
+                            std::FILE* output_file,
+                            CheckpointJournal* checkpoint_journal,
+                            SortedPafWriter* sorted_paf_writer,
+                            BatchStatistics& batch_statistics,
+                            std::shared_ptr<SharedIndexHostCache> shared_host_cache,
+                            const int32_t index_pin_horizon,
                             cudaStream_t cuda_stream,
                             const int64_t number_of_total_batches,
                             std::atomic<int64_t>& number_of_processed_batches)
@@ -391,6 +647,32 @@ void worker_thread_function(const int32_t device_id,
 
     DefaultDeviceAllocator device_allocator = create_default_device_allocator(application_parameters.max_cached_memory_bytes);
 
+    // indices saved to disk by previous runs are used instead of generating them again
+    std::shared_ptr<const IndexDiskCache> query_disk_cache  = nullptr;
+    std::shared_ptr<const IndexDiskCache> target_disk_cache = nullptr;
+    if (!application_parameters.index_cache_directory.empty())
+    {
+        query_disk_cache = std::make_shared<const IndexDiskCache>(application_parameters.index_cache_directory,
+                                                                  application_parameters.query_input_fingerprint,
+                                                                  application_parameters.kmer_size,
+                                                                  application_parameters.windows_size,
+                                                                  true, // hash_representations
+                                                                  application_parameters.filtering_parameter);
+        if (application_parameters.all_to_all)
+        {
+            target_disk_cache = query_disk_cache;
+        }
+        else
+        {
+            target_disk_cache = std::make_shared<const IndexDiskCache>(application_parameters.index_cache_directory,
+                                                                       application_parameters.target_input_fingerprint,
+                                                                       application_parameters.kmer_size,
+                                                                       application_parameters.windows_size,
+                                                                       true, // hash_representations
+                                                                       application_parameters.filtering_parameter);
+        }
+    }
+
     // create host_cache, data is not loaded at this point but later as each batch gets processed
     auto host_cache = std::make_shared<IndexCacheHost>(application_parameters.all_to_all,
                                                        device_allocator,
@@ -400,14 +682,18 @@ void worker_thread_function(const int32_t device_id,
                                                        application_parameters.windows_size,
                                                        true, // hash_representations
                                                        application_parameters.filtering_parameter,
-                                                       cuda_stream);
+                                                       cuda_stream,
+                                                       query_disk_cache,
+                                                       target_disk_cache,
+                                                       shared_host_cache);
 
     // create host_cache, data is not loaded at this point but later as each batch gets processed
     IndexCacheDevice device_cache(application_parameters.all_to_all,
                                   host_cache);
 
     // data structure used to exchnage data with postprocess_and_write_thread
-    ThreadsafeProducerConsumer<OverlapsAndCigars> overlaps_and_cigars_to_process;
+    // if it is full process_one_device_batch waits for postprocess_and_write_threads, so overlaps do not pile up in host memory if writing is slower than overlapping
+    ThreadsafeProducerConsumer<OverlapsAndCigars> overlaps_and_cigars_to_process(application_parameters.output_queue_capacity);
 
     // There should be at least one postprocess_and_write_thread per worker_thread. If more threads are available one thread should be reserved for
     // worker_thread and all other threads should be postprocess_and_write_threads
@@ -423,27 +709,154 @@ void worker_thread_function(const int32_t device_id,
         postprocess_and_write_threads.emplace_back(postprocess_and_write_thread_function,
                                                    device_id,
                                                    std::ref(application_parameters),
+                                                   paf_formatter,
                                                    std::ref(overlaps_and_cigars_to_process),
-                                                   std::ref(output_mutex));
+                                                   std::ref(output_mutex),
+                                                   output_file,
+                                                   checkpoint_journal,
+                                                   sorted_paf_writer);
     }
 
+    // batches which follow the current one in the queue of this device, their host indices are being generated in the background
+    // the batches stay in the queue, so other devices which run out of batches can still steal them
+    std::map<std::size_t, std::future<PrefetchedIndices>> prefetched_batches;
+
+    // indices which the following batches of this device use again, pinned in shared_host_cache
+    IndexBatch pinned_indices;
+
     // keep processing batches of indices until there are none left
-    cga_optional_t<BatchOfIndices> batch_of_indices;
-    while (batch_of_indices = batches_of_indices.get_next_element()) // if optional is empty that means that there are no more batches to process and the thread can finish
+    while (true)
     {
+        std::size_t batch_id                            = 0;
+        cga_optional_t<BatchOfIndices> batch_of_indices = batches_of_indices.get_next_element(device_id, batch_id);
+
+        if (!batch_of_indices) // if optional is empty that means that there are no more batches to process and the thread can finish
+        {
+            break;
+        }
+
+        std::future<PrefetchedIndices> prefetched_indices; // not valid if host indices of this batch are not being generated in the background
+        const auto prefetched_batch = prefetched_batches.find(batch_id);
+        if (prefetched_batch != std::end(prefetched_batches))
+        {
+            prefetched_indices = std::move(prefetched_batch->second);
+            prefetched_batches.erase(prefetched_batch);
+        }
+
+        // start generating host indices of the following batches so that it overlaps with processing of this batch
+        if (application_parameters.index_prefetch_depth > 0)
+        {
+            const std::vector<std::pair<std::size_t, BatchOfIndices>> next_batches = batches_of_indices.peek_next_elements(device_id,
+                                                                                                                           application_parameters.index_prefetch_depth);
+
+            // batches which are not in the queue anymore have been stolen, their indices are still saved in shared_host_cache
+            for (auto stolen_batch = std::begin(prefetched_batches); stolen_batch != std::end(prefetched_batches);)
+            {
+                const std::size_t stolen_batch_id = stolen_batch->first;
+                const bool still_queued           = std::any_of(std::begin(next_batches),
+                                                                std::end(next_batches),
+                                                                [stolen_batch_id](const std::pair<std::size_t, BatchOfIndices>& next_batch) {
+                                                                    return next_batch.first == stolen_batch_id;
+                                                                });
+                // destroying the future of a running std::async would wait for it
+                if (!still_queued && stolen_batch->second.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+                {
+                    stolen_batch = prefetched_batches.erase(stolen_batch);
+                }
+                else
+                {
+                    ++stolen_batch;
+                }
+            }
+
+            for (const std::pair<std::size_t, BatchOfIndices>& next_batch : next_batches)
+            {
+                if (prefetched_batches.count(next_batch.first) == 0)
+                {
+                    prefetched_batches.emplace(next_batch.first,
+                                               std::async(std::launch::async,
+                                                          prefetch_host_indices,
+                                                          device_id,
+                                                          next_batch.second,
+                                                          std::cref(application_parameters),
+                                                          device_allocator,
+                                                          query_disk_cache,
+                                                          target_disk_cache,
+                                                          shared_host_cache));
+                }
+            }
+        }
+
         const int64_t batch_number         = number_of_processed_batches.fetch_add(1); // as this is not called atomically with get_next_element() the value does not have to be completely accurate, but this is ok as the value is only use for displaying progress
         const std::string progress_message = "Device " + std::to_string(device_id) + " took batch " + std::to_string(batch_number + 1) + " out of " + std::to_string(number_of_total_batches) + " batches in total\n";
         std::cerr << progress_message; // TODO: possible race condition, switch to logging library
 
+        const auto batch_start = std::chrono::steady_clock::now();
+
+        // keeps host indices of this batch in shared_host_cache until host_cache has taken them over
+        PrefetchedIndices prefetched;
+        if (prefetched_indices.valid())
+        {
+            CGA_NVTX_RANGE(profiler, "main::worker_thread::wait_for_prefetched_indices");
+            prefetched = prefetched_indices.get();
+            batch_statistics.add_index_prefetch(prefetched.generation_time_seconds,
+                                                std::chrono::duration<double>(std::chrono::steady_clock::now() - batch_start).count());
+        }
+
+        // output of the batch is written once all its overlaps have been post-processed
+        std::shared_ptr<BatchOutput> batch_output = nullptr;
+        if (checkpoint_journal)
+        {
+            batch_output             = std::make_shared<BatchOutput>();
+            batch_output->host_batch = batch_of_indices->host_batch;
+        }
+
         process_one_batch(batch_of_indices.value(),
                           application_parameters,
                           device_allocator,
                           *host_cache,
                           device_cache,
                           overlaps_and_cigars_to_process,
+                          batch_statistics,
+                          batch_output,
                           cuda_stream);
+
+        // all parts of the output have been created, release the part held by this thread
+        if (batch_output)
+        {
+            add_batch_output_part(*batch_output,
+                                  {},
+                                  *checkpoint_journal);
+        }
+
+        // keep indices of this batch and indices pinned earlier which the following batches use again
+        // this batch still holds its indices, so unpinning indices it does not use again cannot discard indices it needs
+        {
+            std::vector<IndexBatch> next_host_batches;
+            for (const std::pair<std::size_t, BatchOfIndices>& next_batch : batches_of_indices.peek_next_elements(device_id, index_pin_horizon))
+            {
+                next_host_batches.push_back(next_batch.second.host_batch);
+            }
+            IndexBatch pin_candidates = batch_of_indices->host_batch;
+            pin_candidates.query_indices.insert(std::end(pin_candidates.query_indices), std::begin(pinned_indices.query_indices), std::end(pinned_indices.query_indices));
+            pin_candidates.target_indices.insert(std::end(pin_candidates.target_indices), std::begin(pinned_indices.target_indices), std::end(pinned_indices.target_indices));
+
+            IndexBatch indices_used_again = find_indices_used_again(pin_candidates,
+                                                                    next_host_batches,
+                                                                    application_parameters.all_to_all);
+            // pins are counted, so indices pinned both before and after stay pinned in between
+            pin_indices(*shared_host_cache, indices_used_again);
+            unpin_indices(*shared_host_cache, pinned_indices);
+            pinned_indices = std::move(indices_used_again);
+        }
+
+        const double batch_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - batch_start).count();
+        batch_statistics.add_batch(batch_time);
+        batch_statistics.add_worker_busy_time(device_id, batch_time);
     }
 
+    unpin_indices(*shared_host_cache, pinned_indices);
+
     // tell writer thread that there will be no more overlaps and it can finish once it has written all overlaps
     overlaps_and_cigars_to_process.signal_pushed_last_element();
 
@@ -452,10 +865,63 @@ void worker_thread_function(const int32_t device_id,
         postprocess_and_write_thread.join();
     }
 
+    batch_statistics.add_output_queue(application_parameters.output_queue_capacity,
+                                      overlaps_and_cigars_to_process.statistics());
+
     // by this point all GPU work should anyway be done as postprocess_and_write_thread also finished and all GPU work had to be done before last values could be written
     CGA_CU_CHECK_ERR(cudaStreamSynchronize(cuda_stream));
 }
 
+/// \brief returns approximately how many indices are kept in host memory, used to choose the tile order
+///
+/// Indices of the previous batch are kept until those of the next batch have been generated, host_index_cache_memory keeps
+/// indices of earlier batches on top of that. Size of an index is estimated from its expected number of sketch elements.
+///
+/// \param parameters
+/// \return number of indices
+number_of_indices_t estimate_index_cache_capacity(const ApplicationParameters& parameters)
+{
+    const number_of_indices_t indices_of_previous_batch = parameters.query_indices_in_host_memory + parameters.target_indices_in_host_memory;
+
+    const double sketch_elements_per_index = 2.0 * std::max(parameters.index_size, parameters.target_index_size) * 1'000'000 / (parameters.windows_size + 1);
+    const double bytes_per_sketch_element  = sizeof(representation_t) + sizeof(read_id_t) + sizeof(position_in_read_t) + sizeof(SketchElement::DirectionOfRepresentation);
+    const double indices_in_host_cache     = parameters.host_index_cache_memory * 1'000'000.0 / (sketch_elements_per_index * bytes_per_sketch_element);
+
+    return indices_of_previous_batch + static_cast<number_of_indices_t>(indices_in_host_cache);
+}
+
+/// \brief returns one line describing the input and all parameters the output depends on
+///
+/// Used to check that a checkpoint journal belongs to the same run
+///
+/// \param parameters
+/// \return description
+std::string describe_run(const ApplicationParameters& parameters)
+{
+    std::ostringstream description;
+    description << std::hex
+                << "query=" << parameters.query_input_fingerprint
+                << " target=" << parameters.target_input_fingerprint
+                << std::dec
+                << " k=" << parameters.kmer_size
+                << " w=" << parameters.windows_size
+                << " F=" << parameters.filtering_parameter
+                << " i=" << parameters.index_size
+                << " t=" << parameters.target_index_size
+                << " Q=" << parameters.query_indices_in_host_memory
+                << " q=" << parameters.query_indices_in_device_memory
+                << " C=" << parameters.target_indices_in_host_memory
+                << " c=" << parameters.target_indices_in_device_memory
+                << " a=" << (parameters.alignment_engines > 0)
+                << " r=" << parameters.min_residues
+                << " l=" << parameters.min_overlap_len
+                << " b=" << parameters.min_bases_per_residue
+                << " z=" << parameters.min_overlap_fraction
+                << " R=" << parameters.perform_overlap_end_rescue
+                << " D=" << parameters.drop_fused_overlaps;
+    return description.str();
+}
+
 } // namespace
 
 int main(int argc, char* argv[])
@@ -466,6 +932,34 @@ int main(int argc, char* argv[])
 
     std::mutex output_mutex;
 
+    // overlaps are written to stdout or to the output file, with a checkpoint journal the journal writes them batch by batch
+    std::FILE* output_file                                = stdout;
+    std::unique_ptr<CheckpointJournal> checkpoint_journal = nullptr;
+    if (!parameters.checkpoint_journal_path.empty())
+    {
+        try
+        {
+            checkpoint_journal = std::make_unique<CheckpointJournal>(parameters.checkpoint_journal_path,
+                                                                     parameters.output_filepath,
+                                                                     describe_run(parameters));
+        }
+        catch (const std::runtime_error& e)
+        {
+            std::cerr << e.what() << std::endl;
+            return 1;
+        }
+        output_file = nullptr;
+    }
+    else if (!parameters.output_filepath.empty())
+    {
+        output_file = std::fopen(parameters.output_filepath.c_str(), "wb");
+        if (nullptr == output_file)
+        {
+            std::cerr << "Cannot open output file " << parameters.output_filepath << std::endl;
+            return 1;
+        }
+    }
+
     // Program should process all combinations of query and target (if query and target are the same half of those can be skipped
     // due to symmetry). The matrix of query-target combinations is split into tiles called batches. Worker threads (one per GPU)
     // take batches one by one and process them.
@@ -476,6 +970,25 @@ int main(int argc, char* argv[])
     // the overlaps.
     // Output formatting and writing is done by a separate thread.
 
+    // overlaps are sorted by query and target name in host memory and temporary files and written once all batches are done
+    std::unique_ptr<SortedPafWriter> sorted_paf_writer = nullptr;
+    if (!parameters.sort_output_directory.empty())
+    {
+        // number of postprocess_and_write_threads, see worker_thread_function()
+        const int32_t threads_adding_lines = std::max(static_cast<int32_t>(std::thread::hardware_concurrency()), parameters.num_devices);
+        try
+        {
+            sorted_paf_writer = std::make_unique<SortedPafWriter>(parameters.sort_output_directory,
+                                                                  parameters.sort_memory * 1'000'000ll, // value was in MB
+                                                                  threads_adding_lines);
+        }
+        catch (const std::runtime_error& e)
+        {
+            std::cerr << e.what() << std::endl;
+            return 1;
+        }
+    }
+
     // Split work into batches
     std::vector<BatchOfIndices> batches_of_indices_vect = generate_batches_of_indices(parameters.query_indices_in_host_memory,
                                                                                       parameters.query_indices_in_device_memory,
@@ -485,10 +998,77 @@ int main(int argc, char* argv[])
                                                                                       parameters.target_parser,
                                                                                       parameters.index_size * 1'000'000,        // value was in MB
                                                                                       parameters.target_index_size * 1'000'000, // value was in MB
-                                                                                      parameters.all_to_all);
-    const int64_t number_of_total_batches               = get_size<int64_t>(batches_of_indices_vect);
+                                                                                      parameters.all_to_all,
+                                                                                      parameters.tile_order,
+                                                                                      estimate_index_cache_capacity(parameters));
+
+    // skip batches completed by an interrupted run
+    if (checkpoint_journal && checkpoint_journal->number_of_resumed_batches() > 0)
+    {
+        const int64_t number_of_all_batches = get_size<int64_t>(batches_of_indices_vect);
+        batches_of_indices_vect.erase(std::remove_if(begin(batches_of_indices_vect),
+                                                     end(batches_of_indices_vect),
+                                                     [&checkpoint_journal](const BatchOfIndices& batch) {
+                                                         return checkpoint_journal->is_batch_completed(batch.host_batch.query_indices,
+                                                                                                       batch.host_batch.target_indices);
+                                                     }),
+                                      end(batches_of_indices_vect));
+        std::cerr << "Resuming run recorded in " << parameters.checkpoint_journal_path << ", skipping " << number_of_all_batches - get_size<int64_t>(batches_of_indices_vect)
+                  << " out of " << number_of_all_batches << " batches" << std::endl;
+    }
+
+    const int64_t number_of_total_batches = get_size<int64_t>(batches_of_indices_vect);
     std::atomic<int64_t> number_of_processed_batches(0);
-    ThreadsafeDataProvider<BatchOfIndices> batches_of_indices(std::move(batches_of_indices_vect));
+
+    // devices take the most expensive batches first and steal remaining batches from each other at the end
+    // if batches are ordered for cache locality every device takes one contiguous run of batches instead
+    const std::vector<double> batch_costs = estimate_batch_costs(batches_of_indices_vect,
+                                                                 *parameters.query_parser,
+                                                                 *parameters.target_parser,
+                                                                 parameters.windows_size);
+
+    const WorkAssignment batch_work_assignment = (TileOrder::row_major == parameters.tile_order) ? WorkAssignment::largest_first : WorkAssignment::contiguous;
+    WorkStealingScheduler<BatchOfIndices> batches_of_indices(std::move(batches_of_indices_vect),
+                                                             batch_costs,
+                                                             parameters.num_devices,
+                                                             batch_work_assignment);
+
+    // shows how evenly work is distributed between tiles and batches, e.g. for different read orderings
+    BatchStatistics batch_statistics;
+
+    // indices which the next batches of a device use again are pinned in host memory, devices look at as many next batches as the host index cache can hold
+    const int32_t index_pin_horizon = std::max(1, estimate_index_cache_capacity(parameters) / (parameters.query_indices_in_host_memory + parameters.target_indices_in_host_memory));
+
+    // every index is created only once and kept in host memory for all devices
+    auto shared_host_cache = std::make_shared<SharedIndexHostCache>(parameters.all_to_all,
+                                                                    parameters.host_index_cache_memory * 1'000'000ll); // value was in MB
+
+    // names and lengths of all reads are formatted once and shared by all postprocess_and_write_threads
+    // binary output instead starts with a table of names and lengths of all reads
+    std::unique_ptr<const PafFormatter> paf_formatter = nullptr;
+    if (parameters.binary_output)
+    {
+        std::vector<char> binary_overlaps_header;
+        append_binary_overlaps_header(*parameters.query_parser,
+                                      *parameters.target_parser,
+                                      parameters.kmer_size,
+                                      binary_overlaps_header);
+        try
+        {
+            write_to_file_descriptor(fileno(output_file), binary_overlaps_header.data(), binary_overlaps_header.size());
+        }
+        catch (const std::runtime_error& e)
+        {
+            std::cerr << e.what() << std::endl;
+            return 1;
+        }
+    }
+    else
+    {
+        paf_formatter = std::make_unique<const PafFormatter>(*parameters.query_parser,
+                                                             *parameters.target_parser,
+                                                             parameters.kmer_size);
+    }
 
     // explicitly assign one stream to each GPU
     std::vector<cudaStream_t> cuda_streams(parameters.num_devices);
@@ -504,7 +1084,14 @@ int main(int argc, char* argv[])
                                     device_id,
                                     std::ref(batches_of_indices),
                                     std::ref(parameters),
+                                    paf_formatter.get(),
                                     std::ref(output_mutex),
+                                    output_file,
+                                    checkpoint_journal.get(),
+                                    sorted_paf_writer.get(),
+                                    std::ref(batch_statistics),
+                                    shared_host_cache,
+                                    index_pin_horizon,
                                     cuda_streams[device_id],
                                     number_of_total_batches,
                                     std::ref(number_of_processed_batches));
@@ -518,6 +1105,23 @@ int main(int argc, char* argv[])
         CGA_CU_CHECK_ERR(cudaStreamDestroy(cuda_streams[device_id])); // no need to sync, it should be done at the end of worker_threads
     }
 
+    if (sorted_paf_writer)
+    {
+        std::cerr << "Merging " << sorted_paf_writer->number_of_runs() << " sorted runs" << std::endl;
+        sorted_paf_writer->merge(output_file);
+    }
+
+    batch_statistics.print(std::cerr);
+    std::cerr << "Batches stolen from other devices: " << batches_of_indices.number_of_steals() << std::endl;
+
+    const IndexCacheStatistics host_cache_statistics = shared_host_cache->statistics();
+    std::cerr << "Host index cache: " << host_cache_statistics.hits << " hits, " << host_cache_statistics.misses << " misses, " << host_cache_statistics.evictions << " evictions" << std::endl;
+
+    if (nullptr != output_file && stdout != output_file)
+    {
+        std::fclose(output_file);
+    }
+
     return 0;
 }
 
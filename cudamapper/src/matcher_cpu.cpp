@@ -0,0 +1,204 @@
+/*
+* Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#include "matcher_cpu.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <tuple>
+
+#include <claragenomics/utils/cudautils.hpp>
+#include <claragenomics/utils/run_in_parallel.hpp>
+
+namespace claraparabricks
+{
+
+namespace genomeworks
+{
+
+namespace cudamapper
+{
+
+namespace
+{
+
+/// every thread gets a few representation ranges so that threads which finish early can help with the remaining ones
+constexpr std::int32_t ranges_per_thread = 4;
+
+} // namespace
+
+MatcherCPU::MatcherCPU(const IndexHostCopyBase& query_index,
+                       const IndexHostCopyBase& target_index,
+                       std::int32_t number_of_threads)
+{
+    CGA_NVTX_RANGE(profile, "matcherCPU");
+
+    const std::vector<representation_t>& query_unique_representations  = query_index.unique_representations();
+    const std::vector<representation_t>& target_unique_representations = target_index.unique_representations();
+    if (query_unique_representations.empty() || target_unique_representations.empty())
+    {
+        return;
+    }
+
+    const std::vector<std::uint32_t>& query_first_occurrences  = query_index.first_occurrence_of_representations();
+    const std::vector<std::uint32_t>& target_first_occurrences = target_index.first_occurrence_of_representations();
+    const std::vector<read_id_t>& query_read_ids               = query_index.read_ids();
+    const std::vector<position_in_read_t>& query_positions     = query_index.positions_in_reads();
+    const std::vector<read_id_t>& target_read_ids              = target_index.read_ids();
+    const std::vector<position_in_read_t>& target_positions    = target_index.positions_in_reads();
+    const read_id_t first_query_read_id                        = query_index.first_read_id();
+    const read_id_t number_of_query_reads                      = query_index.number_of_reads();
+
+    number_of_threads = get_number_of_host_threads(number_of_threads);
+
+    // *** split query's unique representations into ranges with roughly the same number of sketch elements ***
+    const std::size_t number_of_ranges = std::min(static_cast<std::size_t>(number_of_threads * ranges_per_thread),
+                                                  query_unique_representations.size());
+    std::vector<std::size_t> range_first_representation(number_of_ranges + 1);
+    for (std::size_t range_id = 0; range_id <= number_of_ranges; ++range_id)
+    {
+        const std::uint64_t first_sketch_element = static_cast<std::uint64_t>(query_read_ids.size()) * range_id / number_of_ranges;
+        range_first_representation[range_id]     = std::lower_bound(std::begin(query_first_occurrences),
+                                                                std::prev(std::end(query_first_occurrences)),
+                                                                first_sketch_element) -
+                                               std::begin(query_first_occurrences);
+    }
+
+    // *** merge-join unique representations and count anchors of every query read ***
+    // Every query sketch element of a matching representation gets one anchor for every target sketch element with that representation
+    std::vector<std::vector<details::matcher_cpu::RepresentationMatch>> range_matches(number_of_ranges);
+    std::vector<std::atomic<std::int64_t>> anchors_per_query_read(number_of_query_reads);
+    run_in_parallel(number_of_threads,
+                    number_of_ranges,
+                    [&](const std::size_t range_id) {
+                        details::matcher_cpu::find_query_target_matches(query_unique_representations,
+                                                                        target_unique_representations,
+                                                                        range_first_representation[range_id],
+                                                                        range_first_representation[range_id + 1],
+                                                                        range_matches[range_id]);
+                        for (const details::matcher_cpu::RepresentationMatch& match : range_matches[range_id])
+                        {
+                            const std::int64_t number_of_target_elements = target_first_occurrences[match.target_index_ + 1] - target_first_occurrences[match.target_index_];
+                            for (std::uint32_t i = query_first_occurrences[match.query_index_]; i < query_first_occurrences[match.query_index_ + 1]; ++i)
+                            {
+                                anchors_per_query_read[query_read_ids[i] - first_query_read_id].fetch_add(number_of_target_elements, std::memory_order_relaxed);
+                            }
+                        }
+                    });
+
+    // *** exclusive sum gives the section of the anchors array of every query read ***
+    std::vector<std::int64_t> query_read_first_anchor(number_of_query_reads + 1, 0);
+    for (read_id_t local_read_id = 0; local_read_id < number_of_query_reads; ++local_read_id)
+    {
+        query_read_first_anchor[local_read_id + 1] = query_read_first_anchor[local_read_id] + anchors_per_query_read[local_read_id].load(std::memory_order_relaxed);
+    }
+    anchors_.resize(query_read_first_anchor.back());
+
+    // *** generate anchors ***
+    // Anchors of every (query sketch element, representation) pair are written as one block into the section of its query read
+    std::vector<std::atomic<std::int64_t>>& next_anchor_of_query_read = anchors_per_query_read;
+    for (read_id_t local_read_id = 0; local_read_id < number_of_query_reads; ++local_read_id)
+    {
+        next_anchor_of_query_read[local_read_id].store(query_read_first_anchor[local_read_id], std::memory_order_relaxed);
+    }
+    run_in_parallel(number_of_threads,
+                    number_of_ranges,
+                    [&](const std::size_t range_id) {
+                        for (const details::matcher_cpu::RepresentationMatch& match : range_matches[range_id])
+                        {
+                            const std::uint32_t target_begin = target_first_occurrences[match.target_index_];
+                            const std::uint32_t target_end   = target_first_occurrences[match.target_index_ + 1];
+                            for (std::uint32_t i = query_first_occurrences[match.query_index_]; i < query_first_occurrences[match.query_index_ + 1]; ++i)
+                            {
+                                std::int64_t anchor_index = next_anchor_of_query_read[query_read_ids[i] - first_query_read_id].fetch_add(target_end - target_begin, std::memory_order_relaxed);
+                                for (std::uint32_t j = target_begin; j < target_end; ++j, ++anchor_index)
+                                {
+                                    Anchor& anchor                  = anchors_[anchor_index];
+                                    anchor.query_read_id_           = query_read_ids[i];
+                                    anchor.target_read_id_          = target_read_ids[j];
+                                    anchor.query_position_in_read_  = query_positions[i];
+                                    anchor.target_position_in_read_ = target_positions[j];
+                                }
+                            }
+                        }
+                        range_matches[range_id].clear();
+                        range_matches[range_id].shrink_to_fit();
+                    });
+
+    // *** sort anchors of every query read by target_read_id -> query_position_in_read -> target_position_in_read ***
+    run_in_parallel(number_of_threads,
+                    number_of_query_reads,
+                    [&](const std::size_t local_read_id) {
+                        std::sort(std::next(std::begin(anchors_), query_read_first_anchor[local_read_id]),
+                                  std::next(std::begin(anchors_), query_read_first_anchor[local_read_id + 1]),
+                                  [](const Anchor& a, const Anchor& b) {
+                                      return std::tie(a.target_read_id_, a.query_position_in_read_, a.target_position_in_read_) <
+                                             std::tie(b.target_read_id_, b.query_position_in_read_, b.target_position_in_read_);
+                                  });
+                    });
+}
+
+const std::vector<Anchor>& MatcherCPU::anchors() const
+{
+    return anchors_;
+}
+
+namespace details
+{
+
+namespace matcher_cpu
+{
+
+void find_query_target_matches(const std::vector<representation_t>& query_unique_representations,
+                               const std::vector<representation_t>& target_unique_representations,
+                               const std::size_t first_query_index,
+                               const std::size_t past_the_last_query_index,
+                               std::vector<RepresentationMatch>& matches)
+{
+    if (first_query_index >= past_the_last_query_index)
+    {
+        return;
+    }
+
+    std::size_t target_index = std::lower_bound(std::begin(target_unique_representations),
+                                                std::end(target_unique_representations),
+                                                query_unique_representations[first_query_index]) -
+                               std::begin(target_unique_representations);
+    std::size_t query_index = first_query_index;
+    while (query_index < past_the_last_query_index && target_index < target_unique_representations.size())
+    {
+        const representation_t query_representation  = query_unique_representations[query_index];
+        const representation_t target_representation = target_unique_representations[target_index];
+        if (query_representation < target_representation)
+        {
+            ++query_index;
+        }
+        else if (target_representation < query_representation)
+        {
+            ++target_index;
+        }
+        else
+        {
+            matches.push_back({static_cast<std::uint32_t>(query_index), static_cast<std::uint32_t>(target_index)});
+            ++query_index;
+            ++target_index;
+        }
+    }
+}
+
+} // namespace matcher_cpu
+
+} // namespace details
+
+} // namespace cudamapper
+
+} // namespace genomeworks
+
+} // namespace claraparabricks
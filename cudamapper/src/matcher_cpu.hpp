@@ -0,0 +1,97 @@
+/*
+* Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <claragenomics/cudamapper/index.hpp>
+#include <claragenomics/cudamapper/types.hpp>
+
+namespace claraparabricks
+{
+
+namespace genomeworks
+{
+
+namespace cudamapper
+{
+
+/// MatcherCPU - generates anchors of two host indices on the host
+///
+/// Anchors are all combinations of query and target sketch elements with the same representation. They are sorted by
+/// query_read_id -> target_read_id -> query_position_in_read -> target_position_in_read, the same way MatcherGPU sorts them.
+class MatcherCPU
+{
+public:
+    /// \brief Constructor, generates anchors
+    /// \param query_index
+    /// \param target_index
+    /// \param number_of_threads number of threads to use, 0 to use one thread per hardware thread
+    MatcherCPU(const IndexHostCopyBase& query_index,
+               const IndexHostCopyBase& target_index,
+               std::int32_t number_of_threads = 0);
+
+    /// \brief returns anchors
+    /// \return anchors
+    const std::vector<Anchor>& anchors() const;
+
+private:
+    std::vector<Anchor> anchors_;
+};
+
+namespace details
+{
+
+namespace matcher_cpu
+{
+
+/// RepresentationMatch - unique representation present in both indices
+struct RepresentationMatch
+{
+    /// index of the representation in query's unique_representations()
+    std::uint32_t query_index_;
+    /// index of the representation in target's unique_representations()
+    std::uint32_t target_index_;
+};
+
+/// \brief Merge-joins unique representations of query and target in [first_query_index, past_the_last_query_index)
+///
+/// For example:
+///   query:
+///     array-index:    0  1  2  3  4
+///     representation: 0 12 23 32 46
+///   target:
+///     array-index:    0  1  2  3  4  5  6
+///     representation: 5 12 16 23 24 25 46
+///
+/// gives (query_index, target_index): (1, 1), (2, 3), (4, 6)
+///
+/// \param query_unique_representations sorted unique representations of query index
+/// \param target_unique_representations sorted unique representations of target index
+/// \param first_query_index first query unique representation to process
+/// \param past_the_last_query_index past the last query unique representation to process
+/// \param matches matches are appended to this vector, sorted by representation
+void find_query_target_matches(const std::vector<representation_t>& query_unique_representations,
+                               const std::vector<representation_t>& target_unique_representations,
+                               std::size_t first_query_index,
+                               std::size_t past_the_last_query_index,
+                               std::vector<RepresentationMatch>& matches);
+
+} // namespace matcher_cpu
+
+} // namespace details
+
+} // namespace cudamapper
+
+} // namespace genomeworks
+
+} // namespace claraparabricks
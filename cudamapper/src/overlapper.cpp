@@ -312,6 +312,12 @@ void Overlapper::rescue_overlap_ends(std::vector<Overlap>& overlaps,
     // check the similarity of the overlapping head and tail sections (matched for length)
     // If they are more than or equal to <required_similarity> similar, extend the overlap start/end fields by <extension> basepairs.
 
+    // Reads are copied into buffers owned by this call rather than accessed through views, so parsers which do not keep
+    // reads as text (packed, windowed) decode them directly and do not have to keep materialized copies around.
+    // The buffers are reused for all overlaps and only grow up to the longest read.
+    std::string query_sequence;
+    std::string target_sequence;
+
     for (auto& overlap : overlaps)
     {
         // Track whether the overlap needs to be reversed from its original orientation on the '-' strand.
@@ -319,10 +325,12 @@ void Overlapper::rescue_overlap_ends(std::vector<Overlap>& overlaps,
 
         // Overlap rescue at "head" (i.e., "left-side") of overlap
         // Get the sequences of the query and target
-        const std::string query_sequence = query_parser.get_sequence_by_id(overlap.query_read_id_).seq;
+        query_sequence.resize(query_parser.get_sequence_length_by_id(overlap.query_read_id_));
+        query_parser.copy_sequence_by_id(overlap.query_read_id_, 0, query_sequence.size(), &query_sequence[0]);
         cga_string_view_t query_view(query_sequence);
-        // target_sequence is non-const as it may be modified when reversing an overlap.
-        std::string target_sequence = target_parser.get_sequence_by_id(overlap.target_read_id_).seq;
+        // target_sequence may be modified when reversing an overlap.
+        target_sequence.resize(target_parser.get_sequence_length_by_id(overlap.target_read_id_));
+        target_parser.copy_sequence_by_id(overlap.target_read_id_, 0, target_sequence.size(), &target_sequence[0]);
 
         if (overlap.relative_strand == RelativeStrand::Reverse)
         {
@@ -0,0 +1,222 @@
+/*
+* Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+
+#include <claragenomics/cudamapper/types.hpp>
+
+namespace claraparabricks
+{
+
+namespace genomeworks
+{
+
+namespace cudamapper
+{
+
+// Functors shared by OverlapperTriggered and OverlapperTriggeredCPU, both implementations have to use them in order to generate the same overlaps
+
+inline __host__ __device__ bool operator==(const Anchor& lhs,
+                                    const Anchor& rhs)
+{
+    auto score_threshold = 1;
+
+    // Very simple scoring function to quantify quality of overlaps.
+    auto score = 1;
+
+    if ((rhs.query_position_in_read_ - lhs.query_position_in_read_) < 150 and abs(int(rhs.target_position_in_read_) - int(lhs.target_position_in_read_)) < 150)
+        score = 2;
+    return ((lhs.query_read_id_ == rhs.query_read_id_) &&
+            (lhs.target_read_id_ == rhs.target_read_id_) &&
+            score > score_threshold);
+}
+
+struct cuOverlapKey
+{
+    const Anchor* anchor;
+};
+
+struct cuOverlapKey_transform
+{
+    const Anchor* d_anchors;
+    const int32_t* d_chain_start;
+
+    cuOverlapKey_transform(const Anchor* anchors, const int32_t* chain_start)
+        : d_anchors(anchors)
+        , d_chain_start(chain_start)
+    {
+    }
+
+    __host__ __device__ __forceinline__ cuOverlapKey
+    operator()(const int32_t& idx) const
+    {
+        auto anchor_idx = d_chain_start[idx];
+
+        cuOverlapKey key;
+        key.anchor = &d_anchors[anchor_idx];
+        return key;
+    }
+};
+
+inline __host__ __device__ bool operator==(const cuOverlapKey& key0,
+                                    const cuOverlapKey& key1)
+{
+    const Anchor* a = key0.anchor;
+    const Anchor* b = key1.anchor;
+
+    int distance_difference = abs(abs(int(a->query_position_in_read_) - int(b->query_position_in_read_)) -
+                                  abs(int(a->target_position_in_read_) - int(b->target_position_in_read_)));
+
+    bool equal = (a->target_read_id_ == b->target_read_id_) &&
+                 (a->query_read_id_ == b->query_read_id_) &&
+                 distance_difference < 300;
+
+    return equal;
+}
+
+struct cuOverlapArgs
+{
+    int32_t overlap_end;
+    int32_t num_residues;
+    int32_t overlap_start;
+};
+
+struct cuOverlapArgs_transform
+{
+    const int32_t* d_chain_start;
+    const int32_t* d_chain_length;
+
+    cuOverlapArgs_transform(const int32_t* chain_start, const int32_t* chain_length)
+        : d_chain_start(chain_start)
+        , d_chain_length(chain_length)
+    {
+    }
+
+    __host__ __device__ __forceinline__ cuOverlapArgs
+    operator()(const int32_t& idx) const
+    {
+        cuOverlapArgs overlap;
+        auto overlap_start    = d_chain_start[idx];
+        auto overlap_length   = d_chain_length[idx];
+        overlap.overlap_end   = overlap_start + overlap_length;
+        overlap.num_residues  = overlap_length;
+        overlap.overlap_start = overlap_start;
+        return overlap;
+    }
+};
+
+struct FuseOverlapOp
+{
+    __host__ __device__ cuOverlapArgs operator()(const cuOverlapArgs& a,
+                                                 const cuOverlapArgs& b) const
+    {
+        cuOverlapArgs fused_overlap;
+        fused_overlap.num_residues = a.num_residues + b.num_residues;
+        fused_overlap.overlap_end =
+            a.overlap_end > b.overlap_end ? a.overlap_end : b.overlap_end;
+        fused_overlap.overlap_start =
+            a.overlap_start < b.overlap_start ? a.overlap_start : b.overlap_start;
+        return fused_overlap;
+    }
+};
+
+struct FilterOverlapOp
+{
+    size_t min_residues;
+    size_t min_overlap_len;
+    size_t min_bases_per_residue;
+    float min_overlap_fraction;
+
+    __host__ __device__ __forceinline__ FilterOverlapOp(size_t min_residues,
+                                                        size_t min_overlap_len,
+                                                        size_t min_bases_per_residue,
+                                                        float min_overlap_fraction)
+        : min_residues(min_residues)
+        , min_overlap_len(min_overlap_len)
+        , min_bases_per_residue(min_bases_per_residue)
+        , min_overlap_fraction(min_overlap_fraction)
+    {
+    }
+
+    __host__ __device__ __forceinline__ bool operator()(const Overlap& overlap) const
+    {
+
+        const auto target_overlap_length = overlap.target_end_position_in_read_ - overlap.target_start_position_in_read_;
+        const auto query_overlap_length  = overlap.query_end_position_in_read_ - overlap.query_start_position_in_read_;
+        const auto overlap_length        = max(target_overlap_length, query_overlap_length);
+
+        return ((overlap.num_residues_ >= min_residues) &&
+                ((overlap_length / overlap.num_residues_) < min_bases_per_residue) &&
+                (query_overlap_length > min_overlap_len) &&
+                (overlap.query_read_id_ != overlap.target_read_id_) &&
+                ((static_cast<float>(target_overlap_length) / static_cast<float>(overlap_length)) > min_overlap_fraction) &&
+                ((static_cast<float>(query_overlap_length) / static_cast<float>(overlap_length)) > min_overlap_fraction));
+    }
+};
+
+struct CreateOverlap
+{
+    const Anchor* d_anchors;
+
+    __host__ __device__ __forceinline__ CreateOverlap(const Anchor* anchors_ptr)
+        : d_anchors(anchors_ptr)
+    {
+    }
+
+    __host__ __device__ __forceinline__ Overlap
+    operator()(cuOverlapArgs overlap)
+    {
+        Anchor overlap_start_anchor = d_anchors[overlap.overlap_start];
+        Anchor overlap_end_anchor   = d_anchors[overlap.overlap_end - 1];
+
+        Overlap new_overlap;
+
+        new_overlap.query_read_id_  = overlap_end_anchor.query_read_id_;
+        new_overlap.target_read_id_ = overlap_end_anchor.target_read_id_;
+        new_overlap.num_residues_   = overlap.num_residues;
+        new_overlap.target_end_position_in_read_ =
+            overlap_end_anchor.target_position_in_read_;
+        new_overlap.target_start_position_in_read_ =
+            overlap_start_anchor.target_position_in_read_;
+        new_overlap.query_end_position_in_read_ =
+            overlap_end_anchor.query_position_in_read_;
+        new_overlap.query_start_position_in_read_ =
+            overlap_start_anchor.query_position_in_read_;
+        new_overlap.overlap_complete = true;
+
+        // If the target start position is greater than the target end position
+        // We can safely assume that the query and target are template and
+        // complement reads. TODO: Incorporate sketchelement direction value when
+        // this is implemented
+        if (new_overlap.target_start_position_in_read_ >
+            new_overlap.target_end_position_in_read_)
+        {
+            new_overlap.relative_strand = RelativeStrand::Reverse;
+            auto tmp                    = new_overlap.target_end_position_in_read_;
+            new_overlap.target_end_position_in_read_ =
+                new_overlap.target_start_position_in_read_;
+            new_overlap.target_start_position_in_read_ = tmp;
+        }
+        else
+        {
+            new_overlap.relative_strand = RelativeStrand::Forward;
+        }
+        return new_overlap;
+    };
+};
+
+} // namespace cudamapper
+
+} // namespace genomeworks
+
+} // namespace claraparabricks
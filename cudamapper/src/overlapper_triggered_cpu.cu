@@ -0,0 +1,207 @@
+/*
+* Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#include "overlapper_triggered_cpu.hpp"
+#include "overlapper_triggered.cuh"
+
+#include <algorithm>
+#include <cassert>
+#include <tuple>
+
+#include <claragenomics/utils/cudautils.hpp>
+#include <claragenomics/utils/run_in_parallel.hpp>
+
+namespace claraparabricks
+{
+
+namespace genomeworks
+{
+
+namespace cudamapper
+{
+
+namespace
+{
+
+/// every thread gets a few groups of read pairs so that threads which finish early can help with the remaining ones
+constexpr std::int32_t anchor_groups_per_thread = 4;
+
+bool same_read_pair(const Anchor& a, const Anchor& b)
+{
+    return a.query_read_id_ == b.query_read_id_ && a.target_read_id_ == b.target_read_id_;
+}
+
+/// \brief chains and fuses anchors in [first_anchor, past_the_last_anchor), the range must not split any read pair
+///
+/// Does the same steps as OverlapperTriggered::get_overlaps(): run length encoding of anchors, dropping short chains,
+/// reducing consecutive chains with equal keys and filtering of created overlaps
+void get_overlaps_of_anchor_group(std::vector<Overlap>& overlaps,
+                                  const std::vector<Anchor>& anchors,
+                                  const std::int32_t first_anchor,
+                                  const std::int32_t past_the_last_anchor,
+                                  const FilterOverlapOp& filter_op)
+{
+    const std::int32_t tail_length_for_chain = 3;
+
+    CreateOverlap create_op(anchors.data());
+    FuseOverlapOp fuse_op;
+
+    bool fusing = false;
+    cuOverlapKey previous_key;
+    cuOverlapArgs fused_overlap;
+
+    const auto add_fused_overlap = [&]() {
+        const Overlap overlap = create_op(fused_overlap);
+        if (filter_op(overlap))
+        {
+            overlaps.push_back(overlap);
+        }
+    };
+
+    std::int32_t chain_start = first_anchor;
+    for (std::int32_t i = first_anchor + 1; i <= past_the_last_anchor; ++i)
+    {
+        // chain ends at the end of the group or when an anchor is not "equal" to the previous one
+        if (i < past_the_last_anchor && anchors[i - 1] == anchors[i])
+        {
+            continue;
+        }
+
+        const std::int32_t chain_length = i - chain_start;
+        if (chain_length >= tail_length_for_chain)
+        {
+            const cuOverlapKey key{&anchors[chain_start]};
+            cuOverlapArgs chain;
+            chain.overlap_end   = chain_start + chain_length;
+            chain.num_residues  = chain_length;
+            chain.overlap_start = chain_start;
+
+            if (fusing && previous_key == key)
+            {
+                fused_overlap = fuse_op(fused_overlap, chain);
+            }
+            else
+            {
+                if (fusing)
+                {
+                    add_fused_overlap();
+                }
+                fused_overlap = chain;
+                fusing        = true;
+            }
+            previous_key = key;
+        }
+        chain_start = i;
+    }
+
+    if (fusing)
+    {
+        add_fused_overlap();
+    }
+}
+
+} // namespace
+
+OverlapperTriggeredCPU::OverlapperTriggeredCPU(const std::int32_t number_of_threads)
+    : number_of_threads_(get_number_of_host_threads(number_of_threads))
+{
+}
+
+void OverlapperTriggeredCPU::get_overlaps(std::vector<Overlap>& fused_overlaps,
+                                          const device_buffer<Anchor>& d_anchors,
+                                          int64_t min_residues,
+                                          int64_t min_overlap_len,
+                                          int64_t min_bases_per_residue,
+                                          float min_overlap_fraction)
+{
+    std::vector<Anchor> anchors(d_anchors.size());
+    cudautils::device_copy_n(d_anchors.data(), d_anchors.size(), anchors.data()); // D2H
+    get_overlaps(fused_overlaps,
+                 anchors,
+                 min_residues,
+                 min_overlap_len,
+                 min_bases_per_residue,
+                 min_overlap_fraction);
+}
+
+void OverlapperTriggeredCPU::get_overlaps(std::vector<Overlap>& fused_overlaps,
+                                          const std::vector<Anchor>& anchors,
+                                          int64_t min_residues,
+                                          int64_t min_overlap_len,
+                                          int64_t min_bases_per_residue,
+                                          float min_overlap_fraction)
+{
+    CGA_NVTX_RANGE(profiler, "OverlapperTriggeredCPU::get_overlaps");
+
+    assert(std::is_sorted(std::begin(anchors),
+                          std::end(anchors),
+                          [](const Anchor& i, const Anchor& j) {
+                              return std::tie(i.query_read_id_, i.target_read_id_, i.query_position_in_read_, i.target_position_in_read_) <
+                                     std::tie(j.query_read_id_, j.target_read_id_, j.query_position_in_read_, j.target_position_in_read_);
+                          }));
+
+    fused_overlaps.clear();
+
+    // anchor indices are int32_t, same as in OverlapperTriggered
+    const std::int32_t number_of_anchors = anchors.size();
+    if (number_of_anchors == 0)
+    {
+        return;
+    }
+
+    // *** split anchors into groups of roughly the same size, moving every border to the next read pair ***
+    const std::int32_t number_of_groups = std::min(number_of_threads_ * anchor_groups_per_thread, number_of_anchors);
+    std::vector<std::int32_t> group_first_anchor(number_of_groups + 1, 0);
+    group_first_anchor.back() = number_of_anchors;
+    for (std::int32_t group_id = 1; group_id < number_of_groups; ++group_id)
+    {
+        std::int32_t first_anchor = std::max(group_first_anchor[group_id - 1],
+                                             static_cast<std::int32_t>(static_cast<std::int64_t>(number_of_anchors) * group_id / number_of_groups));
+        while (first_anchor > 0 && first_anchor < number_of_anchors && same_read_pair(anchors[first_anchor - 1], anchors[first_anchor]))
+        {
+            ++first_anchor;
+        }
+        group_first_anchor[group_id] = first_anchor;
+    }
+
+    // *** generate overlaps of every group ***
+    const FilterOverlapOp filter_op(min_residues, min_overlap_len, min_bases_per_residue, min_overlap_fraction);
+    std::vector<std::vector<Overlap>> group_overlaps(number_of_groups);
+    run_in_parallel(number_of_threads_,
+                    number_of_groups,
+                    [&](const std::size_t group_id) {
+                        if (group_first_anchor[group_id] < group_first_anchor[group_id + 1])
+                        {
+                            get_overlaps_of_anchor_group(group_overlaps[group_id],
+                                                         anchors,
+                                                         group_first_anchor[group_id],
+                                                         group_first_anchor[group_id + 1],
+                                                         filter_op);
+                        }
+                    });
+
+    // *** concatenate overlaps in the order of groups ***
+    std::size_t number_of_overlaps = 0;
+    for (const std::vector<Overlap>& overlaps : group_overlaps)
+    {
+        number_of_overlaps += overlaps.size();
+    }
+    fused_overlaps.reserve(number_of_overlaps);
+    for (const std::vector<Overlap>& overlaps : group_overlaps)
+    {
+        fused_overlaps.insert(std::end(fused_overlaps), std::begin(overlaps), std::end(overlaps));
+    }
+}
+
+} // namespace cudamapper
+
+} // namespace genomeworks
+
+} // namespace claraparabricks
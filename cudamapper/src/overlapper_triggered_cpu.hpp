@@ -0,0 +1,80 @@
+/*
+* Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <claragenomics/cudamapper/types.hpp>
+#include <claragenomics/cudamapper/overlapper.hpp>
+#include <claragenomics/utils/device_buffer.hpp>
+
+namespace claraparabricks
+{
+
+namespace genomeworks
+{
+
+namespace cudamapper
+{
+
+/// OverlapperTriggeredCPU - host implementation of OverlapperTriggered
+///
+/// Chains anchors and fuses chains into overlaps using the same functors as OverlapperTriggered, so both generate the same overlaps
+/// in the same order. Anchors of different (query_read_id, target_read_id) pairs never end up in the same overlap, so groups of read
+/// pairs are processed in parallel.
+/// query_read_name_ and target_read_name_ in output overlaps are not initialized and
+/// will be updated after Overlapper::update_read_names() call
+class OverlapperTriggeredCPU : public Overlapper
+{
+
+public:
+    /// \brief Constructor
+    /// \param number_of_threads number of threads to use, 0 to use one thread per hardware thread
+    explicit OverlapperTriggeredCPU(std::int32_t number_of_threads = 0);
+
+    /// \brief finds all overlaps, copies anchors to host and calls host version of get_overlaps()
+    /// \param fused_overlaps Output vector into which generated overlaps will be placed
+    /// \param d_anchors vector of anchors sorted by query_read_id -> target_read_id -> query_position_in_read -> target_position_in_read
+    /// \param min_residues smallest number of residues (anchors) for an overlap to be accepted
+    /// \param min_overlap_len the smallest overlap distance which is accepted
+    /// \param min_bases_per_residue the minimum number of nucleotides per residue (e.g minimizer) in an overlap
+    /// \param min_overlap_fraction the minimum ratio between the shortest and longest of the target and query components of an overlap
+    void get_overlaps(std::vector<Overlap>& fused_overlaps,
+                      const device_buffer<Anchor>& d_anchors,
+                      int64_t min_residues          = 20,
+                      int64_t min_overlap_len       = 50,
+                      int64_t min_bases_per_residue = 50,
+                      float min_overlap_fraction    = 0.9) override;
+
+    /// \brief finds all overlaps
+    /// \param fused_overlaps Output vector into which generated overlaps will be placed
+    /// \param anchors vector of anchors in host memory sorted by query_read_id -> target_read_id -> query_position_in_read -> target_position_in_read
+    /// \param min_residues smallest number of residues (anchors) for an overlap to be accepted
+    /// \param min_overlap_len the smallest overlap distance which is accepted
+    /// \param min_bases_per_residue the minimum number of nucleotides per residue (e.g minimizer) in an overlap
+    /// \param min_overlap_fraction the minimum ratio between the shortest and longest of the target and query components of an overlap
+    void get_overlaps(std::vector<Overlap>& fused_overlaps,
+                      const std::vector<Anchor>& anchors,
+                      int64_t min_residues          = 20,
+                      int64_t min_overlap_len       = 50,
+                      int64_t min_bases_per_residue = 50,
+                      float min_overlap_fraction    = 0.9);
+
+private:
+    std::int32_t number_of_threads_;
+};
+
+} // namespace cudamapper
+
+} // namespace genomeworks
+
+} // namespace claraparabricks
@@ -0,0 +1,216 @@
+/*
+* Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#include "paf_formatter.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <stdexcept>
+
+#include <unistd.h>
+
+#include <claragenomics/io/fasta_parser.hpp>
+#include <claragenomics/utils/cudautils.hpp>
+#include <claragenomics/utils/signed_integer_utils.hpp>
+
+namespace claraparabricks
+{
+
+namespace genomeworks
+{
+
+namespace cudamapper
+{
+
+namespace
+{
+
+/// upper bound for the number of characters of all fields of a line except for read names, read lengths and cigar
+constexpr std::int64_t max_chars_of_numeric_fields = 10 * 21;
+
+/// \brief appends integer and moves the pointer past it
+template <typename Integer>
+void append_integer(char*& destination,
+                    const Integer value)
+{
+    // destination always has enough space, see max_chars_of_numeric_fields
+    destination = std::to_chars(destination, destination + 21, value).ptr;
+}
+
+/// \brief appends characters and moves the pointer past them
+void append_chars(char*& destination,
+                  const char* const source,
+                  const std::size_t size)
+{
+    std::memcpy(destination, source, size);
+    destination += size;
+}
+
+} // namespace
+
+PafFormatter::PafFormatter(const io::FastaParser& query_parser,
+                           const io::FastaParser& target_parser,
+                           const std::int32_t kmer_size)
+    : query_fields_(format_read_fields(query_parser))
+    , target_fields_(&query_parser == &target_parser ? query_fields_ : format_read_fields(target_parser))
+    , kmer_size_(kmer_size)
+{
+}
+
+PafFormatter::PafFormatter(const std::vector<std::string>& query_read_names,
+                           const std::vector<number_of_basepairs_t>& query_read_lengths,
+                           const std::vector<std::string>& target_read_names,
+                           const std::vector<number_of_basepairs_t>& target_read_lengths,
+                           const std::int32_t kmer_size)
+    : query_fields_(format_read_fields(query_read_names, query_read_lengths))
+    , target_fields_(&query_read_names == &target_read_names ? query_fields_ : format_read_fields(target_read_names, target_read_lengths))
+    , kmer_size_(kmer_size)
+{
+}
+
+void PafFormatter::append_paf(const std::vector<Overlap>& overlaps,
+                              const std::vector<std::string>& cigars,
+                              std::vector<char>& buffer) const
+{
+    CGA_NVTX_RANGE(profiler, "PafFormatter::append_paf");
+
+    assert(cigars.empty() || (overlaps.size() == cigars.size()));
+
+    const char* const query_fields                  = query_fields_->fields.data();
+    const std::vector<std::int64_t>& query_offsets  = query_fields_->offsets;
+    const char* const target_fields                 = target_fields_->fields.data();
+    const std::vector<std::int64_t>& target_offsets = target_fields_->offsets;
+
+    // grow the buffer once to the maximal size of all lines and shrink it to the actual size at the end
+    std::int64_t max_chars = 0;
+    for (std::size_t i = 0; i < overlaps.size(); ++i)
+    {
+        max_chars += query_offsets[overlaps[i].query_read_id_ + 1] - query_offsets[overlaps[i].query_read_id_] +
+                     target_offsets[overlaps[i].target_read_id_ + 1] - target_offsets[overlaps[i].target_read_id_] +
+                     max_chars_of_numeric_fields +
+                     (cigars.empty() ? 0 : 6 + get_size<std::int64_t>(cigars[i]));
+    }
+    const std::size_t old_size = buffer.size();
+    buffer.resize(old_size + max_chars);
+    char* destination = buffer.data() + old_size;
+
+    for (std::size_t i = 0; i < overlaps.size(); ++i)
+    {
+        const Overlap& overlap = overlaps[i];
+
+        append_chars(destination,
+                     query_fields + query_offsets[overlap.query_read_id_],
+                     query_offsets[overlap.query_read_id_ + 1] - query_offsets[overlap.query_read_id_]);
+        *destination++ = '\t';
+        append_integer(destination, overlap.query_start_position_in_read_);
+        *destination++ = '\t';
+        append_integer(destination, overlap.query_end_position_in_read_);
+        *destination++ = '\t';
+        *destination++ = static_cast<char>(overlap.relative_strand);
+        *destination++ = '\t';
+        append_chars(destination,
+                     target_fields + target_offsets[overlap.target_read_id_],
+                     target_offsets[overlap.target_read_id_ + 1] - target_offsets[overlap.target_read_id_]);
+        *destination++ = '\t';
+        append_integer(destination, overlap.target_start_position_in_read_);
+        *destination++ = '\t';
+        append_integer(destination, overlap.target_end_position_in_read_);
+        *destination++ = '\t';
+        // number of residue matches multiplied by kmer size to get approximate number of matching bases
+        append_integer(destination, static_cast<std::int64_t>(overlap.num_residues_) * kmer_size_);
+        *destination++ = '\t';
+        // approximate alignment length
+        append_integer(destination, std::max(std::abs(static_cast<std::int64_t>(overlap.target_start_position_in_read_) - static_cast<std::int64_t>(overlap.target_end_position_in_read_)),
+                                             std::abs(static_cast<std::int64_t>(overlap.query_start_position_in_read_) - static_cast<std::int64_t>(overlap.query_end_position_in_read_))));
+        append_chars(destination, "\t255", 4);
+        if (!cigars.empty())
+        {
+            append_chars(destination, "\tcg:Z:", 6);
+            append_chars(destination, cigars[i].data(), cigars[i].size());
+        }
+        *destination++ = '\n';
+    }
+
+    buffer.resize(destination - buffer.data());
+}
+
+std::shared_ptr<const PafFormatter::ReadFields> PafFormatter::format_read_fields(const number_of_reads_t number_of_reads,
+                                                                                 const std::function<cga_string_view_t(read_id_t)>& get_name,
+                                                                                 const std::function<number_of_basepairs_t(read_id_t)>& get_length)
+{
+    CGA_NVTX_RANGE(profiler, "PafFormatter::format_read_fields");
+
+    auto read_fields = std::make_shared<ReadFields>();
+    read_fields->offsets.reserve(number_of_reads + 1);
+    read_fields->offsets.push_back(0);
+
+    char length[21];
+    for (read_id_t read_id = 0; read_id < number_of_reads; ++read_id)
+    {
+        const cga_string_view_t name = get_name(read_id);
+        read_fields->fields.insert(end(read_fields->fields), begin(name), end(name));
+        read_fields->fields.push_back('\t');
+        char* const length_end = std::to_chars(length, length + sizeof(length), get_length(read_id)).ptr;
+        read_fields->fields.insert(end(read_fields->fields), length, length_end);
+        read_fields->offsets.push_back(get_size<std::int64_t>(read_fields->fields));
+    }
+
+    return read_fields;
+}
+
+std::shared_ptr<const PafFormatter::ReadFields> PafFormatter::format_read_fields(const io::FastaParser& parser)
+{
+    return format_read_fields(parser.get_num_seqences(),
+                              [&parser](const read_id_t read_id) { return parser.get_name_view_by_id(read_id); },
+                              [&parser](const read_id_t read_id) { return parser.get_sequence_length_by_id(read_id); });
+}
+
+std::shared_ptr<const PafFormatter::ReadFields> PafFormatter::format_read_fields(const std::vector<std::string>& read_names,
+                                                                                 const std::vector<number_of_basepairs_t>& read_lengths)
+{
+    if (read_names.size() != read_lengths.size())
+    {
+        throw std::invalid_argument("PafFormatter: number of read names and read lengths is not the same");
+    }
+
+    return format_read_fields(get_size<number_of_reads_t>(read_names),
+                              [&read_names](const read_id_t read_id) { return cga_string_view_t(read_names[read_id]); },
+                              [&read_lengths](const read_id_t read_id) { return read_lengths[read_id]; });
+}
+
+void write_to_file_descriptor(const int file_descriptor,
+                              const char* data,
+                              std::size_t size)
+{
+    // write() might write only a part of the data
+    while (size > 0)
+    {
+        const ssize_t written = ::write(file_descriptor, data, size);
+        if (written < 0)
+        {
+            if (EINTR == errno)
+            {
+                continue;
+            }
+            throw std::runtime_error(std::string("Cannot write output: ") + std::strerror(errno));
+        }
+        data += written;
+        size -= written;
+    }
+}
+
+} // namespace cudamapper
+
+} // namespace genomeworks
+
+} // namespace claraparabricks
@@ -0,0 +1,110 @@
+/*
+* Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <claragenomics/cudamapper/types.hpp>
+
+namespace claraparabricks
+{
+
+namespace genomeworks
+{
+
+namespace io
+{
+class FastaParser;
+} // namespace io
+
+namespace cudamapper
+{
+
+/// PafFormatter - formats overlaps in <a href="https://github.com/lh3/miniasm/blob/master/PAF.md">PAF format</a>
+///
+/// Name and length of every read are formatted once in the constructor, so formatting an overlap only copies these two
+/// fields of both reads and converts the remaining integers with std::to_chars. Output is appended to a buffer provided
+/// by the caller, which can be reused for many calls to avoid reallocations.
+class PafFormatter
+{
+public:
+    /// \brief Constructor
+    /// \param query_parser needed for read names and lengths
+    /// \param target_parser needed for read names and lengths, if it is the same object as query_parser the fields are only formatted once
+    /// \param kmer_size minimizer kmer size
+    PafFormatter(const io::FastaParser& query_parser,
+                 const io::FastaParser& target_parser,
+                 std::int32_t kmer_size);
+
+    /// \brief Constructor
+    /// \param query_read_names
+    /// \param query_read_lengths
+    /// \param target_read_names if it is the same object as query_read_names the fields are only formatted once
+    /// \param target_read_lengths
+    /// \param kmer_size minimizer kmer size
+    PafFormatter(const std::vector<std::string>& query_read_names,
+                 const std::vector<number_of_basepairs_t>& query_read_lengths,
+                 const std::vector<std::string>& target_read_names,
+                 const std::vector<number_of_basepairs_t>& target_read_lengths,
+                 std::int32_t kmer_size);
+
+    /// \brief appends one line per overlap to buffer
+    /// \param overlaps
+    /// \param cigars empty or one cigar string per overlap
+    /// \param buffer formatted lines are appended here, existing content is kept
+    void append_paf(const std::vector<Overlap>& overlaps,
+                    const std::vector<std::string>& cigars,
+                    std::vector<char>& buffer) const;
+
+private:
+    /// ReadFields - "name\tlength" of every read, stored one after another
+    struct ReadFields
+    {
+        std::vector<char> fields;
+        /// fields of read i are in [offsets[i], offsets[i + 1])
+        std::vector<std::int64_t> offsets;
+    };
+
+    /// \brief formats name and length of every read
+    static std::shared_ptr<const ReadFields> format_read_fields(number_of_reads_t number_of_reads,
+                                                                const std::function<cga_string_view_t(read_id_t)>& get_name,
+                                                                const std::function<number_of_basepairs_t(read_id_t)>& get_length);
+
+    /// \brief formats name and length of every read of the parser
+    static std::shared_ptr<const ReadFields> format_read_fields(const io::FastaParser& parser);
+
+    /// \brief formats name and length of every read
+    static std::shared_ptr<const ReadFields> format_read_fields(const std::vector<std::string>& read_names,
+                                                                const std::vector<number_of_basepairs_t>& read_lengths);
+
+    std::shared_ptr<const ReadFields> query_fields_;
+    std::shared_ptr<const ReadFields> target_fields_;
+    const std::int32_t kmer_size_;
+};
+
+/// \brief writes all data to the file descriptor using as few write() calls as possible
+/// \param file_descriptor
+/// \param data
+/// \param size
+/// \throw std::runtime_error if writing fails
+void write_to_file_descriptor(int file_descriptor,
+                              const char* data,
+                              std::size_t size);
+
+} // namespace cudamapper
+
+} // namespace genomeworks
+
+} // namespace claraparabricks
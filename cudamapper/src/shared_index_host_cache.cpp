@@ -0,0 +1,203 @@
+/*
+* Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#include "shared_index_host_cache.hpp"
+
+#include <cassert>
+#include <exception>
+#include <vector>
+
+#include <claragenomics/cudamapper/index.hpp>
+#include <claragenomics/utils/signed_integer_utils.hpp>
+
+namespace claraparabricks
+{
+
+namespace genomeworks
+{
+
+namespace cudamapper
+{
+
+namespace
+{
+
+template <typename T>
+std::int64_t size_in_bytes(const std::vector<T>& data)
+{
+    return get_size<std::int64_t>(data) * sizeof(T);
+}
+
+/// \brief returns the number of bytes occupied by all arrays of the index
+std::int64_t size_in_bytes(const IndexHostCopyBase& index)
+{
+    return size_in_bytes(index.representations()) +
+           size_in_bytes(index.read_ids()) +
+           size_in_bytes(index.positions_in_reads()) +
+           size_in_bytes(index.directions_of_reads()) +
+           size_in_bytes(index.unique_representations()) +
+           size_in_bytes(index.first_occurrence_of_representations());
+}
+
+} // namespace
+
+SharedIndexHostCache::SharedIndexHostCache(const bool same_query_and_target,
+                                           const std::int64_t host_memory_budget)
+    : same_query_and_target_(same_query_and_target)
+    , host_memory_budget_(host_memory_budget)
+{
+}
+
+std::shared_ptr<const IndexHostCopyBase> SharedIndexHostCache::acquire(const Input input,
+                                                                       const IndexDescriptor& descriptor,
+                                                                       const index_creator_t& create_index)
+{
+    const Input cache_input = key_input(input);
+    lru_map_t& lru_map      = (Input::query == cache_input) ? query_lru_map_ : target_lru_map_;
+
+    std::promise<std::shared_ptr<const IndexHostCopyBase>> index_promise;
+    std::shared_future<std::shared_ptr<const IndexHostCopyBase>> index_future;
+    bool create = false;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        auto lru_map_iter = lru_map.find(descriptor);
+        if (lru_map_iter != lru_map.end())
+        {
+            ++statistics_.hits;
+            ++lru_map_iter->second->users;
+            lru_list_.splice(lru_list_.begin(), lru_list_, lru_map_iter->second); // iterators stay valid
+            index_future = lru_map_iter->second->index;
+        }
+        else
+        {
+            ++statistics_.misses;
+            create       = true;
+            index_future = index_promise.get_future().share();
+            lru_list_.push_front({cache_input, descriptor, index_future, 0, 1});
+            lru_map[descriptor] = lru_list_.begin();
+        }
+    }
+
+    if (!create)
+    {
+        // waits if another thread is still creating the index
+        return index_future.get();
+    }
+
+    // create the index without holding the lock so that other indices can be accessed in the meantime
+    std::shared_ptr<const IndexHostCopyBase> index;
+    try
+    {
+        index = create_index();
+        assert(nullptr != index);
+    }
+    catch (...)
+    {
+        // threads waiting for this index get the same exception, next request tries to create the index again
+        index_promise.set_exception(std::current_exception());
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto lru_map_iter = lru_map.find(descriptor);
+        lru_list_.erase(lru_map_iter->second);
+        lru_map.erase(lru_map_iter);
+        throw;
+    }
+
+    index_promise.set_value(index);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        LruEntry& entry = *lru_map.at(descriptor);
+        entry.bytes     = size_in_bytes(*index);
+        lru_bytes_ += entry.bytes;
+        evict_unused_indices();
+    }
+
+    return index;
+}
+
+void SharedIndexHostCache::release(const Input input,
+                                   const IndexDescriptor& descriptor)
+{
+    const Input cache_input = key_input(input);
+    lru_map_t& lru_map      = (Input::query == cache_input) ? query_lru_map_ : target_lru_map_;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // index might have been removed because creating it failed
+    auto lru_map_iter = lru_map.find(descriptor);
+    if (lru_map_iter != lru_map.end())
+    {
+        assert(lru_map_iter->second->users > 0);
+        --lru_map_iter->second->users;
+        evict_unused_indices();
+    }
+}
+
+void SharedIndexHostCache::pin(const Input input,
+                               const IndexDescriptor& descriptor)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    pin_map_t& pins = (Input::query == key_input(input)) ? query_pins_ : target_pins_;
+    ++pins[descriptor];
+}
+
+void SharedIndexHostCache::unpin(const Input input,
+                                 const IndexDescriptor& descriptor)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    pin_map_t& pins = (Input::query == key_input(input)) ? query_pins_ : target_pins_;
+    auto pins_iter  = pins.find(descriptor);
+    assert(pins_iter != pins.end());
+    if (0 == --pins_iter->second)
+    {
+        pins.erase(pins_iter);
+        evict_unused_indices();
+    }
+}
+
+IndexCacheStatistics SharedIndexHostCache::statistics() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return statistics_;
+}
+
+SharedIndexHostCache::Input SharedIndexHostCache::key_input(const Input input) const
+{
+    return same_query_and_target_ ? Input::query : input;
+}
+
+void SharedIndexHostCache::evict_unused_indices()
+{
+    // go from the least recently used index towards the most recently used one
+    auto lru_iter = lru_list_.end();
+    while (lru_bytes_ > host_memory_budget_ && lru_iter != lru_list_.begin())
+    {
+        --lru_iter;
+
+        const bool is_query   = Input::query == lru_iter->input;
+        const pin_map_t& pins = is_query ? query_pins_ : target_pins_;
+
+        if (0 == lru_iter->users && 0 == pins.count(lru_iter->descriptor))
+        {
+            lru_bytes_ -= lru_iter->bytes;
+            (is_query ? query_lru_map_ : target_lru_map_).erase(lru_iter->descriptor);
+            lru_iter = lru_list_.erase(lru_iter); // points to the already checked element after the erased one
+            ++statistics_.evictions;
+        }
+    }
+}
+
+} // namespace cudamapper
+
+} // namespace genomeworks
+
+} // namespace claraparabricks
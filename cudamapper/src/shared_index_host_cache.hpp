@@ -0,0 +1,160 @@
+/*
+* Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "index_descriptor.hpp"
+
+namespace claraparabricks
+{
+
+namespace genomeworks
+{
+
+namespace cudamapper
+{
+
+class IndexHostCopyBase;
+
+/// IndexCacheStatistics - Counters of SharedIndexHostCache
+struct IndexCacheStatistics
+{
+    /// number of requested indices which were already in host memory or were being created by another thread
+    std::int64_t hits = 0;
+    /// number of requested indices which had to be generated or loaded from disk
+    std::int64_t misses = 0;
+    /// number of indices discarded from host memory
+    std::int64_t evictions = 0;
+};
+
+/// SharedIndexHostCache - Thread-safe store of host copies of indices, shared by IndexCacheHosts of all devices
+///
+/// Indices are identified by IndexDescriptor and by being a query or a target index. The first thread to request an index creates it,
+/// other threads requesting the same index in the meantime wait for that index instead of creating it again.
+///
+/// An index is in use from acquire() until the matching release(). Indices which are not in use are kept in host memory as long as the
+/// total size of all host copies fits into host_memory_budget, least recently used indices are discarded first. Indices in use and pinned
+/// indices are never discarded, even if that means going over the budget.
+class SharedIndexHostCache
+{
+public:
+    enum class Input
+    {
+        query,
+        target
+    };
+
+    using index_creator_t = std::function<std::shared_ptr<const IndexHostCopyBase>()>;
+
+    /// \brief Constructor
+    /// \param same_query_and_target true means that query and target are the same, so the same index is used for both
+    /// \param host_memory_budget max number of bytes of host copies of indices to keep, 0 means that indices are discarded as soon as they are not in use
+    SharedIndexHostCache(bool same_query_and_target,
+                         std::int64_t host_memory_budget = 0);
+
+    SharedIndexHostCache(const SharedIndexHostCache&) = delete;
+    SharedIndexHostCache& operator=(const SharedIndexHostCache&) = delete;
+    SharedIndexHostCache(SharedIndexHostCache&&)                 = delete;
+    SharedIndexHostCache& operator=(SharedIndexHostCache&&) = delete;
+    ~SharedIndexHostCache()                                 = default;
+
+    /// \brief Returns the index and marks it as in use, index is created using create_index if it is not in cache
+    /// If another thread is already creating the index the function waits for it. Every call has to be matched by a call to release()
+    /// \param input
+    /// \param descriptor
+    /// \param create_index called if index is not in cache, must not return nullptr
+    /// \throw exceptions thrown by create_index, also in threads waiting for that index
+    /// \return host copy of the index
+    std::shared_ptr<const IndexHostCopyBase> acquire(Input input,
+                                                     const IndexDescriptor& descriptor,
+                                                     const index_creator_t& create_index);
+
+    /// \brief Marks that the index is not used by the caller anymore, once it is not in use by anybody it can be discarded
+    /// \param input
+    /// \param descriptor
+    void release(Input input,
+                 const IndexDescriptor& descriptor);
+
+    /// \brief Prevents index from being discarded until the matching unpin(), index does not have to be in cache yet
+    /// Pins are counted, so an index pinned by several threads is kept until all of them have unpinned it
+    /// \param input
+    /// \param descriptor
+    void pin(Input input,
+             const IndexDescriptor& descriptor);
+
+    /// \brief Undoes one pin() of the index, once it is neither pinned nor in use it can be discarded
+    /// \param input
+    /// \param descriptor
+    void unpin(Input input,
+               const IndexDescriptor& descriptor);
+
+    /// \brief Returns number of cache hits, misses and evictions so far
+    IndexCacheStatistics statistics() const;
+
+private:
+    using pin_map_t = std::unordered_map<IndexDescriptor,
+                                         std::int32_t,
+                                         IndexDescriptorHash>;
+
+    /// Host copy of an index in LRU list
+    struct LruEntry
+    {
+        /// always query if same_query_and_target_ is true
+        Input input;
+        IndexDescriptor descriptor;
+        /// ready once the index has been created
+        std::shared_future<std::shared_ptr<const IndexHostCopyBase>> index;
+        /// 0 until the index has been created
+        std::int64_t bytes;
+        /// number of acquire() calls not yet matched by release()
+        std::int32_t users;
+    };
+
+    using lru_list_t = std::list<LruEntry>;
+
+    using lru_map_t = std::unordered_map<IndexDescriptor,
+                                         lru_list_t::iterator,
+                                         IndexDescriptorHash>;
+
+    /// \brief Returns the input under which indices are kept, query if same_query_and_target_ is true
+    Input key_input(Input input) const;
+
+    /// \brief Discards least recently used indices which are neither in use nor pinned until all indices fit into host_memory_budget_
+    /// mutex_ has to be locked
+    void evict_unused_indices();
+
+    const bool same_query_and_target_;
+    const std::int64_t host_memory_budget_;
+
+    mutable std::mutex mutex_;
+    /// all indices, most recently used first
+    lru_list_t lru_list_;
+    lru_map_t query_lru_map_;
+    lru_map_t target_lru_map_;
+    std::int64_t lru_bytes_ = 0;
+    /// number of pin() calls not yet matched by unpin(), only pinned indices are present
+    pin_map_t query_pins_;
+    pin_map_t target_pins_;
+    IndexCacheStatistics statistics_;
+};
+
+} // namespace cudamapper
+
+} // namespace genomeworks
+
+} // namespace claraparabricks
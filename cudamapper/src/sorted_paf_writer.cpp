@@ -0,0 +1,364 @@
+/*
+* Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#include "sorted_paf_writer.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <future>
+#include <memory>
+#include <queue>
+#include <stdexcept>
+#include <string_view>
+
+#include <unistd.h>
+
+#include <claragenomics/utils/signed_integer_utils.hpp>
+
+namespace claraparabricks
+{
+
+namespace genomeworks
+{
+
+namespace cudamapper
+{
+
+namespace
+{
+
+/// at most this many runs are merged at once, more runs are merged in several passes
+constexpr std::int64_t max_runs_per_merge = 64;
+/// lines are written to files in chunks of this size
+constexpr std::size_t write_buffer_bytes = 4 * 1024 * 1024;
+
+/// \brief returns the field with the given index of a tab-separated line
+std::string_view paf_field(const std::string_view line,
+                           const std::int32_t field_index)
+{
+    std::size_t field_begin = 0;
+    for (std::int32_t i = 0; i < field_index && field_begin <= line.size(); ++i)
+    {
+        field_begin = line.find('\t', field_begin);
+        if (std::string_view::npos == field_begin)
+        {
+            return {};
+        }
+        ++field_begin;
+    }
+    const std::size_t field_end = line.find('\t', field_begin);
+    return line.substr(field_begin, std::string_view::npos == field_end ? std::string_view::npos : field_end - field_begin);
+}
+
+/// \brief orders lines by query name (first field), then by target name (sixth field), then by the whole line
+bool paf_line_less(const std::string_view a,
+                   const std::string_view b)
+{
+    const int query_comparison = paf_field(a, 0).compare(paf_field(b, 0));
+    if (query_comparison != 0)
+    {
+        return query_comparison < 0;
+    }
+    const int target_comparison = paf_field(a, 5).compare(paf_field(b, 5));
+    if (target_comparison != 0)
+    {
+        return target_comparison < 0;
+    }
+    return a < b;
+}
+
+/// BufferedLineWriter - writes lines to a file in large chunks
+class BufferedLineWriter
+{
+public:
+    BufferedLineWriter(std::FILE* file,
+                       const std::string& path)
+        : file_(file)
+        , path_(path)
+    {
+        buffer_.reserve(write_buffer_bytes);
+    }
+
+    /// \brief appends line and '\n'
+    void write_line(const std::string_view line)
+    {
+        if (buffer_.size() + line.size() + 1 > write_buffer_bytes)
+        {
+            flush();
+        }
+        buffer_.insert(end(buffer_), begin(line), end(line));
+        buffer_.push_back('\n');
+    }
+
+    /// \brief writes all buffered lines
+    void flush()
+    {
+        if (!buffer_.empty() && std::fwrite(buffer_.data(), sizeof(char), buffer_.size(), file_) != buffer_.size())
+        {
+            throw std::runtime_error("SortedPafWriter: cannot write to " + path_ + ": " + std::strerror(errno));
+        }
+        buffer_.clear();
+    }
+
+private:
+    std::FILE* const file_;
+    const std::string path_;
+    std::vector<char> buffer_;
+};
+
+/// RunReader - reads lines of a run through a read buffer of the given size
+class RunReader
+{
+public:
+    RunReader(const std::string& path,
+              const std::int64_t read_buffer_bytes)
+        : read_buffer_(read_buffer_bytes)
+    {
+        file_.rdbuf()->pubsetbuf(read_buffer_.data(), read_buffer_.size()); // has to be set before opening the file
+        file_.open(path, std::ios::binary);
+        if (!file_)
+        {
+            throw std::runtime_error("SortedPafWriter: cannot open " + path);
+        }
+    }
+
+    /// \brief reads the next line, returns false if there are no more lines
+    bool next_line()
+    {
+        return static_cast<bool>(std::getline(file_, line_));
+    }
+
+    /// \brief returns the last read line without '\n'
+    std::string_view line() const
+    {
+        return line_;
+    }
+
+private:
+    std::vector<char> read_buffer_;
+    std::ifstream file_;
+    std::string line_;
+};
+
+/// \brief merges lines of all runs and passes them to writer in sorted order
+void merge_runs(const std::vector<std::string>& run_paths,
+                const std::int64_t read_buffer_bytes,
+                BufferedLineWriter& writer)
+{
+    std::vector<std::unique_ptr<RunReader>> readers;
+    for (const std::string& run_path : run_paths)
+    {
+        readers.push_back(std::make_unique<RunReader>(run_path, read_buffer_bytes));
+    }
+
+    // heap of readers, the one with the smallest current line on top
+    auto reader_greater = [&readers](const std::size_t a, const std::size_t b) {
+        return paf_line_less(readers[b]->line(), readers[a]->line());
+    };
+    std::priority_queue<std::size_t, std::vector<std::size_t>, decltype(reader_greater)> heap(reader_greater);
+
+    for (std::size_t i = 0; i < readers.size(); ++i)
+    {
+        if (readers[i]->next_line())
+        {
+            heap.push(i);
+        }
+    }
+
+    while (!heap.empty())
+    {
+        const std::size_t reader_id = heap.top();
+        heap.pop();
+        writer.write_line(readers[reader_id]->line());
+        if (readers[reader_id]->next_line())
+        {
+            heap.push(reader_id);
+        }
+    }
+
+    writer.flush();
+}
+
+} // namespace
+
+SortedPafWriter::SortedPafWriter(const std::string& temporary_directory,
+                                 const std::int64_t memory_limit_bytes,
+                                 const std::int32_t number_of_threads)
+    : run_size_bytes_(memory_limit_bytes / (std::max(number_of_threads, 1) + 1)) // every thread might be sorting one run while the buffer is being filled
+    , read_buffer_bytes_(std::max<std::int64_t>(memory_limit_bytes / (max_runs_per_merge * std::max(number_of_threads, 1)), 4096))
+    , number_of_threads_(number_of_threads)
+    , next_run_id_(0)
+{
+    if (memory_limit_bytes <= 0)
+    {
+        throw std::invalid_argument("SortedPafWriter: memory_limit_bytes has to be positive");
+    }
+    if (number_of_threads <= 0)
+    {
+        throw std::invalid_argument("SortedPafWriter: number_of_threads has to be positive");
+    }
+
+    std::string directory_template = temporary_directory + "/cudamapper_sort_XXXXXX";
+    if (nullptr == ::mkdtemp(&directory_template[0]))
+    {
+        throw std::runtime_error("SortedPafWriter: cannot create temporary directory in " + temporary_directory + ": " + std::strerror(errno));
+    }
+    directory_ = directory_template;
+}
+
+SortedPafWriter::~SortedPafWriter()
+{
+    // runs which have already been merged have been removed before, std::remove fails for them
+    for (std::int64_t run_id = 0; run_id < next_run_id_; ++run_id)
+    {
+        std::remove(run_path(run_id).c_str());
+    }
+    ::rmdir(directory_.c_str());
+}
+
+void SortedPafWriter::add_lines(const std::vector<char>& paf)
+{
+    std::vector<char> full_buffer;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        buffer_.insert(end(buffer_), begin(paf), end(paf));
+        if (get_size<std::int64_t>(buffer_) >= run_size_bytes_)
+        {
+            full_buffer.swap(buffer_);
+        }
+    }
+
+    // sort outside of the lock so that other threads can keep adding lines
+    if (!full_buffer.empty())
+    {
+        write_run(full_buffer);
+    }
+}
+
+void SortedPafWriter::merge(std::FILE* const output)
+{
+    if (!buffer_.empty())
+    {
+        write_run(buffer_);
+        buffer_.clear();
+        buffer_.shrink_to_fit();
+    }
+
+    std::vector<std::string> run_paths;
+    run_paths.swap(run_paths_);
+
+    // merge groups of runs in parallel until all runs can be merged at once
+    while (get_size<std::int64_t>(run_paths) > max_runs_per_merge)
+    {
+        std::vector<std::vector<std::string>> groups;
+        for (std::int64_t first_run = 0; first_run < get_size<std::int64_t>(run_paths); first_run += max_runs_per_merge)
+        {
+            groups.emplace_back(begin(run_paths) + first_run,
+                                begin(run_paths) + std::min(first_run + max_runs_per_merge, get_size<std::int64_t>(run_paths)));
+        }
+
+        std::vector<std::string> merged_run_paths;
+        for (std::int64_t first_group = 0; first_group < get_size<std::int64_t>(groups); first_group += number_of_threads_)
+        {
+            std::vector<std::future<std::string>> merged_runs;
+            for (std::int64_t group = first_group; group < std::min<std::int64_t>(first_group + number_of_threads_, get_size<std::int64_t>(groups)); ++group)
+            {
+                merged_runs.push_back(std::async(std::launch::async, &SortedPafWriter::merge_into_run, this, std::cref(groups[group])));
+            }
+            for (std::future<std::string>& merged_run : merged_runs)
+            {
+                merged_run_paths.push_back(merged_run.get());
+            }
+        }
+        run_paths.swap(merged_run_paths);
+    }
+
+    BufferedLineWriter writer(output, "output");
+    merge_runs(run_paths, read_buffer_bytes_, writer);
+    std::fflush(output);
+
+    for (const std::string& run_path : run_paths)
+    {
+        std::remove(run_path.c_str());
+    }
+}
+
+std::int64_t SortedPafWriter::number_of_runs() const
+{
+    return next_run_id_;
+}
+
+void SortedPafWriter::write_run(std::vector<char>& lines)
+{
+    std::vector<std::string_view> sorted_lines;
+    for (std::size_t line_begin = 0; line_begin < lines.size();)
+    {
+        const char* const line_end = static_cast<const char*>(std::memchr(lines.data() + line_begin, '\n', lines.size() - line_begin));
+        const std::size_t line_size = (nullptr == line_end ? lines.data() + lines.size() : line_end) - (lines.data() + line_begin);
+        sorted_lines.emplace_back(lines.data() + line_begin, line_size);
+        line_begin += line_size + 1;
+    }
+    std::sort(begin(sorted_lines), end(sorted_lines), paf_line_less);
+
+    const std::string path = run_path(next_run_id_++);
+    std::FILE* const file  = std::fopen(path.c_str(), "wb");
+    if (nullptr == file)
+    {
+        throw std::runtime_error("SortedPafWriter: cannot create " + path + ": " + std::strerror(errno));
+    }
+    BufferedLineWriter writer(file, path);
+    for (const std::string_view line : sorted_lines)
+    {
+        writer.write_line(line);
+    }
+    writer.flush();
+    if (std::fclose(file) != 0)
+    {
+        throw std::runtime_error("SortedPafWriter: cannot write to " + path + ": " + std::strerror(errno));
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    run_paths_.push_back(path);
+}
+
+std::string SortedPafWriter::merge_into_run(const std::vector<std::string>& run_paths)
+{
+    const std::string path = run_path(next_run_id_++);
+    std::FILE* const file  = std::fopen(path.c_str(), "wb");
+    if (nullptr == file)
+    {
+        throw std::runtime_error("SortedPafWriter: cannot create " + path + ": " + std::strerror(errno));
+    }
+    BufferedLineWriter writer(file, path);
+    merge_runs(run_paths, read_buffer_bytes_, writer);
+    if (std::fclose(file) != 0)
+    {
+        throw std::runtime_error("SortedPafWriter: cannot write to " + path + ": " + std::strerror(errno));
+    }
+
+    for (const std::string& run_path : run_paths)
+    {
+        std::remove(run_path.c_str());
+    }
+    return path;
+}
+
+std::string SortedPafWriter::run_path(const std::int64_t run_id) const
+{
+    return directory_ + "/run_" + std::to_string(run_id) + ".paf";
+}
+
+} // namespace cudamapper
+
+} // namespace genomeworks
+
+} // namespace claraparabricks
@@ -0,0 +1,100 @@
+/*
+* Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace claraparabricks
+{
+
+namespace genomeworks
+{
+
+namespace cudamapper
+{
+
+/// SortedPafWriter - writes PAF lines sorted by query name and then by target name using an external merge sort
+///
+/// Added lines are collected in a buffer. Once the buffer is full its lines are sorted and written to a temporary file (a run) by the thread which
+/// has filled it, so runs are sorted in parallel by all threads that add lines. At the end runs are merged into the output. If there are too many
+/// runs to merge them at once groups of runs are first merged into longer runs in parallel.
+/// Host memory is bounded by memory_limit_bytes for buffers and by the read buffers of the runs which are being merged.
+///
+/// Lines with the same query and target name are ordered by the whole line, so the output does not depend on the order in which lines were added.
+class SortedPafWriter
+{
+public:
+    /// \brief Constructor
+    /// \param temporary_directory runs are written to a new directory in this directory, the new directory is removed by the destructor
+    /// \param memory_limit_bytes approximate limit for host memory used by buffered lines and by read buffers
+    /// \param number_of_threads maximal number of threads adding lines at the same time, also used for merging
+    /// \throw std::invalid_argument if memory_limit_bytes or number_of_threads are not positive
+    /// \throw std::runtime_error if temporary directory cannot be created
+    SortedPafWriter(const std::string& temporary_directory,
+                    std::int64_t memory_limit_bytes,
+                    std::int32_t number_of_threads);
+
+    /// \brief deleted copy constructor
+    SortedPafWriter(const SortedPafWriter&) = delete;
+    /// \brief deleted copy assignment operator
+    SortedPafWriter& operator=(const SortedPafWriter&) = delete;
+    /// \brief deleted move constructor
+    SortedPafWriter(SortedPafWriter&&) = delete;
+    /// \brief deleted move assignment operator
+    SortedPafWriter& operator=(SortedPafWriter&&) = delete;
+
+    /// \brief Destructor, removes all temporary files
+    ~SortedPafWriter();
+
+    /// \brief adds PAF lines, thread-safe
+    /// \param paf complete lines, every line terminated by '\n'
+    /// \throw std::runtime_error if a run cannot be written
+    void add_lines(const std::vector<char>& paf);
+
+    /// \brief merges all lines and writes them to output, should be called once after all lines have been added
+    /// \param output
+    /// \throw std::runtime_error if a run cannot be read or written
+    void merge(std::FILE* output);
+
+    /// \brief returns the number of runs written so far
+    std::int64_t number_of_runs() const;
+
+private:
+    /// \brief sorts lines and writes them to a new run
+    void write_run(std::vector<char>& lines);
+
+    /// \brief merges runs into one run and removes them
+    /// \return path of the new run
+    std::string merge_into_run(const std::vector<std::string>& run_paths);
+
+    /// \brief returns path of the run with the given id
+    std::string run_path(std::int64_t run_id) const;
+
+    std::string directory_;
+    const std::int64_t run_size_bytes_;
+    const std::int64_t read_buffer_bytes_;
+    const std::int32_t number_of_threads_;
+    std::vector<char> buffer_;
+    std::vector<std::string> run_paths_;
+    std::atomic<std::int64_t> next_run_id_;
+    mutable std::mutex mutex_;
+};
+
+} // namespace cudamapper
+
+} // namespace genomeworks
+
+} // namespace claraparabricks
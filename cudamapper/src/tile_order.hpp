@@ -0,0 +1,37 @@
+/*
+* Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#pragma once
+
+namespace claraparabricks
+{
+
+namespace genomeworks
+{
+
+namespace cudamapper
+{
+
+/// TileOrder - order in which tiles of the query x target matrix are turned into batches
+///
+/// Consecutive batches which share query or target indices do not have to generate those indices again if they are still cached
+enum class TileOrder
+{
+    row_major,  ///< all tiles of one query section, then all tiles of the next query section
+    serpentine, ///< like row_major, but every other row is walked backwards so that a row starts with the last target section of the previous row
+    hilbert,    ///< tiles along a Hilbert curve, consecutive batches stay close to each other in both directions
+    automatic   ///< the order for which simulate_index_builds() returns the fewest index builds
+};
+
+} // namespace cudamapper
+
+} // namespace genomeworks
+
+} // namespace claraparabricks
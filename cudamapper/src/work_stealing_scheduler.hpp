@@ -0,0 +1,234 @@
+/*
+* Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <claragenomics/types.hpp>
+
+namespace claraparabricks
+{
+
+namespace genomeworks
+{
+
+namespace cudamapper
+{
+
+/// WorkAssignment - how WorkStealingScheduler assigns elements to workers
+enum class WorkAssignment
+{
+    largest_first, ///< elements are sorted by cost and dealt out one by one to the worker with the smallest total cost so far
+    contiguous     ///< elements keep their order and every worker gets one contiguous run of elements with about the same total cost
+};
+
+/// WorkStealingScheduler - gives elements with estimated costs to multiple workers
+///
+/// With WorkAssignment::largest_first every worker gets a queue of elements sorted from the largest to the smallest one.
+/// With WorkAssignment::contiguous consecutive elements stay together, which is useful if consecutive elements share data.
+/// In both cases all workers get about the same total cost.
+/// Workers take elements from the front of their own queue. Once its queue is empty a worker steals the element at the back
+/// of the queue with the largest remaining cost, so estimation errors are evened out at the end of the run.
+///
+/// All functions are thread-safe. Elements take much longer to process than to hand out, so all queues share one mutex.
+template <typename T>
+class WorkStealingScheduler
+{
+public:
+    /// \brief Constructor
+    /// \param elements elements to hand out
+    /// \param costs estimated cost of every element
+    /// \param number_of_workers
+    /// \param work_assignment
+    /// \throw std::invalid_argument if the number of costs and elements differs or if number_of_workers is smaller than 1
+    WorkStealingScheduler(std::vector<T>&& elements,
+                          const std::vector<double>& costs,
+                          const std::int32_t number_of_workers,
+                          const WorkAssignment work_assignment = WorkAssignment::largest_first)
+        : elements_(std::move(elements))
+        , costs_(costs)
+        , queues_(std::max(number_of_workers, 0))
+        , remaining_costs_(std::max(number_of_workers, 0), 0.0)
+    {
+        if (elements_.size() != costs_.size())
+        {
+            throw std::invalid_argument("WorkStealingScheduler: number of elements and costs is not the same");
+        }
+        if (number_of_workers < 1)
+        {
+            throw std::invalid_argument("WorkStealingScheduler: there has to be at least one worker");
+        }
+
+        if (WorkAssignment::largest_first == work_assignment)
+        {
+            assign_largest_first();
+        }
+        else
+        {
+            assign_contiguous();
+        }
+    }
+
+    /// \brief deleted copy constructor
+    WorkStealingScheduler(const WorkStealingScheduler&) = delete;
+    /// \brief deleted copy assignment operator
+    WorkStealingScheduler& operator=(const WorkStealingScheduler&) = delete;
+    /// \brief deleted move constructor
+    WorkStealingScheduler(WorkStealingScheduler&&) = delete;
+    /// \brief deleted move assignment operator
+    WorkStealingScheduler& operator=(WorkStealingScheduler&&) = delete;
+    /// \brief destructor
+    ~WorkStealingScheduler() = default;
+
+    /// \brief returns next element of the given worker, an element stolen from another worker or empty optional object if there are no elements left
+    /// \param worker_id
+    cga_optional_t<T> get_next_element(const std::int32_t worker_id)
+    {
+        std::size_t element_id = 0;
+        return get_next_element(worker_id, element_id);
+    }
+
+    /// \brief returns next element of the given worker, an element stolen from another worker or empty optional object if there are no elements left
+    /// \param worker_id
+    /// \param element_id on output position of the returned element in the elements passed to the constructor, unchanged if there are no elements left
+    cga_optional_t<T> get_next_element(const std::int32_t worker_id,
+                                       std::size_t& element_id)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        if (!queues_[worker_id].empty())
+        {
+            element_id = queues_[worker_id].front();
+            queues_[worker_id].pop_front();
+            remaining_costs_[worker_id] -= costs_[element_id];
+        }
+        else
+        {
+            // steal from the worker with the most remaining work
+            std::int32_t victim_id = -1;
+            for (std::int32_t other_worker_id = 0; other_worker_id < static_cast<std::int32_t>(queues_.size()); ++other_worker_id)
+            {
+                if (!queues_[other_worker_id].empty() && (-1 == victim_id || remaining_costs_[other_worker_id] > remaining_costs_[victim_id]))
+                {
+                    victim_id = other_worker_id;
+                }
+            }
+            if (-1 == victim_id)
+            {
+                return cga_nullopt;
+            }
+            element_id = queues_[victim_id].back();
+            queues_[victim_id].pop_back();
+            remaining_costs_[victim_id] -= costs_[element_id];
+            ++number_of_steals_;
+        }
+
+        return cga_optional_t<T>(std::move(elements_[element_id]));
+    }
+
+    /// \brief returns copies of the next elements in the queue of the given worker without handing them out
+    ///
+    /// Returned elements stay in the queue, so other workers can still steal them once their own queues are empty.
+    /// Meant for preparing the data of the next elements in advance.
+    ///
+    /// \param worker_id
+    /// \param max_number_of_elements
+    /// \return pairs of positions of elements in the elements passed to the constructor and copies of those elements, next element first
+    std::vector<std::pair<std::size_t, T>> peek_next_elements(const std::int32_t worker_id,
+                                                              const std::size_t max_number_of_elements) const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        const std::deque<std::size_t>& queue = queues_[worker_id];
+        std::vector<std::pair<std::size_t, T>> next_elements;
+        for (std::size_t i = 0; i < std::min(max_number_of_elements, queue.size()); ++i)
+        {
+            next_elements.emplace_back(queue[i], elements_[queue[i]]);
+        }
+        return next_elements;
+    }
+
+    /// \brief returns the number of elements taken from the queue of another worker so far
+    std::int64_t number_of_steals() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return number_of_steals_;
+    }
+
+private:
+    /// \brief deals out elements one by one, largest first, to the worker with the smallest total cost so far
+    void assign_largest_first()
+    {
+        // elements with the same cost keep their original order
+        std::vector<std::size_t> element_ids(elements_.size());
+        std::iota(begin(element_ids), end(element_ids), 0);
+        std::stable_sort(begin(element_ids),
+                         end(element_ids),
+                         [this](const std::size_t a, const std::size_t b) { return costs_[a] > costs_[b]; });
+
+        for (const std::size_t element_id : element_ids)
+        {
+            const std::size_t worker_id = std::distance(begin(remaining_costs_),
+                                                        std::min_element(begin(remaining_costs_), end(remaining_costs_)));
+            queues_[worker_id].push_back(element_id);
+            remaining_costs_[worker_id] += costs_[element_id];
+        }
+    }
+
+    /// \brief splits elements into contiguous runs with about the same total cost, one run per worker
+    void assign_contiguous()
+    {
+        const double total_cost          = std::accumulate(begin(costs_), end(costs_), 0.0);
+        const std::size_t workers        = queues_.size();
+        double cost_of_previous_elements = 0.0;
+        for (std::size_t element_id = 0; element_id < elements_.size(); ++element_id)
+        {
+            // element belongs to the worker whose share of the total cost contains the middle of the element
+            std::size_t worker_id = 0;
+            if (total_cost > 0.0)
+            {
+                worker_id = static_cast<std::size_t>((cost_of_previous_elements + costs_[element_id] / 2) / total_cost * workers);
+            }
+            else
+            {
+                worker_id = element_id * workers / elements_.size();
+            }
+            worker_id = std::min(worker_id, workers - 1);
+
+            queues_[worker_id].push_back(element_id);
+            remaining_costs_[worker_id] += costs_[element_id];
+            cost_of_previous_elements += costs_[element_id];
+        }
+    }
+
+    /// whenever an element is handed out it is moved from this value
+    std::vector<T> elements_;
+    const std::vector<double> costs_;
+    /// ids of elements in elements_ for every worker, largest element first
+    std::vector<std::deque<std::size_t>> queues_;
+    /// sum of costs of elements in queue of every worker
+    std::vector<double> remaining_costs_;
+    std::int64_t number_of_steals_ = 0;
+    mutable std::mutex mutex_;
+};
+
+} // namespace cudamapper
+
+} // namespace genomeworks
+
+} // namespace claraparabricks
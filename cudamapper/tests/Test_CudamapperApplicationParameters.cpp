@@ -0,0 +1,125 @@
+/*
+* Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#include "gtest/gtest.h"
+
+#include "../src/application_parameters.hpp"
+
+#include <fstream>
+#include <getopt.h>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <claragenomics/io/fasta_parser.hpp>
+#include <claragenomics/io/read_store.hpp>
+#include <claragenomics/utils/genomeutils.hpp>
+
+namespace claraparabricks
+{
+
+namespace genomeworks
+{
+
+namespace cudamapper
+{
+
+namespace
+{
+
+/// \brief parses the command line as cudamapper does, arguments do not include the program name
+ApplicationParameters parse_arguments(const std::vector<std::string>& arguments)
+{
+    std::vector<std::string> argv_strings(1, "cudamapper");
+    argv_strings.insert(std::end(argv_strings), std::begin(arguments), std::end(arguments));
+    std::vector<char*> argv;
+    for (std::string& argument : argv_strings)
+    {
+        argv.push_back(&argument[0]);
+    }
+    argv.push_back(nullptr);
+
+    // getopt keeps its state between calls, 0 makes it start over
+    optind = 0;
+    return ApplicationParameters(static_cast<int>(argv_strings.size()), argv.data());
+}
+
+std::string write_fasta_file(const std::string& file_name)
+{
+    const std::string file_path = ::testing::TempDir() + file_name;
+    std::ofstream file(file_path);
+    std::minstd_rand rng(1);
+    std::uniform_int_distribution<std::int32_t> read_length(10, 1000);
+    for (std::int32_t i = 0; i < 100; ++i)
+    {
+        file << ">read_" << i << "\n"
+             << genomeutils::generate_random_genome(read_length(rng), rng) << "\n";
+    }
+    return file_path;
+}
+
+void check_same_reads(const io::FastaParser& expected_parser,
+                      const io::FastaParser& parser)
+{
+    ASSERT_EQ(parser.get_num_seqences(), expected_parser.get_num_seqences());
+    for (read_id_t read_id = 0; read_id < expected_parser.get_num_seqences(); ++read_id)
+    {
+        ASSERT_EQ(parser.get_name_view_by_id(read_id), expected_parser.get_name_view_by_id(read_id)) << "read_id: " << read_id;
+        ASSERT_EQ(parser.get_sequence_view_by_id(read_id), expected_parser.get_sequence_view_by_id(read_id)) << "read_id: " << read_id;
+    }
+}
+
+} // namespace
+
+TEST(TestCudamapperApplicationParameters, input_parsers_read_same_reads)
+{
+    const std::string fasta_path = write_fasta_file("test_input_parsers_read_same_reads.fasta");
+    // k + w - 1 is the minimum length of reads
+    const std::unique_ptr<io::FastaParser> expected_parser = io::create_kseq_fasta_parser(fasta_path, 15 + 15 - 1, true);
+
+    for (const std::string input_parser : {"auto", "kseq", "parallel", "mmap"})
+    {
+        const ApplicationParameters parameters = parse_arguments({"-L", input_parser, fasta_path, fasta_path});
+        ASSERT_TRUE(parameters.all_to_all) << "input_parser: " << input_parser;
+        check_same_reads(*expected_parser, *parameters.query_parser);
+    }
+}
+
+TEST(TestCudamapperApplicationParameters, read_store_input)
+{
+    const std::string fasta_path      = write_fasta_file("test_read_store_input.fasta");
+    const std::string read_store_path = ::testing::TempDir() + "test_read_store_input.cgareads";
+    io::write_read_store(*io::create_kseq_fasta_parser(fasta_path, 0, false), read_store_path);
+    const std::unique_ptr<io::FastaParser> expected_parser = io::create_kseq_fasta_parser(fasta_path, 15 + 15 - 1, true);
+
+    // read stores are recognized independently of the selected parser, also in inputs with multiple files
+    for (const std::string input_parser_option : {"-Lauto", "-Lkseq", "-P", "-W1"})
+    {
+        const ApplicationParameters parameters = parse_arguments({input_parser_option, read_store_path, fasta_path});
+        check_same_reads(*expected_parser, *parameters.query_parser);
+        check_same_reads(*expected_parser, *parameters.target_parser);
+    }
+
+    const ApplicationParameters parameters = parse_arguments({"-O", "file", read_store_path + "," + read_store_path, fasta_path});
+    ASSERT_EQ(parameters.query_parser->get_num_seqences(), 2 * expected_parser->get_num_seqences());
+}
+
+TEST(TestCudamapperApplicationParameters, invalid_input_parser)
+{
+    const std::string fasta_path = write_fasta_file("test_invalid_input_parser.fasta");
+    ASSERT_EXIT(parse_arguments({"-L", "unknown", fasta_path, fasta_path}), ::testing::ExitedWithCode(1), "");
+    ASSERT_EXIT(parse_arguments({"-L", "kseq", "-P", fasta_path, fasta_path}), ::testing::ExitedWithCode(1), "");
+}
+
+} // namespace cudamapper
+
+} // namespace genomeworks
+
+} // namespace claraparabricks
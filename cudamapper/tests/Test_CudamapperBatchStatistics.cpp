@@ -0,0 +1,144 @@
+/*
+* Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#include "gtest/gtest.h"
+
+#include "../src/batch_statistics.hpp"
+
+#include <sstream>
+
+namespace claraparabricks
+{
+
+namespace genomeworks
+{
+
+namespace cudamapper
+{
+
+TEST(TestCudamapperBatchStatistics, test_empty)
+{
+    const SummaryStatistics statistics;
+    EXPECT_EQ(statistics.count(), 0);
+    EXPECT_EQ(statistics.mean(), 0.0);
+    EXPECT_EQ(statistics.standard_deviation(), 0.0);
+    EXPECT_EQ(statistics.max(), 0.0);
+}
+
+TEST(TestCudamapperBatchStatistics, test_summary_statistics)
+{
+    SummaryStatistics statistics;
+    for (const double value : {2.0, 4.0, 4.0, 4.0, 5.0, 5.0, 7.0, 9.0})
+    {
+        statistics.add(value);
+    }
+    EXPECT_EQ(statistics.count(), 8);
+    EXPECT_DOUBLE_EQ(statistics.mean(), 5.0);
+    EXPECT_DOUBLE_EQ(statistics.standard_deviation(), 2.0);
+    EXPECT_DOUBLE_EQ(statistics.max(), 9.0);
+}
+
+TEST(TestCudamapperBatchStatistics, test_batch_statistics)
+{
+    BatchStatistics statistics;
+    statistics.add_tile(10);
+    statistics.add_tile(30);
+    statistics.add_batch(1.5);
+
+    EXPECT_EQ(statistics.tile_anchors().count(), 2);
+    EXPECT_DOUBLE_EQ(statistics.tile_anchors().mean(), 20.0);
+    EXPECT_DOUBLE_EQ(statistics.tile_anchors().max(), 30.0);
+    EXPECT_EQ(statistics.batch_wall_times().count(), 1);
+    EXPECT_DOUBLE_EQ(statistics.batch_wall_times().standard_deviation(), 0.0);
+
+    std::ostringstream output;
+    statistics.print(output);
+    EXPECT_NE(output.str().find("2 tiles"), std::string::npos);
+    EXPECT_NE(output.str().find("1 batches"), std::string::npos);
+}
+
+TEST(TestCudamapperBatchStatistics, test_worker_busy_times)
+{
+    BatchStatistics statistics;
+    statistics.add_worker_busy_time(1, 2.0);
+    statistics.add_worker_busy_time(0, 1.0);
+    statistics.add_worker_busy_time(1, 0.5);
+
+    const std::vector<double> busy_times = statistics.worker_busy_times();
+    ASSERT_EQ(busy_times.size(), 2u);
+    EXPECT_DOUBLE_EQ(busy_times[0], 1.0);
+    EXPECT_DOUBLE_EQ(busy_times[1], 2.5);
+
+    std::ostringstream output;
+    statistics.print(output);
+    EXPECT_NE(output.str().find("Busy time per worker: 0: 1 s, 1: 2.5 s"), std::string::npos);
+}
+
+TEST(TestCudamapperBatchStatistics, test_index_prefetch)
+{
+    BatchStatistics statistics;
+    EXPECT_DOUBLE_EQ(statistics.index_prefetch_efficiency(), 0.0);
+    {
+        std::ostringstream output;
+        statistics.print(output);
+        EXPECT_EQ(output.str().find("Index prefetch"), std::string::npos);
+    }
+
+    statistics.add_index_prefetch(3.0, 0.0);
+    statistics.add_index_prefetch(1.0, 1.0);
+    EXPECT_DOUBLE_EQ(statistics.index_prefetch_efficiency(), 0.75);
+
+    statistics.add_index_prefetch(0.0, 10.0);
+    EXPECT_DOUBLE_EQ(statistics.index_prefetch_efficiency(), 0.0);
+
+    std::ostringstream output;
+    statistics.print(output);
+    EXPECT_NE(output.str().find("Index prefetch: 4 s"), std::string::npos);
+}
+
+TEST(TestCudamapperBatchStatistics, test_output_queue)
+{
+    BatchStatistics statistics;
+    {
+        std::ostringstream output;
+        statistics.print(output);
+        EXPECT_EQ(output.str().find("Output queue"), std::string::npos);
+    }
+
+    ProducerConsumerStatistics first_queue;
+    first_queue.high_water_mark          = 4;
+    first_queue.number_of_added_elements = 10;
+    first_queue.number_of_blocked_adds   = 3;
+    first_queue.blocked_seconds          = 1.5;
+    statistics.add_output_queue(4, first_queue);
+
+    ProducerConsumerStatistics second_queue;
+    second_queue.high_water_mark          = 2;
+    second_queue.number_of_added_elements = 6;
+    second_queue.number_of_blocked_adds   = 1;
+    second_queue.blocked_seconds          = 0.5;
+    statistics.add_output_queue(4, second_queue);
+
+    const ProducerConsumerStatistics combined = statistics.output_queue_statistics();
+    EXPECT_EQ(combined.high_water_mark, 4);
+    EXPECT_EQ(combined.number_of_added_elements, 16);
+    EXPECT_EQ(combined.number_of_blocked_adds, 4);
+    EXPECT_DOUBLE_EQ(combined.blocked_seconds, 2.0);
+
+    std::ostringstream output;
+    statistics.print(output);
+    EXPECT_NE(output.str().find("Output queue: at most 4 tiles waiting for writers (capacity 4), 4 of 16 tiles waited 2 s for a free slot"), std::string::npos);
+}
+
+} // namespace cudamapper
+
+} // namespace genomeworks
+
+} // namespace claraparabricks
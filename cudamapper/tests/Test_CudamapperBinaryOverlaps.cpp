@@ -0,0 +1,191 @@
+/*
+* Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#include "gtest/gtest.h"
+
+#include <claragenomics/cudamapper/binary_overlaps.hpp>
+
+#include "../src/paf_formatter.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <claragenomics/io/fasta_parser.hpp>
+
+#include "cudamapper_file_location.hpp"
+
+namespace claraparabricks
+{
+
+namespace genomeworks
+{
+
+namespace cudamapper
+{
+
+namespace
+{
+
+Overlap make_overlap(const read_id_t query_read_id,
+                     const read_id_t target_read_id,
+                     const position_in_read_t start,
+                     const position_in_read_t end,
+                     const RelativeStrand relative_strand,
+                     const std::uint32_t num_residues)
+{
+    Overlap overlap;
+    overlap.query_read_id_                 = query_read_id;
+    overlap.target_read_id_                = target_read_id;
+    overlap.query_start_position_in_read_  = start;
+    overlap.query_end_position_in_read_    = end;
+    overlap.target_start_position_in_read_ = start + 1;
+    overlap.target_end_position_in_read_   = end - 1;
+    overlap.relative_strand                = relative_strand;
+    overlap.num_residues_                  = num_residues;
+    return overlap;
+}
+
+void write_file(const std::string& file_path,
+                const std::vector<char>& data)
+{
+    std::ofstream file(file_path, std::ios::binary | std::ios::trunc);
+    file.write(data.data(), data.size());
+}
+
+void expect_same_overlaps(const std::vector<Overlap>& expected,
+                          const std::vector<Overlap>& actual)
+{
+    ASSERT_EQ(expected.size(), actual.size());
+    for (std::size_t i = 0; i < expected.size(); ++i)
+    {
+        EXPECT_EQ(expected[i].query_read_id_, actual[i].query_read_id_);
+        EXPECT_EQ(expected[i].target_read_id_, actual[i].target_read_id_);
+        EXPECT_EQ(expected[i].query_start_position_in_read_, actual[i].query_start_position_in_read_);
+        EXPECT_EQ(expected[i].query_end_position_in_read_, actual[i].query_end_position_in_read_);
+        EXPECT_EQ(expected[i].target_start_position_in_read_, actual[i].target_start_position_in_read_);
+        EXPECT_EQ(expected[i].target_end_position_in_read_, actual[i].target_end_position_in_read_);
+        EXPECT_EQ(expected[i].relative_strand, actual[i].relative_strand);
+        EXPECT_EQ(expected[i].num_residues_, actual[i].num_residues_);
+    }
+}
+
+} // namespace
+
+TEST(TestCudamapperBinaryOverlaps, write_read_and_convert_to_paf)
+{
+    std::unique_ptr<io::FastaParser> parser = io::create_kseq_fasta_parser(std::string(CUDAMAPPER_BENCHMARK_DATA_DIR) + "/catcaag_aagcta.fasta", 0, false);
+
+    const std::vector<Overlap> first_overlaps    = {make_overlap(0, 1, 1, 6, RelativeStrand::Forward, 2),
+                                                 make_overlap(1, 0, 0, 5, RelativeStrand::Reverse, 1)};
+    const std::vector<Overlap> second_overlaps   = {make_overlap(1, 1, 2, 4, RelativeStrand::Forward, 3)};
+    const std::vector<std::string> second_cigars = {"2M"};
+    const std::string file_path                  = "test_cudamapper_binary_overlaps.cgaovl";
+
+    std::vector<char> data;
+    append_binary_overlaps_header(*parser, *parser, 15, data);
+    append_binary_overlaps_block(first_overlaps, {}, data);
+    append_binary_overlaps_block({}, {}, data); // empty blocks are not written
+    append_binary_overlaps_block(second_overlaps, second_cigars, data);
+    write_file(file_path, data);
+
+    {
+        BinaryOverlapsReader reader(file_path);
+        EXPECT_EQ(reader.kmer_size(), 15);
+        EXPECT_EQ(reader.query_read_names(), std::vector<std::string>({"read_0", "read_1"}));
+        EXPECT_EQ(reader.query_read_lengths(), std::vector<number_of_basepairs_t>({7, 6}));
+        // only one read table
+        EXPECT_EQ(&reader.target_read_names(), &reader.query_read_names());
+
+        std::vector<Overlap> overlaps;
+        std::vector<std::string> cigars = {"not replaced"};
+        ASSERT_TRUE(reader.read_next_block(overlaps, cigars));
+        expect_same_overlaps(first_overlaps, overlaps);
+        EXPECT_TRUE(cigars.empty());
+
+        ASSERT_TRUE(reader.read_next_block(overlaps, cigars));
+        expect_same_overlaps(second_overlaps, overlaps);
+        EXPECT_EQ(cigars, second_cigars);
+
+        // converted output is the same as output written directly as PAF
+        const PafFormatter reader_formatter(reader.query_read_names(),
+                                            reader.query_read_lengths(),
+                                            reader.target_read_names(),
+                                            reader.target_read_lengths(),
+                                            reader.kmer_size());
+        const PafFormatter parser_formatter(*parser, *parser, 15);
+        std::vector<char> reader_paf;
+        std::vector<char> parser_paf;
+        reader_formatter.append_paf(overlaps, cigars, reader_paf);
+        parser_formatter.append_paf(second_overlaps, second_cigars, parser_paf);
+        EXPECT_EQ(reader_paf, parser_paf);
+
+        EXPECT_FALSE(reader.read_next_block(overlaps, cigars));
+        EXPECT_TRUE(overlaps.empty());
+    }
+
+    // truncated block
+    data.resize(data.size() - 1);
+    write_file(file_path, data);
+    {
+        BinaryOverlapsReader reader(file_path);
+        std::vector<Overlap> overlaps;
+        std::vector<std::string> cigars;
+        ASSERT_TRUE(reader.read_next_block(overlaps, cigars));
+        EXPECT_THROW(reader.read_next_block(overlaps, cigars), std::runtime_error);
+    }
+
+    std::remove(file_path.c_str());
+}
+
+TEST(TestCudamapperBinaryOverlaps, different_query_and_target)
+{
+    std::unique_ptr<io::FastaParser> query_parser  = io::create_kseq_fasta_parser(std::string(CUDAMAPPER_BENCHMARK_DATA_DIR) + "/catcaag_aagcta.fasta", 0, false);
+    std::unique_ptr<io::FastaParser> target_parser = io::create_kseq_fasta_parser(std::string(CUDAMAPPER_BENCHMARK_DATA_DIR) + "/aaaactgaa_gccaaag.fasta", 0, false);
+    const std::string file_path                    = "test_cudamapper_binary_overlaps_different.cgaovl";
+
+    std::vector<char> data;
+    append_binary_overlaps_header(*query_parser, *target_parser, 4, data);
+    append_binary_overlaps_block({make_overlap(1, 0, 1, 3, RelativeStrand::Forward, 1)}, {}, data);
+    write_file(file_path, data);
+
+    BinaryOverlapsReader reader(file_path);
+    EXPECT_EQ(reader.query_read_names().size(), 2u);
+    EXPECT_EQ(reader.target_read_names().size(), static_cast<std::size_t>(target_parser->get_num_seqences()));
+    EXPECT_EQ(reader.target_read_lengths()[0], target_parser->get_sequence_length_by_id(0));
+
+    std::vector<Overlap> overlaps;
+    std::vector<std::string> cigars;
+    ASSERT_TRUE(reader.read_next_block(overlaps, cigars));
+    EXPECT_EQ(overlaps.size(), 1u);
+    EXPECT_FALSE(reader.read_next_block(overlaps, cigars));
+
+    std::remove(file_path.c_str());
+}
+
+TEST(TestCudamapperBinaryOverlaps, invalid_files)
+{
+    EXPECT_THROW(BinaryOverlapsReader("test_cudamapper_binary_overlaps_missing.cgaovl"), std::runtime_error);
+
+    const std::string file_path = "test_cudamapper_binary_overlaps_invalid.cgaovl";
+    write_file(file_path, std::vector<char>(100, 'A'));
+    EXPECT_THROW(BinaryOverlapsReader reader(file_path), std::runtime_error);
+
+    std::remove(file_path.c_str());
+}
+
+} // namespace cudamapper
+
+} // namespace genomeworks
+
+} // namespace claraparabricks
@@ -0,0 +1,175 @@
+/*
+* Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#include "gtest/gtest.h"
+
+#include "../src/checkpoint_journal.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace claraparabricks
+{
+
+namespace genomeworks
+{
+
+namespace cudamapper
+{
+
+namespace
+{
+
+std::string read_file(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+void append_to_file(const std::string& path,
+                    const std::string& text)
+{
+    std::ofstream file(path, std::ios::binary | std::ios::app);
+    file << text;
+}
+
+std::vector<char> to_chars(const std::string& text)
+{
+    return std::vector<char>(begin(text), end(text));
+}
+
+} // namespace
+
+TEST(TestCudamapperCheckpointJournal, new_run_and_resume)
+{
+    const std::string journal_path = ::testing::TempDir() + "test_checkpoint_journal_resume.journal";
+    const std::string output_path  = ::testing::TempDir() + "test_checkpoint_journal_resume.paf";
+    std::remove(journal_path.c_str()); // left over from previous runs
+    append_to_file(output_path, "left over from previous runs\n");
+
+    const std::vector<IndexDescriptor> first_indices  = {{0, 10}, {10, 10}};
+    const std::vector<IndexDescriptor> second_indices = {{20, 10}};
+
+    {
+        CheckpointJournal journal(journal_path, output_path, "k=15 w=10");
+        ASSERT_EQ(journal.number_of_resumed_batches(), 0);
+        ASSERT_FALSE(journal.is_batch_completed(first_indices, first_indices));
+        ASSERT_EQ(read_file(output_path), "");
+
+        journal.write_batch(first_indices, first_indices, to_chars("a\tb\n"));
+        journal.write_batch(first_indices, second_indices, to_chars(""));
+        ASSERT_EQ(read_file(output_path), "a\tb\n");
+    }
+
+    // the run got interrupted while writing output of one batch and its line in the journal
+    append_to_file(output_path, "incomplete");
+    append_to_file(journal_path, "14 20:10 20");
+
+    {
+        CheckpointJournal journal(journal_path, output_path, "k=15 w=10");
+        ASSERT_EQ(journal.number_of_resumed_batches(), 2);
+        ASSERT_TRUE(journal.is_batch_completed(first_indices, first_indices));
+        ASSERT_TRUE(journal.is_batch_completed(first_indices, second_indices));
+        ASSERT_FALSE(journal.is_batch_completed(second_indices, first_indices));
+        ASSERT_FALSE(journal.is_batch_completed(second_indices, second_indices));
+        ASSERT_EQ(read_file(output_path), "a\tb\n");
+
+        journal.write_batch(second_indices, second_indices, to_chars("c\td\n"));
+        ASSERT_EQ(read_file(output_path), "a\tb\nc\td\n");
+    }
+
+    {
+        CheckpointJournal journal(journal_path, output_path, "k=15 w=10");
+        ASSERT_EQ(journal.number_of_resumed_batches(), 3);
+        ASSERT_TRUE(journal.is_batch_completed(second_indices, second_indices));
+        ASSERT_EQ(read_file(output_path), "a\tb\nc\td\n");
+    }
+}
+
+TEST(TestCudamapperCheckpointJournal, resume_without_output_file)
+{
+    const std::string journal_path = ::testing::TempDir() + "test_checkpoint_journal_no_output.journal";
+    const std::string output_path  = ::testing::TempDir() + "test_checkpoint_journal_no_output.paf";
+    std::remove(journal_path.c_str()); // left over from previous runs
+
+    // the run stopped before writing any batch, then the output file got removed
+    {
+        CheckpointJournal journal(journal_path, output_path, "k=15 w=10");
+    }
+    std::remove(output_path.c_str());
+
+    {
+        CheckpointJournal journal(journal_path, output_path, "k=15 w=10");
+        ASSERT_EQ(journal.number_of_resumed_batches(), 0);
+        ASSERT_EQ(read_file(output_path), "");
+        journal.write_batch({{0, 10}}, {{0, 10}}, to_chars("a\tb\n"));
+        ASSERT_EQ(read_file(output_path), "a\tb\n");
+    }
+
+    // once a batch is recorded its output is needed
+    std::remove(output_path.c_str());
+    ASSERT_THROW(CheckpointJournal(journal_path, output_path, "k=15 w=10"), std::runtime_error);
+}
+
+TEST(TestCudamapperCheckpointJournal, exceptions)
+{
+    const std::string journal_path = ::testing::TempDir() + "test_checkpoint_journal_exceptions.journal";
+    const std::string output_path  = ::testing::TempDir() + "test_checkpoint_journal_exceptions.paf";
+    std::remove(journal_path.c_str()); // left over from previous runs
+
+    ASSERT_THROW(CheckpointJournal(journal_path, output_path, "two\nlines"), std::invalid_argument);
+
+    {
+        CheckpointJournal journal(journal_path, output_path, "k=15 w=10");
+        journal.write_batch({{0, 10}}, {{0, 10}}, to_chars("a\tb\n"));
+    }
+
+    // different parameters
+    ASSERT_THROW(CheckpointJournal(journal_path, output_path, "k=15 w=5"), std::runtime_error);
+
+    // output is missing a part of a recorded batch
+    {
+        std::ofstream output_file(output_path, std::ios::binary | std::ios::trunc);
+        output_file << "a\t";
+    }
+    ASSERT_THROW(CheckpointJournal(journal_path, output_path, "k=15 w=10"), std::runtime_error);
+}
+
+TEST(TestCudamapperCheckpointJournal, malformed_output_size)
+{
+    const std::string journal_path = ::testing::TempDir() + "test_checkpoint_journal_malformed_output_size.journal";
+    const std::string output_path  = ::testing::TempDir() + "test_checkpoint_journal_malformed_output_size.paf";
+
+    // complete lines whose output size is not a number, does not fit into 64 bits or goes down
+    for (const std::string batch_lines : {"x 0:10 0:10\n",
+                                          "4x 0:10 0:10\n",
+                                          "-4 0:10 0:10\n",
+                                          "99999999999999999999 0:10 0:10\n",
+                                          "4 0:10 0:10\n2 0:10 10:10\n"})
+    {
+        std::remove(journal_path.c_str());
+        append_to_file(journal_path, "cudamapper-journal 1 k=15 w=10\n" + batch_lines);
+        {
+            std::ofstream output_file(output_path, std::ios::binary | std::ios::trunc);
+            output_file << "a\tb\n";
+        }
+        ASSERT_THROW(CheckpointJournal(journal_path, output_path, "k=15 w=10"), std::runtime_error) << batch_lines;
+    }
+}
+
+} // namespace cudamapper
+
+} // namespace genomeworks
+
+} // namespace claraparabricks
@@ -10,7 +10,10 @@
 
 #include "gtest/gtest.h"
 
+#include <algorithm>
+#include <cstdlib>
 #include <exception>
+#include <utility>
 
 #include "../src/index_batcher.cuh"
 
@@ -918,6 +921,134 @@ TEST(TestCudamapperIndexBatcher, test_generate_batches_of_indices_exceptions)
     target_basepairs_per_index = query_basepairs_per_index;
 }
 
+TEST(TestCudamapperIndexBatcher, test_estimate_batch_costs)
+{
+    // catcaag_aagcta.fasta: read 0 has 7 basepairs, read 1 has 6 basepairs
+    // window_size = 1 -> expected number of sketch elements is the number of basepairs
+    const std::shared_ptr<const genomeworks::io::FastaParser> parser = genomeworks::io::create_kseq_fasta_parser(std::string(CUDAMAPPER_BENCHMARK_DATA_DIR) + "/catcaag_aagcta.fasta", 1, false);
+
+    const IndexDescriptor catcaag(0, 1);
+    const IndexDescriptor aagcta(1, 1);
+    const IndexDescriptor catcaag_aagcta(0, 2);
+
+    std::vector<BatchOfIndices> batches;
+    batches.push_back({{{catcaag}, {catcaag, aagcta}},
+                       {{{catcaag}, {catcaag}}, {{catcaag}, {aagcta}}}});
+    batches.push_back({{{catcaag_aagcta}, {aagcta}},
+                       {{{catcaag_aagcta}, {aagcta}}}});
+    batches.push_back({{{catcaag, aagcta}, {catcaag, aagcta}},
+                       {{{catcaag, aagcta}, {catcaag, aagcta}}}});
+
+    const std::vector<double> costs = estimate_batch_costs(batches, *parser, *parser, 1);
+    ASSERT_EQ(get_size(costs), 3);
+    EXPECT_DOUBLE_EQ(costs[0], 7.0 * 7.0 + 7.0 * 6.0);
+    EXPECT_DOUBLE_EQ(costs[1], 13.0 * 6.0);
+    EXPECT_DOUBLE_EQ(costs[2], 13.0 * 13.0);
+}
+
+// *** test tile orders ***
+
+using tile_t = std::pair<number_of_indices_t, number_of_indices_t>;
+
+TEST(TestCudamapperIndexBatcher, test_order_tiles_row_major_and_serpentine)
+{
+    const std::vector<tile_t> row_major = {{0, 0}, {0, 1}, {0, 2}, {1, 0}, {1, 1}, {1, 2}};
+    ASSERT_EQ(details::index_batcher::order_tiles(2, 3, false, TileOrder::row_major), row_major);
+
+    const std::vector<tile_t> serpentine = {{0, 0}, {0, 1}, {0, 2}, {1, 2}, {1, 1}, {1, 0}};
+    ASSERT_EQ(details::index_batcher::order_tiles(2, 3, false, TileOrder::serpentine), serpentine);
+
+    // only upper triangle, every other row starts with the last target section
+    const std::vector<tile_t> serpentine_same_query_and_target = {{0, 0}, {0, 1}, {0, 2}, {1, 2}, {1, 1}, {2, 2}};
+    ASSERT_EQ(details::index_batcher::order_tiles(3, 3, true, TileOrder::serpentine), serpentine_same_query_and_target);
+
+    ASSERT_THROW(details::index_batcher::order_tiles(3, 3, true, TileOrder::automatic), std::invalid_argument);
+}
+
+TEST(TestCudamapperIndexBatcher, test_order_tiles_hilbert)
+{
+    const std::vector<tile_t> two_by_two = {{0, 0}, {0, 1}, {1, 1}, {1, 0}};
+    ASSERT_EQ(details::index_batcher::order_tiles(2, 2, false, TileOrder::hilbert), two_by_two);
+
+    // every tile exactly once and consecutive tiles are neighbours
+    const std::vector<tile_t> eight_by_eight = details::index_batcher::order_tiles(8, 8, false, TileOrder::hilbert);
+    ASSERT_EQ(get_size(eight_by_eight), 64);
+    std::vector<tile_t> sorted_tiles = eight_by_eight;
+    std::sort(begin(sorted_tiles), end(sorted_tiles));
+    ASSERT_EQ(sorted_tiles, details::index_batcher::order_tiles(8, 8, false, TileOrder::row_major));
+    for (std::int64_t i = 1; i < get_size(eight_by_eight); ++i)
+    {
+        ASSERT_EQ(std::abs(eight_by_eight[i].first - eight_by_eight[i - 1].first) + std::abs(eight_by_eight[i].second - eight_by_eight[i - 1].second), 1) << "i: " << i;
+    }
+
+    // matrix which is not a power of two and only upper triangle
+    std::vector<tile_t> upper_triangle = details::index_batcher::order_tiles(5, 5, true, TileOrder::hilbert);
+    std::sort(begin(upper_triangle), end(upper_triangle));
+    ASSERT_EQ(upper_triangle, details::index_batcher::order_tiles(5, 5, true, TileOrder::row_major));
+
+    // skewed matrices in both directions, consecutive tiles are neighbours with at most one diagonal step
+    for (const tile_t& sections : {tile_t(3, 1001), tile_t(1001, 3), tile_t(7, 10)})
+    {
+        const std::vector<tile_t> skewed = details::index_batcher::order_tiles(sections.first, sections.second, false, TileOrder::hilbert);
+        std::vector<tile_t> sorted_skewed = skewed;
+        std::sort(begin(sorted_skewed), end(sorted_skewed));
+        ASSERT_EQ(sorted_skewed, details::index_batcher::order_tiles(sections.first, sections.second, false, TileOrder::row_major));
+        std::int32_t diagonal_steps = 0;
+        for (std::int64_t i = 1; i < get_size(skewed); ++i)
+        {
+            const std::int32_t query_step  = std::abs(skewed[i].first - skewed[i - 1].first);
+            const std::int32_t target_step = std::abs(skewed[i].second - skewed[i - 1].second);
+            ASSERT_LE(std::max(query_step, target_step), 1) << "i: " << i;
+            diagonal_steps += query_step + target_step - 1;
+        }
+        ASSERT_LE(diagonal_steps, 1) << "sections: " << sections.first << " x " << sections.second;
+    }
+}
+
+TEST(TestCudamapperIndexBatcher, test_simulate_index_builds)
+{
+    const std::vector<IndexDescriptor> indices = {{0, 1}, {1, 1}, {2, 1}};
+
+    // capacity of one batch: row-major generates every target index again in the second row, serpentine reuses the last one
+    const std::vector<IndexBatch> row_major = details::index_batcher::group_into_batches({begin(indices), begin(indices) + 2}, indices, 1, 1, false, TileOrder::row_major);
+    ASSERT_EQ(simulate_index_builds(row_major, 0, false), 8);
+    const std::vector<IndexBatch> serpentine = details::index_batcher::group_into_batches({begin(indices), begin(indices) + 2}, indices, 1, 1, false, TileOrder::serpentine);
+    ASSERT_EQ(simulate_index_builds(serpentine, 0, false), 7);
+
+    // everything fits into the cache -> every index is generated once
+    ASSERT_EQ(simulate_index_builds(row_major, 5, false), 5);
+
+    // query and target indices are the same
+    const std::vector<IndexBatch> all_to_all = details::index_batcher::group_into_batches(indices, indices, 1, 1, true, TileOrder::row_major);
+    ASSERT_EQ(simulate_index_builds(all_to_all, 3, true), 3);
+}
+
+TEST(TestCudamapperIndexBatcher, test_find_indices_used_again)
+{
+    const IndexDescriptor index_0(0, 1);
+    const IndexDescriptor index_1(1, 1);
+    const IndexDescriptor index_2(2, 1);
+
+    // column of target-major order: target index is used by every batch, query indices only once
+    const IndexBatch batch              = {{index_0}, {index_2}};
+    const std::vector<IndexBatch> later = {{{index_1}, {index_2}}, {{index_2}, {index_2}}};
+
+    IndexBatch used_again = find_indices_used_again(batch, later, false);
+    ASSERT_EQ(used_again.query_indices, std::vector<IndexDescriptor>());
+    ASSERT_EQ(used_again.target_indices, std::vector<IndexDescriptor>({index_2}));
+
+    // no later batches -> nothing is used again
+    used_again = find_indices_used_again(batch, {}, false);
+    ASSERT_TRUE(used_again.query_indices.empty());
+    ASSERT_TRUE(used_again.target_indices.empty());
+
+    // query and target indices are the same, index used as query is used again as target and is only returned once
+    const IndexBatch all_to_all_batch = {{index_0, index_1}, {index_1, index_1}};
+    used_again                        = find_indices_used_again(all_to_all_batch, {{{index_2}, {index_0, index_1}}}, true);
+    ASSERT_EQ(used_again.query_indices, std::vector<IndexDescriptor>({index_0, index_1}));
+    ASSERT_EQ(used_again.target_indices, std::vector<IndexDescriptor>());
+}
+
 } // namespace cudamapper
 
 } // namespace genomeworks
@@ -0,0 +1,192 @@
+/*
+* Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#include "gtest/gtest.h"
+
+#include "cudamapper_file_location.hpp"
+#include "../src/index_cpu.hpp"
+
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <claragenomics/cudamapper/index.hpp>
+#include <claragenomics/io/fasta_parser.hpp>
+#include <claragenomics/utils/cudautils.hpp>
+#include <claragenomics/utils/genomeutils.hpp>
+
+namespace claraparabricks
+{
+
+namespace genomeworks
+{
+
+namespace cudamapper
+{
+
+namespace
+{
+
+void check_same_index(const IndexHostCopyBase& expected_index,
+                      const IndexHostCopyBase& index)
+{
+    ASSERT_EQ(index.number_of_reads(), expected_index.number_of_reads());
+    ASSERT_EQ(index.number_of_basepairs_in_longest_read(), expected_index.number_of_basepairs_in_longest_read());
+    ASSERT_EQ(index.first_read_id(), expected_index.first_read_id());
+    ASSERT_EQ(index.kmer_size(), expected_index.kmer_size());
+    ASSERT_EQ(index.window_size(), expected_index.window_size());
+    ASSERT_EQ(index.representations(), expected_index.representations());
+    ASSERT_EQ(index.read_ids(), expected_index.read_ids());
+    ASSERT_EQ(index.positions_in_reads(), expected_index.positions_in_reads());
+    ASSERT_EQ(index.directions_of_reads(), expected_index.directions_of_reads());
+    ASSERT_EQ(index.unique_representations(), expected_index.unique_representations());
+    ASSERT_EQ(index.first_occurrence_of_representations(), expected_index.first_occurrence_of_representations());
+}
+
+/// \brief writes reads with random basepairs and poly-A runs, all reads are at least one window long for all tested parameters
+std::string write_reads_file(const std::string& file_name,
+                             const std::int32_t number_of_reads)
+{
+    const std::string file_path = ::testing::TempDir() + file_name;
+    std::ofstream file(file_path);
+    std::minstd_rand rng(1);
+    std::uniform_int_distribution<std::int32_t> read_length(100, 2000);
+    for (std::int32_t i = 0; i < number_of_reads; ++i)
+    {
+        std::string basepairs = genomeutils::generate_random_genome(read_length(rng), rng);
+        basepairs.replace(basepairs.size() / 2, 20, std::string(20, 'A'));
+        file << ">read_" << i << "\n"
+             << basepairs << "\n";
+    }
+    return file_path;
+}
+
+} // namespace
+
+TEST(TestCudamapperIndexCPU, GATT_2_3)
+{
+    // >read_0
+    // GATT
+
+    // All minimizers: GA(0f), AT(1f), AA(2r), see TestCudamapperIndexGPU.GATT_2_3
+
+    std::unique_ptr<io::FastaParser> parser = io::create_kseq_fasta_parser(std::string(CUDAMAPPER_BENCHMARK_DATA_DIR) + "/gatt.fasta");
+
+    const IndexCPU index(*parser, 0, 1, 2, 3, false, 1.0, 1);
+
+    ASSERT_EQ(index.number_of_reads(), 1u);
+    ASSERT_EQ(index.number_of_basepairs_in_longest_read(), 4u);
+    ASSERT_EQ(index.representations(), std::vector<representation_t>({0b0000, 0b0011, 0b1000}));
+    ASSERT_EQ(index.read_ids(), std::vector<read_id_t>({0, 0, 0}));
+    ASSERT_EQ(index.positions_in_reads(), std::vector<position_in_read_t>({2, 1, 0}));
+    ASSERT_EQ(index.directions_of_reads(), std::vector<SketchElement::DirectionOfRepresentation>({SketchElement::DirectionOfRepresentation::REVERSE,
+                                                                                                    SketchElement::DirectionOfRepresentation::FORWARD,
+                                                                                                    SketchElement::DirectionOfRepresentation::FORWARD}));
+    ASSERT_EQ(index.unique_representations(), std::vector<representation_t>({0b0000, 0b0011, 0b1000}));
+    ASSERT_EQ(index.first_occurrence_of_representations(), std::vector<std::uint32_t>({0, 1, 2, 3}));
+}
+
+TEST(TestCudamapperIndexCPU, no_reads_in_index)
+{
+    std::unique_ptr<io::FastaParser> parser = io::create_kseq_fasta_parser(std::string(CUDAMAPPER_BENCHMARK_DATA_DIR) + "/aaaactgaa_gccaaag.fasta");
+
+    // empty range
+    const IndexCPU empty_range_index(*parser, 1, 1, 2, 3, true, 1.0, 0);
+    ASSERT_EQ(empty_range_index.number_of_reads(), 0u);
+    ASSERT_TRUE(empty_range_index.representations().empty());
+
+    // all reads shorter than one window
+    const IndexCPU short_reads_index(*parser, 0, 2, 15, 15, true, 1.0, 0);
+    ASSERT_EQ(short_reads_index.number_of_reads(), 0u);
+    ASSERT_EQ(short_reads_index.number_of_basepairs_in_longest_read(), 0u);
+    ASSERT_TRUE(short_reads_index.representations().empty());
+}
+
+TEST(TestCudamapperIndexCPU, same_as_gpu_index)
+{
+    const std::string fasta_path            = write_reads_file("test_index_cpu_same_as_gpu_index.fasta", 200);
+    std::unique_ptr<io::FastaParser> parser = io::create_kseq_fasta_parser(fasta_path, 0, false);
+    DefaultDeviceAllocator allocator        = create_default_device_allocator();
+
+    cudaStream_t cuda_stream;
+    CGA_CU_CHECK_ERR(cudaStreamCreate(&cuda_stream));
+
+    for (const std::uint64_t kmer_size : {4, 15, 16, 24})
+    {
+        for (const std::uint64_t window_size : {1, 5, 15})
+        {
+            for (const bool hash_representations : {false, true})
+            {
+                for (const double filtering_parameter : {1.0, 0.001})
+                {
+                    std::unique_ptr<Index> gpu_index = Index::create_index(allocator,
+                                                                           *parser,
+                                                                           10,
+                                                                           150,
+                                                                           kmer_size,
+                                                                           window_size,
+                                                                           hash_representations,
+                                                                           filtering_parameter,
+                                                                           cuda_stream);
+
+                    std::unique_ptr<IndexHostCopyBase> expected_index = IndexHostCopyBase::create_cache(*gpu_index,
+                                                                                                        10,
+                                                                                                        kmer_size,
+                                                                                                        window_size,
+                                                                                                        cuda_stream);
+
+                    for (const std::int32_t number_of_threads : {1, 3, 8})
+                    {
+                        SCOPED_TRACE("k: " + std::to_string(kmer_size) +
+                                     ", w: " + std::to_string(window_size) +
+                                     ", hash: " + std::to_string(hash_representations) +
+                                     ", filtering: " + std::to_string(filtering_parameter) +
+                                     ", threads: " + std::to_string(number_of_threads));
+                        std::unique_ptr<IndexHostCopyBase> index = IndexHostCopyBase::create_index_on_host(*parser,
+                                                                                                           10,
+                                                                                                           150,
+                                                                                                           kmer_size,
+                                                                                                           window_size,
+                                                                                                           hash_representations,
+                                                                                                           filtering_parameter,
+                                                                                                           number_of_threads);
+                        check_same_index(*expected_index, *index);
+                    }
+                }
+            }
+        }
+    }
+
+    CGA_CU_CHECK_ERR(cudaStreamDestroy(cuda_stream));
+}
+
+TEST(TestCudamapperIndexCPU, copy_index_to_device)
+{
+    const std::string fasta_path            = write_reads_file("test_index_cpu_copy_index_to_device.fasta", 50);
+    std::unique_ptr<io::FastaParser> parser = io::create_kseq_fasta_parser(fasta_path, 0, false);
+    DefaultDeviceAllocator allocator        = create_default_device_allocator();
+
+    cudaStream_t cuda_stream;
+    CGA_CU_CHECK_ERR(cudaStreamCreate(&cuda_stream));
+
+    std::unique_ptr<IndexHostCopyBase> host_index   = IndexHostCopyBase::create_index_on_host(*parser, 0, 50, 15, 15);
+    std::unique_ptr<Index> device_index             = host_index->copy_index_to_device(allocator, cuda_stream);
+    std::unique_ptr<IndexHostCopyBase> copied_index = IndexHostCopyBase::create_cache(*device_index, 0, 15, 15, cuda_stream);
+    check_same_index(*host_index, *copied_index);
+
+    CGA_CU_CHECK_ERR(cudaStreamDestroy(cuda_stream));
+}
+
+} // namespace cudamapper
+
+} // namespace genomeworks
+
+} // namespace claraparabricks
@@ -904,6 +904,75 @@ TEST(TestCudamapperIndexCaching, test_index_cache_host_keep_on_device)
                               "test_index_cache_host_keep_on_device_4");
 }
 
+TEST(TestCudamapperIndexCaching, test_index_cache_host_shared_host_cache)
+{
+    // catcaag_aagcta.fasta k = 3 w = 2, only the number of hits, misses and evictions are checked, the content of indices is checked by other tests
+
+    cudaStream_t cuda_stream;
+    CGA_CU_CHECK_ERR(cudaStreamCreate(&cuda_stream));
+
+    const bool same_query_and_target               = false;
+    std::shared_ptr<io::FastaParser> query_parser  = io::create_kseq_fasta_parser(std::string(CUDAMAPPER_BENCHMARK_DATA_DIR) + "/catcaag_aagcta.fasta");
+    std::shared_ptr<io::FastaParser> target_parser = io::create_kseq_fasta_parser(std::string(CUDAMAPPER_BENCHMARK_DATA_DIR) + "/catcaag_aagcta.fasta");
+    DefaultDeviceAllocator allocator               = create_default_device_allocator();
+    const std::uint64_t k                          = 3;
+    const std::uint64_t w                          = 2;
+    const bool hash_representations                = false;
+    const double filtering_parameter               = 1.0;
+
+    const IndexDescriptor catcaag_index_descriptor(0, 1);
+    const IndexDescriptor aagcta_index_descriptor(1, 1);
+
+    auto shared_host_cache = std::make_shared<SharedIndexHostCache>(same_query_and_target,
+                                                                    1'000'000);
+
+    // two host caches (e.g. for two devices) sharing the same host copies
+    IndexCacheHost index_host_cache_0(same_query_and_target,
+                                      allocator,
+                                      query_parser,
+                                      target_parser,
+                                      k,
+                                      w,
+                                      hash_representations,
+                                      filtering_parameter,
+                                      cuda_stream,
+                                      nullptr,
+                                      nullptr,
+                                      shared_host_cache);
+    IndexCacheHost index_host_cache_1(same_query_and_target,
+                                      allocator,
+                                      query_parser,
+                                      target_parser,
+                                      k,
+                                      w,
+                                      hash_representations,
+                                      filtering_parameter,
+                                      cuda_stream,
+                                      nullptr,
+                                      nullptr,
+                                      shared_host_cache);
+
+    index_host_cache_0.generate_query_cache_content({catcaag_index_descriptor});
+    index_host_cache_0.generate_query_cache_content({aagcta_index_descriptor});
+    index_host_cache_1.generate_query_cache_content({catcaag_index_descriptor});
+    index_host_cache_1.generate_query_cache_content({aagcta_index_descriptor});
+    // query and target are not the same, so query indices can not be used as target indices
+    index_host_cache_1.generate_target_cache_content({catcaag_index_descriptor});
+
+    const IndexCacheStatistics statistics = shared_host_cache->statistics();
+    ASSERT_EQ(statistics.hits, 2);
+    ASSERT_EQ(statistics.misses, 3);
+    ASSERT_EQ(statistics.evictions, 0);
+
+    // only indices in the requested content can be retrieved
+    ASSERT_NO_THROW(index_host_cache_0.get_index_from_query_cache(aagcta_index_descriptor));
+    ASSERT_ANY_THROW(index_host_cache_0.get_index_from_query_cache(catcaag_index_descriptor));
+    ASSERT_NO_THROW(index_host_cache_1.get_index_from_target_cache(catcaag_index_descriptor));
+
+    CGA_CU_CHECK_ERR(cudaStreamSynchronize(cuda_stream));
+    CGA_CU_CHECK_ERR(cudaStreamDestroy(cuda_stream));
+}
+
 // *** Test IndexCacheDevice ***
 
 TEST(TestCudamapperIndexCaching, test_index_cache_device_same_query_and_target)
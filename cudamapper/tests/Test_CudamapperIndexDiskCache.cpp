@@ -0,0 +1,115 @@
+/*
+* Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#include "gtest/gtest.h"
+
+#include "../src/index_disk_cache.hpp"
+
+#include <cstdio>
+#include <fstream>
+
+#include <claragenomics/cudamapper/index.hpp>
+#include <claragenomics/io/fasta_parser.hpp>
+
+#include "cudamapper_file_location.hpp"
+
+namespace claraparabricks
+{
+
+namespace genomeworks
+{
+
+namespace cudamapper
+{
+
+TEST(TestCudamapperIndexDiskCache, store_and_load)
+{
+    const std::string fasta_path            = std::string(CUDAMAPPER_BENCHMARK_DATA_DIR) + "/20_reads.fasta";
+    std::unique_ptr<io::FastaParser> parser = io::create_kseq_fasta_parser(fasta_path, 0, false);
+    const std::uint64_t fingerprint         = compute_input_fingerprint({fasta_path}, io::ReadOrdering::file_order);
+    const std::string directory             = ::testing::TempDir() + "test_index_disk_cache/store_and_load";
+
+    const IndexDescriptor descriptor(5, 10);
+    const IndexDiskCache disk_cache(directory, fingerprint, 4, 2, true, 0.5);
+    std::remove(disk_cache.file_path(descriptor).c_str()); // left over from previous runs
+
+    ASSERT_EQ(disk_cache.load(descriptor), nullptr);
+
+    std::unique_ptr<IndexHostCopyBase> index = IndexHostCopyBase::create_index_on_host(*parser, 5, 15, 4, 2, true, 0.5);
+    ASSERT_FALSE(index->representations().empty());
+    disk_cache.store(descriptor, *index);
+
+    std::unique_ptr<IndexHostCopyBase> loaded_index = disk_cache.load(descriptor);
+    ASSERT_NE(loaded_index, nullptr);
+    ASSERT_EQ(loaded_index->number_of_reads(), index->number_of_reads());
+    ASSERT_EQ(loaded_index->number_of_basepairs_in_longest_read(), index->number_of_basepairs_in_longest_read());
+    ASSERT_EQ(loaded_index->first_read_id(), index->first_read_id());
+    ASSERT_EQ(loaded_index->kmer_size(), index->kmer_size());
+    ASSERT_EQ(loaded_index->window_size(), index->window_size());
+    ASSERT_EQ(loaded_index->representations(), index->representations());
+    ASSERT_EQ(loaded_index->read_ids(), index->read_ids());
+    ASSERT_EQ(loaded_index->positions_in_reads(), index->positions_in_reads());
+    ASSERT_EQ(loaded_index->directions_of_reads(), index->directions_of_reads());
+    ASSERT_EQ(loaded_index->unique_representations(), index->unique_representations());
+    ASSERT_EQ(loaded_index->first_occurrence_of_representations(), index->first_occurrence_of_representations());
+
+    // other indices and other parameters are not in cache
+    ASSERT_EQ(disk_cache.load(IndexDescriptor(5, 11)), nullptr);
+    ASSERT_EQ(IndexDiskCache(directory, fingerprint, 4, 2, true, 0.25).load(descriptor), nullptr);
+    ASSERT_EQ(IndexDiskCache(directory, fingerprint, 4, 2, false, 0.5).load(descriptor), nullptr);
+    ASSERT_EQ(IndexDiskCache(directory, fingerprint + 1, 4, 2, true, 0.5).load(descriptor), nullptr);
+
+    // truncated files are ignored
+    {
+        std::ofstream file(disk_cache.file_path(descriptor), std::ios::binary | std::ios::trunc);
+        file << "truncated";
+    }
+    ASSERT_EQ(disk_cache.load(descriptor), nullptr);
+}
+
+TEST(TestCudamapperIndexDiskCache, empty_index)
+{
+    const std::string fasta_path            = std::string(CUDAMAPPER_BENCHMARK_DATA_DIR) + "/gatt.fasta";
+    std::unique_ptr<io::FastaParser> parser = io::create_kseq_fasta_parser(fasta_path, 0, false);
+    const std::uint64_t fingerprint         = compute_input_fingerprint({fasta_path}, io::ReadOrdering::file_order);
+    const std::string directory             = ::testing::TempDir() + "test_index_disk_cache/empty_index";
+
+    const IndexDescriptor descriptor(0, 1);
+    const IndexDiskCache disk_cache(directory, fingerprint, 5, 1, true, 1.0);
+
+    std::unique_ptr<IndexHostCopyBase> index = IndexHostCopyBase::create_index_on_host(*parser, 0, 1, 5, 1); // kmer longer than read
+    ASSERT_TRUE(index->representations().empty());
+    disk_cache.store(descriptor, *index);
+
+    std::unique_ptr<IndexHostCopyBase> loaded_index = disk_cache.load(descriptor);
+    ASSERT_NE(loaded_index, nullptr);
+    ASSERT_TRUE(loaded_index->representations().empty());
+    ASSERT_EQ(loaded_index->first_occurrence_of_representations(), index->first_occurrence_of_representations());
+}
+
+TEST(TestCudamapperIndexDiskCache, input_fingerprint)
+{
+    const std::string gatt_path    = std::string(CUDAMAPPER_BENCHMARK_DATA_DIR) + "/gatt.fasta";
+    const std::string catcaag_path = std::string(CUDAMAPPER_BENCHMARK_DATA_DIR) + "/catcaag.fasta";
+
+    const std::uint64_t fingerprint = compute_input_fingerprint({gatt_path, catcaag_path}, io::ReadOrdering::file_order);
+    ASSERT_EQ(compute_input_fingerprint({gatt_path, catcaag_path}, io::ReadOrdering::file_order), fingerprint);
+    ASSERT_NE(compute_input_fingerprint({catcaag_path, gatt_path}, io::ReadOrdering::file_order), fingerprint);
+    ASSERT_NE(compute_input_fingerprint({gatt_path, catcaag_path}, io::ReadOrdering::random), fingerprint);
+    ASSERT_NE(compute_input_fingerprint({gatt_path}, io::ReadOrdering::file_order), fingerprint);
+
+    ASSERT_THROW(compute_input_fingerprint({gatt_path + ".does_not_exist"}, io::ReadOrdering::file_order), std::invalid_argument);
+}
+
+} // namespace cudamapper
+
+} // namespace genomeworks
+
+} // namespace claraparabricks
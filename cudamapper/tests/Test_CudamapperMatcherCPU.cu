@@ -0,0 +1,148 @@
+/*
+* Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#include "gtest/gtest.h"
+
+#include "cudamapper_file_location.hpp"
+
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <claragenomics/cudamapper/index.hpp>
+#include <claragenomics/io/fasta_parser.hpp>
+#include <claragenomics/utils/cudautils.hpp>
+#include <claragenomics/utils/genomeutils.hpp>
+
+#include "../src/matcher_cpu.hpp"
+#include "../src/matcher_gpu.cuh"
+
+namespace claraparabricks
+{
+
+namespace genomeworks
+{
+
+namespace cudamapper
+{
+
+namespace
+{
+
+void check_same_anchors(const std::vector<Anchor>& expected_anchors,
+                        const std::vector<Anchor>& anchors)
+{
+    ASSERT_EQ(anchors.size(), expected_anchors.size());
+    for (std::size_t i = 0; i < anchors.size(); ++i)
+    {
+        ASSERT_EQ(anchors[i].query_read_id_, expected_anchors[i].query_read_id_) << "index: " << i;
+        ASSERT_EQ(anchors[i].target_read_id_, expected_anchors[i].target_read_id_) << "index: " << i;
+        ASSERT_EQ(anchors[i].query_position_in_read_, expected_anchors[i].query_position_in_read_) << "index: " << i;
+        ASSERT_EQ(anchors[i].target_position_in_read_, expected_anchors[i].target_position_in_read_) << "index: " << i;
+    }
+}
+
+/// \brief writes reads which are random substrings of one random genome, so that reads share many sketch elements
+std::string write_overlapping_reads_file(const std::string& file_name,
+                                         const std::int32_t number_of_reads)
+{
+    const std::string file_path = ::testing::TempDir() + file_name;
+    std::ofstream file(file_path);
+    std::minstd_rand rng(1);
+    const std::string genome = genomeutils::generate_random_genome(20000, rng);
+    std::uniform_int_distribution<std::int32_t> read_length(100, 2000);
+    for (std::int32_t i = 0; i < number_of_reads; ++i)
+    {
+        const std::int32_t length = read_length(rng);
+        std::uniform_int_distribution<std::int32_t> read_start(0, genome.size() - length);
+        file << ">read_" << i << "\n"
+             << genome.substr(read_start(rng), length) << "\n";
+    }
+    return file_path;
+}
+
+} // namespace
+
+TEST(TestCudamapperMatcherCPU, test_find_query_target_matches_small_example)
+{
+    const std::vector<representation_t> query_representations({0, 12, 23, 32, 46});
+    const std::vector<representation_t> target_representations({5, 12, 16, 23, 24, 25, 46});
+
+    std::vector<details::matcher_cpu::RepresentationMatch> matches;
+    details::matcher_cpu::find_query_target_matches(query_representations, target_representations, 0, 5, matches);
+    ASSERT_EQ(matches.size(), 3u);
+    EXPECT_EQ(matches[0].query_index_, 1u);
+    EXPECT_EQ(matches[0].target_index_, 1u);
+    EXPECT_EQ(matches[1].query_index_, 2u);
+    EXPECT_EQ(matches[1].target_index_, 3u);
+    EXPECT_EQ(matches[2].query_index_, 4u);
+    EXPECT_EQ(matches[2].target_index_, 6u);
+
+    // only a part of query, results are appended
+    details::matcher_cpu::find_query_target_matches(query_representations, target_representations, 3, 4, matches);
+    ASSERT_EQ(matches.size(), 3u);
+    details::matcher_cpu::find_query_target_matches(query_representations, target_representations, 2, 4, matches);
+    ASSERT_EQ(matches.size(), 4u);
+    EXPECT_EQ(matches[3].query_index_, 2u);
+    EXPECT_EQ(matches[3].target_index_, 3u);
+}
+
+TEST(TestCudamapperMatcherCPU, AtLeastOneIndexEmpty)
+{
+    std::unique_ptr<io::FastaParser> parser        = io::create_kseq_fasta_parser(std::string(CUDAMAPPER_BENCHMARK_DATA_DIR) + "/gatt.fasta");
+    std::unique_ptr<IndexHostCopyBase> index_full  = IndexHostCopyBase::create_index_on_host(*parser, 0, parser->get_num_seqences(), 4, 1);
+    std::unique_ptr<IndexHostCopyBase> index_empty = IndexHostCopyBase::create_index_on_host(*parser, 0, parser->get_num_seqences(), 5, 1); // kmer longer than read
+
+    EXPECT_EQ(MatcherCPU(*index_full, *index_empty).anchors().size(), 0u);
+    EXPECT_EQ(MatcherCPU(*index_empty, *index_full).anchors().size(), 0u);
+    EXPECT_EQ(MatcherCPU(*index_empty, *index_empty).anchors().size(), 0u);
+    EXPECT_EQ(MatcherCPU(*index_full, *index_full).anchors().size(), 1u);
+}
+
+TEST(TestCudamapperMatcherCPU, same_as_gpu_matcher)
+{
+    const std::string fasta_path            = write_overlapping_reads_file("test_matcher_cpu_same_as_gpu_matcher.fasta", 200);
+    std::unique_ptr<io::FastaParser> parser = io::create_kseq_fasta_parser(fasta_path, 0, false);
+    DefaultDeviceAllocator allocator        = create_default_device_allocator();
+
+    cudaStream_t cuda_stream;
+    CGA_CU_CHECK_ERR(cudaStreamCreate(&cuda_stream));
+
+    for (const std::uint64_t kmer_size : {8, 15})
+    {
+        std::unique_ptr<IndexHostCopyBase> query_index  = IndexHostCopyBase::create_index_on_host(*parser, 0, 120, kmer_size, 5);
+        std::unique_ptr<IndexHostCopyBase> target_index = IndexHostCopyBase::create_index_on_host(*parser, 80, 200, kmer_size, 5);
+
+        std::unique_ptr<Index> query_index_d  = query_index->copy_index_to_device(allocator, cuda_stream);
+        std::unique_ptr<Index> target_index_d = target_index->copy_index_to_device(allocator, cuda_stream);
+        MatcherGPU gpu_matcher(allocator, *query_index_d, *target_index_d, cuda_stream);
+
+        std::vector<Anchor> expected_anchors(gpu_matcher.anchors().size());
+        cudautils::device_copy_n(gpu_matcher.anchors().data(), gpu_matcher.anchors().size(), expected_anchors.data(), cuda_stream); // D2H
+        CGA_CU_CHECK_ERR(cudaStreamSynchronize(cuda_stream));
+        ASSERT_FALSE(expected_anchors.empty());
+
+        for (const std::int32_t number_of_threads : {1, 3, 8})
+        {
+            SCOPED_TRACE("k: " + std::to_string(kmer_size) + ", threads: " + std::to_string(number_of_threads));
+            const MatcherCPU matcher(*query_index, *target_index, number_of_threads);
+            check_same_anchors(expected_anchors, matcher.anchors());
+        }
+    }
+
+    CGA_CU_CHECK_ERR(cudaStreamDestroy(cuda_stream));
+}
+
+} // namespace cudamapper
+
+} // namespace genomeworks
+
+} // namespace claraparabricks
@@ -9,9 +9,13 @@
 */
 
 #include "gtest/gtest.h"
+#include <fstream>
+#include <random>
 #include <string>
 #include <vector>
 #include "../include/claragenomics/cudamapper/overlapper.hpp"
+#include <claragenomics/io/fasta_parser.hpp>
+#include <claragenomics/utils/genomeutils.hpp>
 
 namespace claraparabricks
 {
@@ -77,6 +81,63 @@ TEST(TestOverlapExtension, short_forward_head_overlap_properly_extended)
     ASSERT_EQ(o.target_end_position_in_read_, 1000);
 }
 
+TEST(TestOverlapExtension, rescue_overlap_ends_same_for_all_parsers)
+{
+    // target contains the query on the forward strand, a second target contains its reverse complement
+    std::minstd_rand rng(7);
+    const std::string query_sequence  = genomeutils::generate_random_genome(1000, rng);
+    const std::string target_sequence = genomeutils::generate_random_genome(300, rng) + query_sequence + genomeutils::generate_random_genome(200, rng);
+    std::string reverse_target_sequence(target_sequence.size(), 'N');
+    genomeutils::reverse_complement(target_sequence.data(), target_sequence.size(), &reverse_target_sequence[0]);
+
+    const std::string fasta_path = ::testing::TempDir() + "test_rescue_overlap_ends_same_for_all_parsers.fasta";
+    {
+        std::ofstream fasta_file(fasta_path);
+        fasta_file << ">query\n"
+                   << query_sequence << "\n>target\n"
+                   << target_sequence << "\n>reverse_target\n"
+                   << reverse_target_sequence << "\n";
+    }
+
+    Overlap forward_overlap;
+    forward_overlap.query_read_id_                 = 0;
+    forward_overlap.target_read_id_                = 1;
+    forward_overlap.query_start_position_in_read_  = 80;
+    forward_overlap.query_end_position_in_read_    = 920;
+    forward_overlap.target_start_position_in_read_ = 380;
+    forward_overlap.target_end_position_in_read_   = 1220;
+    forward_overlap.relative_strand                = RelativeStrand::Forward;
+    Overlap reverse_overlap                        = forward_overlap;
+    reverse_overlap.target_read_id_                = 2;
+    reverse_overlap.target_start_position_in_read_ = target_sequence.size() - forward_overlap.target_end_position_in_read_;
+    reverse_overlap.target_end_position_in_read_   = target_sequence.size() - forward_overlap.target_start_position_in_read_;
+    reverse_overlap.relative_strand                = RelativeStrand::Reverse;
+
+    const std::unique_ptr<io::FastaParser> kseq_parser = io::create_kseq_fasta_parser(fasta_path, 0, false);
+    std::vector<Overlap> expected_overlaps{forward_overlap, reverse_overlap};
+    Overlapper::rescue_overlap_ends(expected_overlaps, *kseq_parser, *kseq_parser, 100, 0.9);
+    // both overlaps are extended to the whole query
+    for (const Overlap& overlap : expected_overlaps)
+    {
+        EXPECT_EQ(overlap.query_start_position_in_read_, 0);
+        EXPECT_EQ(overlap.query_end_position_in_read_, 1000);
+    }
+
+    // packed parser decodes reads into the buffers of rescue_overlap_ends
+    const std::unique_ptr<io::FastaParser> packed_parser = io::create_packed_fasta_parser(fasta_path, 0, false);
+    std::vector<Overlap> overlaps{forward_overlap, reverse_overlap};
+    Overlapper::rescue_overlap_ends(overlaps, *packed_parser, *packed_parser, 100, 0.9);
+    ASSERT_EQ(overlaps.size(), expected_overlaps.size());
+    for (std::size_t i = 0; i < overlaps.size(); ++i)
+    {
+        EXPECT_EQ(overlaps[i].query_start_position_in_read_, expected_overlaps[i].query_start_position_in_read_) << "i: " << i;
+        EXPECT_EQ(overlaps[i].query_end_position_in_read_, expected_overlaps[i].query_end_position_in_read_) << "i: " << i;
+        EXPECT_EQ(overlaps[i].target_start_position_in_read_, expected_overlaps[i].target_start_position_in_read_) << "i: " << i;
+        EXPECT_EQ(overlaps[i].target_end_position_in_read_, expected_overlaps[i].target_end_position_in_read_) << "i: " << i;
+        EXPECT_EQ(overlaps[i].relative_strand, expected_overlaps[i].relative_strand) << "i: " << i;
+    }
+}
+
 TEST(TestDropOverlaps, drop_overlaps_by_mask)
 {
     Overlap o1;
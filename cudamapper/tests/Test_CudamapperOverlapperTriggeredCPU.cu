@@ -0,0 +1,188 @@
+/*
+* Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <random>
+#include <tuple>
+#include <vector>
+
+#include <claragenomics/utils/cudautils.hpp>
+
+#include "../src/overlapper_triggered.hpp"
+#include "../src/overlapper_triggered_cpu.hpp"
+
+namespace claraparabricks
+{
+
+namespace genomeworks
+{
+
+namespace cudamapper
+{
+
+namespace
+{
+
+Anchor make_anchor(const read_id_t query_read_id,
+                   const read_id_t target_read_id,
+                   const position_in_read_t query_position_in_read,
+                   const position_in_read_t target_position_in_read)
+{
+    Anchor anchor;
+    anchor.query_read_id_           = query_read_id;
+    anchor.target_read_id_          = target_read_id;
+    anchor.query_position_in_read_  = query_position_in_read;
+    anchor.target_position_in_read_ = target_position_in_read;
+    return anchor;
+}
+
+/// \brief generates sorted anchors of random read pairs, most of them lying on a diagonal so that they form overlaps
+std::vector<Anchor> generate_random_anchors(std::minstd_rand& rng)
+{
+    std::vector<Anchor> anchors;
+    std::uniform_int_distribution<std::int32_t> coin(0, 2);
+    std::uniform_int_distribution<std::int32_t> anchors_per_pair(0, 60);
+    std::uniform_int_distribution<position_in_read_t> position(0, 5000);
+    for (read_id_t query_read_id = 0; query_read_id < 20; ++query_read_id)
+    {
+        for (read_id_t target_read_id = 0; target_read_id < 20; ++target_read_id)
+        {
+            if (coin(rng) == 0)
+            {
+                continue;
+            }
+            const position_in_read_t offset = position(rng);
+            const bool reverse              = coin(rng) == 0;
+            const std::int32_t n            = anchors_per_pair(rng);
+            for (std::int32_t i = 0; i < n; ++i)
+            {
+                const position_in_read_t query_position = position(rng);
+                position_in_read_t target_position      = reverse ? offset + 5000 - query_position : offset + query_position;
+                if (coin(rng) == 0)
+                {
+                    target_position = position(rng); // noise
+                }
+                anchors.push_back(make_anchor(query_read_id, target_read_id, query_position, target_position));
+            }
+        }
+    }
+    std::sort(std::begin(anchors),
+              std::end(anchors),
+              [](const Anchor& a, const Anchor& b) {
+                  return std::tie(a.query_read_id_, a.target_read_id_, a.query_position_in_read_, a.target_position_in_read_) <
+                         std::tie(b.query_read_id_, b.target_read_id_, b.query_position_in_read_, b.target_position_in_read_);
+              });
+    return anchors;
+}
+
+} // namespace
+
+TEST(TestCudamapperOverlapperTriggeredCPU, NoAnchors)
+{
+    OverlapperTriggeredCPU overlapper;
+
+    std::vector<Overlap> overlaps(1);
+    overlapper.get_overlaps(overlaps, std::vector<Anchor>(), 0, 0);
+    ASSERT_EQ(overlaps.size(), 0u);
+}
+
+TEST(TestCudamapperOverlapperTriggeredCPU, FourAnchorsOneOverlap)
+{
+    OverlapperTriggeredCPU overlapper(1);
+
+    const std::vector<Anchor> anchors({make_anchor(1, 2, 100, 1000),
+                                       make_anchor(1, 2, 200, 1100),
+                                       make_anchor(1, 2, 300, 1200),
+                                       make_anchor(1, 2, 400, 1300)});
+
+    std::vector<Overlap> overlaps;
+    overlapper.get_overlaps(overlaps, anchors, 0, 0, 1000);
+    ASSERT_EQ(overlaps.size(), 1u);
+    ASSERT_EQ(overlaps[0].query_read_id_, 1u);
+    ASSERT_EQ(overlaps[0].target_read_id_, 2u);
+    ASSERT_EQ(overlaps[0].query_start_position_in_read_, 100u);
+    ASSERT_EQ(overlaps[0].query_end_position_in_read_, 400u);
+    ASSERT_EQ(overlaps[0].target_start_position_in_read_, 1000u);
+    ASSERT_EQ(overlaps[0].target_end_position_in_read_, 1300u);
+    ASSERT_EQ(overlaps[0].num_residues_, 4u);
+    ASSERT_EQ(overlaps[0].relative_strand, RelativeStrand::Forward);
+}
+
+TEST(TestCudamapperOverlapperTriggeredCPU, ReverseStrand)
+{
+    OverlapperTriggeredCPU overlapper(1);
+
+    const std::vector<Anchor> anchors({make_anchor(1, 2, 100, 1300),
+                                       make_anchor(1, 2, 200, 1200),
+                                       make_anchor(1, 2, 300, 1100),
+                                       make_anchor(1, 2, 400, 1000)});
+
+    std::vector<Overlap> overlaps;
+    overlapper.get_overlaps(overlaps, anchors, 0, 0, 1000);
+    ASSERT_EQ(overlaps.size(), 1u);
+    ASSERT_GT(overlaps[0].target_end_position_in_read_, overlaps[0].target_start_position_in_read_);
+    ASSERT_EQ(overlaps[0].relative_strand, RelativeStrand::Reverse);
+}
+
+TEST(TestCudamapperOverlapperTriggeredCPU, same_as_gpu_overlapper)
+{
+    DefaultDeviceAllocator allocator = create_default_device_allocator();
+    cudaStream_t cuda_stream;
+    CGA_CU_CHECK_ERR(cudaStreamCreate(&cuda_stream));
+
+    std::minstd_rand rng(1);
+    for (std::int32_t test_case = 0; test_case < 20; ++test_case)
+    {
+        const std::vector<Anchor> anchors = generate_random_anchors(rng);
+
+        device_buffer<Anchor> anchors_d(anchors.size(), allocator, cuda_stream);
+        cudautils::device_copy_n(anchors.data(), anchors.size(), anchors_d.data(), cuda_stream); //H2D
+
+        std::vector<Overlap> expected_overlaps;
+        OverlapperTriggered gpu_overlapper(allocator, cuda_stream);
+        gpu_overlapper.get_overlaps(expected_overlaps, anchors_d, 3, 50, 1000, 0.5);
+
+        for (const std::int32_t number_of_threads : {1, 3, 8})
+        {
+            SCOPED_TRACE("test case: " + std::to_string(test_case) + ", threads: " + std::to_string(number_of_threads));
+            OverlapperTriggeredCPU overlapper(number_of_threads);
+            std::vector<Overlap> overlaps;
+            overlapper.get_overlaps(overlaps, anchors, 3, 50, 1000, 0.5);
+            ASSERT_EQ(overlaps.size(), expected_overlaps.size());
+            for (std::size_t i = 0; i < overlaps.size(); ++i)
+            {
+                ASSERT_EQ(overlaps[i].query_read_id_, expected_overlaps[i].query_read_id_) << "index: " << i;
+                ASSERT_EQ(overlaps[i].target_read_id_, expected_overlaps[i].target_read_id_) << "index: " << i;
+                ASSERT_EQ(overlaps[i].query_start_position_in_read_, expected_overlaps[i].query_start_position_in_read_) << "index: " << i;
+                ASSERT_EQ(overlaps[i].query_end_position_in_read_, expected_overlaps[i].query_end_position_in_read_) << "index: " << i;
+                ASSERT_EQ(overlaps[i].target_start_position_in_read_, expected_overlaps[i].target_start_position_in_read_) << "index: " << i;
+                ASSERT_EQ(overlaps[i].target_end_position_in_read_, expected_overlaps[i].target_end_position_in_read_) << "index: " << i;
+                ASSERT_EQ(overlaps[i].num_residues_, expected_overlaps[i].num_residues_) << "index: " << i;
+                ASSERT_EQ(overlaps[i].relative_strand, expected_overlaps[i].relative_strand) << "index: " << i;
+            }
+        }
+
+        // device_buffer overload gives the same result
+        OverlapperTriggeredCPU overlapper;
+        std::vector<Overlap> overlaps;
+        overlapper.get_overlaps(overlaps, anchors_d, 3, 50, 1000, 0.5);
+        ASSERT_EQ(overlaps.size(), expected_overlaps.size());
+    }
+
+    CGA_CU_CHECK_ERR(cudaStreamDestroy(cuda_stream));
+}
+
+} // namespace cudamapper
+
+} // namespace genomeworks
+
+} // namespace claraparabricks
@@ -0,0 +1,120 @@
+/*
+* Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#include "gtest/gtest.h"
+
+#include "../src/paf_formatter.hpp"
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <claragenomics/io/fasta_parser.hpp>
+
+#include "cudamapper_file_location.hpp"
+
+namespace claraparabricks
+{
+
+namespace genomeworks
+{
+
+namespace cudamapper
+{
+
+namespace
+{
+
+Overlap make_overlap(const read_id_t query_read_id,
+                     const position_in_read_t query_start,
+                     const position_in_read_t query_end,
+                     const read_id_t target_read_id,
+                     const position_in_read_t target_start,
+                     const position_in_read_t target_end,
+                     const RelativeStrand relative_strand,
+                     const std::uint32_t num_residues)
+{
+    Overlap overlap;
+    overlap.query_read_id_                 = query_read_id;
+    overlap.query_start_position_in_read_  = query_start;
+    overlap.query_end_position_in_read_    = query_end;
+    overlap.target_read_id_                = target_read_id;
+    overlap.target_start_position_in_read_ = target_start;
+    overlap.target_end_position_in_read_   = target_end;
+    overlap.relative_strand                = relative_strand;
+    overlap.num_residues_                  = num_residues;
+    return overlap;
+}
+
+} // namespace
+
+TEST(TestCudamapperPafFormatter, overlaps_without_cigars)
+{
+    std::unique_ptr<io::FastaParser> parser = io::create_kseq_fasta_parser(std::string(CUDAMAPPER_BENCHMARK_DATA_DIR) + "/catcaag_aagcta.fasta", 0, false);
+
+    const PafFormatter formatter(*parser, *parser, 3);
+
+    const std::vector<Overlap> overlaps = {make_overlap(0, 1, 6, 1, 0, 4, RelativeStrand::Forward, 2),
+                                           make_overlap(1, 5, 2, 0, 3, 7, RelativeStrand::Reverse, 1)};
+
+    // existing content of the buffer is kept
+    std::vector<char> buffer = {'x', '\n'};
+    formatter.append_paf(overlaps, {}, buffer);
+    formatter.append_paf({}, {}, buffer);
+
+    const std::string expected = "x\n"
+                                 "read_0\t7\t1\t6\t+\tread_1\t6\t0\t4\t6\t5\t255\n"
+                                 "read_1\t6\t5\t2\t-\tread_0\t7\t3\t7\t3\t4\t255\n";
+    ASSERT_EQ(std::string(begin(buffer), end(buffer)), expected);
+}
+
+TEST(TestCudamapperPafFormatter, overlaps_with_cigars_and_different_parsers)
+{
+    std::unique_ptr<io::FastaParser> query_parser  = io::create_kseq_fasta_parser(std::string(CUDAMAPPER_BENCHMARK_DATA_DIR) + "/catcaag_aagcta.fasta", 0, false);
+    std::unique_ptr<io::FastaParser> target_parser = io::create_kseq_fasta_parser(std::string(CUDAMAPPER_BENCHMARK_DATA_DIR) + "/catcaag_aagcta.fasta", 0, false);
+
+    const PafFormatter formatter(*query_parser, *target_parser, 4);
+
+    // number of matching bases does not fit into 32-bit signed integer
+    const std::vector<Overlap> overlaps   = {make_overlap(1, 0, 6, 1, 0, 6, RelativeStrand::Forward, 1000000000)};
+    const std::vector<std::string> cigars = {"6M"};
+
+    std::vector<char> buffer;
+    formatter.append_paf(overlaps, cigars, buffer);
+
+    const std::string expected = "read_1\t6\t0\t6\t+\tread_1\t6\t0\t6\t4000000000\t6\t255\tcg:Z:6M\n";
+    ASSERT_EQ(std::string(begin(buffer), end(buffer)), expected);
+}
+
+TEST(TestCudamapperPafFormatter, write_to_file_descriptor)
+{
+    std::FILE* file = std::tmpfile();
+    ASSERT_NE(file, nullptr);
+
+    const std::string data(3 * 1000 * 1000, 'A');
+    write_to_file_descriptor(fileno(file), data.data(), data.size());
+    write_to_file_descriptor(fileno(file), "\n", 1);
+
+    std::rewind(file);
+    std::string read_data(data.size() + 1, '\0');
+    ASSERT_EQ(std::fread(&read_data[0], 1, read_data.size(), file), read_data.size());
+    ASSERT_EQ(read_data, data + "\n");
+    ASSERT_EQ(std::fgetc(file), EOF);
+    std::fclose(file);
+
+    ASSERT_THROW(write_to_file_descriptor(-1, data.data(), 1), std::runtime_error);
+}
+
+} // namespace cudamapper
+
+} // namespace genomeworks
+
+} // namespace claraparabricks
@@ -0,0 +1,254 @@
+/*
+* Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#include "gtest/gtest.h"
+
+#include "../src/shared_index_host_cache.hpp"
+
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <claragenomics/cudamapper/index.hpp>
+#include <claragenomics/io/fasta_parser.hpp>
+
+#include "cudamapper_file_location.hpp"
+
+namespace claraparabricks
+{
+
+namespace genomeworks
+{
+
+namespace cudamapper
+{
+
+namespace
+{
+
+/// returns a function which creates index with the given reads of catcaag_aagcta.fasta and counts the calls
+SharedIndexHostCache::index_creator_t make_index_creator(const IndexDescriptor& descriptor,
+                                                         std::atomic<std::int32_t>& number_of_calls)
+{
+    return [descriptor, &number_of_calls]() -> std::shared_ptr<const IndexHostCopyBase> {
+        ++number_of_calls;
+        std::unique_ptr<io::FastaParser> parser = io::create_kseq_fasta_parser(std::string(CUDAMAPPER_BENCHMARK_DATA_DIR) + "/catcaag_aagcta.fasta", 0, false);
+        return IndexHostCopyBase::create_index_on_host(*parser,
+                                                       descriptor.first_read(),
+                                                       descriptor.first_read() + descriptor.number_of_reads(),
+                                                       3,
+                                                       2,
+                                                       false);
+    };
+}
+
+} // namespace
+
+TEST(TestCudamapperSharedIndexHostCache, no_budget)
+{
+    const IndexDescriptor catcaag_index_descriptor(0, 1);
+    const IndexDescriptor aagcta_index_descriptor(1, 1);
+    std::atomic<std::int32_t> number_of_calls(0);
+
+    SharedIndexHostCache cache(false);
+
+    auto catcaag_index = cache.acquire(SharedIndexHostCache::Input::query, catcaag_index_descriptor, make_index_creator(catcaag_index_descriptor, number_of_calls));
+    ASSERT_NE(catcaag_index, nullptr);
+    ASSERT_EQ(catcaag_index->first_read_id(), 0u);
+    // index in use is not discarded
+    ASSERT_EQ(cache.acquire(SharedIndexHostCache::Input::query, catcaag_index_descriptor, make_index_creator(catcaag_index_descriptor, number_of_calls)), catcaag_index);
+    cache.release(SharedIndexHostCache::Input::query, catcaag_index_descriptor);
+    cache.release(SharedIndexHostCache::Input::query, catcaag_index_descriptor);
+    ASSERT_EQ(number_of_calls, 1);
+
+    // not in use anymore -> discarded
+    auto new_catcaag_index = cache.acquire(SharedIndexHostCache::Input::query, catcaag_index_descriptor, make_index_creator(catcaag_index_descriptor, number_of_calls));
+    ASSERT_NE(new_catcaag_index, catcaag_index);
+    ASSERT_EQ(number_of_calls, 2);
+
+    // query and target indices are different
+    auto aagcta_index = cache.acquire(SharedIndexHostCache::Input::target, aagcta_index_descriptor, make_index_creator(aagcta_index_descriptor, number_of_calls));
+    ASSERT_EQ(aagcta_index->first_read_id(), 1u);
+    ASSERT_EQ(number_of_calls, 3);
+
+    const IndexCacheStatistics statistics = cache.statistics();
+    ASSERT_EQ(statistics.hits, 1);
+    ASSERT_EQ(statistics.misses, 3);
+    ASSERT_EQ(statistics.evictions, 1);
+}
+
+TEST(TestCudamapperSharedIndexHostCache, budget)
+{
+    const IndexDescriptor catcaag_index_descriptor(0, 1);
+    const IndexDescriptor aagcta_index_descriptor(1, 1);
+    const IndexDescriptor catcaag_aagcta_index_descriptor(0, 2);
+    std::atomic<std::int32_t> number_of_calls(0);
+
+    // indices of one read fit into the budget, index of both reads does not
+    std::int64_t catcaag_bytes = 0;
+    {
+        auto index    = make_index_creator(catcaag_index_descriptor, number_of_calls)();
+        catcaag_bytes = index->representations().size() * sizeof(representation_t) +
+                        index->read_ids().size() * sizeof(read_id_t) +
+                        index->positions_in_reads().size() * sizeof(position_in_read_t) +
+                        index->directions_of_reads().size() * sizeof(SketchElement::DirectionOfRepresentation) +
+                        index->unique_representations().size() * sizeof(representation_t) +
+                        index->first_occurrence_of_representations().size() * sizeof(std::uint32_t);
+    }
+    number_of_calls = 0;
+
+    // same_query_and_target -> query index can be used as target index
+    SharedIndexHostCache cache(true, catcaag_bytes);
+
+    cache.acquire(SharedIndexHostCache::Input::query, catcaag_index_descriptor, make_index_creator(catcaag_index_descriptor, number_of_calls));
+    cache.release(SharedIndexHostCache::Input::query, catcaag_index_descriptor);
+    cache.acquire(SharedIndexHostCache::Input::target, catcaag_index_descriptor, make_index_creator(catcaag_index_descriptor, number_of_calls));
+    cache.release(SharedIndexHostCache::Input::target, catcaag_index_descriptor);
+    ASSERT_EQ(number_of_calls, 1);
+
+    // catcaag is least recently used and gets discarded, index of both reads alone is over the budget and gets discarded once released
+    cache.acquire(SharedIndexHostCache::Input::query, catcaag_aagcta_index_descriptor, make_index_creator(catcaag_aagcta_index_descriptor, number_of_calls));
+    ASSERT_EQ(cache.statistics().evictions, 1);
+    cache.release(SharedIndexHostCache::Input::query, catcaag_aagcta_index_descriptor);
+    ASSERT_EQ(cache.statistics().evictions, 2);
+
+    // indices in use are kept even though both indices are over the budget
+    cache.acquire(SharedIndexHostCache::Input::query, catcaag_index_descriptor, make_index_creator(catcaag_index_descriptor, number_of_calls));
+    cache.acquire(SharedIndexHostCache::Input::query, aagcta_index_descriptor, make_index_creator(aagcta_index_descriptor, number_of_calls));
+    ASSERT_EQ(number_of_calls, 4);
+    ASSERT_EQ(cache.statistics().evictions, 2);
+
+    // released index is least recently used and gets discarded
+    cache.release(SharedIndexHostCache::Input::query, catcaag_index_descriptor);
+    cache.release(SharedIndexHostCache::Input::query, aagcta_index_descriptor);
+
+    const IndexCacheStatistics statistics = cache.statistics();
+    ASSERT_EQ(statistics.hits, 1);
+    ASSERT_EQ(statistics.misses, 4);
+    ASSERT_EQ(statistics.evictions, 3);
+}
+
+TEST(TestCudamapperSharedIndexHostCache, pins)
+{
+    const IndexDescriptor catcaag_index_descriptor(0, 1);
+    std::atomic<std::int32_t> number_of_calls(0);
+
+    // no budget, indices which are neither in use nor pinned are discarded as soon as they are released
+    SharedIndexHostCache cache(false);
+
+    // pinned by two devices, index does not have to be in cache yet
+    cache.pin(SharedIndexHostCache::Input::target, catcaag_index_descriptor);
+    cache.pin(SharedIndexHostCache::Input::target, catcaag_index_descriptor);
+
+    auto catcaag_index = cache.acquire(SharedIndexHostCache::Input::target, catcaag_index_descriptor, make_index_creator(catcaag_index_descriptor, number_of_calls));
+    cache.release(SharedIndexHostCache::Input::target, catcaag_index_descriptor);
+    ASSERT_EQ(cache.acquire(SharedIndexHostCache::Input::target, catcaag_index_descriptor, make_index_creator(catcaag_index_descriptor, number_of_calls)), catcaag_index);
+    cache.release(SharedIndexHostCache::Input::target, catcaag_index_descriptor);
+    ASSERT_EQ(number_of_calls, 1);
+    ASSERT_EQ(cache.statistics().evictions, 0);
+
+    // pin only applies to target index
+    cache.acquire(SharedIndexHostCache::Input::query, catcaag_index_descriptor, make_index_creator(catcaag_index_descriptor, number_of_calls));
+    cache.release(SharedIndexHostCache::Input::query, catcaag_index_descriptor);
+    ASSERT_EQ(number_of_calls, 2);
+    ASSERT_EQ(cache.statistics().evictions, 1);
+
+    // still pinned by the other device
+    cache.unpin(SharedIndexHostCache::Input::target, catcaag_index_descriptor);
+    ASSERT_EQ(cache.acquire(SharedIndexHostCache::Input::target, catcaag_index_descriptor, make_index_creator(catcaag_index_descriptor, number_of_calls)), catcaag_index);
+    cache.release(SharedIndexHostCache::Input::target, catcaag_index_descriptor);
+    ASSERT_EQ(number_of_calls, 2);
+
+    // neither pinned nor in use -> discarded
+    cache.unpin(SharedIndexHostCache::Input::target, catcaag_index_descriptor);
+    ASSERT_EQ(cache.statistics().evictions, 2);
+    ASSERT_NE(cache.acquire(SharedIndexHostCache::Input::target, catcaag_index_descriptor, make_index_creator(catcaag_index_descriptor, number_of_calls)), catcaag_index);
+    cache.release(SharedIndexHostCache::Input::target, catcaag_index_descriptor);
+    ASSERT_EQ(number_of_calls, 3);
+
+    const IndexCacheStatistics statistics = cache.statistics();
+    ASSERT_EQ(statistics.hits, 2);
+    ASSERT_EQ(statistics.misses, 3);
+    ASSERT_EQ(statistics.evictions, 3);
+}
+
+TEST(TestCudamapperSharedIndexHostCache, concurrent_requests_create_index_once)
+{
+    const IndexDescriptor catcaag_aagcta_index_descriptor(0, 2);
+    std::atomic<std::int32_t> number_of_calls(0);
+    std::atomic<bool> creation_started(false);
+    std::atomic<bool> finish_creation(false);
+
+    SharedIndexHostCache cache(false);
+
+    // first thread blocks in index creation until all other threads have requested the same index
+    const SharedIndexHostCache::index_creator_t create_index      = make_index_creator(catcaag_aagcta_index_descriptor, number_of_calls);
+    const SharedIndexHostCache::index_creator_t slow_create_index = [&]() {
+        creation_started = true;
+        while (!finish_creation)
+        {
+            std::this_thread::yield();
+        }
+        return create_index();
+    };
+
+    const std::int32_t number_of_threads = 4;
+    std::vector<std::shared_ptr<const IndexHostCopyBase>> indices(number_of_threads);
+    std::vector<std::thread> threads;
+    threads.emplace_back([&]() { indices[0] = cache.acquire(SharedIndexHostCache::Input::query, catcaag_aagcta_index_descriptor, slow_create_index); });
+    while (!creation_started)
+    {
+        std::this_thread::yield();
+    }
+    for (std::int32_t i = 1; i < number_of_threads; ++i)
+    {
+        threads.emplace_back([&, i]() { indices[i] = cache.acquire(SharedIndexHostCache::Input::query, catcaag_aagcta_index_descriptor, create_index); });
+    }
+    while (cache.statistics().hits != number_of_threads - 1)
+    {
+        std::this_thread::yield();
+    }
+    finish_creation = true;
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    ASSERT_EQ(number_of_calls, 1);
+    for (const auto& index : indices)
+    {
+        ASSERT_NE(index, nullptr);
+        ASSERT_EQ(index, indices[0]);
+    }
+}
+
+TEST(TestCudamapperSharedIndexHostCache, failed_creation)
+{
+    const IndexDescriptor catcaag_index_descriptor(0, 1);
+    std::atomic<std::int32_t> number_of_calls(0);
+
+    SharedIndexHostCache cache(false);
+
+    const SharedIndexHostCache::index_creator_t failing_create_index = []() -> std::shared_ptr<const IndexHostCopyBase> {
+        throw std::runtime_error("creation failed");
+    };
+    ASSERT_THROW(cache.acquire(SharedIndexHostCache::Input::query, catcaag_index_descriptor, failing_create_index), std::runtime_error);
+
+    // next request tries again
+    ASSERT_NE(cache.acquire(SharedIndexHostCache::Input::query, catcaag_index_descriptor, make_index_creator(catcaag_index_descriptor, number_of_calls)), nullptr);
+    ASSERT_EQ(number_of_calls, 1);
+}
+
+} // namespace cudamapper
+
+} // namespace genomeworks
+
+} // namespace claraparabricks
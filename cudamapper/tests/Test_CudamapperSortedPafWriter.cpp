@@ -0,0 +1,151 @@
+/*
+* Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#include "gtest/gtest.h"
+
+#include "../src/sorted_paf_writer.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+namespace claraparabricks
+{
+
+namespace genomeworks
+{
+
+namespace cudamapper
+{
+
+namespace
+{
+
+/// \brief returns PAF-like line with the given query and target name, other fields are query_start and some constant values
+std::string paf_line(const std::int32_t query_id,
+                     const std::int32_t target_id,
+                     const std::int32_t query_start)
+{
+    return "read_" + std::to_string(query_id) + "\t1000\t" + std::to_string(query_start) + "\t900\t+\tread_" + std::to_string(target_id) + "\t1000\t0\t900\t100\t900\t255\n";
+}
+
+/// \brief returns the lines in the order in which SortedPafWriter should output them
+std::string sort_lines(std::vector<std::tuple<std::string, std::string, std::string>> lines)
+{
+    std::sort(begin(lines), end(lines));
+    std::string sorted;
+    for (const auto& line : lines)
+    {
+        sorted += std::get<2>(line);
+    }
+    return sorted;
+}
+
+/// \brief merges writer into a temporary file and returns its content
+std::string merge_into_string(SortedPafWriter& writer)
+{
+    std::FILE* const file = std::tmpfile();
+    writer.merge(file);
+    std::rewind(file);
+    std::string content;
+    char buffer[4096];
+    std::size_t read_bytes = 0;
+    while ((read_bytes = std::fread(buffer, 1, sizeof(buffer), file)) > 0)
+    {
+        content.append(buffer, read_bytes);
+    }
+    std::fclose(file);
+    return content;
+}
+
+} // namespace
+
+TEST(TestCudamapperSortedPafWriter, invalid_arguments)
+{
+    EXPECT_THROW(SortedPafWriter(::testing::TempDir(), 0, 1), std::invalid_argument);
+    EXPECT_THROW(SortedPafWriter(::testing::TempDir(), 1000, 0), std::invalid_argument);
+    EXPECT_THROW(SortedPafWriter(::testing::TempDir() + "/directory_that_does_not_exist", 1000, 1), std::runtime_error);
+}
+
+TEST(TestCudamapperSortedPafWriter, no_lines)
+{
+    SortedPafWriter writer(::testing::TempDir(), 1000, 1);
+    EXPECT_EQ(merge_into_string(writer), "");
+    EXPECT_EQ(writer.number_of_runs(), 0);
+}
+
+TEST(TestCudamapperSortedPafWriter, multiple_merge_passes)
+{
+    // names are compared as strings, so read_10 comes before read_2
+    std::vector<std::tuple<std::string, std::string, std::string>> lines;
+    SortedPafWriter writer(::testing::TempDir(), 1000, 1); // about 10 lines per run
+    for (std::int32_t i = 0; i < 2000; ++i)
+    {
+        const std::int32_t query_id    = (i * 7919) % 97;
+        const std::int32_t target_id   = (i * 104729) % 13;
+        const std::int32_t query_start = i % 5;
+        const std::string line         = paf_line(query_id, target_id, query_start);
+        lines.emplace_back("read_" + std::to_string(query_id), "read_" + std::to_string(target_id), line);
+        writer.add_lines(std::vector<char>(begin(line), end(line)));
+    }
+
+    // more runs than can be merged at once
+    ASSERT_GT(writer.number_of_runs(), 64);
+    ASSERT_EQ(merge_into_string(writer), sort_lines(lines));
+}
+
+TEST(TestCudamapperSortedPafWriter, concurrent_adds)
+{
+    const std::int32_t number_of_threads = 4;
+    SortedPafWriter writer(::testing::TempDir(), 20000, number_of_threads);
+
+    std::vector<std::vector<std::tuple<std::string, std::string, std::string>>> lines_per_thread(number_of_threads);
+    std::vector<std::thread> threads;
+    for (std::int32_t thread_id = 0; thread_id < number_of_threads; ++thread_id)
+    {
+        threads.emplace_back([&, thread_id]() {
+            for (std::int32_t i = 0; i < 500; ++i)
+            {
+                // several lines at once
+                std::string paf;
+                for (std::int32_t j = 0; j < 3; ++j)
+                {
+                    const std::int32_t query_id  = (i * 31 + j) % 50;
+                    const std::int32_t target_id = thread_id;
+                    const std::string line       = paf_line(query_id, target_id, i);
+                    lines_per_thread[thread_id].emplace_back("read_" + std::to_string(query_id), "read_" + std::to_string(target_id), line);
+                    paf += line;
+                }
+                writer.add_lines(std::vector<char>(begin(paf), end(paf)));
+            }
+        });
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    std::vector<std::tuple<std::string, std::string, std::string>> lines;
+    for (const auto& thread_lines : lines_per_thread)
+    {
+        lines.insert(end(lines), begin(thread_lines), end(thread_lines));
+    }
+    ASSERT_EQ(merge_into_string(writer), sort_lines(lines));
+}
+
+} // namespace cudamapper
+
+} // namespace genomeworks
+
+} // namespace claraparabricks
@@ -0,0 +1,162 @@
+/*
+* Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#include "gtest/gtest.h"
+
+#include "../src/work_stealing_scheduler.hpp"
+
+#include <algorithm>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace claraparabricks
+{
+
+namespace genomeworks
+{
+
+namespace cudamapper
+{
+
+TEST(TestCudamapperWorkStealingScheduler, invalid_arguments)
+{
+    EXPECT_THROW(WorkStealingScheduler<int>({1, 2}, {1.0}, 1), std::invalid_argument);
+    EXPECT_THROW(WorkStealingScheduler<int>({1, 2}, {1.0, 2.0}, 0), std::invalid_argument);
+}
+
+TEST(TestCudamapperWorkStealingScheduler, no_elements)
+{
+    WorkStealingScheduler<int> scheduler({}, {}, 2);
+    EXPECT_FALSE(scheduler.get_next_element(0));
+    EXPECT_FALSE(scheduler.get_next_element(1));
+    EXPECT_EQ(scheduler.number_of_steals(), 0);
+}
+
+TEST(TestCudamapperWorkStealingScheduler, largest_first_and_stealing)
+{
+    // element i has cost costs[i]
+    // sorted by cost: 3 (8), 1 (5), 5 (4), 2 (3), 4 (2), 0 (1)
+    // worker 0: 3, 2, 0 (total 12)
+    // worker 1: 1, 5, 4 (total 11)
+    WorkStealingScheduler<int> scheduler({0, 1, 2, 3, 4, 5}, {1.0, 5.0, 3.0, 8.0, 2.0, 4.0}, 2);
+
+    EXPECT_EQ(scheduler.get_next_element(0).value(), 3);
+    EXPECT_EQ(scheduler.get_next_element(0).value(), 2);
+    EXPECT_EQ(scheduler.get_next_element(0).value(), 0);
+    // worker 0 steals the smallest element of worker 1
+    EXPECT_EQ(scheduler.get_next_element(0).value(), 4);
+    EXPECT_EQ(scheduler.number_of_steals(), 1);
+
+    EXPECT_EQ(scheduler.get_next_element(1).value(), 1);
+    EXPECT_EQ(scheduler.get_next_element(1).value(), 5);
+    EXPECT_FALSE(scheduler.get_next_element(1));
+    EXPECT_FALSE(scheduler.get_next_element(0));
+    EXPECT_EQ(scheduler.number_of_steals(), 1);
+}
+
+TEST(TestCudamapperWorkStealingScheduler, contiguous)
+{
+    // total cost 12, worker 0 gets elements whose middle is in [0, 6), worker 1 the rest
+    WorkStealingScheduler<int> scheduler({0, 1, 2, 3, 4}, {4.0, 1.0, 3.0, 2.0, 2.0}, 2, WorkAssignment::contiguous);
+
+    EXPECT_EQ(scheduler.get_next_element(0).value(), 0);
+    EXPECT_EQ(scheduler.get_next_element(0).value(), 1);
+    EXPECT_EQ(scheduler.get_next_element(1).value(), 2);
+    EXPECT_EQ(scheduler.get_next_element(1).value(), 3);
+    // worker 0 steals the last element of worker 1
+    EXPECT_EQ(scheduler.get_next_element(0).value(), 4);
+    EXPECT_FALSE(scheduler.get_next_element(1));
+    EXPECT_EQ(scheduler.number_of_steals(), 1);
+
+    // no costs -> elements are split by count
+    WorkStealingScheduler<int> no_costs({0, 1, 2, 3}, {0.0, 0.0, 0.0, 0.0}, 2, WorkAssignment::contiguous);
+    EXPECT_EQ(no_costs.get_next_element(1).value(), 2);
+    EXPECT_EQ(no_costs.get_next_element(1).value(), 3);
+    EXPECT_EQ(no_costs.get_next_element(0).value(), 0);
+}
+
+TEST(TestCudamapperWorkStealingScheduler, peeked_elements_can_be_stolen)
+{
+    // total cost 6, worker 0 gets 10, 11 and 12, worker 1 gets 13
+    WorkStealingScheduler<int> scheduler({10, 11, 12, 13}, {1.0, 1.0, 1.0, 3.0}, 2, WorkAssignment::contiguous);
+
+    std::size_t element_id = 0;
+    EXPECT_EQ(scheduler.get_next_element(0, element_id).value(), 10);
+    EXPECT_EQ(element_id, 0u);
+
+    const std::vector<std::pair<std::size_t, int>> next_elements = scheduler.peek_next_elements(0, 5);
+    ASSERT_EQ(next_elements.size(), 2u);
+    EXPECT_EQ(next_elements[0], std::make_pair(std::size_t(1), 11));
+    EXPECT_EQ(next_elements[1], std::make_pair(std::size_t(2), 12));
+    EXPECT_EQ(scheduler.peek_next_elements(0, 1).size(), 1u);
+
+    // worker 1 runs dry and steals the last peeked element of worker 0
+    EXPECT_EQ(scheduler.get_next_element(1, element_id).value(), 13);
+    EXPECT_EQ(element_id, 3u);
+    EXPECT_EQ(scheduler.get_next_element(1, element_id).value(), 12);
+    EXPECT_EQ(element_id, 2u);
+    EXPECT_EQ(scheduler.number_of_steals(), 1);
+
+    ASSERT_EQ(scheduler.peek_next_elements(0, 5).size(), 1u);
+    EXPECT_EQ(scheduler.get_next_element(0, element_id).value(), 11);
+    EXPECT_EQ(element_id, 1u);
+    EXPECT_TRUE(scheduler.peek_next_elements(0, 5).empty());
+    EXPECT_FALSE(scheduler.get_next_element(0, element_id));
+    EXPECT_EQ(element_id, 1u);
+}
+
+TEST(TestCudamapperWorkStealingScheduler, every_element_once)
+{
+    const int number_of_elements = 1000;
+    const int number_of_workers  = 4;
+
+    std::vector<int> elements(number_of_elements);
+    std::vector<double> costs(number_of_elements);
+    for (int i = 0; i < number_of_elements; ++i)
+    {
+        elements[i] = i;
+        costs[i]    = (i * 7919) % 101;
+    }
+
+    WorkStealingScheduler<int> scheduler(std::move(elements), costs, number_of_workers);
+
+    std::mutex taken_elements_mutex;
+    std::vector<int> taken_elements;
+    std::vector<std::thread> workers;
+    for (int worker_id = 0; worker_id < number_of_workers; ++worker_id)
+    {
+        workers.emplace_back([&, worker_id]() {
+            while (cga_optional_t<int> element = scheduler.get_next_element(worker_id))
+            {
+                std::lock_guard<std::mutex> lock(taken_elements_mutex);
+                taken_elements.push_back(element.value());
+            }
+        });
+    }
+    for (std::thread& worker : workers)
+    {
+        worker.join();
+    }
+
+    std::sort(begin(taken_elements), end(taken_elements));
+    ASSERT_EQ(static_cast<int>(taken_elements.size()), number_of_elements);
+    for (int i = 0; i < number_of_elements; ++i)
+    {
+        ASSERT_EQ(taken_elements[i], i);
+    }
+}
+
+} // namespace cudamapper
+
+} // namespace genomeworks
+
+} // namespace claraparabricks
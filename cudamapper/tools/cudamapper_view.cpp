@@ -0,0 +1,68 @@
+/*
+* Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#include <claragenomics/cudamapper/binary_overlaps.hpp>
+
+#include "../src/paf_formatter.hpp"
+
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+/// Converts a binary overlaps file written by cudamapper -f binary to PAF and writes it to stdout
+int main(int argc, char* argv[])
+{
+    using namespace claraparabricks::genomeworks;
+
+    if (argc != 2)
+    {
+        std::cerr << "Usage: cudamapper-view <binary overlaps file>" << std::endl;
+        return EXIT_FAILURE;
+    }
+    const std::string input_file = argv[1];
+
+    try
+    {
+        cudamapper::BinaryOverlapsReader reader(input_file);
+        const cudamapper::PafFormatter paf_formatter(reader.query_read_names(),
+                                                     reader.query_read_lengths(),
+                                                     reader.target_read_names(),
+                                                     reader.target_read_lengths(),
+                                                     reader.kmer_size());
+
+        // output is collected and written in large chunks
+        constexpr std::size_t min_output_write_size = 4 * 1024 * 1024;
+
+        std::vector<cudamapper::Overlap> overlaps;
+        std::vector<std::string> cigars;
+        std::vector<char> output;
+        while (reader.read_next_block(overlaps, cigars))
+        {
+            paf_formatter.append_paf(overlaps, cigars, output);
+            if (output.size() >= min_output_write_size)
+            {
+                cudamapper::write_to_file_descriptor(STDOUT_FILENO, output.data(), output.size());
+                output.clear();
+            }
+        }
+        cudamapper::write_to_file_descriptor(STDOUT_FILENO, output.data(), output.size());
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
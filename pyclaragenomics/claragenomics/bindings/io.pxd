@@ -0,0 +1,51 @@
+#
+# Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+#
+# NVIDIA CORPORATION and its licensors retain all intellectual property
+# and proprietary rights in and to this software, related documentation
+# and any modifications thereto.  Any use, reproduction, disclosure or
+# distribution of this software and related documentation without an express
+# license agreement from NVIDIA CORPORATION is strictly prohibited.
+#
+
+# cython: profile=False
+# distutils: language = c++
+# cython: embedsignature = True
+# cython: language_level = 3
+
+from libcpp cimport bool
+from libcpp.string cimport string
+from libcpp.memory cimport unique_ptr
+from libc.stdint cimport int32_t, uint32_t
+
+# This file declared public structs and API calls
+# from the ClaraGenomicsAnalysis `io` module.
+
+# Declare types from types.hpp
+cdef extern from "claragenomics/types.hpp" namespace "claraparabricks::genomeworks":
+    ctypedef uint32_t read_id_t
+    ctypedef uint32_t number_of_reads_t
+    ctypedef uint32_t number_of_basepairs_t
+
+    cdef cppclass cga_string_view_t:
+        cga_string_view_t()
+        cga_string_view_t(const char*, size_t)
+        const char* data()
+        size_t size()
+
+# Declare structs and APIs from fasta_parser.hpp
+cdef extern from "claragenomics/io/fasta_parser.hpp" namespace "claraparabricks::genomeworks::io":
+    ctypedef struct FastaSequence:
+        string name
+        string seq
+
+    cdef cppclass FastaParser:
+        number_of_reads_t get_num_seqences() except +
+        const FastaSequence& get_sequence_by_id(read_id_t) except +
+        number_of_basepairs_t get_sequence_length_by_id(read_id_t) except +
+        cga_string_view_t get_name_view_by_id(read_id_t) except +
+        cga_string_view_t get_sequence_view_by_id(read_id_t) except +
+        read_id_t get_sequence_id_by_name(cga_string_view_t) except +
+
+    unique_ptr[FastaParser] create_kseq_fasta_parser(const string&, number_of_basepairs_t, bool) except +
+    unique_ptr[FastaParser] create_parallel_fasta_parser(const string&, number_of_basepairs_t, bool, int32_t) except +
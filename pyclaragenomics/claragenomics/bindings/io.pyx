@@ -0,0 +1,118 @@
+#
+# Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+#
+# NVIDIA CORPORATION and its licensors retain all intellectual property
+# and proprietary rights in and to this software, related documentation
+# and any modifications thereto.  Any use, reproduction, disclosure or
+# distribution of this software and related documentation without an express
+# license agreement from NVIDIA CORPORATION is strictly prohibited.
+#
+
+# cython: profile=False
+# distutils: language = c++
+# cython: embedsignature = True
+# cython: language_level = 3
+
+"""Bindings for IO."""
+
+from cython.operator cimport dereference as deref
+from libcpp.memory cimport unique_ptr
+from libcpp.string cimport string
+
+from bindings cimport io
+
+
+cdef class FastaParser:
+    """Python API for reading FASTA/FASTQ files.
+
+    Reads get the same ids as in cudamapper, so ids and names found in its
+    output can be mapped onto each other.
+    """
+    cdef unique_ptr[io.FastaParser] parser
+
+    def __cinit__(
+            self,
+            fasta_file,
+            min_sequence_length=0,
+            shuffle=True,
+            parallel=False,
+            num_threads=0,
+            *args,
+            **kwargs):
+        """Parse a FASTA/FASTQ file.
+
+        Args:
+            fasta_file - Path to FASTA/FASTQ file, optionally compressed with bgzip
+            min_sequence_length - Sequences shorter than this are ignored
+            shuffle - Assign read ids in the same shuffled order as cudamapper
+            parallel - Parse the file on multiple threads
+            num_threads - Number of threads used if parallel is set, 0 to use all hardware threads
+        """
+        cdef string encoded_file = fasta_file.encode('utf-8')
+        if parallel:
+            self.parser = io.create_parallel_fasta_parser(encoded_file, min_sequence_length, shuffle, num_threads)
+        else:
+            self.parser = io.create_kseq_fasta_parser(encoded_file, min_sequence_length, shuffle)
+
+    def __init__(
+            self,
+            fasta_file,
+            min_sequence_length=0,
+            shuffle=True,
+            parallel=False,
+            num_threads=0,
+            *args,
+            **kwargs):
+        """Dummy implementation of __init__ function to allow
+        for Python subclassing.
+        """
+        pass
+
+    def __len__(self):
+        """Number of sequences in the file.
+        """
+        return deref(self.parser).get_num_seqences()
+
+    def get_sequence(self, sequence_id):
+        """Get the name and the basepairs of a sequence.
+
+        Args:
+            sequence_id - Id of the sequence
+
+        Returns:
+            Tuple of name and basepairs strings
+        """
+        if sequence_id < 0 or sequence_id >= len(self):
+            raise IndexError("sequence_id {} is out of range".format(sequence_id))
+        cdef io.cga_string_view_t name = deref(self.parser).get_name_view_by_id(sequence_id)
+        cdef io.cga_string_view_t seq = deref(self.parser).get_sequence_view_by_id(sequence_id)
+        return (name.data()[:name.size()].decode('utf-8'), seq.data()[:seq.size()].decode('utf-8'))
+
+    def get_sequence_id(self, name):
+        """Get the id of the sequence with the given name.
+
+        The name index is built on the first call, further lookups take constant time.
+
+        Args:
+            name - Name of the sequence, i.e. its header up to the first whitespace
+
+        Returns:
+            Id of the sequence, the lowest id if several sequences have the same name
+        """
+        cdef string encoded_name = name.encode('utf-8')
+        try:
+            return deref(self.parser).get_sequence_id_by_name(io.cga_string_view_t(encoded_name.data(),
+                                                                                   encoded_name.size()))
+        except IndexError:
+            raise KeyError(name)
+
+    def get_sequence_ids(self, names):
+        """Get the ids of the sequences with the given names.
+
+        Args:
+            names - Iterable of sequence names
+
+        Returns:
+            List of ids, in the order of the names
+        """
+        return [self.get_sequence_id(name) for name in names]
@@ -0,0 +1,166 @@
+#
+# Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+#
+# NVIDIA CORPORATION and its licensors retain all intellectual property
+# and proprietary rights in and to this software, related documentation
+# and any modifications thereto.  Any use, reproduction, disclosure or
+# distribution of this software and related documentation without an express
+# license agreement from NVIDIA CORPORATION is strictly prohibited.
+#
+"""Functions for reading binary overlaps files written by cudamapper -f binary.
+
+The file format is described in claragenomics/cudamapper/binary_overlaps.hpp.
+"""
+import struct
+
+import numpy as np
+
+from claragenomics.io.pafio import Overlap
+
+
+__all__ = ["BinaryOverlapsReader", "read_binary_overlaps", "RECORD_DTYPE"]
+
+
+MAGIC = b"CGAOVLP\0"
+VERSION = 1
+
+FILE_HEADER = struct.Struct("=8sIiIIII")
+BLOCK_HEADER = struct.Struct("=QQII")
+
+RECORD_DTYPE = np.dtype([
+    ("query_read_id", "=u4"),
+    ("target_read_id", "=u4"),
+    ("query_start", "=u4"),
+    ("query_end", "=u4"),
+    ("target_start", "=u4"),
+    ("target_end", "=u4"),
+    ("num_residues", "=u4"),
+    ("relative_strand", "=u1"),
+    ("reserved", "=u1", 3),
+])
+
+
+class BinaryOverlapsReader:
+    """Reads a binary overlaps file block by block.
+
+    Read names and lengths are available as attributes, overlaps can be read
+    as numpy structured arrays of RECORD_DTYPE or as PAF Overlap namedtuples.
+    """
+
+    def __init__(self, filepath):
+        """Open the file and read read names and lengths.
+
+        Args:
+            filepath (str): Path to binary overlaps file
+
+        Raises:
+            ValueError: If the file is not a binary overlaps file of a supported version
+        """
+        self._filepath = filepath
+        self._fh = open(filepath, "rb")
+        try:
+            magic, version, kmer_size, num_query_reads, num_target_reads, same_query_and_target, _ = \
+                FILE_HEADER.unpack(self._read(FILE_HEADER.size))
+            if magic != MAGIC:
+                raise ValueError("{} is not a binary overlaps file".format(filepath))
+            if version != VERSION:
+                raise ValueError("{} has binary overlaps format version {}, only version {} is supported".format(
+                    filepath, version, VERSION))
+            self.kmer_size = kmer_size
+            self.query_read_names, self.query_read_lengths = self._read_read_table(num_query_reads)
+            if same_query_and_target:
+                self.target_read_names, self.target_read_lengths = self.query_read_names, self.query_read_lengths
+            else:
+                self.target_read_names, self.target_read_lengths = self._read_read_table(num_target_reads)
+        except Exception:
+            self._fh.close()
+            raise
+
+    def __enter__(self):
+        """Enter context manager."""
+        return self
+
+    def __exit__(self, *args):
+        """Close the file when leaving context manager."""
+        self.close()
+
+    def close(self):
+        """Close the file."""
+        self._fh.close()
+
+    def blocks(self):
+        """Generator that yields blocks of overlaps.
+
+        Yields:
+            tuple: numpy array of RECORD_DTYPE records and a list of CIGAR strings or None
+            if the block has no CIGAR strings
+
+        Raises:
+            ValueError: If the file is truncated
+        """
+        while True:
+            header = self._fh.read(BLOCK_HEADER.size)
+            if not header:
+                return
+            if len(header) != BLOCK_HEADER.size:
+                raise ValueError("{} is truncated".format(self._filepath))
+            num_overlaps, num_cigar_chars, has_cigars, _ = BLOCK_HEADER.unpack(header)
+            records = np.frombuffer(self._read(num_overlaps * RECORD_DTYPE.itemsize), dtype=RECORD_DTYPE)
+            cigars = None
+            if has_cigars:
+                offsets = np.frombuffer(self._read((num_overlaps + 1) * 8), dtype="=u8")
+                chars = self._read(num_cigar_chars)
+                cigars = [chars[offsets[i]:offsets[i + 1]].decode() for i in range(num_overlaps)]
+            yield records, cigars
+
+    def overlaps(self):
+        """Generator that yields overlaps in the same form as pafio.read_paf.
+
+        Yields:
+            namedtuple: PAF Overlap, tags contain the CIGAR string if there is one
+        """
+        for records, cigars in self.blocks():
+            for i, record in enumerate(records):
+                query_start, query_end = int(record["query_start"]), int(record["query_end"])
+                target_start, target_end = int(record["target_start"]), int(record["target_end"])
+                yield Overlap(
+                    self.query_read_names[record["query_read_id"]],
+                    int(self.query_read_lengths[record["query_read_id"]]),
+                    query_start,
+                    query_end,
+                    chr(record["relative_strand"]),
+                    self.target_read_names[record["target_read_id"]],
+                    int(self.target_read_lengths[record["target_read_id"]]),
+                    target_start,
+                    target_end,
+                    int(record["num_residues"]) * self.kmer_size,
+                    max(abs(target_end - target_start), abs(query_end - query_start)),
+                    255,
+                    {"cg": cigars[i]} if cigars is not None else {},
+                )
+
+    def _read(self, size):
+        data = self._fh.read(size)
+        if len(data) != size:
+            raise ValueError("{} is truncated".format(self._filepath))
+        return data
+
+    def _read_read_table(self, num_reads):
+        lengths = np.frombuffer(self._read(num_reads * 4), dtype="=u4")
+        offsets = np.frombuffer(self._read((num_reads + 1) * 8), dtype="=u8")
+        names = self._read(int(offsets[-1]))
+        return [names[offsets[i]:offsets[i + 1]].decode() for i in range(num_reads)], lengths
+
+
+def read_binary_overlaps(filepath):
+    """Read a binary overlaps file into a list.
+
+    Args:
+        filepath (str): Path to read binary overlaps file from
+
+    Returns:
+        list: List of PAF namedtuples, same as pafio.read_paf would return for the same overlaps in PAF format
+
+    """
+    with BinaryOverlapsReader(filepath) as reader:
+        return list(reader.overlaps())
@@ -150,6 +150,18 @@ extensions = [
         libraries=["cudaaligner", "cudart", "cgabase"],
         language="c++",
         extra_compile_args=["-std=c++14"],
+    ),
+    Extension(
+        "claragenomics.bindings.io",
+        sources=[os.path.join("claragenomics/**/io.pyx")],
+        include_dirs=[
+            get_verified_absolute_path(os.path.join(cga_install_dir, "include")),
+        ],
+        library_dirs=[get_verified_absolute_path(os.path.join(cga_install_dir, "lib"))],
+        runtime_library_dirs=[os.path.join('$ORIGIN', os.pardir, 'shared_libs')],
+        libraries=["cgaio", "cgabase"],
+        language="c++",
+        extra_compile_args=["-std=c++14"],
     )
 ]
 
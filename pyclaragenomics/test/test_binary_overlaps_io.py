@@ -0,0 +1,93 @@
+#
+# Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+#
+# NVIDIA CORPORATION and its licensors retain all intellectual property
+# and proprietary rights in and to this software, related documentation
+# and any modifications thereto.  Any use, reproduction, disclosure or
+# distribution of this software and related documentation without an express
+# license agreement from NVIDIA CORPORATION is strictly prohibited.
+#
+
+import os
+import struct
+import tempfile
+
+import pytest
+
+from claragenomics.io.binaryoverlapsio import BinaryOverlapsReader, read_binary_overlaps
+
+
+def read_table(names, lengths):
+    data = struct.pack("={}I".format(len(lengths)), *lengths)
+    offset = 0
+    offsets = [0]
+    for name in names:
+        offset += len(name)
+        offsets.append(offset)
+    data += struct.pack("={}Q".format(len(offsets)), *offsets)
+    return data + "".join(names).encode()
+
+
+def block(records, cigars=None):
+    data = struct.pack("=QQII", len(records), sum(len(c) for c in cigars) if cigars else 0, 1 if cigars else 0, 0)
+    for record in records:
+        data += struct.pack("=7IB3x", *record[:7], ord(record[7]))
+    if cigars:
+        offsets = [0]
+        for cigar in cigars:
+            offsets.append(offsets[-1] + len(cigar))
+        data += struct.pack("={}Q".format(len(offsets)), *offsets) + "".join(cigars).encode()
+    return data
+
+
+@pytest.fixture
+def binary_overlaps_file():
+    with tempfile.TemporaryDirectory() as temp_dir:
+        file_path = os.path.join(temp_dir, "overlaps.cgaovl")
+        with open(file_path, "wb") as f:
+            f.write(struct.pack("=8sIiIIII", b"CGAOVLP\0", 1, 15, 2, 2, 1, 0))
+            f.write(read_table(["read_0", "read_1"], [7, 6]))
+            f.write(block([(0, 1, 1, 6, 0, 4, 2, "+")]))
+            f.write(block([(1, 0, 5, 2, 3, 7, 1, "-"), (1, 1, 0, 6, 0, 6, 3, "+")], ["3M", "6M"]))
+        yield file_path
+
+
+def test_read_binary_overlaps(binary_overlaps_file):
+    """Test that overlaps are the same as in PAF written by cudamapper.
+    """
+    overlaps = read_binary_overlaps(binary_overlaps_file)
+    assert(len(overlaps) == 3)
+    assert(overlaps[0][:12] == ("read_0", 7, 1, 6, "+", "read_1", 6, 0, 4, 30, 5, 255))
+    assert(overlaps[0].tags == {})
+    assert(overlaps[1][:12] == ("read_1", 6, 5, 2, "-", "read_0", 7, 3, 7, 15, 4, 255))
+    assert(overlaps[1].tags == {"cg": "3M"})
+    assert(overlaps[2].tags == {"cg": "6M"})
+
+
+def test_blocks(binary_overlaps_file):
+    """Test that blocks are returned as numpy arrays.
+    """
+    with BinaryOverlapsReader(binary_overlaps_file) as reader:
+        assert(reader.kmer_size == 15)
+        assert(reader.query_read_names == ["read_0", "read_1"])
+        assert(list(reader.target_read_lengths) == [7, 6])
+        blocks = list(reader.blocks())
+    assert(len(blocks) == 2)
+    assert(blocks[0][1] is None)
+    assert(list(blocks[1][0]["query_start"]) == [5, 0])
+    assert(blocks[1][1] == ["3M", "6M"])
+
+
+def test_invalid_files(binary_overlaps_file):
+    """Test that truncated files and files in other formats raise errors.
+    """
+    with open(binary_overlaps_file, "rb") as f:
+        data = f.read()
+    with open(binary_overlaps_file, "wb") as f:
+        f.write(data[:-1])
+    with pytest.raises(ValueError):
+        read_binary_overlaps(binary_overlaps_file)
+    with open(binary_overlaps_file, "wb") as f:
+        f.write(b"A" * 100)
+    with pytest.raises(ValueError):
+        BinaryOverlapsReader(binary_overlaps_file)
@@ -0,0 +1,62 @@
+#
+# Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+#
+# NVIDIA CORPORATION and its licensors retain all intellectual property
+# and proprietary rights in and to this software, related documentation
+# and any modifications thereto.  Any use, reproduction, disclosure or
+# distribution of this software and related documentation without an express
+# license agreement from NVIDIA CORPORATION is strictly prohibited.
+#
+
+import os
+import pytest
+import tempfile
+
+from claragenomics.bindings.io import FastaParser
+
+
+@pytest.fixture
+def fasta_file():
+    with tempfile.TemporaryDirectory() as temp_dir:
+        fasta_path = os.path.join(temp_dir, "reads.fasta")
+        with open(fasta_path, "w") as f:
+            for i in range(100):
+                f.write(">read_{} comment\n{}\n".format(i, "ACGT" * (i + 1)))
+            f.write(">read_0\nA\n")
+        yield fasta_path
+
+
+@pytest.mark.parametrize("parallel", [False, True])
+@pytest.mark.parametrize("shuffle", [False, True])
+def test_sequence_ids_by_name(fasta_file, parallel, shuffle):
+    """Test that every sequence is found by its name.
+    """
+    parser = FastaParser(fasta_file, shuffle=shuffle, parallel=parallel)
+    assert(len(parser) == 101)
+    for sequence_id in range(len(parser)):
+        name, seq = parser.get_sequence(sequence_id)
+        if name != "read_0":
+            assert(parser.get_sequence_id(name) == sequence_id)
+    names = ["read_{}".format(i) for i in range(1, 100)]
+    ids = parser.get_sequence_ids(names)
+    assert([parser.get_sequence(sequence_id)[0] for sequence_id in ids] == names)
+
+
+def test_duplicate_names(fasta_file):
+    """Test that the first of several sequences with the same name is found.
+    """
+    parser = FastaParser(fasta_file, shuffle=False)
+    assert(parser.get_sequence_id("read_0") == 0)
+    assert(parser.get_sequence(0) == ("read_0", "ACGT"))
+
+
+def test_missing_names(fasta_file):
+    """Test that missing names and ids raise errors.
+    """
+    parser = FastaParser(fasta_file)
+    with pytest.raises(KeyError):
+        parser.get_sequence_id("read_100")
+    with pytest.raises(KeyError):
+        parser.get_sequence_ids(["read_1", "read_0 comment"])
+    with pytest.raises(IndexError):
+        parser.get_sequence(101)